@@ -0,0 +1,88 @@
+#include "trdp_simulator/config.hpp"
+#include "trdp_simulator/logger.hpp"
+#include "trdp_simulator/runtime_metrics.hpp"
+#include "trdp_simulator/trdp_pd_worker.hpp"
+#include "trdp_simulator/trdp_stack_adapter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace trdp_sim {
+std::unique_ptr<TrdpStackAdapter> create_stub_trdp_stack_adapter();
+}
+
+namespace {
+
+using namespace trdp_sim;
+
+// Publishes back to back on the stub adapter and returns the mean time per packet in nanoseconds.
+double measure(bool bound, std::chrono::milliseconds duration, std::size_t payloadSize)
+{
+    PdPublisherConfig config;
+    config.name = "Bench";
+    config.comId = 1000;
+    config.cycleTimeMs = 0;
+    config.payload.format = PayloadConfig::Format::Text;
+    config.payload.value.assign(payloadSize, 'x');
+
+    Logger logger(LogLevel::Error);
+    RuntimeMetrics metrics;
+    auto adapter = create_stub_trdp_stack_adapter();
+    adapter->initialize(NetworkConfig{}, LoggingConfig{});
+
+    std::unique_ptr<PdPublisherWorker> worker;
+    if (bound) {
+        worker = adapter->create_pd_publisher_worker(config, logger, metrics);
+    } else {
+        worker = std::make_unique<BasicPdPublisherWorker<TrdpStackAdapter>>(config, *adapter, logger, metrics);
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    worker->start();
+    std::this_thread::sleep_for(duration);
+    worker->stop();
+    const auto elapsed = std::chrono::steady_clock::now() - started;
+    adapter->shutdown();
+
+    std::uint64_t packets = 0;
+    for (const auto &stats : metrics.snapshot().pdPublishers) {
+        packets += stats.packetsSent;
+    }
+    if (packets == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+           static_cast<double>(packets);
+}
+
+}  // namespace
+
+// Usage: trdp-simulator-adapter-benchmark [durationMs] [payloadBytes] [rounds]
+int main(int argc, char **argv)
+{
+    const auto duration = std::chrono::milliseconds(argc > 1 ? std::atoi(argv[1]) : 1000);
+    const std::size_t payloadSize = argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : 64U;
+    const int rounds = argc > 3 ? std::max(1, std::atoi(argv[3])) : 5;
+
+    // Rounds alternate between the variants and keep the best result of each to filter out scheduler noise.
+    double bestVirtual = std::numeric_limits<double>::max();
+    double bestBound = std::numeric_limits<double>::max();
+    for (int round = 0; round < rounds; ++round) {
+        bestVirtual = std::min(bestVirtual, measure(false, duration, payloadSize));
+        bestBound = std::min(bestBound, measure(true, duration, payloadSize));
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "payload_bytes=" << payloadSize << " rounds=" << rounds << " duration_ms=" << duration.count() << '\n';
+    std::cout << "virtual_ns_per_packet=" << bestVirtual << '\n';
+    std::cout << "bound_ns_per_packet=" << bestBound << '\n';
+    std::cout << "gain_ns_per_packet=" << bestVirtual - bestBound << '\n';
+    return 0;
+}
@@ -0,0 +1,566 @@
+#include "trdp_simulator/config.hpp"
+#include "trdp_simulator/config_loader.hpp"
+#include "trdp_simulator/log_file.hpp"
+#include "trdp_simulator/logger.hpp"
+#include "trdp_simulator/runtime_metrics.hpp"
+#include "trdp_simulator/trdp_stack_adapter.hpp"
+#include "trdp_simulator/web_application.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trdp_sim {
+
+std::unique_ptr<TrdpStackAdapter> create_stub_trdp_stack_adapter();
+
+// The web helpers under test are private to WebApplication.
+struct WebApplicationBenchmark {
+    static std::string json_escape(const std::string &value) { return WebApplication::json_escape(value); }
+    static std::string url_decode(std::string_view value) { return WebApplication::url_decode(value); }
+    static std::size_t parse_form_urlencoded(const std::string &body)
+    {
+        return WebApplication::parse_form_urlencoded(body).size();
+    }
+};
+
+}  // namespace trdp_sim
+
+namespace {
+
+using namespace trdp_sim;
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::vector<std::size_t> sizes{16, 256, 4096, 65536};
+    std::vector<std::size_t> threads{1, 2, 4, 8};
+    std::vector<std::size_t> telegrams{10, 100, 1000};
+    std::vector<std::size_t> fanout{1, 8, 64};
+    std::string filter;
+    std::string format{"text"};
+    std::chrono::milliseconds minTime{200};
+    int repetitions{3};
+    bool list{false};
+};
+
+// One parameterised measurement. run(thread, iterations) performs `iterations` operations on behalf of one of
+// `threads` threads and returns a value derived from the results, so the work cannot be optimised away.
+struct Case {
+    std::string family;
+    std::string name;
+    std::size_t threads{1};
+    std::uint64_t bytesPerOp{0};
+    std::function<std::size_t(std::size_t, std::uint64_t)> run;
+};
+
+struct Result {
+    const Case *benchmark;
+    std::uint64_t iterations;
+    double realNs;
+    double realNsMin;
+    double cpuNs;
+};
+
+std::atomic<std::size_t> sink{0};
+
+double process_cpu_ns()
+{
+    timespec now{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return static_cast<double>(now.tv_sec) * 1e9 + static_cast<double>(now.tv_nsec);
+}
+
+// Runs the case once with `iterations` operations per thread and returns the wall and CPU time per operation.
+std::pair<double, double> measure(const Case &benchmark, std::uint64_t iterations)
+{
+    std::atomic<std::size_t> ready{0};
+    std::atomic<bool> go{false};
+    const auto body = [&](std::size_t thread) {
+        ready.fetch_add(1);
+        while (!go.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        sink.fetch_add(benchmark.run(thread, iterations), std::memory_order_relaxed);
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t thread = 1; thread < benchmark.threads; ++thread) {
+        workers.emplace_back(body, thread);
+    }
+    while (ready.load() + 1U < benchmark.threads) {
+        std::this_thread::yield();
+    }
+    const auto cpuStart = process_cpu_ns();
+    const auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    ready.fetch_add(1);
+    body(0);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    const auto cpu = process_cpu_ns() - cpuStart;
+    const auto operations = static_cast<double>(iterations * benchmark.threads);
+    return {elapsed / operations, cpu / operations};
+}
+
+Result run_case(const Case &benchmark, const Options &options)
+{
+    // Grow the iteration count until one run lasts minTime, then keep the median of the repetitions.
+    std::uint64_t iterations = 1;
+    const double target = std::chrono::duration<double, std::nano>(options.minTime).count();
+    while (true) {
+        const auto perOp = measure(benchmark, iterations).first;
+        const auto elapsed = perOp * static_cast<double>(iterations);
+        if (elapsed >= target || iterations >= (1ULL << 40U)) {
+            break;
+        }
+        const auto scale = elapsed > 0.0 ? target / elapsed * 1.2 : 10.0;
+        iterations = std::max(iterations + 1U, static_cast<std::uint64_t>(static_cast<double>(iterations) *
+                                                                           std::min(scale, 10.0)));
+    }
+    std::vector<std::pair<double, double>> samples;
+    for (int repetition = 0; repetition < options.repetitions; ++repetition) {
+        samples.push_back(measure(benchmark, iterations));
+    }
+    std::sort(samples.begin(), samples.end());
+    const auto &median = samples[samples.size() / 2U];
+    return {&benchmark, iterations, median.first, samples.front().first, median.second};
+}
+
+std::string random_text(std::size_t size, std::uint32_t seed)
+{
+    // Mostly printable text with the characters the escapers have to handle mixed in.
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 <>/=\"&%+\n\t\\";
+    std::string text(size, ' ');
+    for (auto &ch : text) {
+        seed = seed * 1664525U + 1013904223U;
+        ch = alphabet[(seed >> 16U) % (sizeof(alphabet) - 1U)];
+    }
+    return text;
+}
+
+std::string url_encode(const std::string &value)
+{
+    std::ostringstream out;
+    for (const unsigned char ch : value) {
+        if (std::isalnum(ch) != 0) {
+            out << ch;
+        } else if (ch == ' ') {
+            out << '+';
+        } else {
+            out << '%' << std::uppercase << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(ch)
+                << std::nouppercase << std::dec;
+        }
+    }
+    return out.str();
+}
+
+std::string generated_configuration(std::size_t telegrams)
+{
+    std::ostringstream xml;
+    xml << "<trdpSimulator>\n  <network interface=\"lo\" hostIp=\"127.0.0.1\" />\n  <pd>\n";
+    for (std::size_t i = 0; i < telegrams; ++i) {
+        xml << "    <publisher name=\"Pub" << i << "\" comId=\"" << 10000 + i
+            << "\" cycleTimeMs=\"100\"><payload format=\"hex\">0102030405060708</payload></publisher>\n";
+        xml << "    <subscriber name=\"Sub" << i << "\" comId=\"" << 20000 + i << "\" timeoutMs=\"300\" />\n";
+    }
+    xml << "  </pd>\n</trdpSimulator>\n";
+    return xml.str();
+}
+
+void add_sized(std::vector<Case> &cases, const Options &options, const std::string &family,
+               const std::function<std::function<std::size_t(std::size_t, std::uint64_t)>(std::size_t)> &make)
+{
+    for (const auto size : options.sizes) {
+        cases.push_back({family, family + "/" + std::to_string(size), 1, size, make(size)});
+    }
+}
+
+std::vector<Case> build_cases(const Options &options, const std::filesystem::path &scratch)
+{
+    std::vector<Case> cases;
+
+    for (const auto format : {PayloadConfig::Format::Hex, PayloadConfig::Format::Text, PayloadConfig::Format::File}) {
+        const auto family = "load_payload/" + payload_format_to_string(format);
+        add_sized(cases, options, family, [format, scratch](std::size_t size) {
+            auto payload = std::make_shared<PayloadConfig>();
+            payload->format = format;
+            const auto bytes = random_text(size, 7);
+            if (format == PayloadConfig::Format::Hex) {
+                payload->value = to_hex(std::vector<std::uint8_t>(bytes.begin(), bytes.end()));
+            } else if (format == PayloadConfig::Format::Text) {
+                payload->value = bytes;
+            } else {
+                const auto path = scratch / ("payload-" + std::to_string(size) + ".bin");
+                std::ofstream(path, std::ios::binary) << bytes;
+                payload->value = path.string();
+            }
+            return [payload](std::size_t, std::uint64_t iterations) {
+                std::size_t total = 0;
+                for (std::uint64_t i = 0; i < iterations; ++i) {
+                    total += load_payload(*payload).size();
+                }
+                return total;
+            };
+        });
+    }
+
+    add_sized(cases, options, "to_hex", [](std::size_t size) {
+        const auto text = random_text(size, 11);
+        auto data = std::make_shared<std::vector<std::uint8_t>>(text.begin(), text.end());
+        return [data](std::size_t, std::uint64_t iterations) {
+            std::size_t total = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                total += to_hex(*data).size();
+            }
+            return total;
+        };
+    });
+
+    add_sized(cases, options, "json_escape", [](std::size_t size) {
+        auto text = std::make_shared<std::string>(random_text(size, 13));
+        return [text](std::size_t, std::uint64_t iterations) {
+            std::size_t total = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                total += WebApplicationBenchmark::json_escape(*text).size();
+            }
+            return total;
+        };
+    });
+
+    add_sized(cases, options, "url_decode", [](std::size_t size) {
+        auto encoded = std::make_shared<std::string>(url_encode(random_text(size, 17)));
+        return [encoded](std::size_t, std::uint64_t iterations) {
+            std::size_t total = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                total += WebApplicationBenchmark::url_decode(*encoded).size();
+            }
+            return total;
+        };
+    });
+
+    // The form the page posts when saving: a name and the URL-encoded document.
+    add_sized(cases, options, "parse_form_urlencoded", [](std::size_t size) {
+        auto body = std::make_shared<std::string>("name=bench&label=&xml=" + url_encode(random_text(size, 19)));
+        return [body](std::size_t, std::uint64_t iterations) {
+            std::size_t total = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                total += WebApplicationBenchmark::parse_form_urlencoded(*body);
+            }
+            return total;
+        };
+    });
+
+    for (const auto count : options.telegrams) {
+        auto xml = std::make_shared<std::string>(generated_configuration(count));
+        cases.push_back({"load_configuration_from_string", "load_configuration_from_string/" + std::to_string(count),
+                         1, xml->size(), [xml](std::size_t, std::uint64_t iterations) {
+                             std::size_t total = 0;
+                             for (std::uint64_t i = 0; i < iterations; ++i) {
+                                 total += load_configuration_from_string(*xml).pdPublishers.size();
+                             }
+                             return total;
+                         }});
+    }
+
+    for (const auto threads : options.threads) {
+        const auto suffix = "/threads:" + std::to_string(threads);
+        // Each thread records against its own telegram, as the publisher and subscriber threads do.
+        auto metrics = std::make_shared<RuntimeMetrics>();
+        auto names = std::make_shared<std::vector<std::string>>();
+        for (std::size_t thread = 0; thread < threads; ++thread) {
+            names->push_back("Telegram" + std::to_string(thread));
+        }
+        cases.push_back({"RuntimeMetrics::record_pd_publish", "RuntimeMetrics::record_pd_publish" + suffix, threads, 0,
+                         [metrics, names](std::size_t thread, std::uint64_t iterations) {
+                             for (std::uint64_t i = 0; i < iterations; ++i) {
+                                 metrics->record_pd_publish((*names)[thread]);
+                             }
+                             return std::size_t{0};
+                         }});
+        cases.push_back({"RuntimeMetrics::record_pd_receive", "RuntimeMetrics::record_pd_receive" + suffix, threads, 0,
+                         [metrics, names](std::size_t thread, std::uint64_t iterations) {
+                             for (std::uint64_t i = 0; i < iterations; ++i) {
+                                 metrics->record_pd_receive((*names)[thread]);
+                             }
+                             return std::size_t{0};
+                         }});
+        cases.push_back({"RuntimeMetrics::record_loop_lag", "RuntimeMetrics::record_loop_lag" + suffix, threads, 0,
+                         [metrics, names](std::size_t thread, std::uint64_t iterations) {
+                             for (std::uint64_t i = 0; i < iterations; ++i) {
+                                 metrics->record_loop_lag((*names)[thread], static_cast<std::int64_t>(i & 1023U));
+                             }
+                             return std::size_t{0};
+                         }});
+
+        // A message below the logger's level, and one written to a rotating log file.
+        auto filtered = std::make_shared<Logger>(LogLevel::Warn);
+        filtered->enable_console(false);
+        cases.push_back({"Logger::log/filtered", "Logger::log/filtered" + suffix, threads, 0,
+                         [filtered](std::size_t, std::uint64_t iterations) {
+                             const std::string message = "PD Pub0001 received comId=10001 payload=01 02 03 04";
+                             for (std::uint64_t i = 0; i < iterations; ++i) {
+                                 filtered->debug(message);
+                             }
+                             return std::size_t{0};
+                         }});
+        LoggingConfig fileConfig;
+        fileConfig.filePath = (scratch / ("logger-" + std::to_string(threads) + ".log")).string();
+        fileConfig.rotateSizeMb = 16;
+        fileConfig.keepFiles = 1;
+        fileConfig.compressRotated = false;
+        auto file = std::shared_ptr<RotatingLogFile>(new RotatingLogFile(fileConfig, [](const std::string &) {}));
+        auto written = std::shared_ptr<Logger>(new Logger(LogLevel::Info), [file](Logger *logger) { delete logger; });
+        written->enable_console(false);
+        written->set_file(file.get());
+        cases.push_back({"Logger::log/file", "Logger::log/file" + suffix, threads, 0,
+                         [written](std::size_t, std::uint64_t iterations) {
+                             const std::string message = "PD Pub0001 received comId=10001 payload=01 02 03 04";
+                             for (std::uint64_t i = 0; i < iterations; ++i) {
+                                 written->info(message);
+                             }
+                             return std::size_t{0};
+                         }});
+
+        // Every thread publishes its own telegram, which `fanout` local subscribers receive.
+        for (const auto fanout : options.fanout) {
+            auto adapter = std::shared_ptr<TrdpStackAdapter>(create_stub_trdp_stack_adapter().release(),
+                                                             [](TrdpStackAdapter *stack) {
+                                                                 stack->shutdown();
+                                                                 delete stack;
+                                                             });
+            adapter->initialize(NetworkConfig{}, LoggingConfig{});
+            auto received = std::make_shared<std::atomic<std::uint64_t>>(0);
+            for (std::size_t thread = 0; thread < threads; ++thread) {
+                PdPublisherConfig publisher;
+                publisher.name = (*names)[thread];
+                publisher.comId = 1000U + static_cast<std::uint32_t>(thread);
+                adapter->register_pd_publisher(publisher);
+                for (std::size_t subscriber = 0; subscriber < fanout; ++subscriber) {
+                    PdSubscriberConfig config;
+                    config.name = publisher.name + "Sub" + std::to_string(subscriber);
+                    config.comId = publisher.comId;
+                    adapter->register_pd_subscriber(config, [received](const PdMessage &message) {
+                        received->fetch_add(message.payload.size(), std::memory_order_relaxed);
+                    });
+                }
+            }
+            auto payload = std::make_shared<std::vector<std::uint8_t>>(64, 0x5A);
+            cases.push_back({"TrdpStackAdapter::publish_pd/stub",
+                             "TrdpStackAdapter::publish_pd/stub/fanout:" + std::to_string(fanout) + suffix, threads,
+                             payload->size(),
+                             [adapter, names, payload, received](std::size_t thread, std::uint64_t iterations) {
+                                 for (std::uint64_t i = 0; i < iterations; ++i) {
+                                     adapter->publish_pd((*names)[thread], *payload);
+                                 }
+                                 return static_cast<std::size_t>(received->load(std::memory_order_relaxed));
+                             }});
+        }
+    }
+
+    return cases;
+}
+
+std::string json_string(const std::string &value)
+{
+    std::string result = "\"";
+    for (const char ch : value) {
+        if (ch == '"' || ch == '\\') {
+            result += '\\';
+        }
+        result += ch;
+    }
+    return result + '"';
+}
+
+void print_results(const std::vector<Result> &results, const Options &options, const char *program)
+{
+    // Times are per operation over all threads, so this is the combined rate of the threads.
+    const auto throughput = [](double perOp) { return perOp > 0.0 ? 1e9 / perOp : 0.0; };
+    std::cout << std::fixed << std::setprecision(2);
+    if (options.format == "json") {
+        // Laid out like Google Benchmark's JSON report, so its compare tooling can diff two runs.
+        const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::tm local{};
+        localtime_r(&now, &local);
+        std::ostringstream date;
+        date << std::put_time(&local, "%Y-%m-%dT%H:%M:%S%z");
+        std::cout << "{\n  \"context\": {\n"
+                  << "    \"date\": " << json_string(date.str()) << ",\n"
+                  << "    \"executable\": " << json_string(program) << ",\n"
+                  << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+                  << "    \"library_build_type\": \"release\",\n"
+#else
+                  << "    \"library_build_type\": \"debug\",\n"
+#endif
+                  << "    \"min_time_ms\": " << options.minTime.count() << ",\n"
+                  << "    \"repetitions\": " << options.repetitions << "\n  },\n  \"benchmarks\": [\n";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const auto &result = results[i];
+            const auto perThreadOps = throughput(result.realNs);
+            std::cout << "    {\"name\": " << json_string(result.benchmark->name)
+                      << ", \"family\": " << json_string(result.benchmark->family)
+                      << ", \"run_type\": \"iteration\", \"threads\": " << result.benchmark->threads
+                      << ", \"iterations\": " << result.iterations << ", \"real_time\": " << result.realNs
+                      << ", \"real_time_min\": " << result.realNsMin << ", \"cpu_time\": " << result.cpuNs
+                      << ", \"time_unit\": \"ns\", \"items_per_second\": " << perThreadOps;
+            if (result.benchmark->bytesPerOp != 0) {
+                std::cout << ", \"bytes_per_second\": "
+                          << perThreadOps * static_cast<double>(result.benchmark->bytesPerOp);
+            }
+            std::cout << '}' << (i + 1U == results.size() ? "\n" : ",\n");
+        }
+        std::cout << "  ]\n}\n";
+        return;
+    }
+    if (options.format == "csv") {
+        std::cout << "name,family,threads,iterations,real_ns,real_ns_min,cpu_ns,items_per_second,bytes_per_second\n";
+        for (const auto &result : results) {
+            const auto perThreadOps = throughput(result.realNs);
+            std::cout << json_string(result.benchmark->name) << ',' << json_string(result.benchmark->family) << ','
+                      << result.benchmark->threads << ',' << result.iterations << ',' << result.realNs << ','
+                      << result.realNsMin << ',' << result.cpuNs << ',' << perThreadOps << ','
+                      << perThreadOps * static_cast<double>(result.benchmark->bytesPerOp) << '\n';
+        }
+        return;
+    }
+    std::cout << std::left << std::setw(64) << "benchmark" << std::right << std::setw(14) << "ns/op"
+              << std::setw(14) << "cpu ns/op" << std::setw(14) << "MB/s" << '\n';
+    for (const auto &result : results) {
+        std::cout << std::left << std::setw(64) << result.benchmark->name << std::right << std::setw(14)
+                  << result.realNs << std::setw(14) << result.cpuNs << std::setw(14);
+        if (result.benchmark->bytesPerOp != 0) {
+            std::cout << throughput(result.realNs) * static_cast<double>(result.benchmark->bytesPerOp) / 1e6;
+        } else {
+            std::cout << "-";
+        }
+        std::cout << '\n';
+    }
+}
+
+std::vector<std::size_t> parse_list(const std::string &value)
+{
+    std::vector<std::size_t> result;
+    std::istringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        const auto number = std::strtoull(item.c_str(), nullptr, 10);
+        if (number == 0) {
+            throw std::runtime_error("Invalid list entry '" + item + "'");
+        }
+        result.push_back(static_cast<std::size_t>(number));
+    }
+    return result;
+}
+
+void print_usage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [options]" << std::endl;
+    std::cerr << "  --filter <text>        run the benchmarks whose name contains text" << std::endl;
+    std::cerr << "  --format <fmt>         text (default), json or csv" << std::endl;
+    std::cerr << "  --min-time-ms <n>      length of one measured run (default 200)" << std::endl;
+    std::cerr << "  --repetitions <n>      measured runs per benchmark; the median is reported (default 3)"
+              << std::endl;
+    std::cerr << "  --sizes <a,b,...>      input sizes in bytes (default 16,256,4096,65536)" << std::endl;
+    std::cerr << "  --threads <a,b,...>    thread counts (default 1,2,4,8)" << std::endl;
+    std::cerr << "  --telegrams <a,b,...>  telegrams per generated configuration (default 10,100,1000)" << std::endl;
+    std::cerr << "  --fanout <a,b,...>     subscribers per published telegram (default 1,8,64)" << std::endl;
+    std::cerr << "  --list                 print the benchmark names and exit" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument = argv[i];
+            const auto value = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::runtime_error("Missing value for " + argument);
+                }
+                return argv[++i];
+            };
+            if (argument == "--filter") {
+                options.filter = value();
+            } else if (argument == "--format") {
+                options.format = value();
+                if (options.format != "text" && options.format != "json" && options.format != "csv") {
+                    throw std::runtime_error("Unknown format '" + options.format + "'");
+                }
+            } else if (argument == "--min-time-ms") {
+                options.minTime = std::chrono::milliseconds(std::max(1, std::atoi(value().c_str())));
+            } else if (argument == "--repetitions") {
+                options.repetitions = std::max(1, std::atoi(value().c_str()));
+            } else if (argument == "--sizes") {
+                options.sizes = parse_list(value());
+            } else if (argument == "--threads") {
+                options.threads = parse_list(value());
+            } else if (argument == "--telegrams") {
+                options.telegrams = parse_list(value());
+            } else if (argument == "--fanout") {
+                options.fanout = parse_list(value());
+            } else if (argument == "--list") {
+                options.list = true;
+            } else {
+                print_usage(argv[0]);
+                return argument == "--help" ? 0 : 2;
+            }
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << std::endl;
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    const auto scratch = std::filesystem::temp_directory_path() / "trdp-simulator-component-benchmark";
+    std::filesystem::create_directories(scratch);
+    int status = 0;
+    {
+        auto cases = build_cases(options, scratch);
+        cases.erase(std::remove_if(cases.begin(), cases.end(),
+                                   [&options](const Case &benchmark) {
+                                       return benchmark.name.find(options.filter) == std::string::npos;
+                                   }),
+                    cases.end());
+        if (options.list) {
+            for (const auto &benchmark : cases) {
+                std::cout << benchmark.name << '\n';
+            }
+        } else {
+            std::vector<Result> results;
+            for (const auto &benchmark : cases) {
+                try {
+                    results.push_back(run_case(benchmark, options));
+                } catch (const std::exception &ex) {
+                    std::cerr << benchmark.name << ": " << ex.what() << std::endl;
+                    status = 1;
+                }
+                // Progress goes to stderr so the report on stdout stays machine-readable.
+                if (options.format != "text") {
+                    std::cerr << benchmark.name << " done" << std::endl;
+                }
+            }
+            print_results(results, options, argv[0]);
+        }
+    }
+    std::error_code ec;
+    std::filesystem::remove_all(scratch, ec);
+    return status;
+}
@@ -0,0 +1,317 @@
+#include <sys/wait.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Runs the stack workload built for each TRDP stack version with the same arguments and prints one table.
+// The workloads run one after another, since they share the loop-back ports.
+
+#ifndef TRDPSIM_STACK_WORKLOADS
+#define TRDPSIM_STACK_WORKLOADS ""
+#endif
+
+namespace {
+
+struct Workload {
+    std::string version;
+    std::string path;
+};
+
+using Sample = std::map<std::string, std::string>;
+
+struct Row {
+    std::string version;
+    std::string stack;
+    std::vector<Sample> samples;
+    std::string error;
+};
+
+// Parses "version=path,version=path".
+std::vector<Workload> parse_workloads(const std::string &list)
+{
+    std::vector<Workload> workloads;
+    std::istringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        const auto eq = item.find('=');
+        if (eq == std::string::npos || eq == 0 || eq + 1 == item.size()) {
+            throw std::runtime_error("Invalid workload '" + item + "', expected <version>=<path>");
+        }
+        workloads.push_back({item.substr(0, eq), item.substr(eq + 1)});
+    }
+    return workloads;
+}
+
+std::string shell_quote(const std::string &value)
+{
+    std::string quoted = "'";
+    for (const char ch : value) {
+        if (ch == '\'') {
+            quoted += "'\\''";
+        } else {
+            quoted += ch;
+        }
+    }
+    return quoted + "'";
+}
+
+Sample run_workload(const Workload &workload, const std::vector<std::string> &arguments)
+{
+    std::string command = shell_quote(workload.path);
+    for (const auto &argument : arguments) {
+        command += ' ' + shell_quote(argument);
+    }
+    FILE *pipe = ::popen(command.c_str(), "r");
+    if (pipe == nullptr) {
+        throw std::runtime_error("Unable to run " + workload.path);
+    }
+    std::string output;
+    char buffer[4096];
+    std::size_t read = 0;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+        output.append(buffer, read);
+    }
+    const int status = ::pclose(pipe);
+    if (status == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        throw std::runtime_error(workload.path + " failed");
+    }
+
+    Sample sample;
+    std::istringstream fields(output);
+    std::string field;
+    while (fields >> field) {
+        const auto eq = field.find('=');
+        if (eq != std::string::npos) {
+            sample[field.substr(0, eq)] = field.substr(eq + 1);
+        }
+    }
+    if (sample.count("pd_received") == 0) {
+        throw std::runtime_error(workload.path + " printed no results");
+    }
+    return sample;
+}
+
+double number(const Sample &sample, const std::string &key)
+{
+    const auto it = sample.find(key);
+    return it == sample.end() ? 0.0 : std::stod(it->second);
+}
+
+struct Column {
+    const char *header;
+    const char *key;
+    int precision;
+};
+
+// Derived values are computed per run; the table shows the median over the runs.
+double value(const Sample &sample, const std::string &key)
+{
+    const auto seconds = number(sample, "duration_ms") / 1000.0;
+    if (key == "pd_per_second") {
+        return seconds > 0.0 ? number(sample, "pd_received") / seconds : 0.0;
+    }
+    if (key == "pd_loss_percent") {
+        const auto sent = number(sample, "pd_sent");
+        return sent > 0.0 ? std::max(0.0, sent - number(sample, "pd_received")) * 100.0 / sent : 0.0;
+    }
+    if (key == "md_per_second") {
+        return seconds > 0.0 ? number(sample, "md_replies") / seconds : 0.0;
+    }
+    if (key == "cpu_percent") {
+        return seconds > 0.0 ? number(sample, "cpu_us") / 1e6 / seconds * 100.0 : 0.0;
+    }
+    if (key == "peak_rss_mib") {
+        return number(sample, "peak_rss_kb") / 1024.0;
+    }
+    return number(sample, key);
+}
+
+double median(const Row &row, const std::string &key)
+{
+    std::vector<double> values;
+    for (const auto &sample : row.samples) {
+        values.push_back(value(sample, key));
+    }
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2U];
+}
+
+const std::vector<Column> &columns()
+{
+    static const std::vector<Column> result{
+        {"PD/s", "pd_per_second", 0},
+        {"PD loss %", "pd_loss_percent", 2},
+        {"PD mean us", "pd_latency_mean_us", 1},
+        {"PD p99 us", "pd_latency_p99_us", 0},
+        {"MD/s", "md_per_second", 0},
+        {"MD timeouts", "md_timeouts", 0},
+        {"MD mean us", "md_rtt_mean_us", 1},
+        {"MD p99 us", "md_rtt_p99_us", 0},
+        {"CPU %", "cpu_percent", 1},
+        {"RSS MiB", "peak_rss_mib", 1},
+    };
+    return result;
+}
+
+void print_table(const std::vector<Row> &rows, const std::string &format)
+{
+    std::cout << std::fixed;
+    if (format == "csv") {
+        std::cout << "version,stack,runs";
+        for (const auto &column : columns()) {
+            std::cout << ',' << column.key;
+        }
+        std::cout << ",error\n";
+        for (const auto &row : rows) {
+            std::cout << row.version << ',' << row.stack << ',' << row.samples.size();
+            for (const auto &column : columns()) {
+                std::cout << ',' << std::setprecision(column.precision) << median(row, column.key);
+            }
+            std::cout << ',' << row.error << '\n';
+        }
+        return;
+    }
+    if (format == "json") {
+        std::cout << "[\n";
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            const auto &row = rows[i];
+            std::cout << "  {\"version\": \"" << row.version << "\", \"stack\": \"" << row.stack
+                      << "\", \"runs\": " << row.samples.size();
+            for (const auto &column : columns()) {
+                std::cout << ", \"" << column.key << "\": " << std::setprecision(column.precision)
+                          << median(row, column.key);
+            }
+            if (!row.error.empty()) {
+                std::cout << ", \"error\": \"" << row.error << '"';
+            }
+            std::cout << '}' << (i + 1U == rows.size() ? "\n" : ",\n");
+        }
+        std::cout << "]\n";
+        return;
+    }
+
+    std::cout << std::left << std::setw(10) << "version" << std::setw(6) << "stack" << std::right;
+    for (const auto &column : columns()) {
+        std::cout << std::setw(13) << column.header;
+    }
+    std::cout << '\n';
+    for (const auto &row : rows) {
+        std::cout << std::left << std::setw(10) << row.version << std::setw(6) << row.stack << std::right;
+        if (row.samples.empty()) {
+            std::cout << "  " << row.error << '\n';
+            continue;
+        }
+        for (const auto &column : columns()) {
+            std::cout << std::setw(13) << std::setprecision(column.precision) << median(row, column.key);
+        }
+        std::cout << '\n';
+    }
+}
+
+void print_usage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [options] [-- workload arguments]" << std::endl;
+    std::cerr << "  --rounds <n>                  runs per stack version; the median is reported (default 3)"
+              << std::endl;
+    std::cerr << "  --format <fmt>                text (default), csv or json" << std::endl;
+    std::cerr << "  --workload <version>=<path>   add a workload binary built elsewhere" << std::endl;
+    std::cerr << "  --only <version>              run only this version (repeatable)" << std::endl;
+    std::cerr << "Workload arguments: --duration-ms, --warmup-ms, --pd-telegrams, --pd-rate (0 = back to back),"
+              << std::endl;
+    std::cerr << "  --payload-bytes, --md-senders, --md-rate (0 = uncapped), --interface, --host-ip, --pd-port,"
+              << std::endl;
+    std::cerr << "  --md-port" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    int rounds = 3;
+    std::string format = "text";
+    std::vector<std::string> only;
+    std::vector<std::string> workloadArguments;
+    std::vector<Workload> workloads;
+    try {
+        workloads = parse_workloads(TRDPSIM_STACK_WORKLOADS);
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument = argv[i];
+            if (argument == "--") {
+                workloadArguments.assign(argv + i + 1, argv + argc);
+                break;
+            }
+            if (argument == "--help") {
+                print_usage(argv[0]);
+                return 0;
+            }
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value for " + argument);
+            }
+            const std::string value = argv[++i];
+            if (argument == "--rounds") {
+                rounds = std::max(1, std::stoi(value));
+            } else if (argument == "--format") {
+                if (value != "text" && value != "csv" && value != "json") {
+                    throw std::runtime_error("Unknown format '" + value + "'");
+                }
+                format = value;
+            } else if (argument == "--workload") {
+                const auto added = parse_workloads(value);
+                workloads.insert(workloads.end(), added.begin(), added.end());
+            } else if (argument == "--only") {
+                only.push_back(value);
+            } else {
+                throw std::runtime_error("Unknown argument " + argument);
+            }
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << std::endl;
+        print_usage(argv[0]);
+        return 2;
+    }
+    if (!only.empty()) {
+        workloads.erase(std::remove_if(workloads.begin(), workloads.end(),
+                                       [&only](const Workload &workload) {
+                                           return std::find(only.begin(), only.end(), workload.version) == only.end();
+                                       }),
+                        workloads.end());
+    }
+    if (workloads.empty()) {
+        std::cerr << "No stack workloads to run" << std::endl;
+        return 2;
+    }
+
+    std::vector<Row> rows;
+    for (const auto &workload : workloads) {
+        rows.push_back({workload.version, "-", {}, {}});
+    }
+    // Rounds visit every version in turn, so a change in machine load affects all of them alike.
+    for (int round = 0; round < rounds; ++round) {
+        for (std::size_t i = 0; i < workloads.size(); ++i) {
+            if (!rows[i].error.empty()) {
+                continue;
+            }
+            std::cerr << "Round " << round + 1 << '/' << rounds << ": TRDP " << workloads[i].version << std::endl;
+            try {
+                auto sample = run_workload(workloads[i], workloadArguments);
+                rows[i].stack = sample["stack"];
+                rows[i].samples.push_back(std::move(sample));
+            } catch (const std::exception &ex) {
+                rows[i].error = ex.what();
+            }
+        }
+    }
+    print_table(rows, format);
+    return std::all_of(rows.begin(), rows.end(), [](const Row &row) { return row.error.empty(); }) ? 0 : 1;
+}
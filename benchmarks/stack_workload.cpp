@@ -0,0 +1,410 @@
+#include "trdp_simulator/config.hpp"
+#include "trdp_simulator/runtime_metrics.hpp"
+#include "trdp_simulator/trdp_stack_adapter.hpp"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Runs a fixed PD/MD workload through the stack's loop-back path and prints one line of key=value results.
+// One copy of this program is built per TRDP stack version; trdp-simulator-stack-comparison runs them all.
+
+namespace {
+
+using namespace trdp_sim;
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string interfaceName{"lo"};
+    std::string hostIp{"127.0.0.1"};
+    // Off the TRDP defaults, so a simulator running on the same host does not receive the workload.
+    std::uint16_t pdPort{27224};
+    std::uint16_t mdPort{27225};
+    std::chrono::milliseconds warmup{500};
+    std::chrono::milliseconds duration{5000};
+    std::size_t pdTelegrams{100};
+    std::uint64_t pdRate{20000};
+    std::size_t payloadBytes{64};
+    std::size_t mdSenders{10};
+    std::uint64_t mdRate{2000};
+};
+
+std::int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+// Payloads start with the steady clock time they were sent at.
+std::int64_t sent_at(const std::vector<std::uint8_t> &payload)
+{
+    std::int64_t stamp = 0;
+    if (payload.size() >= sizeof(stamp)) {
+        std::memcpy(&stamp, payload.data(), sizeof(stamp));
+    }
+    return stamp;
+}
+
+std::int64_t cpu_time_us()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return (static_cast<std::int64_t>(usage.ru_utime.tv_sec) + usage.ru_stime.tv_sec) * 1000000 +
+           usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+class Workload {
+public:
+    explicit Workload(Options options) : options_(std::move(options)), adapter_(create_trdp_stack_adapter()) {}
+
+    void run()
+    {
+        NetworkConfig network;
+        network.interfaceName = options_.interfaceName;
+        network.hostIp = options_.hostIp;
+        network.pdPort = options_.pdPort;
+        network.mdPort = options_.mdPort;
+        LoggingConfig logging;
+        logging.enableConsole = false;
+        logging.level = LogLevel::Error;
+        adapter_->initialize(network, logging);
+        register_telegrams();
+
+        polling_ = true;
+        std::thread poller([this] {
+            while (polling_) {
+                adapter_->poll(std::chrono::milliseconds(100));
+            }
+        });
+
+        // Only telegrams sent inside the window are counted; the warm-up lets sockets and session tables settle.
+        const auto start = now_ns();
+        windowStartNs_ = start + std::chrono::nanoseconds(options_.warmup).count();
+        windowEndNs_ = windowStartNs_ + std::chrono::nanoseconds(options_.duration).count();
+        sending_ = true;
+        std::thread pdSender([this] { send_pd(); });
+        std::thread mdSender([this] { send_md(); });
+
+        std::this_thread::sleep_until(Clock::time_point(std::chrono::nanoseconds(windowStartNs_)));
+        const auto cpuStart = cpu_time_us();
+        std::this_thread::sleep_until(Clock::time_point(std::chrono::nanoseconds(windowEndNs_)));
+        const auto cpuEnd = cpu_time_us();
+        sending_ = false;
+        mdCv_.notify_all();
+        pdSender.join();
+        mdSender.join();
+        // Telegrams still in flight are given time to arrive before the receive counts are read.
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        polling_ = false;
+        poller.join();
+        adapter_->shutdown();
+
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        print(cpuEnd - cpuStart, usage.ru_maxrss);
+    }
+
+private:
+    static constexpr std::uint32_t PdComIdBase = 40000U;
+    static constexpr std::uint32_t MdComIdBase = 50000U;
+
+    void register_telegrams()
+    {
+        for (std::size_t i = 0; i < options_.pdTelegrams; ++i) {
+            PdPublisherConfig publisher;
+            publisher.name = "Pub" + std::to_string(i);
+            publisher.comId = PdComIdBase + static_cast<std::uint32_t>(i);
+            publisher.destIp = options_.hostIp;
+            // Sent only when the workload puts a payload, so the stack adds no cyclic traffic of its own.
+            publisher.sendMode = PdPublisherConfig::SendMode::OnChange;
+            adapter_->register_pd_publisher(publisher);
+            pdPublishers_.push_back(publisher.name);
+
+            PdSubscriberConfig subscriber;
+            subscriber.name = "Sub" + std::to_string(i);
+            subscriber.comId = publisher.comId;
+            subscriber.timeoutMs = 60000;
+            adapter_->register_pd_subscriber(subscriber, [this](const PdMessage &message) {
+                const auto stamp = sent_at(message.payload);
+                if (in_window(stamp)) {
+                    ++pdReceived_;
+                    std::lock_guard<std::mutex> lock(histogramMutex_);
+                    pdLatency_.record((now_ns() - stamp) / 1000);
+                }
+            });
+        }
+
+        mdOutstanding_ = std::make_unique<std::atomic<bool>[]>(options_.mdSenders);
+        for (std::size_t i = 0; i < options_.mdSenders; ++i) {
+            MdListenerConfig listener;
+            listener.name = "Rep" + std::to_string(i);
+            listener.comId = MdComIdBase + static_cast<std::uint32_t>(i);
+            adapter_->register_md_listener(listener, [this, name = listener.name](const MdMessage &message) {
+                if (message.type == MdMessageType::Request) {
+                    adapter_->send_md_reply(name, message, message.payload);
+                }
+            });
+
+            MdSenderConfig sender;
+            sender.name = "Req" + std::to_string(i);
+            sender.comId = listener.comId;
+            sender.destIp = options_.hostIp;
+            sender.expectReply = true;
+            sender.replyTimeoutMs = 1000;
+            adapter_->register_md_sender(
+                sender,
+                [this, i](const MdMessage &message) {
+                    const auto stamp = sent_at(message.payload);
+                    if (in_window(stamp)) {
+                        ++mdReplies_;
+                        std::lock_guard<std::mutex> lock(histogramMutex_);
+                        mdRoundTrip_.record((now_ns() - stamp) / 1000);
+                    }
+                    complete_md(i);
+                },
+                [this, i](const MdSessionId &) {
+                    ++mdTimeouts_;
+                    complete_md(i);
+                });
+            mdSenders_.push_back(sender.name);
+        }
+    }
+
+    bool in_window(std::int64_t stamp) const { return stamp >= windowStartNs_ && stamp < windowEndNs_; }
+
+    std::vector<std::uint8_t> stamped_payload()
+    {
+        std::vector<std::uint8_t> payload(options_.payloadBytes, 0xA5);
+        const auto stamp = now_ns();
+        std::memcpy(payload.data(), &stamp, sizeof(stamp));
+        return payload;
+    }
+
+    // Publishes round robin over the telegrams at pdRate, or back to back when it is 0.
+    void send_pd()
+    {
+        if (pdPublishers_.empty()) {
+            return;
+        }
+        const auto start = Clock::now();
+        std::uint64_t sent = 0;
+        while (sending_) {
+            const auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            const auto due = options_.pdRate == 0 ? sent + 1U
+                                                  : static_cast<std::uint64_t>(elapsed * static_cast<double>(options_.pdRate));
+            while (sent < due && sending_) {
+                const auto payload = stamped_payload();
+                try {
+                    adapter_->publish_pd_immediate(pdPublishers_[sent % pdPublishers_.size()], payload);
+                    if (in_window(sent_at(payload))) {
+                        ++pdSent_;
+                    }
+                } catch (const std::exception &) {
+                    ++pdErrors_;
+                }
+                ++sent;
+            }
+            if (options_.pdRate != 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+    }
+
+    void complete_md(std::size_t sender)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mdMutex_);
+            mdOutstanding_[sender] = false;
+        }
+        mdCv_.notify_one();
+    }
+
+    // Closed loop: every sender keeps one request outstanding, so the MD rate follows the round trip time.
+    // mdRate caps the total request rate; 0 leaves it uncapped.
+    void send_md()
+    {
+        if (mdSenders_.empty()) {
+            return;
+        }
+        const auto start = Clock::now();
+        std::uint64_t sent = 0;
+        std::size_t next = 0;
+        std::unique_lock<std::mutex> lock(mdMutex_);
+        while (sending_) {
+            if (options_.mdRate != 0) {
+                const auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+                if (sent >= static_cast<std::uint64_t>(elapsed * static_cast<double>(options_.mdRate))) {
+                    mdCv_.wait_for(lock, std::chrono::microseconds(200));
+                    continue;
+                }
+            }
+            std::size_t sender = mdSenders_.size();
+            for (std::size_t offset = 0; offset < mdSenders_.size(); ++offset) {
+                const auto candidate = (next + offset) % mdSenders_.size();
+                if (!mdOutstanding_[candidate]) {
+                    sender = candidate;
+                    break;
+                }
+            }
+            if (sender == mdSenders_.size()) {
+                mdCv_.wait_for(lock, std::chrono::milliseconds(10));
+                continue;
+            }
+            next = sender + 1U;
+            mdOutstanding_[sender] = true;
+            const auto payload = stamped_payload();
+            // The stub adapter answers inside send_md_request, which completes the request under this lock.
+            lock.unlock();
+            try {
+                adapter_->send_md_request(mdSenders_[sender], payload);
+                if (in_window(sent_at(payload))) {
+                    ++mdRequests_;
+                }
+            } catch (const std::exception &) {
+                ++mdErrors_;
+                mdOutstanding_[sender] = false;
+            }
+            ++sent;
+            lock.lock();
+        }
+    }
+
+    void print(std::int64_t cpuUs, long peakRssKb) const
+    {
+#ifdef TRDP_STACK_VERSION
+        std::cout << "version=" << TRDP_STACK_VERSION;
+#else
+        std::cout << "version=unknown";
+#endif
+#ifdef TRDPSIM_WITH_TRDP
+        std::cout << " stack=real";
+#else
+        std::cout << " stack=stub";
+#endif
+        std::cout << " duration_ms=" << options_.duration.count() << " pd_telegrams=" << options_.pdTelegrams
+                  << " payload_bytes=" << options_.payloadBytes << " pd_sent=" << pdSent_
+                  << " pd_received=" << pdReceived_ << " pd_errors=" << pdErrors_
+                  << " pd_latency_mean_us=" << mean_us(pdLatency_)
+                  << " pd_latency_p50_us=" << pdLatency_.percentile_us(50.0)
+                  << " pd_latency_p99_us=" << pdLatency_.percentile_us(99.0)
+                  << " pd_latency_max_us=" << pdLatency_.max_us() << " md_senders=" << options_.mdSenders
+                  << " md_requests=" << mdRequests_ << " md_replies=" << mdReplies_ << " md_timeouts=" << mdTimeouts_
+                  << " md_errors=" << mdErrors_ << " md_rtt_mean_us=" << mean_us(mdRoundTrip_)
+                  << " md_rtt_p50_us=" << mdRoundTrip_.percentile_us(50.0)
+                  << " md_rtt_p99_us=" << mdRoundTrip_.percentile_us(99.0)
+                  << " md_rtt_max_us=" << mdRoundTrip_.max_us() << " cpu_us=" << cpuUs
+                  << " peak_rss_kb=" << peakRssKb << std::endl;
+    }
+
+    static double mean_us(const LatencyHistogram &histogram)
+    {
+        return histogram.count() == 0 ? 0.0
+                                      : static_cast<double>(histogram.sum_us()) / static_cast<double>(histogram.count());
+    }
+
+    Options options_;
+    std::unique_ptr<TrdpStackAdapter> adapter_;
+    std::vector<std::string> pdPublishers_;
+    std::vector<std::string> mdSenders_;
+
+    std::int64_t windowStartNs_{0};
+    std::int64_t windowEndNs_{0};
+    std::atomic<bool> polling_{false};
+    std::atomic<bool> sending_{false};
+
+    std::atomic<std::uint64_t> pdSent_{0};
+    std::atomic<std::uint64_t> pdErrors_{0};
+    std::atomic<std::uint64_t> mdRequests_{0};
+    std::atomic<std::uint64_t> mdErrors_{0};
+    // Handlers run on the poll thread for the real stack and on the sending thread for the stub.
+    std::atomic<std::uint64_t> pdReceived_{0};
+    std::atomic<std::uint64_t> mdReplies_{0};
+    std::atomic<std::uint64_t> mdTimeouts_{0};
+    std::mutex histogramMutex_;
+    LatencyHistogram pdLatency_;
+    LatencyHistogram mdRoundTrip_;
+
+    std::mutex mdMutex_;
+    std::condition_variable mdCv_;
+    std::unique_ptr<std::atomic<bool>[]> mdOutstanding_;
+};
+
+void print_usage(const char *program)
+{
+    std::cerr << "Usage: " << program
+              << " [--duration-ms n] [--warmup-ms n] [--pd-telegrams n] [--pd-rate n] [--payload-bytes n]"
+                 " [--md-senders n] [--md-rate n] [--interface name] [--host-ip ip] [--pd-port n] [--md-port n]"
+              << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument = argv[i];
+            if (argument == "--help") {
+                print_usage(argv[0]);
+                return 0;
+            }
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value for " + argument);
+            }
+            const std::string value = argv[++i];
+            if (argument == "--duration-ms") {
+                options.duration = std::chrono::milliseconds(std::stoul(value));
+            } else if (argument == "--warmup-ms") {
+                options.warmup = std::chrono::milliseconds(std::stoul(value));
+            } else if (argument == "--pd-telegrams") {
+                options.pdTelegrams = std::stoul(value);
+            } else if (argument == "--pd-rate") {
+                options.pdRate = std::stoull(value);
+            } else if (argument == "--payload-bytes") {
+                options.payloadBytes = std::stoul(value);
+            } else if (argument == "--md-senders") {
+                options.mdSenders = std::stoul(value);
+            } else if (argument == "--md-rate") {
+                options.mdRate = std::stoull(value);
+            } else if (argument == "--interface") {
+                options.interfaceName = value;
+            } else if (argument == "--host-ip") {
+                options.hostIp = value;
+            } else if (argument == "--pd-port") {
+                options.pdPort = static_cast<std::uint16_t>(std::stoul(value));
+            } else if (argument == "--md-port") {
+                options.mdPort = static_cast<std::uint16_t>(std::stoul(value));
+            } else {
+                throw std::runtime_error("Unknown argument " + argument);
+            }
+        }
+        if (options.payloadBytes < sizeof(std::int64_t)) {
+            throw std::runtime_error("--payload-bytes must be at least " + std::to_string(sizeof(std::int64_t)));
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << std::endl;
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    try {
+        Workload(options).run();
+    } catch (const std::exception &ex) {
+        std::cerr << "Workload failed: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace trdp_sim {
+
+// Heap allocation counters of the TRDPSimulator_ALLOCATION_TRACKING build, which replaces the global operator
+// new and, on glibc, the C malloc family. Counts are kept per named thread and per code region; allocations
+// outside any region are only counted for the thread. Other builds compile the hooks below to nothing and report
+// tracking as disabled.
+struct AllocationCounter {
+    std::string name;
+    std::uint64_t allocations{0};
+    std::uint64_t bytes{0};
+};
+
+struct AllocationReport {
+    bool enabled{false};
+    std::vector<AllocationCounter> threads;
+    std::vector<AllocationCounter> regions;
+};
+
+#ifdef TRDPSIM_ALLOCATION_TRACKING
+
+// Threads sharing a name share a counter, so restarted workers keep adding to the same entry.
+void set_allocation_thread_name(const std::string &name);
+AllocationReport allocation_report();
+
+// Attributes the allocations made by the current thread while it is alive to `name`, which must be a string
+// literal. Regions nest; allocations go to the innermost one.
+class AllocationRegion {
+public:
+    explicit AllocationRegion(const char *name) noexcept;
+    ~AllocationRegion();
+
+    AllocationRegion(const AllocationRegion &) = delete;
+    AllocationRegion &operator=(const AllocationRegion &) = delete;
+
+private:
+    int previous_;
+};
+
+#else
+
+inline void set_allocation_thread_name(const std::string &) {}
+inline AllocationReport allocation_report()
+{
+    return {};
+}
+
+class AllocationRegion {
+public:
+    explicit AllocationRegion(const char *) noexcept {}
+};
+
+#endif
+
+}  // namespace trdp_sim
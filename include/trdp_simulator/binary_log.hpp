@@ -0,0 +1,187 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "trdp_simulator/logger.hpp"
+
+namespace trdp_sim {
+
+// Static message catalogue of the binary log; the text of each message lives in binary_log_format() so the
+// simulator only stores the arguments. Append new IDs at the end, files keep the numbers they were written with.
+enum class BinaryLogMessage : std::uint16_t {
+    Text = 1,
+    TextContinuation,
+    PdReceived,
+    MdRequestReceived,
+    MdNotificationReceived,
+    MdConfirmReceived,
+    MdReplySent,
+    MdReplyQuerySent,
+    MdReplyReceived,
+    MdReplyQueryReceived,
+    PdSent,
+    PdPullRequested,
+    MdRequestSent,
+    MdNotificationSent,
+    MdConfirmSent,
+};
+
+enum class BinaryLogArgType : std::uint8_t {
+    None = 0,
+    String,  // ID from BinaryLog::intern()
+    Unsigned,
+    Signed
+};
+
+enum class BinaryLogDataFormat : std::uint8_t {
+    None = 0,
+    Hex,
+    Text
+};
+
+struct BinaryLogArg {
+    BinaryLogArgType type;
+    std::uint64_t value;
+
+    static BinaryLogArg string(std::uint32_t id) { return {BinaryLogArgType::String, id}; }
+    static BinaryLogArg unsigned_value(std::uint64_t value) { return {BinaryLogArgType::Unsigned, value}; }
+    static BinaryLogArg signed_value(std::int64_t value)
+    {
+        return {BinaryLogArgType::Signed, static_cast<std::uint64_t>(value)};
+    }
+};
+
+struct BinaryLogData {
+    BinaryLogDataFormat format{BinaryLogDataFormat::None};
+    const void *bytes{nullptr};
+    std::size_t size{0};
+};
+
+constexpr std::size_t BinaryLogMaxArgs = 4;
+constexpr std::size_t BinaryLogRecordData = 64;
+
+struct BinaryLogRecord {
+    std::uint64_t timestampNs;  // CLOCK_MONOTONIC
+    // Record index + 1, stored last; a record whose sequence does not match its slot is torn or overwritten.
+    std::uint32_t sequence;
+    std::uint32_t threadId;
+    std::uint16_t messageId;
+    std::uint8_t level;
+    std::uint8_t argCount;
+    std::uint8_t argTypes[BinaryLogMaxArgs];
+    // Length of the original data; only the first BinaryLogRecordData bytes are kept unless continued.
+    std::uint16_t dataLength;
+    std::uint8_t dataFormat;
+    std::uint8_t reserved[5];
+    std::uint64_t args[BinaryLogMaxArgs];
+    std::uint8_t data[BinaryLogRecordData];
+};
+static_assert(sizeof(BinaryLogRecord) == 128, "binary log records have a fixed layout");
+
+struct BinaryLogHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t recordSize;
+    std::uint64_t recordCapacity;
+    std::uint64_t recordsOffset;
+    std::uint64_t stringTableOffset;
+    std::uint64_t stringTableSize;
+    // CLOCK_REALTIME minus CLOCK_MONOTONIC when the file was created, to render wall-clock times.
+    std::int64_t realtimeOffsetNs;
+    std::atomic<std::uint64_t> nextRecord;
+    std::atomic<std::uint64_t> stringTableUsed;
+};
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "the binary log header is shared through a mapping");
+
+// Preallocated, memory-mapped ring of fixed-size records. Writers claim slots with one atomic increment and
+// fill them in place; once the ring is full the oldest records are overwritten. Strings such as telegram names
+// are interned once into a table in the file header so records only carry their IDs.
+class BinaryLog {
+public:
+    // The string table takes stringTableBytes of the capacity, rounded up to whole pages and at least 64 KiB;
+    // size it with string_entry_size() of every string the run interns.
+    BinaryLog(const std::string &path, std::size_t capacityBytes, std::size_t stringTableBytes = 0);
+    ~BinaryLog();
+
+    BinaryLog(const BinaryLog &) = delete;
+    BinaryLog &operator=(const BinaryLog &) = delete;
+
+    std::uint32_t intern(const std::string &value);
+    static std::size_t string_entry_size(const std::string &value);
+
+    void write(LogLevel level, BinaryLogMessage message, std::initializer_list<BinaryLogArg> args,
+               BinaryLogData data = {});
+    // Free-form line; text longer than one record continues in the records directly following it.
+    void write_text(LogLevel level, const std::string &text);
+
+    const std::string &path() const { return path_; }
+    std::uint64_t records_written() const;
+
+private:
+    BinaryLogRecord &slot(std::uint64_t index);
+
+    std::string path_;
+    int fd_{-1};
+    void *mapping_{nullptr};
+    std::size_t mappingSize_{0};
+    BinaryLogHeader *header_{nullptr};
+    BinaryLogRecord *records_{nullptr};
+    char *strings_{nullptr};
+    std::size_t stringTableSize_{0};
+
+    std::mutex internMutex_;
+    std::unordered_map<std::string, std::uint32_t> interned_;
+};
+
+struct BinaryLogEntry {
+    std::uint64_t index{0};
+    std::int64_t wallTimeNs{0};
+    std::uint32_t threadId{0};
+    LogLevel level{LogLevel::Info};
+    BinaryLogMessage message{BinaryLogMessage::Text};
+    std::vector<BinaryLogArg> args;
+    BinaryLogDataFormat dataFormat{BinaryLogDataFormat::None};
+    std::vector<std::uint8_t> data;
+    bool truncated{false};
+};
+
+// Reads a binary log file back, used by trdp-simulator-logdump. Throws if the file is not a binary log.
+class BinaryLogReader {
+public:
+    explicit BinaryLogReader(const std::string &path);
+
+    const std::vector<std::string> &strings() const { return strings_; }
+    std::uint64_t records_written() const { return nextRecord_; }
+    // Records overwritten by the ring or left incomplete; counted by for_each().
+    std::uint64_t records_lost() const { return recordsLost_; }
+
+    // Visits the surviving records oldest first, with continued text already joined.
+    void for_each(const std::function<void(const BinaryLogEntry &)> &visit);
+    // Renders the catalogue text of the entry with its arguments and data filled in.
+    std::string format(const BinaryLogEntry &entry) const;
+
+private:
+    std::string path_;
+    std::ifstream file_;
+    std::uint64_t recordCapacity_{0};
+    std::uint64_t recordsOffset_{0};
+    std::int64_t realtimeOffsetNs_{0};
+    std::uint64_t nextRecord_{0};
+    std::uint64_t recordsLost_{0};
+    std::vector<std::string> strings_;
+};
+
+const char *binary_log_format(BinaryLogMessage message);
+// Short name of a message for filtering, e.g. "pd-received"; empty past the end of the catalogue.
+std::string binary_log_message_name(BinaryLogMessage message);
+
+}  // namespace trdp_sim
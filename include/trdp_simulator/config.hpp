@@ -9,18 +9,44 @@
 
 namespace trdp_sim {
 
+// One TRDP session of a sharded stack. Empty/zero fields inherit the <network> defaults.
+struct SessionConfig {
+    std::string hostIp;
+    std::uint16_t pdPort{0};
+    std::uint16_t mdPort{0};
+    int cpu{-1};
+};
+
 struct NetworkConfig {
     std::string interfaceName;
     std::string hostIp;
     std::string gatewayIp;
     std::uint16_t vlanId{0};
     std::uint8_t ttl{64};
+    std::uint16_t pdPort{0};
+    std::uint16_t mdPort{0};
+    // Idle TCP connections to an MD peer stay open this long for reuse by later requests.
+    std::uint32_t mdTcpIdleTimeoutMs{60000};
+    // Upper bound on open MD sessions per table; requests beyond it fail instead of growing the table.
+    std::uint32_t mdMaxSessions{1000};
+    std::vector<SessionConfig> sessions;
 };
 
 struct LoggingConfig {
     bool enableConsole{true};
     std::string filePath;
     LogLevel level{LogLevel::Info};
+    // Rotation of the text log; 0 disables the limit. keepFiles bounds the rotated segments kept (0 keeps all).
+    std::uint32_t rotateSizeMb{0};
+    std::uint32_t rotateIntervalMinutes{0};
+    std::uint32_t keepFiles{10};
+    bool compressRotated{true};
+    // Fixed-size binary ring read back with trdp-simulator-logdump; empty disables it.
+    std::string binaryFilePath;
+    std::uint32_t binaryCapacityMb{64};
+    // Per-telegram levels and rate limit for the messages logged about individual telegrams.
+    std::vector<LogOverride> overrides;
+    LogRateLimit rateLimit;
 };
 
 struct PayloadConfig {
@@ -38,32 +64,91 @@ PayloadConfig::Format payload_format_from_string(const std::string &value);
 std::string payload_format_to_string(PayloadConfig::Format format);
 
 struct PdPublisherConfig {
+    enum class Role {
+        Push,
+        PullResponder
+    };
+
+    enum class SendMode {
+        Cyclic,
+        OnChange,
+        Tsn
+    };
+
+    enum class LaunchClock {
+        Tai,
+        Monotonic
+    };
+
     std::string name;
+    std::uint32_t session{0};
     std::uint32_t comId{0};
     std::uint32_t datasetId{0};
-    std::uint16_t etbTopoCount{0};
-    std::uint16_t opTrnTopoCount{0};
+    std::uint32_t etbTopoCount{0};
+    std::uint32_t opTrnTopoCount{0};
     std::string sourceIp;
     std::string destIp;
     std::uint32_t cycleTimeMs{1000};
     std::uint32_t redundancyGroup{0};
     bool useSequenceCounter{false};
+    Role role{Role::Push};
+    SendMode sendMode{SendMode::Cyclic};
+    std::uint32_t minIntervalMs{0};
+    std::uint32_t keepAliveMs{0};
+    LaunchClock launchClock{LaunchClock::Tai};
+    std::uint32_t launchOffsetUs{0};
+    std::uint32_t launchLeadUs{500};
+    std::uint32_t socketPriority{0};
     PayloadConfig payload;
 };
 
+PdPublisherConfig::SendMode pd_send_mode_from_string(const std::string &value);
+std::string pd_send_mode_to_string(PdPublisherConfig::SendMode mode);
+PdPublisherConfig::LaunchClock pd_launch_clock_from_string(const std::string &value);
+std::string pd_launch_clock_to_string(PdPublisherConfig::LaunchClock clock);
+PdPublisherConfig::Role pd_publisher_role_from_string(const std::string &value);
+std::string pd_publisher_role_to_string(PdPublisherConfig::Role role);
+
 struct PdSubscriberConfig {
+    enum class Role {
+        Push,
+        PullRequester
+    };
+
     std::string name;
+    std::uint32_t session{0};
     std::uint32_t comId{0};
-    std::uint16_t etbTopoCount{0};
-    std::uint16_t opTrnTopoCount{0};
+    std::uint32_t etbTopoCount{0};
+    std::uint32_t opTrnTopoCount{0};
     std::string sourceIp;
     std::string destIp;
     std::uint32_t timeoutMs{0};
     bool enableComIdFiltering{true};
+    Role role{Role::Push};
+    std::uint32_t requestComId{0};
+    std::uint32_t pullIntervalMs{0};
+};
+
+PdSubscriberConfig::Role pd_subscriber_role_from_string(const std::string &value);
+std::string pd_subscriber_role_to_string(PdSubscriberConfig::Role role);
+
+enum class MdTransport {
+    Udp,
+    Tcp,
 };
 
+MdTransport md_transport_from_string(const std::string &value);
+std::string md_transport_to_string(MdTransport transport);
+
 struct MdSenderConfig {
+    // Requests (Mr) open a session that collects replies; notifications (Mn) carry no session.
+    enum class Type {
+        Request,
+        Notify,
+    };
+
     std::string name;
+    std::uint32_t session{0};
     std::uint32_t comId{0};
     std::uint32_t replyComId{0};
     std::string sourceIp;
@@ -71,27 +156,76 @@ struct MdSenderConfig {
     std::uint32_t cycleTimeMs{0};
     std::uint32_t replyTimeoutMs{1000};
     bool expectReply{false};
+    MdTransport transport{MdTransport::Udp};
+    Type type{Type::Request};
     PayloadConfig payload;
 };
 
+MdSenderConfig::Type md_sender_type_from_string(const std::string &value);
+std::string md_sender_type_to_string(MdSenderConfig::Type type);
+
 struct MdListenerConfig {
+    // Plain replies (Mp) close the session; reply queries (Mq) keep it open until the caller confirms (Mc).
+    enum class ReplyType {
+        Reply,
+        Query,
+    };
+
     std::string name;
+    std::uint32_t session{0};
     std::uint32_t comId{0};
     std::string sourceIp;
     std::string destIp;
+    MdTransport transport{MdTransport::Udp};
     bool autoReply{false};
+    ReplyType replyType{ReplyType::Reply};
+    std::uint32_t confirmTimeoutMs{1000};
     PayloadConfig replyPayload;
 };
 
+MdListenerConfig::ReplyType md_reply_type_from_string(const std::string &value);
+std::string md_reply_type_to_string(MdListenerConfig::ReplyType type);
+
+struct PdRedundancyGroupConfig {
+    std::uint32_t id{0};
+    bool leader{true};
+    std::uint32_t partnerId{0};
+    std::uint32_t failoverIntervalMs{0};
+};
+
+// Runs every <network> session as its own worker process and aggregates their metrics.
+struct CoordinatorConfig {
+    bool enabled{false};
+    std::string listen{"unix:/tmp/trdp-simulator.sock"};
+    bool launchWorkers{true};
+    std::string workerBinary;
+    std::uint32_t startDelayMs{500};
+    std::uint32_t connectTimeoutMs{10000};
+    std::uint32_t reportIntervalMs{500};
+};
+
+// Checks that the event loop, schedulers and workers wake when they planned to; a thread that has not checked
+// in stallThresholdMs after its planned wake-up is reported together with a snapshot of its stack.
+struct WatchdogConfig {
+    bool enabled{true};
+    std::uint32_t stallThresholdMs{50};
+};
+
 struct SimulatorConfig {
+    std::string sourcePath;
     NetworkConfig network;
+    CoordinatorConfig coordinator;
     LoggingConfig logging;
+    WatchdogConfig watchdog;
     std::vector<PdPublisherConfig> pdPublishers;
+    std::vector<PdRedundancyGroupConfig> pdRedundancyGroups;
     std::vector<PdSubscriberConfig> pdSubscribers;
     std::vector<MdSenderConfig> mdSenders;
     std::vector<MdListenerConfig> mdListeners;
 };
 
 std::vector<std::uint8_t> load_payload(const PayloadConfig &payload);
+// Space-separated hex bytes, as payloads are shown in log messages.
+std::string to_hex(const std::vector<std::uint8_t> &data);
 
 }  // namespace trdp_sim
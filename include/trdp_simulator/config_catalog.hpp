@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace trdp_sim {
+
+// What the catalog knows about one stored configuration without reading it again.
+struct ConfigCatalogEntry {
+    enum class Status { Pending, Valid, Invalid };
+
+    std::string name;
+    std::uintmax_t size{0};
+    std::filesystem::file_time_type modified{};
+    Status status{Status::Pending};
+    // Why the document failed to load, for Invalid entries.
+    std::string error;
+    std::size_t pdPublishers{0};
+    std::size_t pdSubscribers{0};
+    std::size_t mdSenders{0};
+    std::size_t mdListeners{0};
+};
+
+const char *to_string(ConfigCatalogEntry::Status status);
+
+// In-memory index of the *.xml files in a configuration directory. The directory is listed once on
+// construction and the files are parsed on a background thread, which then follows changes through inotify.
+// inotify does not report changes made by other hosts on network file systems, so the thread also rescans
+// every rescanInterval; a rescan only parses files whose size or modification time changed.
+class ConfigCatalog {
+public:
+    explicit ConfigCatalog(std::filesystem::path directory,
+                           std::chrono::milliseconds rescanInterval = std::chrono::seconds(30));
+    ~ConfigCatalog();
+
+    ConfigCatalog(const ConfigCatalog &) = delete;
+    ConfigCatalog &operator=(const ConfigCatalog &) = delete;
+
+    // Entries whose name contains `filter`, ignoring case, sorted by name.
+    std::vector<ConfigCatalogEntry> entries(std::string_view filter = {}) const;
+    std::vector<std::string> names() const;
+    // Indexes one file now. Writers in this process call it so their change is listed before inotify reports it.
+    void refresh(const std::string &name);
+    // False where inotify is unavailable; changes then show after the next rescan.
+    bool watching() const { return inotifyFd_ >= 0; }
+
+private:
+    void run();
+    void rescan();
+    void index(const std::string &name);
+    void handle_events();
+
+    std::filesystem::path directory_;
+    std::chrono::milliseconds rescanInterval_;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, ConfigCatalogEntry> entries_;
+
+    int inotifyFd_{-1};
+    int wakePipe_[2]{-1, -1};
+    std::atomic<bool> stopping_{false};
+    std::thread worker_;
+};
+
+}  // namespace trdp_sim
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace trdp_sim {
+
+// One saved state of a configuration. The document is stored as a list of chunks, each kept once in the
+// object store under its SHA-256, so versions that share most of their text share most of their storage.
+struct ConfigVersion {
+    struct Chunk {
+        std::string hash;
+        std::size_t size{0};
+        std::size_t lines{0};
+    };
+
+    std::uint32_t number{0};
+    // Unix seconds.
+    std::int64_t created{0};
+    std::uintmax_t size{0};
+    // SHA-256 of the whole document.
+    std::string digest;
+    std::string label;
+    std::vector<Chunk> chunks;
+};
+
+// Content-addressed version history of the configuration library, kept in <library>/.history:
+//   objects/<2 hex>/<62 hex>   chunk contents, named by their SHA-256
+//   versions/<name>/<number>   manifest of one version: metadata and its chunk hashes
+// Documents are cut into chunks at line ends chosen from the line's own content, so an edit only changes the
+// chunks around it and the rest of the document keeps deduplicating. Lines longer than a chunk are cut inside.
+// Every file is written under a temporary name and renamed into place.
+class ConfigHistory {
+public:
+    explicit ConfigHistory(std::filesystem::path directory);
+
+    // Adds the document at `path` as the next version of `name`. A document identical to the latest version is
+    // not recorded again unless it carries a label; the latest version is returned instead.
+    ConfigVersion record(const std::string &name, const std::filesystem::path &path, const std::string &label);
+    // Versions of `name`, oldest first.
+    std::vector<ConfigVersion> versions(const std::string &name) const;
+    ConfigVersion version(const std::string &name, std::uint32_t number) const;
+    std::string load(const ConfigVersion &version) const;
+    // Writes a version to `target` atomically.
+    void restore(const ConfigVersion &version, const std::filesystem::path &target) const;
+    // Line diff from one version to another in unified hunk form without context lines. Chunks the versions
+    // share are skipped without being read.
+    std::string diff(const ConfigVersion &from, const ConfigVersion &to) const;
+
+private:
+    std::filesystem::path object_path(const std::string &hash) const;
+    std::filesystem::path versions_directory(const std::string &name) const;
+    std::string read_object(const std::string &hash) const;
+    void write_object(const std::string &hash, const std::string &contents) const;
+
+    std::filesystem::path directory_;
+};
+
+// Writes `contents` to a temporary file next to `target` and renames it over `target`.
+void write_file_atomically(const std::filesystem::path &target, const std::string &contents);
+
+}  // namespace trdp_sim
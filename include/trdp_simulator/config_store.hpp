@@ -1,25 +1,47 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "trdp_simulator/config_catalog.hpp"
+#include "trdp_simulator/config_history.hpp"
+
 namespace trdp_sim {
 
 class ConfigStore {
 public:
     explicit ConfigStore(std::filesystem::path base_directory);
 
+    // Names come from the catalog, which is kept current without listing the directory on every call.
     std::vector<std::string> list() const;
+    const ConfigCatalog &catalog() const { return *catalog_; }
     bool exists(const std::string &name) const;
     std::string load_xml(const std::string &name) const;
-    void save(const std::string &name, const std::string &xml) const;
+    // Saving replaces the stored file atomically and records the document as a new version in the history.
+    ConfigVersion save(const std::string &name, const std::string &xml, const std::string &label = {}) const;
+    // Moves a document already on disk, such as a spooled upload, into the store.
+    ConfigVersion save_file(const std::string &name, const std::filesystem::path &source,
+                            const std::string &label = {}) const;
+    std::vector<ConfigVersion> versions(const std::string &name) const;
+    std::string load_version(const std::string &name, std::uint32_t number) const;
+    std::string diff(const std::string &name, std::uint32_t from, std::uint32_t to) const;
+    // Makes an earlier version current again; the restored document is recorded as the newest version.
+    ConfigVersion restore(const std::string &name, std::uint32_t number) const;
     std::filesystem::path path_for(const std::string &name) const;
+    // Uploads are spooled here, on the same filesystem as the library, so save_file can rename them into place.
+    const std::filesystem::path &spool_directory() const { return spool_directory_; }
 
     static bool is_valid_name(const std::string &name);
 
 private:
+    void require_valid_name(const std::string &name) const;
+
     std::filesystem::path base_directory_;
+    std::filesystem::path spool_directory_;
+    std::unique_ptr<ConfigCatalog> catalog_;
+    std::unique_ptr<ConfigHistory> history_;
 };
 
 }  // namespace trdp_sim
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace trdp_sim {
+
+// HTTP/1.1 request assembled by HttpRequestParser. Bodies up to the parser's memory limit are kept in `body`;
+// larger ones are streamed to `bodyFile`, a temporary file that is removed with the request.
+struct HttpRequest {
+    HttpRequest() = default;
+    ~HttpRequest();
+    HttpRequest(const HttpRequest &) = delete;
+    HttpRequest &operator=(const HttpRequest &) = delete;
+
+    std::string method;
+    std::string target;
+    std::string version;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::uint64_t contentLength{0};
+    std::string body;
+    std::filesystem::path bodyFile;
+
+    // Value of the first header with this name, compared without case; empty if absent.
+    std::string_view header(std::string_view name) const;
+    // Media type of the body without parameters, in lower case, e.g. "application/xml".
+    std::string media_type() const;
+    // Reads a body streamed to a file into `body` and removes the file.
+    void load_body();
+};
+
+// Incremental parser fed with the bytes of one connection as they arrive. The request line and headers are
+// collected in a fixed buffer and split in place; body bytes go straight to memory or to the spool file, so a
+// large upload is held once, on disk, instead of in several copies of the whole request.
+class HttpRequestParser {
+public:
+    enum class State { Headers, Body, Complete, Error };
+
+    static constexpr std::size_t HeaderLimit = 16U * 1024U;
+
+    HttpRequestParser(std::size_t memoryBodyLimit, std::uint64_t maxBodySize, std::filesystem::path spoolDirectory);
+    ~HttpRequestParser();
+
+    HttpRequestParser(const HttpRequestParser &) = delete;
+    HttpRequestParser &operator=(const HttpRequestParser &) = delete;
+
+    // Consumes received bytes and returns the resulting state. Bytes after the end of the request are ignored.
+    State feed(const char *data, std::size_t size);
+    State state() const { return state_; }
+    // HTTP status and reason of a request that could not be parsed.
+    int error_status() const { return errorStatus_; }
+    const std::string &error_message() const { return errorMessage_; }
+
+    HttpRequest &request() { return request_; }
+
+private:
+    State fail(int status, std::string message);
+    State parse_head(std::string_view head);
+    void start_body();
+    void append_body(const char *data, std::size_t size);
+
+    std::size_t memoryBodyLimit_;
+    std::uint64_t maxBodySize_;
+    std::filesystem::path spoolDirectory_;
+
+    State state_{State::Headers};
+    int errorStatus_{0};
+    std::string errorMessage_;
+    std::array<char, HeaderLimit> head_{};
+    std::size_t headSize_{0};
+    std::uint64_t bodyReceived_{0};
+    int bodyFd_{-1};
+    HttpRequest request_;
+};
+
+}  // namespace trdp_sim
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+#include "trdp_simulator/config.hpp"
+
+namespace trdp_sim {
+
+// Launch times are nanoseconds on the clock the kernel qdisc expects: CLOCK_TAI for etf, CLOCK_MONOTONIC for fq.
+int launch_clock_id(PdPublisherConfig::LaunchClock clock);
+std::int64_t launch_clock_now_ns(PdPublisherConfig::LaunchClock clock);
+void launch_clock_sleep_until(PdPublisherConfig::LaunchClock clock, std::int64_t deadlineNs);
+
+// Launch times sit on a cycle grid of the launch clock, shifted by the offset, so publishers sharing a clock keep
+// their relative phase. The first launch is the next grid point after `nowNs`.
+std::int64_t first_launch_ns(std::int64_t nowNs, std::int64_t cycleNs, std::int64_t offsetNs);
+// Advances to the next launch; grid points whose handoff window (launch minus lead) has already passed at `nowNs`
+// are skipped rather than sent in a burst.
+std::int64_t next_launch_ns(std::int64_t launchNs, std::int64_t nowNs, std::int64_t cycleNs, std::int64_t leadNs);
+
+// Converts a launch time to CLOCK_REALTIME, the clock kernel software timestamps are reported in.
+std::int64_t launch_clock_to_realtime_ns(PdPublisherConfig::LaunchClock clock, std::int64_t launchNs);
+
+}  // namespace trdp_sim
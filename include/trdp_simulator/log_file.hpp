@@ -0,0 +1,87 @@
+#pragma once
+
+#include <chrono>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "trdp_simulator/config.hpp"
+
+namespace trdp_sim {
+
+// Text log file that rotates by size and age. A full segment is renamed to <stem>.<yyyymmdd-hhmmss><ext> and
+// a new file opened in its place by a background thread running at the lowest priority, which then compresses
+// the segment and prunes old ones. The writer keeps appending to the renamed segment until the new file is
+// ready and only swaps the streams, so rotation never blocks the logger on the file system.
+class RotatingLogFile {
+public:
+    using ErrorHandler = std::function<void(const std::string &)>;
+
+    RotatingLogFile(const LoggingConfig &config, ErrorHandler onError);
+    ~RotatingLogFile();
+
+    RotatingLogFile(const RotatingLogFile &) = delete;
+    RotatingLogFile &operator=(const RotatingLogFile &) = delete;
+
+    // Callers serialise writes; the logger holds its mutex.
+    void write(const std::string &line);
+
+    const std::filesystem::path &path() const { return path_; }
+    // Rotated segments of this log, oldest first.
+    std::vector<std::filesystem::path> rotated_segments() const;
+
+private:
+    // Work for the background thread: rotate the file, or close and compress a segment the writer has left.
+    struct Job {
+        enum class Kind { Rotate, Retire };
+
+        Kind kind{Kind::Rotate};
+        std::filesystem::path segment;
+        std::ofstream stream;
+    };
+
+    void open();
+    void switch_stream();
+    void rotate();
+    void retire(Job &job);
+    void submit(Job job);
+    void run();
+    void compress(const std::filesystem::path &segment);
+    void prune();
+
+    std::filesystem::path path_;
+    std::uint64_t rotateBytes_;
+    std::chrono::minutes rotateInterval_;
+    std::uint32_t keepFiles_;
+    bool compress_;
+    ErrorHandler onError_;
+
+    std::ofstream stream_;
+    std::uint64_t bytesWritten_{0};
+    std::chrono::steady_clock::time_point openedAt_;
+    bool rotationPending_{false};
+
+    // Result of a rotation, picked up by the writer with its next line; the stream is closed when the rename or
+    // the reopen failed.
+    std::mutex handoffMutex_;
+    std::atomic<bool> handoffReady_{false};
+    std::ofstream nextStream_;
+    std::filesystem::path nextSegment_;
+    std::uint64_t nextBytes_{0};
+
+    std::mutex jobsMutex_;
+    std::condition_variable jobsCv_;
+    std::deque<Job> jobs_;
+    bool stopping_{false};
+    std::thread worker_;
+};
+
+}  // namespace trdp_sim
@@ -1,15 +1,21 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <mutex>
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace trdp_sim {
 
+class BinaryLog;
+class RotatingLogFile;
+
 enum class LogLevel {
     Error = 0,
     Warn,
@@ -17,13 +23,71 @@ enum class LogLevel {
     Debug
 };
 
+// Level for the messages of matching telegrams, selected by name, by ComID (non-zero) or by category
+// ("pd" for PD publishers and subscribers, "md" for MD senders and listeners). Name beats ComID beats category.
+// Sends are logged at debug level, receptions at info.
+struct LogOverride {
+    std::string name;
+    std::uint32_t comId{0};
+    std::string category;
+    LogLevel level{LogLevel::Info};
+};
+
+// Token bucket applied to the messages of each telegram; 0 messages per second disables it.
+struct LogRateLimit {
+    std::uint32_t messagesPerSecond{0};
+    std::uint32_t burst{0};
+};
+
+class Logger;
+
+// Log settings of one telegram, resolved when the telegram is registered so handlers test one bit per message.
+class LogChannel {
+public:
+    bool enabled(LogLevel level) const { return (levelMask_ & (1U << static_cast<unsigned>(level))) != 0U; }
+    // Takes a token for a message about to be logged. Returns false while the telegram is over its rate; the
+    // next admitted message is preceded by a count of the ones dropped.
+    bool admit(LogLevel level);
+    // Writes a message this channel has enabled, even when the logger level alone would drop it.
+    void log(LogLevel level, const std::string &message);
+
+private:
+    friend class Logger;
+
+    void report_suppressed(LogLevel level, std::uint64_t count);
+
+    Logger *logger_{nullptr};
+    std::string name_;
+    std::uint8_t levelMask_{0};
+
+    double ratePerSecond_{0.0};
+    double capacity_{0.0};
+    std::mutex bucketMutex_;
+    double tokens_{0.0};
+    std::chrono::steady_clock::time_point refilledAt_{};
+    std::uint64_t suppressed_{0};
+    // Most severe level among the suppressed messages; the summary is logged at this level.
+    LogLevel suppressedLevel_{LogLevel::Debug};
+};
+
 class Logger {
 public:
     explicit Logger(LogLevel level = LogLevel::Info);
 
     void set_level(LogLevel level);
     void enable_console(bool enable);
-    void set_file(std::ostream *stream);
+    void set_file(RotatingLogFile *file);
+    // Every line is also written to the binary log; per-telegram messages go there alone (see binary_log()).
+    void set_binary_log(BinaryLog *log);
+    BinaryLog *binary_log() const { return binaryLog_; }
+    // Lets hot paths skip formatting messages that would be dropped.
+    bool enabled(LogLevel level) const { return level <= level_; }
+
+    // Set before channels are created; channels keep the settings they were created with.
+    void set_overrides(std::vector<LogOverride> overrides, LogRateLimit rateLimit);
+    LogChannel &channel(const std::string &category, const std::string &name, std::uint32_t comId);
+    // Logs the messages still held back by the rate limit, e.g. when the simulator stops.
+    void report_suppressed();
 
     void error(const std::string &message);
     void warn(const std::string &message);
@@ -31,12 +95,22 @@ public:
     void debug(const std::string &message);
 
 private:
+    friend class LogChannel;
+
     void log(LogLevel level, const std::string &message);
+    void write(LogLevel level, const std::string &message);
 
     LogLevel level_;
     bool consoleEnabled_;
-    std::ostream *fileStream_;
+    RotatingLogFile *file_;
+    BinaryLog *binaryLog_;
     std::mutex mutex_;
+
+    std::vector<LogOverride> overrides_;
+    LogRateLimit rateLimit_;
+    std::mutex channelsMutex_;
+    // Keyed by category and name; map nodes keep the channels that handlers point to in place.
+    std::map<std::string, LogChannel> channels_;
 };
 
 std::string log_level_to_string(LogLevel level);
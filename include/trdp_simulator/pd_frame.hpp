@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "trdp_simulator/config.hpp"
+
+namespace trdp_sim {
+
+constexpr std::size_t PdFrameHeaderSize = 40U;
+
+// Builds a PD frame the same way the stack does: big-endian header, little-endian header FCS, 4-byte padded data.
+void build_pd_frame(std::vector<std::uint8_t> &frame,
+                    const PdPublisherConfig &config,
+                    std::uint32_t sequence,
+                    const std::vector<std::uint8_t> &data);
+
+// The IEC 61375-2-3 frame check sequence (CRC-32 as used by Ethernet).
+std::uint32_t pd_frame_fcs(const std::uint8_t *data, std::size_t size);
+
+}  // namespace trdp_sim
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "trdp_simulator/config.hpp"
+#include "trdp_simulator/logger.hpp"
+#include "trdp_simulator/runtime_metrics.hpp"
+#include "trdp_simulator/stall_detector.hpp"
+#include "trdp_simulator/trdp_stack_adapter.hpp"
+
+namespace trdp_sim {
+
+// Owns the leader/follower state of PD redundancy groups and measures the receive gap around switchovers.
+class PdRedundancyManager {
+public:
+    PdRedundancyManager(const SimulatorConfig &config, TrdpStackAdapter &adapter, Logger &logger,
+                        RuntimeMetrics &metrics,
+                        std::pmr::memory_resource *resource = std::pmr::get_default_resource(),
+                        StallDetector *stallDetector = nullptr);
+    ~PdRedundancyManager();
+
+    void apply_initial_state();
+    void start();
+    void stop();
+
+    bool failover(std::uint32_t groupId, std::string &error_message);
+    void on_receive(const std::string &subscriberName, std::uint32_t comId);
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct Group {
+        PdRedundancyGroupConfig config;
+        bool leader{true};
+        std::uint32_t cycleTimeMs{0};
+        std::uint64_t generation{0};
+    };
+
+    struct SubscriberTrack {
+        clock::time_point lastReceive{};
+        std::uint64_t seenGeneration{0};
+        bool valid{false};
+    };
+
+    void run();
+
+    TrdpStackAdapter &adapter_;
+    Logger &logger_;
+    RuntimeMetrics &metrics_;
+    StallDetector *stallDetector_;
+
+    std::pmr::map<std::uint32_t, Group> groups_;
+    std::pmr::unordered_map<std::uint32_t, std::uint32_t> comIdGroups_;
+    std::pmr::unordered_map<std::string, SubscriberTrack> tracks_;
+    std::mutex mutex_;
+
+    std::atomic<bool> running_{false};
+    std::thread schedulerThread_;
+    std::mutex scheduleMutex_;
+    std::condition_variable scheduleCv_;
+};
+
+}  // namespace trdp_sim
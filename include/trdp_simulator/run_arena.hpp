@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace trdp_sim {
+
+// Memory resource for the state of one simulator run. Everything allocated from it is returned to the system
+// when the arena is destroyed, and allocations are counted per run phase.
+class RunArena final : public std::pmr::memory_resource {
+public:
+    enum class Phase {
+        Setup,
+        Running,
+        Shutdown,
+    };
+    static constexpr std::size_t PhaseCount = 3U;
+
+    struct PhaseStats {
+        std::uint64_t allocations{0};
+        std::uint64_t bytes{0};
+    };
+
+    RunArena() = default;
+    RunArena(const RunArena &) = delete;
+    RunArena &operator=(const RunArena &) = delete;
+
+    void set_phase(Phase phase) { phase_.store(phase); }
+    Phase phase() const { return phase_.load(); }
+
+    PhaseStats phase_stats(Phase phase) const;
+    std::uint64_t bytes_in_use() const { return bytesInUse_.load(); }
+    std::uint64_t peak_bytes() const { return peakBytes_.load(); }
+
+    static const char *phase_name(Phase phase);
+
+private:
+    struct Counters {
+        std::atomic<std::uint64_t> allocations{0};
+        std::atomic<std::uint64_t> bytes{0};
+    };
+
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *pointer, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+    // Pools keep small nodes of the same size together instead of scattering them across the global heap.
+    std::pmr::synchronized_pool_resource pool_;
+    std::atomic<Phase> phase_{Phase::Setup};
+    std::array<Counters, PhaseCount> counters_;
+    std::atomic<std::uint64_t> bytesInUse_{0};
+    std::atomic<std::uint64_t> peakBytes_{0};
+};
+
+}  // namespace trdp_sim
@@ -1,35 +1,139 @@
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <cstdint>
 #include <map>
+#include <memory_resource>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace trdp_sim {
 
+class LatencyHistogram {
+public:
+    // Bucket i holds samples in [2^(i-1), 2^i) microseconds; bucket 0 holds samples below 1us.
+    static constexpr std::size_t BucketCount = 32U;
+
+    void record(std::int64_t microseconds);
+
+    std::uint64_t count() const { return count_; }
+    std::int64_t sum_us() const { return sumUs_; }
+    std::int64_t min_us() const { return count_ == 0 ? 0 : minUs_; }
+    std::int64_t max_us() const { return maxUs_; }
+    const std::array<std::uint64_t, BucketCount> &buckets() const { return buckets_; }
+
+    static std::int64_t bucket_upper_bound_us(std::size_t index);
+    std::int64_t percentile_us(double percentile) const;
+
+    void merge(const LatencyHistogram &other);
+    static LatencyHistogram from_parts(const std::array<std::uint64_t, BucketCount> &buckets,
+                                       std::uint64_t count,
+                                       std::int64_t sumUs,
+                                       std::int64_t minUs,
+                                       std::int64_t maxUs);
+
+private:
+    std::array<std::uint64_t, BucketCount> buckets_{};
+    std::uint64_t count_{0};
+    std::int64_t sumUs_{0};
+    std::int64_t minUs_{0};
+    std::int64_t maxUs_{0};
+};
+
 class RuntimeMetrics {
 public:
     struct PdPublisherStats {
         std::string name;
         std::uint64_t packetsSent{0};
+        std::uint64_t onChangeSends{0};
+        std::uint64_t keepAliveSends{0};
+        std::int64_t latencySavedUs{0};
+        std::uint64_t tsnLateHandoffs{0};
+        std::uint64_t tsnMissedLaunches{0};
+        LatencyHistogram tsnLaunchError;
     };
 
     struct PdSubscriberStats {
         std::string name;
         std::uint64_t packetsReceived{0};
+        std::uint64_t pullRequestsSent{0};
+        std::uint64_t pullRepliesReceived{0};
+        // Pull requests still unanswered when the next one was sent.
+        std::uint64_t pullRequestsLost{0};
+        LatencyHistogram pullLatency;
+        std::uint64_t switchoversOverCycle{0};
+        LatencyHistogram switchoverGap;
+    };
+
+    struct PdRedundancyGroupStats {
+        std::uint32_t id{0};
+        bool leader{false};
+        std::uint64_t failovers{0};
+    };
+
+    struct TopologyStats {
+        std::uint32_t etbTopoCount{0};
+        std::uint32_t opTrnTopoCount{0};
+        std::uint64_t updates{0};
+        std::uint64_t telegramsUpdated{0};
+        std::uint64_t staleOverCycle{0};
+        LatencyHistogram staleWindow;
     };
 
     struct MdSenderStats {
         std::string name;
         std::uint64_t requestsSent{0};
         std::uint64_t repliesReceived{0};
+        std::uint64_t notificationsSent{0};
+        std::uint64_t replyQueriesReceived{0};
+        std::uint64_t confirmsSent{0};
+        std::uint64_t replyTimeouts{0};
+    };
+
+    // TCP message data per peer; exchanges beyond the connections opened reused a pooled connection.
+    struct MdTcpPeerStats {
+        std::string peer;
+        std::uint64_t exchanges{0};
+        std::uint64_t connects{0};
+        std::uint64_t openConnections{0};
     };
 
     struct MdListenerStats {
         std::string name;
         std::uint64_t requestsReceived{0};
         std::uint64_t repliesSent{0};
+        std::uint64_t notificationsReceived{0};
+        std::uint64_t replyQueriesSent{0};
+        std::uint64_t confirmsReceived{0};
+    };
+
+    // Occupancy of the stack's MD session tables: callers wait for replies, repliers for the application's
+    // reply or the caller's confirmation.
+    struct MdSessionStats {
+        std::uint64_t callerOpen{0};
+        std::uint64_t callerPeak{0};
+        std::uint64_t callerTimeouts{0};
+        std::uint64_t replierOpen{0};
+        std::uint64_t replierPeak{0};
+        std::uint64_t replierTimeouts{0};
+    };
+
+    // Lag between the planned and the actual wake-up of a poll thread, scheduler or worker.
+    struct LoopStats {
+        std::string name;
+        LatencyHistogram lag;
+        std::uint64_t stalls{0};
+        std::string lastStallTrace;
+    };
+
+    struct ArenaPhaseStats {
+        std::uint64_t allocations{0};
+        std::uint64_t bytes{0};
     };
 
     struct Snapshot {
@@ -38,32 +142,87 @@ public:
         std::string adapterState{"Idle"};
         std::vector<PdPublisherStats> pdPublishers;
         std::vector<PdSubscriberStats> pdSubscribers;
+        std::vector<PdRedundancyGroupStats> pdRedundancyGroups;
+        TopologyStats topology;
         std::vector<MdSenderStats> mdSenders;
         std::vector<MdListenerStats> mdListeners;
+        std::vector<MdTcpPeerStats> mdTcpPeers;
+        MdSessionStats mdSessions;
+        std::vector<LoopStats> loops;
+        // Time the simulator has been running, used to turn counters into rates.
+        std::int64_t uptimeMs{0};
+        // Allocations served by the run arena in each phase (setup, running, shutdown) and its current footprint.
+        std::array<ArenaPhaseStats, 3> arenaPhases{};
+        std::uint64_t arenaBytesInUse{0};
+        std::uint64_t arenaPeakBytes{0};
     };
 
+    // Per-telegram state is allocated from `resource`, which the simulator points at its run arena.
+    explicit RuntimeMetrics(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
     void reset();
     void set_simulator_running(bool running);
     void set_adapter_status(bool initialized, std::string state);
 
     void record_pd_publish(const std::string &name);
+    void record_pd_on_change_publish(const std::string &name, std::int64_t latencySavedUs);
+    void record_pd_keep_alive_publish(const std::string &name);
+    void record_pd_tsn_launch(const std::string &name, bool lateHandoff);
+    void record_pd_tsn_launch_report(const std::string &name, std::int64_t errorNs, bool missed);
     void record_pd_receive(const std::string &name);
+    void record_pd_pull_request(const std::string &name, bool previousLost);
+    void record_pd_pull_reply(const std::string &name, std::int64_t latencyUs);
+    void record_pd_switchover_gap(const std::string &name, std::int64_t gapUs, bool withinCycle);
+    void record_pd_redundancy_state(std::uint32_t groupId, bool leader, bool failover);
+    void record_topology_update(std::uint32_t etbTopoCount, std::uint32_t opTrnTopoCount, std::size_t telegramsUpdated);
+    // Time from a counter change to the first publish of a re-addressed telegram that carries the new counters.
+    void record_topology_stale_window(std::int64_t staleWindowUs, bool withinCycle);
     void record_md_request_sent(const std::string &name);
     void record_md_reply_received(const std::string &name);
+    void record_md_notification_sent(const std::string &name);
+    void record_md_reply_query_received(const std::string &name);
+    void record_md_confirm_sent(const std::string &name);
+    void record_md_reply_timeout(const std::string &name);
+    void record_md_tcp_exchange(const std::string &peer);
+    void record_md_tcp_connection(const std::string &peer, bool opened);
     void record_md_request_received(const std::string &name);
     void record_md_reply_sent(const std::string &name);
+    void record_md_notification_received(const std::string &name);
+    void record_md_reply_query_sent(const std::string &name);
+    void record_md_confirm_received(const std::string &name);
+    void record_md_session_opened(bool caller);
+    void record_md_session_closed(bool caller, bool timedOut);
+    void record_loop_lag(const std::string &name, std::int64_t lagUs);
+    void record_loop_stall(const std::string &name, const std::string &trace);
 
     Snapshot snapshot() const;
 
+    // Snapshots travel between coordinator and worker processes in this compact text encoding.
+    static std::string encode_snapshot(const Snapshot &snapshot);
+    static Snapshot decode_snapshot(const std::string &encoded);
+    // Folds the snapshot of another shard into `into`; telegram names are unique across shards.
+    static void merge_snapshot(Snapshot &into, const Snapshot &from);
+
 private:
+    struct NameLess {
+        using is_transparent = void;
+        bool operator()(std::string_view lhs, std::string_view rhs) const { return lhs < rhs; }
+    };
+
+    // Keys live in the resource; the name inside each entry is only filled in when a snapshot is taken.
+    template <typename Stats>
+    using NamedStatsMap = std::pmr::map<std::pmr::string, Stats, NameLess>;
+
     template <typename StatsMap>
     static typename StatsMap::mapped_type &ensure_entry(StatsMap &map, const std::string &name)
     {
-        auto &entry = map[name];
-        if (entry.name.empty()) {
-            entry.name = name;
+        auto it = map.find(name);
+        if (it == map.end()) {
+            it = map.emplace(std::piecewise_construct, std::forward_as_tuple(std::string_view(name)),
+                             std::forward_as_tuple())
+                     .first;
         }
-        return entry;
+        return it->second;
     }
 
     template <typename StatsMap>
@@ -79,12 +238,19 @@ private:
 
     mutable std::mutex mutex_;
     bool simulatorRunning_{false};
+    std::chrono::steady_clock::time_point startedAt_{};
+    std::chrono::steady_clock::time_point stoppedAt_{};
     bool adapterInitialized_{false};
     std::string adapterState_{"Idle"};
-    std::map<std::string, PdPublisherStats> pdPublishers_;
-    std::map<std::string, PdSubscriberStats> pdSubscribers_;
-    std::map<std::string, MdSenderStats> mdSenders_;
-    std::map<std::string, MdListenerStats> mdListeners_;
+    NamedStatsMap<PdPublisherStats> pdPublishers_;
+    NamedStatsMap<PdSubscriberStats> pdSubscribers_;
+    std::pmr::map<std::uint32_t, PdRedundancyGroupStats> pdRedundancyGroups_;
+    TopologyStats topology_;
+    NamedStatsMap<MdSenderStats> mdSenders_;
+    NamedStatsMap<MdListenerStats> mdListeners_;
+    NamedStatsMap<MdTcpPeerStats> mdTcpPeers_;
+    MdSessionStats mdSessions_;
+    NamedStatsMap<LoopStats> loops_;
 };
 
 }  // namespace trdp_sim
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "trdp_simulator/config.hpp"
+#include "trdp_simulator/logger.hpp"
+#include "trdp_simulator/runtime_metrics.hpp"
+
+namespace trdp_sim {
+
+// A coordinated scenario runs one worker process per <network> session.
+std::size_t shard_count(const SimulatorConfig &config);
+// Returns the single-session configuration run by worker `shard` (1-based), using the same ComID partitioning as
+// the in-process sharded adapter.
+SimulatorConfig shard_configuration(const SimulatorConfig &config, std::size_t shard);
+
+// Launches or accepts the worker processes of a scenario over a unix: or tcp: endpoint, releases them at a common
+// start time and keeps the latest metrics of each one.
+class ShardCoordinator {
+public:
+    ShardCoordinator(const SimulatorConfig &config, Logger &logger);
+    ~ShardCoordinator();
+
+    // Returns once every shard has connected and been sent the start time.
+    void start();
+    void stop();
+
+    RuntimeMetrics::Snapshot metrics_snapshot() const;
+
+private:
+    struct Connection {
+        int fd{-1};
+        std::string buffer;
+    };
+
+    struct Shard {
+        Connection connection;
+        pid_t pid{-1};
+        bool connected{false};
+        bool haveSnapshot{false};
+        RuntimeMetrics::Snapshot snapshot;
+    };
+
+    void launch_worker(std::size_t index);
+    void run();
+    void poll_once(int timeoutMs);
+    bool handle_pending(Connection &connection);
+    bool handle_shard(std::size_t index);
+    void disconnect(std::size_t index, const std::string &reason);
+    void reap_workers(bool block);
+
+    SimulatorConfig config_;
+    Logger &logger_;
+
+    int listenFd_{-1};
+    std::int64_t startTimeNs_{0};
+    std::vector<Connection> pending_;
+    std::vector<Shard> shards_;
+    bool stopping_{false};
+    std::atomic<bool> running_{false};
+    std::thread ioThread_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+// The worker side of a coordinated scenario.
+class ShardWorkerLink {
+public:
+    ShardWorkerLink(const std::string &endpoint, std::size_t shard, std::size_t shardCount, std::uint32_t connectTimeoutMs);
+    ~ShardWorkerLink();
+
+    // Blocks until the coordinator has released every shard, then sleeps until the common start time.
+    void wait_for_start();
+    // Reports metrics every interval; onStop runs when the coordinator asks to stop or goes away.
+    void start_reporting(std::function<RuntimeMetrics::Snapshot()> snapshot,
+                         std::uint32_t intervalMs,
+                         std::function<void()> onStop);
+    // Sends a final report and disconnects.
+    void stop();
+
+private:
+    void run();
+
+    int fd_{-1};
+    std::string buffer_;
+    std::function<RuntimeMetrics::Snapshot()> snapshot_;
+    std::function<void()> onStop_;
+    std::uint32_t intervalMs_{500};
+    std::atomic<bool> running_{false};
+    std::thread reportThread_;
+    std::mutex sendMutex_;
+};
+
+}  // namespace trdp_sim
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "trdp_simulator/trdp_stack_adapter.hpp"
+
+namespace trdp_sim {
+
+// Spreads telegrams over several independent stack sessions so each one can be processed on its own core.
+// Telegrams go to their configured session (1-based) or, when unassigned, to a session chosen by ComID hash.
+class ShardedTrdpStackAdapter final : public TrdpStackAdapter {
+public:
+    using Factory = std::function<std::unique_ptr<TrdpStackAdapter>()>;
+
+    ShardedTrdpStackAdapter(std::size_t sessionCount, Factory factory);
+    ~ShardedTrdpStackAdapter() override;
+
+    static std::size_t shard_for(std::uint32_t session, std::uint32_t comId, std::size_t sessionCount);
+
+    void initialize(const NetworkConfig &networkConfig, const LoggingConfig &loggingConfig) override;
+    void shutdown() override;
+
+    void register_pd_publisher(const PdPublisherConfig &config) override;
+    void register_pd_subscriber(const PdSubscriberConfig &config, PdHandler handler) override;
+    void publish_pd(const std::string &publisherName, const std::vector<std::uint8_t> &data) override;
+    void publish_pd_immediate(const std::string &publisherName, const std::vector<std::uint8_t> &data) override;
+    void publish_pd_at(const std::string &publisherName,
+                       const std::vector<std::uint8_t> &data,
+                       std::int64_t launchTimeNs) override;
+    void set_pd_launch_handler(PdLaunchHandler handler) override;
+    void request_pd(const std::string &subscriberName) override;
+    void set_pd_redundancy(const std::vector<PdRedundancyState> &states) override;
+    bool pd_redundancy_leader(std::uint32_t groupId) override;
+    TopologyUpdateResult set_topology(std::uint32_t etbTopoCount, std::uint32_t opTrnTopoCount) override;
+
+    void register_md_sender(const MdSenderConfig &config, MdHandler replyHandler,
+                            MdTimeoutHandler timeoutHandler) override;
+    void send_md_request(const std::string &senderName, const std::vector<std::uint8_t> &data) override;
+    void send_md_confirm(const std::string &senderName, const MdMessage &replyQuery) override;
+    void set_md_connection_handler(MdConnectionHandler handler) override;
+    void set_md_session_handler(MdSessionHandler handler) override;
+
+    void register_md_listener(const MdListenerConfig &config, MdHandler requestHandler) override;
+    void send_md_reply(const std::string &listenerName, const MdMessage &request, const std::vector<std::uint8_t> &data) override;
+
+    std::unique_ptr<PdPublisherWorker> create_pd_publisher_worker(const PdPublisherConfig &config,
+                                                                  Logger &logger,
+                                                                  RuntimeMetrics &metrics) override;
+    std::unique_ptr<MdSenderWorker> create_md_sender_worker(const MdSenderConfig &config,
+                                                            Logger &logger,
+                                                            RuntimeMetrics &metrics) override;
+
+    void poll(std::chrono::milliseconds timeout) override;
+    std::size_t poll_partitions() const override;
+    void poll_partition(std::size_t partition, std::chrono::milliseconds timeout) override;
+
+private:
+    using ShardMap = std::unordered_map<std::string, std::size_t>;
+
+    std::size_t assign(ShardMap &shards, const std::string &name, std::uint32_t session, std::uint32_t comId);
+    std::size_t assign_pd_publisher(const PdPublisherConfig &config);
+    TrdpStackAdapter &route(const ShardMap &shards, const std::string &name, const char *kind) const;
+
+    std::vector<std::unique_ptr<TrdpStackAdapter>> shards_;
+    std::size_t initialized_{0};
+    ShardMap pdPublisherShards_;
+    ShardMap pdSubscriberShards_;
+    ShardMap mdSenderShards_;
+    ShardMap mdListenerShards_;
+    // Sessions holding a publisher of each redundancy group; partner groups may be split across sessions.
+    std::unordered_map<std::uint32_t, std::set<std::size_t>> redundancyGroupShards_;
+};
+
+}  // namespace trdp_sim
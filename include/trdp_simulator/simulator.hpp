@@ -3,19 +3,27 @@
 #include <atomic>
 #include <condition_variable>
 #include <fstream>
+#include <functional>
 #include <memory>
 #include <thread>
 #include <vector>
 
 #include "trdp_simulator/config.hpp"
 #include "trdp_simulator/logger.hpp"
+#include "trdp_simulator/run_arena.hpp"
 #include "trdp_simulator/runtime_metrics.hpp"
+#include "trdp_simulator/shard_coordinator.hpp"
 #include "trdp_simulator/trdp_stack_adapter.hpp"
 
 namespace trdp_sim {
 
 class PdPublisherWorker;
+class PdPullScheduler;
+class PdRedundancyManager;
 class MdSenderWorker;
+class StallDetector;
+class BinaryLog;
+class RotatingLogFile;
 
 class Simulator {
 public:
@@ -35,25 +43,42 @@ public:
                         PayloadConfig::Format format,
                         const std::string &value,
                         std::string &error_message);
+    bool trigger_pd_failover(std::uint32_t group_id, std::string &error_message);
+    bool set_topology(std::uint32_t etb_topo_count, std::uint32_t op_trn_topo_count, std::string &error_message);
+    // Runs once the stack is initialised and every telegram is registered, right before traffic starts; a worker
+    // shard blocks here until the coordinator releases it.
+    void set_start_gate(std::function<void()> gate);
 
 private:
     void setup_logging();
     void setup_pd_workers();
     void setup_md_workers();
     void start_event_loop();
+    void run_coordinator();
+    void log_arena_report();
 
+    // Per-run state is allocated here and handed back in one piece when the simulator is destroyed,
+    // so repeated runs in the web process do not fragment the global heap. Declared first to outlive its users.
+    RunArena arena_;
     SimulatorConfig config_;
     std::unique_ptr<TrdpStackAdapter> adapter_;
     Logger logger_;
-    std::unique_ptr<std::ofstream> logFile_;
+    std::unique_ptr<RotatingLogFile> logFile_;
+    std::unique_ptr<BinaryLog> binaryLog_;
 
     std::shared_ptr<RuntimeMetrics> metrics_;
+    // Set when this process coordinates worker processes instead of driving a stack itself.
+    std::unique_ptr<ShardCoordinator> coordinator_;
+    std::function<void()> startGate_;
 
     std::vector<std::unique_ptr<PdPublisherWorker>> pdWorkers_;
+    std::unique_ptr<PdPullScheduler> pdPullScheduler_;
+    std::unique_ptr<PdRedundancyManager> pdRedundancy_;
     std::vector<std::unique_ptr<MdSenderWorker>> mdWorkers_;
+    std::unique_ptr<StallDetector> stallDetector_;
 
     std::atomic<bool> running_{false};
-    std::thread eventThread_;
+    std::vector<std::thread> eventThreads_;
     mutable std::mutex stateMutex_;
     std::condition_variable stateCv_;
     bool cleanedUp_{false};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "trdp_simulator/config.hpp"
+#include "trdp_simulator/logger.hpp"
+#include "trdp_simulator/runtime_metrics.hpp"
+
+namespace trdp_sim {
+
+// Check-in point of one loop thread. The loop announces when it expects to wake next and reports when it did;
+// the difference is its lag. Probes that are not attached to a detector ignore every call.
+class LoopProbe {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void sleeping_until(Clock::time_point expectedWake);
+    // Blocks on an event without a deadline, e.g. a payload change; no lag is measured for that wait.
+    void waiting();
+    void woke();
+
+private:
+    friend class StallDetector;
+
+    static constexpr std::int64_t Never = std::numeric_limits<std::int64_t>::max();
+    static constexpr std::size_t MaxFrames = 48U;
+
+    std::string name_;
+    RuntimeMetrics *metrics_{nullptr};
+    std::int64_t thresholdNs_{0};
+    std::thread::native_handle_type thread_{};
+    std::atomic<bool> attached_{false};
+    std::atomic<std::int64_t> expectedNs_{Never};
+    // The watchdog reports the thread once it has not checked in by this time.
+    std::atomic<std::int64_t> deadlineNs_{Never};
+    // Watchdog-only: the deadline last reported, so one stall is captured once.
+    std::int64_t reportedDeadlineNs_{Never};
+
+    // Filled by the thread itself from the capture signal handler.
+    std::array<void *, MaxFrames> frames_{};
+    std::atomic<int> frameCount_{-1};
+};
+
+// Watchdog thread over the probes of the poll threads, schedulers and workers. A thread that misses its
+// check-in deadline is interrupted once to record its stack, so the trace shows where it is stuck.
+class StallDetector {
+public:
+    StallDetector(const WatchdogConfig &config, Logger &logger, RuntimeMetrics &metrics);
+    ~StallDetector();
+
+    StallDetector(const StallDetector &) = delete;
+    StallDetector &operator=(const StallDetector &) = delete;
+
+    void start();
+    void stop();
+
+    // Binds a probe to the calling thread; a loop restarted under the same name gets its probe back.
+    LoopProbe &attach(const std::string &name);
+    void detach(LoopProbe &probe);
+
+    // Shared probe for loops that run without a detector.
+    static LoopProbe &detached();
+
+private:
+    void run();
+    void capture(LoopProbe &probe, std::int64_t overdueNs);
+    static void record_stack(int signal);
+
+    WatchdogConfig config_;
+    Logger &logger_;
+    RuntimeMetrics &metrics_;
+
+    std::mutex probesMutex_;
+    std::vector<std::unique_ptr<LoopProbe>> probes_;
+
+    std::atomic<bool> running_{false};
+    std::thread watchdogThread_;
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCv_;
+};
+
+}  // namespace trdp_sim
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trdp_sim {
+
+// Names the calling thread by role (and telegram) for the kernel, the thread monitor and the allocation
+// tracker. The kernel keeps the first 15 characters; the monitor reports the full name.
+void set_thread_name(const std::string &name);
+
+struct ThreadUsage {
+    int tid{0};
+    std::string name;
+    // Rates cover the last sampling interval; the totals cover the lifetime of the thread.
+    double cpuPercent{0.0};
+    std::uint64_t cpuTimeMs{0};
+    std::uint64_t voluntarySwitches{0};
+    std::uint64_t involuntarySwitches{0};
+    double voluntarySwitchesPerSecond{0.0};
+    double involuntarySwitchesPerSecond{0.0};
+    // Time spent runnable but waiting for a CPU, as a share of the interval.
+    double runQueueWaitPercent{0.0};
+    std::uint64_t runQueueWaitMs{0};
+};
+
+// Samples the CPU time, context switches and run-queue wait of every thread of this process from /proc.
+class ThreadMonitor {
+public:
+    explicit ThreadMonitor(std::chrono::milliseconds interval = std::chrono::seconds(1));
+    ~ThreadMonitor();
+
+    ThreadMonitor(const ThreadMonitor &) = delete;
+    ThreadMonitor &operator=(const ThreadMonitor &) = delete;
+
+    void start();
+    void stop();
+
+    static bool supported();
+    std::chrono::milliseconds interval() const { return interval_; }
+    // Threads of the latest sample, busiest first.
+    std::vector<ThreadUsage> threads() const;
+
+private:
+    struct Counters {
+        std::string comm;
+        std::uint64_t cpuNs{0};
+        std::uint64_t waitNs{0};
+        std::uint64_t voluntarySwitches{0};
+        std::uint64_t involuntarySwitches{0};
+    };
+
+    static std::map<int, Counters> read_counters();
+    void sample();
+    void run();
+
+    std::chrono::milliseconds interval_;
+    std::map<int, Counters> previous_;
+    std::chrono::steady_clock::time_point previousAt_{};
+
+    mutable std::mutex mutex_;
+    std::vector<ThreadUsage> latest_;
+
+    std::atomic<bool> running_{false};
+    std::thread samplerThread_;
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCv_;
+};
+
+}  // namespace trdp_sim
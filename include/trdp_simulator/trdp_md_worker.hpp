@@ -1,25 +1,28 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
+#include "trdp_simulator/allocation_tracker.hpp"
 #include "trdp_simulator/config.hpp"
 #include "trdp_simulator/logger.hpp"
 #include "trdp_simulator/runtime_metrics.hpp"
+#include "trdp_simulator/stall_detector.hpp"
+#include "trdp_simulator/thread_monitor.hpp"
 #include "trdp_simulator/trdp_stack_adapter.hpp"
 
 namespace trdp_sim {
 
+// Lifecycle and payload handling shared by every sender; BasicMdSenderWorker sends through the concrete adapter.
 class MdSenderWorker {
 public:
-    MdSenderWorker(const MdSenderConfig &config,
-                   TrdpStackAdapter &adapter,
-                   Logger &logger,
-                   RuntimeMetrics &metrics);
-    ~MdSenderWorker();
+    virtual ~MdSenderWorker();
 
     void start();
     void stop();
@@ -27,20 +30,119 @@ public:
     const std::string &name() const { return config_.name; }
     PayloadConfig payload_config() const;
     bool update_payload(PayloadConfig::Format format, const std::string &value, std::string &error_message);
+    // Set before start(); the send loop then reports its wake-ups to the detector.
+    void set_stall_detector(StallDetector *detector) { stallDetector_ = detector; }
 
-private:
-    void run();
+protected:
+    MdSenderWorker(const MdSenderConfig &config, Logger &logger, RuntimeMetrics &metrics);
+
+    virtual void send(const std::vector<std::uint8_t> &payload) = 0;
+    virtual void run() = 0;
+
+    // Records the send and, on a channel with debug enabled, logs it.
+    void record_sent(const std::vector<std::uint8_t> &payload);
+    void record_confirm_sent(const MdMessage &replyQuery);
+    void handle_reply(const MdMessage &message);
+    void handle_timeout();
 
     MdSenderConfig config_;
-    TrdpStackAdapter &adapter_;
     Logger &logger_;
     RuntimeMetrics &metrics_;
 
     std::atomic<bool> running_{false};
-    std::thread workerThread_;
     mutable std::mutex payloadMutex_;
     std::vector<std::uint8_t> payload_;
+    StallDetector *stallDetector_{nullptr};
+    std::uint32_t binaryNameId_{0};
+    LogChannel &log_;
+
+private:
+    std::thread workerThread_;
+};
+
+template <typename Adapter>
+class BasicMdSenderWorker final : public MdSenderWorker {
+public:
+    BasicMdSenderWorker(const MdSenderConfig &config, Adapter &adapter, Logger &logger, RuntimeMetrics &metrics);
+    ~BasicMdSenderWorker() override;
+
+private:
+    void send(const std::vector<std::uint8_t> &payload) override;
+    void run() override;
+    void confirm(const MdMessage &replyQuery);
+
+    Adapter &adapter_;
 };
 
+template <typename Adapter>
+BasicMdSenderWorker<Adapter>::BasicMdSenderWorker(const MdSenderConfig &config,
+                                                  Adapter &adapter,
+                                                  Logger &logger,
+                                                  RuntimeMetrics &metrics)
+    : MdSenderWorker(config, logger, metrics), adapter_(adapter)
+{
+    auto replyHandler = [this](const MdMessage &message) {
+        handle_reply(message);
+        if (message.type == MdMessageType::ReplyQuery) {
+            confirm(message);
+        }
+    };
+    adapter_.register_md_sender(config_, std::move(replyHandler), [this](const MdSessionId &) { handle_timeout(); });
+}
+
+template <typename Adapter>
+BasicMdSenderWorker<Adapter>::~BasicMdSenderWorker()
+{
+    stop();
+}
+
+template <typename Adapter>
+void BasicMdSenderWorker<Adapter>::send(const std::vector<std::uint8_t> &payload)
+{
+    adapter_.send_md_request(config_.name, payload);
+    record_sent(payload);
+}
+
+template <typename Adapter>
+void BasicMdSenderWorker<Adapter>::run()
+{
+    const std::string threadName = "md:" + config_.name;
+    set_thread_name(threadName);
+    LoopProbe &probe = stallDetector_ != nullptr ? stallDetector_->attach(threadName) : StallDetector::detached();
+    logger_.info("Starting MD sender '" + config_.name + "'");
+    const auto interval = std::chrono::milliseconds(config_.cycleTimeMs);
+    std::vector<std::uint8_t> payloadCopy;
+    while (running_) {
+        try {
+            AllocationRegion region("md.send");
+            {
+                std::lock_guard<std::mutex> lock(payloadMutex_);
+                payloadCopy = payload_;
+            }
+            send(payloadCopy);
+        } catch (const std::exception &ex) {
+            logger_.error("MD request failed for '" + config_.name + "': " + ex.what());
+        }
+        probe.sleeping_until(std::chrono::steady_clock::now() + interval);
+        std::this_thread::sleep_for(interval);
+        probe.woke();
+    }
+    if (stallDetector_ != nullptr) {
+        stallDetector_->detach(probe);
+    }
+    logger_.info("Stopping MD sender '" + config_.name + "'");
+}
+
+template <typename Adapter>
+void BasicMdSenderWorker<Adapter>::confirm(const MdMessage &replyQuery)
+{
+    try {
+        adapter_.send_md_confirm(config_.name, replyQuery);
+        record_confirm_sent(replyQuery);
+    } catch (const std::exception &ex) {
+        logger_.error("MD confirmation failed for '" + config_.name + "': " + ex.what());
+    }
+}
+
 }  // namespace trdp_sim
 
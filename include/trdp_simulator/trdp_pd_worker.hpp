@@ -1,25 +1,30 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
+#include "trdp_simulator/allocation_tracker.hpp"
 #include "trdp_simulator/config.hpp"
+#include "trdp_simulator/launch_clock.hpp"
 #include "trdp_simulator/logger.hpp"
 #include "trdp_simulator/runtime_metrics.hpp"
+#include "trdp_simulator/stall_detector.hpp"
 #include "trdp_simulator/trdp_stack_adapter.hpp"
 
 namespace trdp_sim {
 
+// Lifecycle and payload handling shared by every publisher. The send loops live in BasicPdPublisherWorker,
+// which calls the adapter through its concrete type; workers are created by the adapter they publish on.
 class PdPublisherWorker {
 public:
-    PdPublisherWorker(const PdPublisherConfig &config,
-                      TrdpStackAdapter &adapter,
-                      Logger &logger,
-                      RuntimeMetrics &metrics);
-    ~PdPublisherWorker();
+    virtual ~PdPublisherWorker();
 
     void start();
     void stop();
@@ -27,20 +32,316 @@ public:
     const std::string &name() const { return config_.name; }
     PayloadConfig payload_config() const;
     bool update_payload(PayloadConfig::Format format, const std::string &value, std::string &error_message);
+    // Set before start(); the send loop then reports its wake-ups to the detector.
+    void set_stall_detector(StallDetector *detector) { stallDetector_ = detector; }
+    // Called once the stack carries new topology counters for this telegram; the next publish records how long
+    // the counters were stale.
+    void mark_topology_change(std::chrono::steady_clock::time_point changedAt);
 
-private:
-    void run();
+protected:
+    PdPublisherWorker(const PdPublisherConfig &config, Logger &logger, RuntimeMetrics &metrics);
+
+    virtual void run_cyclic() = 0;
+    virtual void run_on_change() = 0;
+    virtual void run_responder() = 0;
+    virtual void run_tsn() = 0;
+
+    // Per-send message for a channel with debug enabled; the send loops check log_.enabled() first.
+    void log_sent(const std::vector<std::uint8_t> &payload);
+    void record_topology_publish();
 
     PdPublisherConfig config_;
-    TrdpStackAdapter &adapter_;
     Logger &logger_;
     RuntimeMetrics &metrics_;
+    LogChannel &log_;
+    std::uint32_t binaryNameId_{0};
 
     std::atomic<bool> running_{false};
-    std::thread workerThread_;
     mutable std::mutex payloadMutex_;
+    std::condition_variable payloadCv_;
     std::vector<std::uint8_t> payload_;
+    bool payloadChanged_{false};
+    std::chrono::steady_clock::time_point payloadChangedAt_{};
+    LoopProbe *probe_{&StallDetector::detached()};
+    // Steady-clock time of a topology change not yet followed by a publish, 0 when there is none.
+    std::atomic<std::int64_t> topologyChangedNs_{0};
+
+private:
+    void run();
+
+    StallDetector *stallDetector_{nullptr};
+
+    std::thread workerThread_;
 };
 
+template <typename Adapter>
+class BasicPdPublisherWorker final : public PdPublisherWorker {
+public:
+    BasicPdPublisherWorker(const PdPublisherConfig &config, Adapter &adapter, Logger &logger, RuntimeMetrics &metrics);
+    ~BasicPdPublisherWorker() override;
+
+private:
+    void run_cyclic() override;
+    void run_on_change() override;
+    void run_responder() override;
+    void run_tsn() override;
+
+    Adapter &adapter_;
+};
+
+// Issues PD pull requests for every requester from one thread, ordered by deadline.
+class PdPullScheduler {
+public:
+    PdPullScheduler(TrdpStackAdapter &adapter, Logger &logger, RuntimeMetrics &metrics,
+                    StallDetector *stallDetector = nullptr);
+    ~PdPullScheduler();
+
+    void add_requester(const PdSubscriberConfig &config, TrdpStackAdapter::PdHandler handler);
+    void start();
+    void stop();
+
+private:
+    struct Requester {
+        PdSubscriberConfig config;
+        TrdpStackAdapter::PdHandler handler;
+        LogChannel *log{nullptr};
+        std::uint32_t binaryNameId{0};
+        std::atomic<std::int64_t> pendingSinceNs{0};
+    };
+
+    struct Deadline {
+        std::chrono::steady_clock::time_point due;
+        std::size_t index;
+
+        bool operator>(const Deadline &other) const { return due > other.due; }
+    };
+
+    void run();
+    void log_request(Requester &requester);
+    void handle_reply(Requester &requester, const PdMessage &message);
+
+    TrdpStackAdapter &adapter_;
+    Logger &logger_;
+    RuntimeMetrics &metrics_;
+    StallDetector *stallDetector_;
+
+    std::vector<std::unique_ptr<Requester>> requesters_;
+    std::atomic<bool> running_{false};
+    std::thread schedulerThread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+template <typename Adapter>
+BasicPdPublisherWorker<Adapter>::BasicPdPublisherWorker(const PdPublisherConfig &config,
+                                                        Adapter &adapter,
+                                                        Logger &logger,
+                                                        RuntimeMetrics &metrics)
+    : PdPublisherWorker(config, logger, metrics), adapter_(adapter)
+{
+    adapter_.register_pd_publisher(config_);
+}
+
+template <typename Adapter>
+BasicPdPublisherWorker<Adapter>::~BasicPdPublisherWorker()
+{
+    // The send loop runs in this class, so it has to finish before the base is torn down.
+    stop();
+}
+
+template <typename Adapter>
+void BasicPdPublisherWorker<Adapter>::run_cyclic()
+{
+    const auto interval = std::chrono::milliseconds(config_.cycleTimeMs);
+    // Copy assignment reuses the buffer, so a steady payload costs no allocation per cycle.
+    std::vector<std::uint8_t> payloadCopy;
+    while (running_) {
+        try {
+            AllocationRegion region("pd.publish");
+            {
+                std::lock_guard<std::mutex> lock(payloadMutex_);
+                payloadCopy = payload_;
+            }
+            adapter_.publish_pd(config_.name, payloadCopy);
+            metrics_.record_pd_publish(config_.name);
+            if (log_.enabled(LogLevel::Debug)) {
+                log_sent(payloadCopy);
+            }
+            if (topologyChangedNs_.load(std::memory_order_relaxed) != 0) {
+                record_topology_publish();
+            }
+        } catch (const std::exception &ex) {
+            logger_.error("PD publish failed for '" + config_.name + "': " + ex.what());
+        }
+        probe_->sleeping_until(std::chrono::steady_clock::now() + interval);
+        std::this_thread::sleep_for(interval);
+        probe_->woke();
+    }
+}
+
+template <typename Adapter>
+void BasicPdPublisherWorker<Adapter>::run_on_change()
+{
+    using clock = std::chrono::steady_clock;
+    const auto cycle = std::chrono::milliseconds(config_.cycleTimeMs);
+    const auto minInterval = std::chrono::milliseconds(config_.minIntervalMs);
+    const auto keepAlive = std::chrono::milliseconds(config_.keepAliveMs);
+    const auto phaseOrigin = clock::now();
+
+    // The initial payload is sent straight away so subscribers do not wait for the first change.
+    bool pending = true;
+    auto changedAt = phaseOrigin;
+    auto lastSend = clock::time_point{};
+    bool haveSent = false;
+    std::vector<std::uint8_t> payloadCopy;
+
+    while (running_) {
+        bool keepAliveDue = false;
+        {
+            std::unique_lock<std::mutex> lock(payloadMutex_);
+            if (!pending && !payloadChanged_) {
+                if (keepAlive.count() > 0) {
+                    probe_->sleeping_until(lastSend + keepAlive);
+                    payloadCv_.wait_until(lock, lastSend + keepAlive, [this] { return !running_ || payloadChanged_; });
+                } else {
+                    probe_->waiting();
+                    payloadCv_.wait(lock, [this] { return !running_ || payloadChanged_; });
+                }
+                probe_->woke();
+            }
+            if (!running_) {
+                break;
+            }
+            if (payloadChanged_) {
+                if (!pending) {
+                    changedAt = payloadChangedAt_;
+                }
+                pending = true;
+                payloadChanged_ = false;
+            }
+            keepAliveDue = !pending && keepAlive.count() > 0 && clock::now() >= lastSend + keepAlive;
+            if (!pending && !keepAliveDue) {
+                continue;
+            }
+
+            if (haveSent && minInterval.count() > 0) {
+                // Further changes arriving while rate limited are coalesced into this send.
+                probe_->sleeping_until(lastSend + minInterval);
+                payloadCv_.wait_until(lock, lastSend + minInterval, [this] { return !running_.load(); });
+                probe_->woke();
+                if (!running_) {
+                    break;
+                }
+                payloadChanged_ = false;
+            }
+            payloadCopy = payload_;
+        }
+
+        const auto sendTime = clock::now();
+        try {
+            AllocationRegion region("pd.publish");
+            adapter_.publish_pd_immediate(config_.name, payloadCopy);
+            if (!haveSent) {
+                // The initial send carries no change, so it neither counts as one nor saves any latency.
+                metrics_.record_pd_publish(config_.name);
+            } else if (pending) {
+                // A cyclic publisher would only have carried the change at the next cycle boundary.
+                const auto sinceOrigin = changedAt - phaseOrigin;
+                const auto cyclesElapsed = (sinceOrigin + cycle - clock::duration(1)) / cycle;
+                const auto cyclicSendTime = phaseOrigin + cyclesElapsed * cycle;
+                const auto saved = std::chrono::duration_cast<std::chrono::microseconds>(cyclicSendTime - sendTime);
+                metrics_.record_pd_on_change_publish(config_.name, saved.count());
+            } else {
+                metrics_.record_pd_keep_alive_publish(config_.name);
+            }
+            if (log_.enabled(LogLevel::Debug)) {
+                log_sent(payloadCopy);
+            }
+            if (topologyChangedNs_.load(std::memory_order_relaxed) != 0) {
+                record_topology_publish();
+            }
+        } catch (const std::exception &ex) {
+            logger_.error("PD publish failed for '" + config_.name + "': " + ex.what());
+        }
+        lastSend = sendTime;
+        haveSent = true;
+        pending = false;
+    }
+}
+
+template <typename Adapter>
+void BasicPdPublisherWorker<Adapter>::run_responder()
+{
+    // The stack answers pull requests from the publisher buffer, so it only needs refreshing on change.
+    bool pending = true;
+    std::vector<std::uint8_t> payloadCopy;
+    while (running_) {
+        {
+            std::unique_lock<std::mutex> lock(payloadMutex_);
+            if (!pending) {
+                probe_->waiting();
+                payloadCv_.wait(lock, [this] { return !running_ || payloadChanged_; });
+                probe_->woke();
+            }
+            if (!running_) {
+                break;
+            }
+            payloadChanged_ = false;
+            payloadCopy = payload_;
+        }
+        try {
+            adapter_.publish_pd(config_.name, payloadCopy);
+            if (log_.enabled(LogLevel::Debug)) {
+                log_sent(payloadCopy);
+            }
+        } catch (const std::exception &ex) {
+            logger_.error("PD responder update failed for '" + config_.name + "': " + ex.what());
+        }
+        pending = false;
+    }
+}
+
+template <typename Adapter>
+void BasicPdPublisherWorker<Adapter>::run_tsn()
+{
+    const auto clock = config_.launchClock;
+    const std::int64_t cycleNs = static_cast<std::int64_t>(config_.cycleTimeMs) * 1000000LL;
+    const std::int64_t offsetNs = static_cast<std::int64_t>(config_.launchOffsetUs) * 1000LL;
+    const std::int64_t leadNs = static_cast<std::int64_t>(config_.launchLeadUs) * 1000LL;
+
+    std::int64_t launchNs = first_launch_ns(launch_clock_now_ns(clock), cycleNs, offsetNs);
+    std::vector<std::uint8_t> payloadCopy;
+    while (running_) {
+        probe_->sleeping_until(std::chrono::steady_clock::now() +
+                               std::chrono::nanoseconds(launchNs - leadNs - launch_clock_now_ns(clock)));
+        launch_clock_sleep_until(clock, launchNs - leadNs);
+        probe_->woke();
+        if (!running_) {
+            break;
+        }
+        {
+            std::lock_guard<std::mutex> lock(payloadMutex_);
+            payloadCopy = payload_;
+        }
+
+        const std::int64_t handoffNs = launch_clock_now_ns(clock);
+        try {
+            AllocationRegion region("pd.publish");
+            adapter_.publish_pd_at(config_.name, payloadCopy, launchNs);
+            metrics_.record_pd_tsn_launch(config_.name, handoffNs > launchNs);
+            if (log_.enabled(LogLevel::Debug)) {
+                log_sent(payloadCopy);
+            }
+            if (topologyChangedNs_.load(std::memory_order_relaxed) != 0) {
+                record_topology_publish();
+            }
+        } catch (const std::exception &ex) {
+            logger_.error("TSN PD publish failed for '" + config_.name + "': " + ex.what());
+        }
+
+        launchNs = next_launch_ns(launchNs, launch_clock_now_ns(clock), cycleNs, leadNs);
+    }
+}
+
 }  // namespace trdp_sim
 
@@ -12,6 +12,11 @@
 
 namespace trdp_sim {
 
+class Logger;
+class MdSenderWorker;
+class PdPublisherWorker;
+class RuntimeMetrics;
+
 struct PdMessage {
     std::string endpoint;
     std::uint32_t comId{0};
@@ -19,10 +24,79 @@ struct PdMessage {
     std::uint64_t sequenceCounter{0};
 };
 
+struct PdRedundancyState {
+    std::uint32_t groupId{0};
+    bool leader{false};
+};
+
+struct PdLaunchReport {
+    std::string publisherName;
+    std::int64_t errorNs{0};
+    bool missed{false};
+};
+
+// Reported for every MD exchange sent over TCP and whenever the stack opens or closes a TCP connection to a peer.
+struct MdConnectionEvent {
+    enum class Kind {
+        Exchange,
+        Opened,
+        Closed,
+    };
+
+    Kind kind{Kind::Exchange};
+    std::string peer;
+};
+
+// Reported whenever the stack adds a session to or removes one from its caller or replier session table.
+struct MdSessionEvent {
+    enum class Role {
+        Caller,
+        Replier,
+    };
+    enum class Kind {
+        Opened,
+        Closed,
+        TimedOut,
+    };
+
+    Role role{Role::Caller};
+    Kind kind{Kind::Opened};
+};
+
+struct TopologyUpdateResult {
+    std::size_t publishersUpdated{0};
+    std::size_t subscribersUpdated{0};
+};
+
+// Applies new topology counters to a publisher or subscriber configuration and reports whether they changed.
+// Counters of zero mean "do not check"; only telegrams that validate them follow the new topology.
+template <typename Config>
+bool retarget_topology(Config &config, std::uint32_t etbTopoCount, std::uint32_t opTrnTopoCount)
+{
+    const std::uint32_t etb = config.etbTopoCount == 0 ? 0U : etbTopoCount;
+    const std::uint32_t opTrn = config.opTrnTopoCount == 0 ? 0U : opTrnTopoCount;
+    if (etb == config.etbTopoCount && opTrn == config.opTrnTopoCount) {
+        return false;
+    }
+    config.etbTopoCount = etb;
+    config.opTrnTopoCount = opTrn;
+    return true;
+}
+
 inline constexpr std::size_t MdSessionIdSize = 16U;
 using MdSessionId = std::array<std::uint8_t, MdSessionIdSize>;
 
+// TRDP message data types: Mn, Mr, Mp, Mq and Mc.
+enum class MdMessageType {
+    Notification,
+    Request,
+    Reply,
+    ReplyQuery,
+    Confirm,
+};
+
 struct MdMessage {
+    MdMessageType type{MdMessageType::Request};
     std::string endpoint;
     std::uint32_t comId{0};
     std::vector<std::uint8_t> payload;
@@ -33,6 +107,10 @@ class TrdpStackAdapter {
 public:
     using PdHandler = std::function<void(const PdMessage &)>;
     using MdHandler = std::function<void(const MdMessage &)>;
+    using PdLaunchHandler = std::function<void(const PdLaunchReport &)>;
+    using MdConnectionHandler = std::function<void(const MdConnectionEvent &)>;
+    using MdSessionHandler = std::function<void(const MdSessionEvent &)>;
+    using MdTimeoutHandler = std::function<void(const MdSessionId &)>;
 
     virtual ~TrdpStackAdapter() = default;
 
@@ -42,16 +120,51 @@ public:
     virtual void register_pd_publisher(const PdPublisherConfig &config) = 0;
     virtual void register_pd_subscriber(const PdSubscriberConfig &config, PdHandler handler) = 0;
     virtual void publish_pd(const std::string &publisherName, const std::vector<std::uint8_t> &data) = 0;
+    virtual void publish_pd_immediate(const std::string &publisherName, const std::vector<std::uint8_t> &data) = 0;
+    // Hands a TSN telegram to the kernel for transmission at launchTimeNs on the publisher's launch clock.
+    virtual void publish_pd_at(const std::string &publisherName,
+                               const std::vector<std::uint8_t> &data,
+                               std::int64_t launchTimeNs) = 0;
+    virtual void set_pd_launch_handler(PdLaunchHandler handler) = 0;
+    virtual void request_pd(const std::string &subscriberName) = 0;
+    // Applies all leader transitions before follower transitions so a swap never leaves a gap.
+    virtual void set_pd_redundancy(const std::vector<PdRedundancyState> &states) = 0;
+    virtual bool pd_redundancy_leader(std::uint32_t groupId) = 0;
+    // Switches the session to new topology counters and re-addresses every telegram that validates them,
+    // without letting the stack process in between.
+    virtual TopologyUpdateResult set_topology(std::uint32_t etbTopoCount, std::uint32_t opTrnTopoCount) = 0;
 
-    virtual void register_md_sender(const MdSenderConfig &config, MdHandler replyHandler) = 0;
+    // Replies and reply queries go to replyHandler; a reply query keeps the session open until send_md_confirm.
+    // timeoutHandler runs for each request that got no reply within replyTimeoutMs.
+    virtual void register_md_sender(const MdSenderConfig &config, MdHandler replyHandler,
+                                    MdTimeoutHandler timeoutHandler) = 0;
+    // Sends a request or, for notify senders, a notification.
     virtual void send_md_request(const std::string &senderName, const std::vector<std::uint8_t> &data) = 0;
+    virtual void send_md_confirm(const std::string &senderName, const MdMessage &replyQuery) = 0;
+    virtual void set_md_connection_handler(MdConnectionHandler handler) = 0;
+    virtual void set_md_session_handler(MdSessionHandler handler) = 0;
 
+    // Notifications, requests and confirmations of earlier reply queries go to requestHandler.
     virtual void register_md_listener(const MdListenerConfig &config, MdHandler requestHandler) = 0;
+    // Answers with a reply query instead of a reply when the listener is configured for confirmed replies.
     virtual void send_md_reply(const std::string &listenerName, const MdMessage &request, const std::vector<std::uint8_t> &data) = 0;
 
+    // Workers are bound to the concrete adapter type so their per-packet calls do not go through this interface.
+    virtual std::unique_ptr<PdPublisherWorker> create_pd_publisher_worker(const PdPublisherConfig &config,
+                                                                          Logger &logger,
+                                                                          RuntimeMetrics &metrics) = 0;
+    virtual std::unique_ptr<MdSenderWorker> create_md_sender_worker(const MdSenderConfig &config,
+                                                                    Logger &logger,
+                                                                    RuntimeMetrics &metrics) = 0;
+
     virtual void poll(std::chrono::milliseconds timeout) = 0;
+    // Adapters with several stack sessions let each session be processed by its own thread.
+    virtual std::size_t poll_partitions() const { return 1U; }
+    virtual void poll_partition(std::size_t, std::chrono::milliseconds timeout) { poll(timeout); }
 };
 
 std::unique_ptr<TrdpStackAdapter> create_trdp_stack_adapter();
+// Returns a sharded adapter when the network configuration asks for more than one stack session.
+std::unique_ptr<TrdpStackAdapter> create_trdp_stack_adapter(const NetworkConfig &networkConfig);
 
 }  // namespace trdp_sim
@@ -7,12 +7,18 @@
 #include <mutex>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "trdp_simulator/runtime_metrics.hpp"
 #include "trdp_simulator/config_store.hpp"
 #include "trdp_simulator/config.hpp"
+#include "trdp_simulator/http_request.hpp"
+#include "trdp_simulator/thread_monitor.hpp"
+#include "trdp_simulator/web_assets.hpp"
 
 namespace trdp_sim {
 
@@ -26,48 +32,75 @@ public:
     void run();
     void request_stop();
 
+    // Paging, sorting and filtering of the per-telegram lists in the JSON endpoints, taken from the query
+    // parameters list, offset, limit, sort (name or comId), order (asc or desc) and filter. The filter matches
+    // a part of the name, ignoring case, or a ComID given as a number.
+    struct ListQuery {
+        enum class Sort { Configured, Name, ComId };
+
+        // Restricts the response to this list; empty includes every list.
+        std::string list;
+        std::size_t offset{0};
+        std::optional<std::size_t> limit;
+        Sort sort{Sort::Configured};
+        bool descending{false};
+        std::string filter;
+        // Any parameter was given; the response then reports the row counts of each list under "pages".
+        bool paged{false};
+
+        bool includes(const char *name) const { return list.empty() || list == name; }
+    };
+
 private:
     friend int run_web_application_tests();
+    friend struct WebApplicationBenchmark;
 
     struct HttpResponse {
         int status_code;
         std::string status_message;
         std::string content_type;
         std::string body;
+        std::vector<std::pair<std::string, std::string>> headers{};
+        // Sent instead of `body` when set; points at data that outlives the response, such as an embedded asset.
+        std::string_view static_body{};
     };
 
     void accept_loop();
     void handle_client(int client_fd);
-    HttpResponse handle_request(const std::string &method, const std::string &target,
-                                const std::string &body);
+    HttpResponse handle_request(HttpRequest &request);
 
-    HttpResponse handle_list_configs();
+    HttpResponse handle_list_configs(const std::string &query);
     HttpResponse handle_get_config(const std::string &method, const std::string &query,
                                    const std::string &body);
     HttpResponse handle_save_config(const std::string &body);
+    HttpResponse handle_save_config_file(HttpRequest &request, const std::string &name, const std::string &label);
+    HttpResponse handle_config_history(const std::string &path, const std::string &query, const std::string &body);
     HttpResponse handle_upload_config(const std::string &body);
+    static HttpResponse handle_static_asset(const WebAsset &asset, const HttpRequest &request);
 
     bool start_simulator(const std::string &config_path, const std::string &config_label, std::string &message);
     bool stop_simulator(std::string &message);
     std::string build_status_json() const;
-    std::string build_metrics_json() const;
-    std::string build_config_summary_json(const SimulatorConfig &config) const;
-    std::string build_payloads_json() const;
-    std::unordered_map<std::string, std::string> parse_form_urlencoded(const std::string &body) const;
+    std::string build_metrics_json(const ListQuery &query) const;
+    std::string build_config_summary_json(const SimulatorConfig &config, const ListQuery &query) const;
+    std::string build_payloads_json(const ListQuery &query) const;
+    std::string build_allocations_json() const;
+    std::string build_threads_json() const;
+    static std::unordered_map<std::string, std::string> parse_form_urlencoded(const std::string &body);
     HttpResponse respond_json(int status, const std::string &body) const;
 
-    static std::string main_page_html();
+    static ListQuery parse_list_query(const std::string &query);
     static std::string json_escape(const std::string &value);
-    static std::string url_decode(const std::string &value)
+    static std::string url_decode(std::string_view value)
     {
         std::string result;
         result.reserve(value.size());
         for (std::size_t i = 0; i < value.size(); ++i) {
             if (value[i] == '%' && i + 2 < value.size()) {
-                std::string hex = value.substr(i + 1, 2);
+                const char hex[3] = {value[i + 1], value[i + 2], '\0'};
                 char *end = nullptr;
-                long decoded = std::strtol(hex.c_str(), &end, 16);
-                if (end != nullptr && *end == '\0') {
+                long decoded = std::strtol(hex, &end, 16);
+                if (end == hex + 2) {
                     result.push_back(static_cast<char>(decoded));
                     i += 2;
                     continue;
@@ -124,6 +157,7 @@ private:
     int server_fd_{-1};
 
     ConfigStore config_store_;
+    ThreadMonitor thread_monitor_;
 
     mutable std::mutex simulator_mutex_;
     std::condition_variable simulator_cv_;
@@ -137,6 +171,14 @@ private:
     std::optional<std::string> last_error_;
     mutable RuntimeMetrics::Snapshot last_metrics_snapshot_;
     mutable bool has_metrics_snapshot_{false};
+    // ComIDs of the telegrams of the last configuration started, for filtering and sorting the metrics by ComID.
+    struct TelegramComIds {
+        std::unordered_map<std::string, std::uint32_t> pdPublishers;
+        std::unordered_map<std::string, std::uint32_t> pdSubscribers;
+        std::unordered_map<std::string, std::uint32_t> mdSenders;
+        std::unordered_map<std::string, std::uint32_t> mdListeners;
+    };
+    std::shared_ptr<const TelegramComIds> telegram_com_ids_;
 };
 
 }  // namespace trdp_sim
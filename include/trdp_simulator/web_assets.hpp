@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace trdp_sim {
+
+// One stored encoding of an embedded file.
+struct WebAssetRepresentation {
+    // Content-Encoding token; empty for the file as written.
+    std::string_view contentEncoding;
+    // Strong ETag of these bytes, including the quotes.
+    std::string_view etag;
+    std::string_view data;
+};
+
+// Static file of the web interface. The files under web/ are embedded at build time by
+// trdp-simulator-embed-assets, together with gzip and brotli variants, and served from read-only memory.
+struct WebAsset {
+    std::string_view path;
+    std::string_view contentType;
+    // The identity encoding first, then each precompressed variant that came out smaller.
+    const WebAssetRepresentation *representations;
+    std::size_t representationCount;
+};
+
+// nullptr if no file is embedded under this path; "/" serves index.html.
+const WebAsset *find_web_asset(std::string_view path);
+
+// Smallest representation whose encoding the Accept-Encoding header allows.
+const WebAssetRepresentation &select_web_asset_representation(const WebAsset &asset,
+                                                              std::string_view acceptEncoding);
+
+// Whether an If-None-Match header lists this ETag (or is "*").
+bool etag_matches(std::string_view ifNoneMatch, std::string_view etag);
+
+}  // namespace trdp_sim
@@ -0,0 +1,320 @@
+#include "trdp_simulator/allocation_tracker.hpp"
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifdef __GLIBC__
+// glibc's own entry points, which the interposed C allocation functions below forward to.
+extern "C" {
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *pointer, std::size_t size);
+void *__libc_memalign(std::size_t alignment, std::size_t size);
+}
+#endif
+
+namespace trdp_sim {
+namespace {
+
+// Counters live in fixed tables because they are updated from inside operator new and malloc.
+struct Slot {
+    std::atomic<bool> used{false};
+    char name[48]{};
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> bytes{0};
+};
+
+constexpr std::size_t ThreadSlotCount = 256U;
+constexpr std::size_t RegionSlotCount = 64U;
+
+std::array<Slot, ThreadSlotCount> threadSlots;
+std::array<Slot, RegionSlotCount> regionSlots;
+std::atomic_flag claimLock = ATOMIC_FLAG_INIT;
+
+// Slot 0 of each table collects unnamed threads and names that no longer fit.
+thread_local int currentThreadSlot = 0;
+thread_local int currentRegionSlot = -1;
+
+template <std::size_t Count>
+int claim_slot(std::array<Slot, Count> &slots, const char *name)
+{
+    while (claimLock.test_and_set(std::memory_order_acquire)) {
+    }
+    int found = 0;
+    for (std::size_t index = 1; index < Count; ++index) {
+        auto &slot = slots[index];
+        if (!slot.used.load(std::memory_order_relaxed)) {
+            std::strncpy(slot.name, name, sizeof(slot.name) - 1U);
+            slot.used.store(true, std::memory_order_release);
+            found = static_cast<int>(index);
+            break;
+        }
+        if (std::strncmp(slot.name, name, sizeof(slot.name) - 1U) == 0) {
+            found = static_cast<int>(index);
+            break;
+        }
+    }
+    claimLock.clear(std::memory_order_release);
+    return found;
+}
+
+int region_slot(const char *name)
+{
+    for (std::size_t index = 1; index < RegionSlotCount; ++index) {
+        const auto &slot = regionSlots[index];
+        if (!slot.used.load(std::memory_order_acquire)) {
+            break;
+        }
+        if (std::strncmp(slot.name, name, sizeof(slot.name) - 1U) == 0) {
+            return static_cast<int>(index);
+        }
+    }
+    return claim_slot(regionSlots, name);
+}
+
+void count(std::size_t size) noexcept
+{
+    auto &thread = threadSlots[static_cast<std::size_t>(currentThreadSlot)];
+    thread.allocations.fetch_add(1U, std::memory_order_relaxed);
+    thread.bytes.fetch_add(size, std::memory_order_relaxed);
+    if (currentRegionSlot >= 0) {
+        auto &region = regionSlots[static_cast<std::size_t>(currentRegionSlot)];
+        region.allocations.fetch_add(1U, std::memory_order_relaxed);
+        region.bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+}
+
+// On glibc operator new goes straight to the C library, so an allocation is not counted twice.
+void *allocate(std::size_t size) noexcept
+{
+    count(size);
+#ifdef __GLIBC__
+    return __libc_malloc(size == 0 ? 1U : size);
+#else
+    return std::malloc(size == 0 ? 1U : size);
+#endif
+}
+
+void *allocate_aligned(std::size_t size, std::align_val_t alignment) noexcept
+{
+    count(size);
+    const auto align = static_cast<std::size_t>(alignment);
+#ifdef __GLIBC__
+    return __libc_memalign(align, size == 0 ? 1U : size);
+#else
+    // aligned_alloc wants a size that is a multiple of the alignment.
+    const std::size_t rounded = size == 0 ? align : (size + align - 1U) / align * align;
+    return std::aligned_alloc(align, rounded);
+#endif
+}
+
+template <std::size_t Count>
+void append(std::vector<AllocationCounter> &out, const std::array<Slot, Count> &slots, const char *unnamed)
+{
+    for (std::size_t index = 0; index < Count; ++index) {
+        const auto &slot = slots[index];
+        const auto allocations = slot.allocations.load(std::memory_order_relaxed);
+        if (index != 0 && !slot.used.load(std::memory_order_acquire)) {
+            break;
+        }
+        if (index == 0 && allocations == 0) {
+            continue;
+        }
+        out.push_back({index == 0 ? unnamed : slot.name, allocations, slot.bytes.load(std::memory_order_relaxed)});
+    }
+}
+
+}  // namespace
+
+void set_allocation_thread_name(const std::string &name)
+{
+    currentThreadSlot = claim_slot(threadSlots, name.c_str());
+}
+
+AllocationReport allocation_report()
+{
+    AllocationReport report;
+    report.enabled = true;
+    report.threads.reserve(ThreadSlotCount);
+    report.regions.reserve(RegionSlotCount);
+    append(report.threads, threadSlots, "other");
+    append(report.regions, regionSlots, "other");
+    return report;
+}
+
+AllocationRegion::AllocationRegion(const char *name) noexcept
+    : previous_(currentRegionSlot)
+{
+    currentRegionSlot = region_slot(name);
+}
+
+AllocationRegion::~AllocationRegion()
+{
+    currentRegionSlot = previous_;
+}
+
+}  // namespace trdp_sim
+
+void *operator new(std::size_t size)
+{
+    if (void *pointer = trdp_sim::allocate(size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return trdp_sim::allocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return trdp_sim::allocate(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (void *pointer = trdp_sim::allocate_aligned(size, alignment)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return trdp_sim::allocate_aligned(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return trdp_sim::allocate_aligned(size, alignment);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    std::free(pointer);
+}
+
+#ifdef __GLIBC__
+// The C allocation functions are interposed too, so allocations made by the TRDP stack and other C code are
+// counted. Blocks stay glibc's, so the library's free releases them.
+extern "C" {
+
+void *malloc(std::size_t size) noexcept
+{
+    trdp_sim::count(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(std::size_t count, std::size_t size) noexcept
+{
+    trdp_sim::count(count * size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, std::size_t size) noexcept
+{
+    if (size != 0) {
+        trdp_sim::count(size);
+    }
+    return __libc_realloc(pointer, size);
+}
+
+void *aligned_alloc(std::size_t alignment, std::size_t size) noexcept
+{
+    trdp_sim::count(size);
+    return __libc_memalign(alignment, size);
+}
+
+void *memalign(std::size_t alignment, std::size_t size) noexcept
+{
+    trdp_sim::count(size);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **result, std::size_t alignment, std::size_t size) noexcept
+{
+    if (alignment == 0 || alignment % sizeof(void *) != 0 || (alignment & (alignment - 1U)) != 0) {
+        return EINVAL;
+    }
+    trdp_sim::count(size);
+    void *pointer = __libc_memalign(alignment, size);
+    if (pointer == nullptr) {
+        return ENOMEM;
+    }
+    *result = pointer;
+    return 0;
+}
+
+}  // extern "C"
+#endif
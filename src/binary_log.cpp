@@ -0,0 +1,426 @@
+#include "trdp_simulator/binary_log.hpp"
+
+#include "trdp_simulator/config.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+
+namespace trdp_sim {
+namespace {
+
+constexpr char Magic[8] = {'T', 'R', 'D', 'P', 'B', 'L', 'O', 'G'};
+constexpr std::uint32_t FormatVersion = 1;
+constexpr std::size_t HeaderSize = 4096;
+constexpr std::size_t MinStringTableSize = 64U * 1024U;
+constexpr std::size_t MaxStringLength = 0xFFFF;
+constexpr std::size_t MinRecords = 1024;
+constexpr std::size_t MaxTextLength = 0xFFFF;
+
+std::int64_t clock_ns(clockid_t clock)
+{
+    timespec now{};
+    ::clock_gettime(clock, &now);
+    return static_cast<std::int64_t>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+}
+
+std::uint32_t current_thread_id()
+{
+    thread_local const auto tid = static_cast<std::uint32_t>(::syscall(SYS_gettid));
+    return tid;
+}
+
+// The sequence is written last, so a record interrupted by a crash keeps a stale sequence and is skipped.
+void begin_record(BinaryLogRecord &record)
+{
+    __atomic_store_n(&record.sequence, 0U, __ATOMIC_RELAXED);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void commit_record(BinaryLogRecord &record, std::uint64_t index)
+{
+    __atomic_store_n(&record.sequence, static_cast<std::uint32_t>(index + 1U), __ATOMIC_RELEASE);
+}
+
+void fill_header(BinaryLogRecord &record, std::int64_t timestampNs, LogLevel level, BinaryLogMessage message)
+{
+    record.timestampNs = static_cast<std::uint64_t>(timestampNs);
+    record.threadId = current_thread_id();
+    record.messageId = static_cast<std::uint16_t>(message);
+    record.level = static_cast<std::uint8_t>(level);
+    record.argCount = 0;
+    std::memset(record.argTypes, 0, sizeof(record.argTypes));
+    record.dataLength = 0;
+    record.dataFormat = static_cast<std::uint8_t>(BinaryLogDataFormat::None);
+    std::memset(record.reserved, 0, sizeof(record.reserved));
+}
+
+}  // namespace
+
+BinaryLog::BinaryLog(const std::string &path, std::size_t capacityBytes, std::size_t stringTableBytes)
+    : path_(path),
+      stringTableSize_((std::max(stringTableBytes, MinStringTableSize) + HeaderSize - 1U) / HeaderSize * HeaderSize)
+{
+    const std::size_t recordsOffset = HeaderSize + stringTableSize_;
+    if (capacityBytes < recordsOffset + MinRecords * sizeof(BinaryLogRecord)) {
+        throw std::runtime_error("Binary log '" + path + "' needs at least " +
+                                 std::to_string((recordsOffset + MinRecords * sizeof(BinaryLogRecord)) / 1024U) +
+                                 " KiB");
+    }
+    const std::uint64_t recordCapacity = (capacityBytes - recordsOffset) / sizeof(BinaryLogRecord);
+    mappingSize_ = recordsOffset + static_cast<std::size_t>(recordCapacity) * sizeof(BinaryLogRecord);
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("Unable to open binary log '" + path + "': " + std::strerror(errno));
+    }
+    // Reserve the blocks up front so a full disk shows here and not as SIGBUS while logging.
+    int result = ::posix_fallocate(fd_, 0, static_cast<off_t>(mappingSize_));
+    if (result == EOPNOTSUPP || result == EINVAL) {
+        result = ::ftruncate(fd_, static_cast<off_t>(mappingSize_)) == 0 ? 0 : errno;
+    }
+    if (result == 0) {
+        mapping_ = ::mmap(nullptr, mappingSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (mapping_ == MAP_FAILED) {
+            mapping_ = nullptr;
+            result = errno;
+        }
+    }
+    if (result != 0) {
+        ::close(fd_);
+        throw std::runtime_error("Unable to preallocate binary log '" + path + "': " + std::strerror(result));
+    }
+
+    header_ = new (mapping_) BinaryLogHeader();
+    std::memcpy(header_->magic, Magic, sizeof(Magic));
+    header_->version = FormatVersion;
+    header_->recordSize = sizeof(BinaryLogRecord);
+    header_->recordCapacity = recordCapacity;
+    header_->recordsOffset = recordsOffset;
+    header_->stringTableOffset = HeaderSize;
+    header_->stringTableSize = stringTableSize_;
+    header_->realtimeOffsetNs = clock_ns(CLOCK_REALTIME) - clock_ns(CLOCK_MONOTONIC);
+    strings_ = static_cast<char *>(mapping_) + HeaderSize;
+    records_ = reinterpret_cast<BinaryLogRecord *>(static_cast<char *>(mapping_) + recordsOffset);
+}
+
+BinaryLog::~BinaryLog()
+{
+    if (mapping_ != nullptr) {
+        ::msync(mapping_, mappingSize_, MS_ASYNC);
+        ::munmap(mapping_, mappingSize_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+std::uint64_t BinaryLog::records_written() const
+{
+    return header_->nextRecord.load(std::memory_order_relaxed);
+}
+
+BinaryLogRecord &BinaryLog::slot(std::uint64_t index)
+{
+    return records_[index % header_->recordCapacity];
+}
+
+std::uint32_t BinaryLog::intern(const std::string &value)
+{
+    std::lock_guard<std::mutex> lock(internMutex_);
+    const auto it = interned_.find(value);
+    if (it != interned_.end()) {
+        return it->second;
+    }
+    const std::size_t length = std::min(value.size(), MaxStringLength);
+    const auto used = header_->stringTableUsed.load(std::memory_order_relaxed);
+    if (used + 2U + length > stringTableSize_) {
+        throw std::runtime_error("Binary log string table is full");
+    }
+    // Entries are a 16-bit length followed by the bytes; IDs are the entry order.
+    const auto prefix = static_cast<std::uint16_t>(length);
+    std::memcpy(strings_ + used, &prefix, sizeof(prefix));
+    std::memcpy(strings_ + used + 2U, value.data(), length);
+    header_->stringTableUsed.store(used + 2U + length, std::memory_order_release);
+    const auto id = static_cast<std::uint32_t>(interned_.size());
+    interned_.emplace(value, id);
+    return id;
+}
+
+std::size_t BinaryLog::string_entry_size(const std::string &value)
+{
+    return 2U + std::min(value.size(), MaxStringLength);
+}
+
+void BinaryLog::write(LogLevel level, BinaryLogMessage message, std::initializer_list<BinaryLogArg> args,
+                      BinaryLogData data)
+{
+    const auto timestampNs = clock_ns(CLOCK_MONOTONIC);
+    const auto index = header_->nextRecord.fetch_add(1U, std::memory_order_relaxed);
+    auto &record = slot(index);
+    begin_record(record);
+    fill_header(record, timestampNs, level, message);
+    for (const auto &arg : args) {
+        if (record.argCount == BinaryLogMaxArgs) {
+            break;
+        }
+        record.argTypes[record.argCount] = static_cast<std::uint8_t>(arg.type);
+        record.args[record.argCount] = arg.value;
+        ++record.argCount;
+    }
+    if (data.format != BinaryLogDataFormat::None) {
+        record.dataFormat = static_cast<std::uint8_t>(data.format);
+        record.dataLength = static_cast<std::uint16_t>(std::min(data.size, MaxTextLength));
+        if (data.size != 0) {
+            std::memcpy(record.data, data.bytes, std::min(data.size, BinaryLogRecordData));
+        }
+    }
+    commit_record(record, index);
+}
+
+void BinaryLog::write_text(LogLevel level, const std::string &text)
+{
+    const auto timestampNs = clock_ns(CLOCK_MONOTONIC);
+    const std::size_t length = std::min(text.size(), MaxTextLength);
+    const std::size_t count = std::max<std::size_t>(1U, (length + BinaryLogRecordData - 1U) / BinaryLogRecordData);
+    // One increment claims adjacent slots, so the continuation records cannot interleave with other threads.
+    const auto first = header_->nextRecord.fetch_add(count, std::memory_order_relaxed);
+    for (std::size_t part = 0; part < count; ++part) {
+        const auto index = first + part;
+        auto &record = slot(index);
+        begin_record(record);
+        fill_header(record, timestampNs, level,
+                    part == 0 ? BinaryLogMessage::Text : BinaryLogMessage::TextContinuation);
+        const std::size_t offset = part * BinaryLogRecordData;
+        const std::size_t chunk = std::min(BinaryLogRecordData, length - std::min(length, offset));
+        record.dataFormat = static_cast<std::uint8_t>(BinaryLogDataFormat::Text);
+        record.dataLength = static_cast<std::uint16_t>(part == 0 ? length : chunk);
+        std::memcpy(record.data, text.data() + offset, chunk);
+        commit_record(record, index);
+    }
+}
+
+BinaryLogReader::BinaryLogReader(const std::string &path)
+    : path_(path), file_(path, std::ios::binary)
+{
+    if (!file_) {
+        throw std::runtime_error("Unable to open binary log '" + path + "'");
+    }
+
+    // The header is read field by field; its atomics are plain 64-bit values on disk.
+    char magic[8];
+    std::uint32_t version = 0;
+    std::uint32_t recordSize = 0;
+    std::uint64_t stringTableOffset = 0;
+    std::uint64_t stringTableSize = 0;
+    std::uint64_t stringTableUsed = 0;
+    file_.read(magic, sizeof(magic));
+    file_.read(reinterpret_cast<char *>(&version), sizeof(version));
+    file_.read(reinterpret_cast<char *>(&recordSize), sizeof(recordSize));
+    file_.read(reinterpret_cast<char *>(&recordCapacity_), sizeof(recordCapacity_));
+    file_.read(reinterpret_cast<char *>(&recordsOffset_), sizeof(recordsOffset_));
+    file_.read(reinterpret_cast<char *>(&stringTableOffset), sizeof(stringTableOffset));
+    file_.read(reinterpret_cast<char *>(&stringTableSize), sizeof(stringTableSize));
+    file_.read(reinterpret_cast<char *>(&realtimeOffsetNs_), sizeof(realtimeOffsetNs_));
+    file_.read(reinterpret_cast<char *>(&nextRecord_), sizeof(nextRecord_));
+    file_.read(reinterpret_cast<char *>(&stringTableUsed), sizeof(stringTableUsed));
+    if (!file_ || std::memcmp(magic, Magic, sizeof(Magic)) != 0) {
+        throw std::runtime_error("'" + path + "' is not a TRDP simulator binary log");
+    }
+    if (version != FormatVersion || recordSize != sizeof(BinaryLogRecord) || recordCapacity_ == 0 ||
+        stringTableUsed > stringTableSize) {
+        throw std::runtime_error("Binary log '" + path + "' has an unsupported format (version " +
+                                 std::to_string(version) + ")");
+    }
+
+    std::vector<char> table(static_cast<std::size_t>(stringTableUsed));
+    file_.seekg(static_cast<std::streamoff>(stringTableOffset));
+    file_.read(table.data(), static_cast<std::streamsize>(table.size()));
+    for (std::size_t offset = 0; offset + 2U <= table.size();) {
+        std::uint16_t length = 0;
+        std::memcpy(&length, table.data() + offset, sizeof(length));
+        offset += 2U;
+        strings_.emplace_back(table.data() + offset, std::min<std::size_t>(length, table.size() - offset));
+        offset += length;
+    }
+}
+
+void BinaryLogReader::for_each(const std::function<void(const BinaryLogEntry &)> &visit)
+{
+    const std::uint64_t first = nextRecord_ > recordCapacity_ ? nextRecord_ - recordCapacity_ : 0U;
+    recordsLost_ = first;
+
+    BinaryLogEntry pending;
+    std::size_t pendingLength = 0;
+    bool havePending = false;
+    const auto flush = [&] {
+        if (havePending) {
+            pending.truncated = pending.data.size() < pendingLength;
+            visit(pending);
+            havePending = false;
+        }
+    };
+
+    file_.clear();
+    BinaryLogRecord record{};
+    for (std::uint64_t index = first; index < nextRecord_; ++index) {
+        file_.seekg(static_cast<std::streamoff>(recordsOffset_ + (index % recordCapacity_) * sizeof(BinaryLogRecord)));
+        if (!file_.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+            throw std::runtime_error("Binary log '" + path_ + "' is truncated");
+        }
+        if (record.sequence != static_cast<std::uint32_t>(index + 1U)) {
+            ++recordsLost_;
+            continue;
+        }
+        const auto message = static_cast<BinaryLogMessage>(record.messageId);
+        const std::size_t stored = std::min<std::size_t>(record.dataLength, BinaryLogRecordData);
+        if (message == BinaryLogMessage::TextContinuation) {
+            if (havePending && pending.message == BinaryLogMessage::Text && pending.data.size() < pendingLength) {
+                pending.data.insert(pending.data.end(), record.data, record.data + stored);
+            }
+            continue;
+        }
+        flush();
+
+        pending = BinaryLogEntry{};
+        pending.index = index;
+        pending.wallTimeNs = static_cast<std::int64_t>(record.timestampNs) + realtimeOffsetNs_;
+        pending.threadId = record.threadId;
+        pending.level = static_cast<LogLevel>(std::min<int>(record.level, static_cast<int>(LogLevel::Debug)));
+        pending.message = message;
+        for (std::size_t arg = 0; arg < std::min<std::size_t>(record.argCount, BinaryLogMaxArgs); ++arg) {
+            pending.args.push_back({static_cast<BinaryLogArgType>(record.argTypes[arg]), record.args[arg]});
+        }
+        pending.dataFormat = static_cast<BinaryLogDataFormat>(record.dataFormat);
+        pending.data.assign(record.data, record.data + stored);
+        pendingLength = record.dataLength;
+        havePending = true;
+    }
+    flush();
+}
+
+const char *binary_log_format(BinaryLogMessage message)
+{
+    switch (message) {
+    case BinaryLogMessage::Text:
+    case BinaryLogMessage::TextContinuation:
+        return "{}";
+    case BinaryLogMessage::PdReceived:
+        return "PD subscriber '{}' received COMID {} payload={}";
+    case BinaryLogMessage::MdRequestReceived:
+        return "MD listener '{}' received request COMID {} payload={}";
+    case BinaryLogMessage::MdNotificationReceived:
+        return "MD listener '{}' received notification COMID {} payload={}";
+    case BinaryLogMessage::MdConfirmReceived:
+        return "MD listener '{}' received confirmation from '{}'";
+    case BinaryLogMessage::MdReplySent:
+        return "MD listener '{}' sent automatic reply";
+    case BinaryLogMessage::MdReplyQuerySent:
+        return "MD listener '{}' sent automatic reply query";
+    case BinaryLogMessage::MdReplyReceived:
+        return "Received MD reply for sender '{}' from '{}'";
+    case BinaryLogMessage::MdReplyQueryReceived:
+        return "Received MD reply query for sender '{}' from '{}'";
+    case BinaryLogMessage::PdSent:
+        return "PD publisher '{}' sent COMID {} payload={}";
+    case BinaryLogMessage::PdPullRequested:
+        return "PD requester '{}' sent pull request COMID {}";
+    case BinaryLogMessage::MdRequestSent:
+        return "MD sender '{}' sent request COMID {} payload={}";
+    case BinaryLogMessage::MdNotificationSent:
+        return "MD sender '{}' sent notification COMID {} payload={}";
+    case BinaryLogMessage::MdConfirmSent:
+        return "MD sender '{}' sent confirmation to '{}'";
+    }
+    return "unknown message {} {} {} {} {}";
+}
+
+std::string binary_log_message_name(BinaryLogMessage message)
+{
+    switch (message) {
+    case BinaryLogMessage::Text:
+        return "text";
+    case BinaryLogMessage::TextContinuation:
+        return "text-continuation";
+    case BinaryLogMessage::PdReceived:
+        return "pd-received";
+    case BinaryLogMessage::MdRequestReceived:
+        return "md-request-received";
+    case BinaryLogMessage::MdNotificationReceived:
+        return "md-notification-received";
+    case BinaryLogMessage::MdConfirmReceived:
+        return "md-confirm-received";
+    case BinaryLogMessage::MdReplySent:
+        return "md-reply-sent";
+    case BinaryLogMessage::MdReplyQuerySent:
+        return "md-reply-query-sent";
+    case BinaryLogMessage::MdReplyReceived:
+        return "md-reply-received";
+    case BinaryLogMessage::MdReplyQueryReceived:
+        return "md-reply-query-received";
+    case BinaryLogMessage::PdSent:
+        return "pd-sent";
+    case BinaryLogMessage::PdPullRequested:
+        return "pd-pull-requested";
+    case BinaryLogMessage::MdRequestSent:
+        return "md-request-sent";
+    case BinaryLogMessage::MdNotificationSent:
+        return "md-notification-sent";
+    case BinaryLogMessage::MdConfirmSent:
+        return "md-confirm-sent";
+    }
+    return std::string();
+}
+
+// Placeholders take the arguments in order and then the data.
+std::string BinaryLogReader::format(const BinaryLogEntry &entry) const
+{
+    std::string result;
+    const std::string format = binary_log_format(entry.message);
+    std::size_t next = 0;
+    bool dataUsed = false;
+    for (std::size_t pos = 0; pos < format.size(); ++pos) {
+        if (format.compare(pos, 2, "{}") != 0) {
+            result.push_back(format[pos]);
+            continue;
+        }
+        ++pos;
+        if (next < entry.args.size()) {
+            const auto &arg = entry.args[next++];
+            switch (arg.type) {
+            case BinaryLogArgType::String:
+                result += arg.value < strings_.size() ? strings_[arg.value]
+                                                      : "<string " + std::to_string(arg.value) + ">";
+                break;
+            case BinaryLogArgType::Signed:
+                result += std::to_string(static_cast<std::int64_t>(arg.value));
+                break;
+            case BinaryLogArgType::Unsigned:
+            case BinaryLogArgType::None:
+                result += std::to_string(arg.value);
+                break;
+            }
+        } else if (!dataUsed) {
+            dataUsed = true;
+            result += entry.dataFormat == BinaryLogDataFormat::Hex
+                          ? to_hex(entry.data)
+                          : std::string(entry.data.begin(), entry.data.end());
+            if (entry.truncated) {
+                result += " ...";
+            }
+        }
+    }
+    return result;
+}
+
+}  // namespace trdp_sim
@@ -2,6 +2,7 @@
 
 #include <cctype>
 #include <fstream>
+#include <iomanip>
 #include <sstream>
 #include <stdexcept>
 
@@ -37,6 +38,18 @@ std::vector<std::uint8_t> from_hex(const std::string &hex)
     return data;
 }
 
+std::string normalize_keyword(const std::string &value)
+{
+    std::string lowered;
+    lowered.reserve(value.size());
+    for (unsigned char c : value) {
+        if (c != '-' && c != '_') {
+            lowered.push_back(static_cast<char>(std::tolower(c)));
+        }
+    }
+    return lowered;
+}
+
 std::vector<std::uint8_t> from_text(const std::string &text)
 {
     return std::vector<std::uint8_t>(text.begin(), text.end());
@@ -68,6 +81,18 @@ std::string payload_format_to_string(PayloadConfig::Format format)
     throw std::runtime_error("Unsupported payload format");
 }
 
+std::string to_hex(const std::vector<std::uint8_t> &data)
+{
+    std::ostringstream oss;
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        if (i != 0) {
+            oss << ' ';
+        }
+        oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(data[i]);
+    }
+    return oss.str();
+}
+
 PayloadConfig::Format payload_format_from_string(const std::string &value)
 {
     std::string lowered;
@@ -87,6 +112,172 @@ PayloadConfig::Format payload_format_from_string(const std::string &value)
     throw std::runtime_error("Unsupported payload format: " + value);
 }
 
+std::string pd_publisher_role_to_string(PdPublisherConfig::Role role)
+{
+    switch (role) {
+    case PdPublisherConfig::Role::Push:
+        return "push";
+    case PdPublisherConfig::Role::PullResponder:
+        return "pullResponder";
+    }
+    throw std::runtime_error("Unsupported PD publisher role");
+}
+
+PdPublisherConfig::Role pd_publisher_role_from_string(const std::string &value)
+{
+    const auto lowered = normalize_keyword(value);
+    if (lowered == "push") {
+        return PdPublisherConfig::Role::Push;
+    }
+    if (lowered == "pullresponder" || lowered == "responder") {
+        return PdPublisherConfig::Role::PullResponder;
+    }
+    throw std::runtime_error("Unsupported PD publisher role: " + value);
+}
+
+std::string pd_subscriber_role_to_string(PdSubscriberConfig::Role role)
+{
+    switch (role) {
+    case PdSubscriberConfig::Role::Push:
+        return "push";
+    case PdSubscriberConfig::Role::PullRequester:
+        return "pullRequester";
+    }
+    throw std::runtime_error("Unsupported PD subscriber role");
+}
+
+PdSubscriberConfig::Role pd_subscriber_role_from_string(const std::string &value)
+{
+    const auto lowered = normalize_keyword(value);
+    if (lowered == "push") {
+        return PdSubscriberConfig::Role::Push;
+    }
+    if (lowered == "pullrequester" || lowered == "requester") {
+        return PdSubscriberConfig::Role::PullRequester;
+    }
+    throw std::runtime_error("Unsupported PD subscriber role: " + value);
+}
+
+std::string md_transport_to_string(MdTransport transport)
+{
+    switch (transport) {
+    case MdTransport::Udp:
+        return "udp";
+    case MdTransport::Tcp:
+        return "tcp";
+    }
+    throw std::runtime_error("Unsupported MD transport");
+}
+
+MdTransport md_transport_from_string(const std::string &value)
+{
+    const auto lowered = normalize_keyword(value);
+    if (lowered == "udp") {
+        return MdTransport::Udp;
+    }
+    if (lowered == "tcp") {
+        return MdTransport::Tcp;
+    }
+    throw std::runtime_error("Unsupported MD transport: " + value);
+}
+
+std::string md_sender_type_to_string(MdSenderConfig::Type type)
+{
+    switch (type) {
+    case MdSenderConfig::Type::Request:
+        return "request";
+    case MdSenderConfig::Type::Notify:
+        return "notify";
+    }
+    throw std::runtime_error("Unsupported MD sender type");
+}
+
+MdSenderConfig::Type md_sender_type_from_string(const std::string &value)
+{
+    const auto lowered = normalize_keyword(value);
+    if (lowered == "request") {
+        return MdSenderConfig::Type::Request;
+    }
+    if (lowered == "notify" || lowered == "notification") {
+        return MdSenderConfig::Type::Notify;
+    }
+    throw std::runtime_error("Unsupported MD sender type: " + value);
+}
+
+std::string md_reply_type_to_string(MdListenerConfig::ReplyType type)
+{
+    switch (type) {
+    case MdListenerConfig::ReplyType::Reply:
+        return "reply";
+    case MdListenerConfig::ReplyType::Query:
+        return "query";
+    }
+    throw std::runtime_error("Unsupported MD reply type");
+}
+
+MdListenerConfig::ReplyType md_reply_type_from_string(const std::string &value)
+{
+    const auto lowered = normalize_keyword(value);
+    if (lowered == "reply") {
+        return MdListenerConfig::ReplyType::Reply;
+    }
+    if (lowered == "query" || lowered == "replyquery") {
+        return MdListenerConfig::ReplyType::Query;
+    }
+    throw std::runtime_error("Unsupported MD reply type: " + value);
+}
+
+std::string pd_send_mode_to_string(PdPublisherConfig::SendMode mode)
+{
+    switch (mode) {
+    case PdPublisherConfig::SendMode::Cyclic:
+        return "cyclic";
+    case PdPublisherConfig::SendMode::OnChange:
+        return "onChange";
+    case PdPublisherConfig::SendMode::Tsn:
+        return "tsn";
+    }
+    throw std::runtime_error("Unsupported PD send mode");
+}
+
+PdPublisherConfig::SendMode pd_send_mode_from_string(const std::string &value)
+{
+    const auto lowered = normalize_keyword(value);
+    if (lowered == "cyclic") {
+        return PdPublisherConfig::SendMode::Cyclic;
+    }
+    if (lowered == "onchange") {
+        return PdPublisherConfig::SendMode::OnChange;
+    }
+    if (lowered == "tsn") {
+        return PdPublisherConfig::SendMode::Tsn;
+    }
+    throw std::runtime_error("Unsupported PD send mode: " + value);
+}
+
+std::string pd_launch_clock_to_string(PdPublisherConfig::LaunchClock clock)
+{
+    switch (clock) {
+    case PdPublisherConfig::LaunchClock::Tai:
+        return "tai";
+    case PdPublisherConfig::LaunchClock::Monotonic:
+        return "monotonic";
+    }
+    throw std::runtime_error("Unsupported PD launch clock");
+}
+
+PdPublisherConfig::LaunchClock pd_launch_clock_from_string(const std::string &value)
+{
+    const auto lowered = normalize_keyword(value);
+    if (lowered == "tai") {
+        return PdPublisherConfig::LaunchClock::Tai;
+    }
+    if (lowered == "monotonic") {
+        return PdPublisherConfig::LaunchClock::Monotonic;
+    }
+    throw std::runtime_error("Unsupported PD launch clock: " + value);
+}
+
 std::vector<std::uint8_t> load_payload(const PayloadConfig &payload)
 {
     switch (payload.format) {
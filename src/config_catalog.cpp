@@ -0,0 +1,259 @@
+#include "trdp_simulator/config_catalog.hpp"
+
+#include "trdp_simulator/config_loader.hpp"
+#include "trdp_simulator/thread_monitor.hpp"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <exception>
+#include <set>
+#include <system_error>
+
+namespace trdp_sim {
+namespace {
+
+std::string lowercase(std::string_view value)
+{
+    std::string result(value);
+    std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return result;
+}
+
+// The catalogued name of a directory entry: the stem of a *.xml file, or empty for anything else.
+std::string catalog_name(const std::filesystem::path &filename)
+{
+    return filename.extension() == ".xml" ? filename.stem().string() : std::string();
+}
+
+}  // namespace
+
+const char *to_string(ConfigCatalogEntry::Status status)
+{
+    switch (status) {
+    case ConfigCatalogEntry::Status::Pending:
+        return "pending";
+    case ConfigCatalogEntry::Status::Valid:
+        return "valid";
+    case ConfigCatalogEntry::Status::Invalid:
+        return "invalid";
+    }
+    return "unknown";
+}
+
+ConfigCatalog::ConfigCatalog(std::filesystem::path directory, std::chrono::milliseconds rescanInterval)
+    : directory_(std::move(directory)), rescanInterval_(rescanInterval)
+{
+#ifdef __linux__
+    // Watching starts before the listing so that no change falls between the two.
+    inotifyFd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ >= 0 &&
+        ::inotify_add_watch(inotifyFd_, directory_.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE) <
+            0) {
+        ::close(inotifyFd_);
+        inotifyFd_ = -1;
+    }
+#endif
+    if (::pipe(wakePipe_) == 0) {
+        ::fcntl(wakePipe_[0], F_SETFD, FD_CLOEXEC);
+        ::fcntl(wakePipe_[1], F_SETFD, FD_CLOEXEC);
+    }
+
+    // Only the file metadata is read here; the documents are parsed by the worker.
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator(directory_, ec)) {
+        const auto name = catalog_name(entry.path().filename());
+        std::error_code statError;
+        if (name.empty() || !entry.is_regular_file(statError)) {
+            continue;
+        }
+        ConfigCatalogEntry catalogued;
+        catalogued.name = name;
+        catalogued.size = entry.file_size(statError);
+        catalogued.modified = entry.last_write_time(statError);
+        entries_.emplace(name, std::move(catalogued));
+    }
+    worker_ = std::thread(&ConfigCatalog::run, this);
+}
+
+ConfigCatalog::~ConfigCatalog()
+{
+    stopping_ = true;
+    if (wakePipe_[1] >= 0) {
+        const char wake = 0;
+        (void) ::write(wakePipe_[1], &wake, 1);
+    }
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    for (const int fd : {inotifyFd_, wakePipe_[0], wakePipe_[1]}) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+std::vector<ConfigCatalogEntry> ConfigCatalog::entries(std::string_view filter) const
+{
+    const auto needle = lowercase(filter);
+    std::vector<ConfigCatalogEntry> result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    result.reserve(entries_.size());
+    for (const auto &entry : entries_) {
+        if (needle.empty() || lowercase(entry.first).find(needle) != std::string::npos) {
+            result.push_back(entry.second);
+        }
+    }
+    return result;
+}
+
+std::vector<std::string> ConfigCatalog::names() const
+{
+    std::vector<std::string> result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    result.reserve(entries_.size());
+    for (const auto &entry : entries_) {
+        result.push_back(entry.first);
+    }
+    return result;
+}
+
+void ConfigCatalog::refresh(const std::string &name)
+{
+    index(name);
+}
+
+void ConfigCatalog::index(const std::string &name)
+{
+    const auto path = directory_ / (name + ".xml");
+    std::error_code ec;
+    const auto status = std::filesystem::status(path, ec);
+    if (ec || !std::filesystem::is_regular_file(status)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.erase(name);
+        return;
+    }
+    ConfigCatalogEntry entry;
+    entry.name = name;
+    entry.size = std::filesystem::file_size(path, ec);
+    entry.modified = std::filesystem::last_write_time(path, ec);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto existing = entries_.find(name);
+        if (existing != entries_.end() && existing->second.status != ConfigCatalogEntry::Status::Pending &&
+            existing->second.size == entry.size && existing->second.modified == entry.modified) {
+            return;
+        }
+    }
+
+    // Parsed without the lock, so listing never waits for a large document. A write that lands during the parse
+    // changes the modification time and is indexed again on its own event.
+    try {
+        const auto config = load_configuration(path.string());
+        entry.status = ConfigCatalogEntry::Status::Valid;
+        entry.pdPublishers = config.pdPublishers.size();
+        entry.pdSubscribers = config.pdSubscribers.size();
+        entry.mdSenders = config.mdSenders.size();
+        entry.mdListeners = config.mdListeners.size();
+    } catch (const std::exception &ex) {
+        entry.status = ConfigCatalogEntry::Status::Invalid;
+        entry.error = ex.what();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[name] = std::move(entry);
+}
+
+void ConfigCatalog::rescan()
+{
+    std::set<std::string> present;
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator(directory_, ec)) {
+        auto name = catalog_name(entry.path().filename());
+        if (!name.empty()) {
+            present.insert(std::move(name));
+        }
+    }
+    if (ec) {
+        // An unreachable directory keeps the last known catalog rather than emptying it.
+        return;
+    }
+    std::vector<std::string> removed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &entry : entries_) {
+            if (present.count(entry.first) == 0) {
+                removed.push_back(entry.first);
+            }
+        }
+    }
+    for (const auto &name : removed) {
+        index(name);
+    }
+    for (const auto &name : present) {
+        if (stopping_) {
+            return;
+        }
+        index(name);
+    }
+}
+
+void ConfigCatalog::handle_events()
+{
+#ifdef __linux__
+    alignas(inotify_event) std::array<char, 16384> buffer;
+    while (true) {
+        const auto length = ::read(inotifyFd_, buffer.data(), buffer.size());
+        if (length <= 0) {
+            return;
+        }
+        for (std::size_t offset = 0; offset < static_cast<std::size_t>(length);) {
+            const auto *event = reinterpret_cast<const inotify_event *>(buffer.data() + offset);
+            offset += sizeof(inotify_event) + event->len;
+            if ((event->mask & IN_Q_OVERFLOW) != 0) {
+                rescan();
+                continue;
+            }
+            const auto name = event->len != 0 ? catalog_name(event->name) : std::string();
+            if (!name.empty()) {
+                index(name);
+            }
+        }
+    }
+#endif
+}
+
+void ConfigCatalog::run()
+{
+    using clock = std::chrono::steady_clock;
+    set_thread_name("config-catalog");
+    rescan();
+    auto nextRescan = clock::now() + rescanInterval_;
+    while (!stopping_) {
+        // A steady stream of events must not hold off the rescan, so the timeout counts down to a fixed time.
+        const auto remaining =
+            std::chrono::duration_cast<std::chrono::milliseconds>(nextRescan - clock::now()).count();
+        std::array<pollfd, 2> fds{{{wakePipe_[0], POLLIN, 0}, {inotifyFd_, POLLIN, 0}}};
+        const int ready = ::poll(fds.data(), fds.size(), static_cast<int>(std::max<std::int64_t>(remaining, 0)));
+        if (stopping_) {
+            return;
+        }
+        if (ready > 0 && (fds[1].revents & POLLIN) != 0) {
+            handle_events();
+        }
+        if (clock::now() >= nextRescan) {
+            rescan();
+            nextRescan = clock::now() + rescanInterval_;
+        }
+    }
+}
+
+}  // namespace trdp_sim
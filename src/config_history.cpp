@@ -0,0 +1,523 @@
+#include "trdp_simulator/config_history.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+namespace trdp_sim {
+namespace {
+
+// Chunks end at a line whose hash has its top kBoundaryBits clear, giving chunks of about 64 lines, but never
+// before kMinChunkSize and always by kMaxChunkSize, inside a line if need be, so that one long line cannot produce
+// a huge object.
+constexpr unsigned kBoundaryBits = 6;
+constexpr std::size_t kMinChunkSize = 512;
+constexpr std::size_t kMaxChunkSize = 256 * 1024;
+// Largest line-by-line comparison table for one changed region; bigger regions are reported as replaced whole.
+constexpr std::size_t kMaxDiffCells = 4 * 1024 * 1024;
+
+class Sha256 {
+public:
+    void update(const char *data, std::size_t size)
+    {
+        length_ += size;
+        while (size != 0) {
+            const auto count = std::min(size, block_.size() - used_);
+            std::copy(data, data + count, block_.begin() + static_cast<std::ptrdiff_t>(used_));
+            used_ += count;
+            data += count;
+            size -= count;
+            if (used_ == block_.size()) {
+                transform();
+                used_ = 0;
+            }
+        }
+    }
+
+    std::string finish()
+    {
+        const std::uint64_t bits = length_ * 8U;
+        const char pad = static_cast<char>(0x80);
+        update(&pad, 1);
+        const char zero = 0;
+        while (used_ != 56U) {
+            update(&zero, 1);
+        }
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            const char byte = static_cast<char>((bits >> shift) & 0xFFU);
+            update(&byte, 1);
+        }
+        std::string hex;
+        hex.reserve(64);
+        static const char *digits = "0123456789abcdef";
+        for (const auto word : state_) {
+            for (int shift = 28; shift >= 0; shift -= 4) {
+                hex.push_back(digits[(word >> shift) & 0xFU]);
+            }
+        }
+        return hex;
+    }
+
+private:
+    static std::uint32_t rotate(std::uint32_t value, int bits) { return (value >> bits) | (value << (32 - bits)); }
+
+    void transform()
+    {
+        static constexpr std::array<std::uint32_t, 64> k{
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+        std::array<std::uint32_t, 64> w{};
+        for (std::size_t i = 0; i < 16; ++i) {
+            w[i] = static_cast<std::uint32_t>(static_cast<unsigned char>(block_[i * 4]) << 24U) |
+                   static_cast<std::uint32_t>(static_cast<unsigned char>(block_[i * 4 + 1]) << 16U) |
+                   static_cast<std::uint32_t>(static_cast<unsigned char>(block_[i * 4 + 2]) << 8U) |
+                   static_cast<std::uint32_t>(static_cast<unsigned char>(block_[i * 4 + 3]));
+        }
+        for (std::size_t i = 16; i < 64; ++i) {
+            const auto s0 = rotate(w[i - 15], 7) ^ rotate(w[i - 15], 18) ^ (w[i - 15] >> 3U);
+            const auto s1 = rotate(w[i - 2], 17) ^ rotate(w[i - 2], 19) ^ (w[i - 2] >> 10U);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        auto [a, b, c, d, e, f, g, h] = state_;
+        for (std::size_t i = 0; i < 64; ++i) {
+            const auto s1 = rotate(e, 6) ^ rotate(e, 11) ^ rotate(e, 25);
+            const auto choice = (e & f) ^ (~e & g);
+            const auto t1 = h + s1 + choice + k[i] + w[i];
+            const auto s0 = rotate(a, 2) ^ rotate(a, 13) ^ rotate(a, 22);
+            const auto majority = (a & b) ^ (a & c) ^ (b & c);
+            const auto t2 = s0 + majority;
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        const std::array<std::uint32_t, 8> result{a, b, c, d, e, f, g, h};
+        for (std::size_t i = 0; i < 8; ++i) {
+            state_[i] += result[i];
+        }
+    }
+
+    std::array<std::uint32_t, 8> state_{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    std::array<char, 64> block_{};
+    std::size_t used_{0};
+    std::uint64_t length_{0};
+};
+
+std::string sha256(const std::string &data)
+{
+    Sha256 hash;
+    hash.update(data.data(), data.size());
+    return hash.finish();
+}
+
+// FNV-1a of the current line, including its newline.
+constexpr std::uint64_t kLineHashSeed = 14695981039346656037ULL;
+
+std::uint64_t update_line_hash(std::uint64_t hash, char ch)
+{
+    return (hash ^ static_cast<unsigned char>(ch)) * 1099511628211ULL;
+}
+
+bool is_boundary(std::uint64_t lineHash)
+{
+    // The low bits of FNV-1a only depend on the low bits of the input, so the decision uses the top ones.
+    return (lineHash >> (64U - kBoundaryBits)) == 0;
+}
+
+std::vector<std::string_view> split_lines(std::string_view text)
+{
+    std::vector<std::string_view> lines;
+    while (!text.empty()) {
+        const auto end = text.find('\n');
+        const auto length = end == std::string_view::npos ? text.size() : end + 1U;
+        lines.push_back(text.substr(0, length));
+        text.remove_prefix(length);
+    }
+    return lines;
+}
+
+std::string read_file(const std::filesystem::path &path)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        throw std::runtime_error("Unable to read " + path.string());
+    }
+    return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+ConfigVersion parse_manifest(const std::string &text, std::uint32_t number)
+{
+    ConfigVersion version;
+    version.number = number;
+    std::istringstream stream(text);
+    std::string line;
+    bool chunks = false;
+    while (std::getline(stream, line)) {
+        if (chunks) {
+            ConfigVersion::Chunk chunk;
+            std::istringstream fields(line);
+            if (fields >> chunk.hash >> chunk.size >> chunk.lines) {
+                version.chunks.push_back(std::move(chunk));
+            }
+            continue;
+        }
+        const auto space = line.find(' ');
+        const auto key = line.substr(0, space);
+        const auto value = space == std::string::npos ? std::string() : line.substr(space + 1U);
+        if (key == "created") {
+            version.created = std::stoll(value);
+        } else if (key == "size") {
+            version.size = std::stoull(value);
+        } else if (key == "sha256") {
+            version.digest = value;
+        } else if (key == "label") {
+            version.label = value;
+        } else if (key == "chunks") {
+            chunks = true;
+        }
+    }
+    return version;
+}
+
+std::string format_manifest(const ConfigVersion &version)
+{
+    std::ostringstream stream;
+    stream << "trdp-simulator-config-version 1\n"
+           << "created " << version.created << '\n'
+           << "size " << version.size << '\n'
+           << "sha256 " << version.digest << '\n';
+    if (!version.label.empty()) {
+        stream << "label " << version.label << '\n';
+    }
+    stream << "chunks\n";
+    for (const auto &chunk : version.chunks) {
+        stream << chunk.hash << ' ' << chunk.size << ' ' << chunk.lines << '\n';
+    }
+    return stream.str();
+}
+
+// Appends hunks for the changed lines between `from` and `to`, which start at the given 1-based line numbers.
+void append_line_diff(std::ostringstream &out, const std::vector<std::string_view> &from,
+                      const std::vector<std::string_view> &to, std::size_t fromLine, std::size_t toLine)
+{
+    const auto emit = [&out](std::size_t fromStart, std::size_t fromCount, std::size_t toStart, std::size_t toCount,
+                             const std::string_view *removed, const std::string_view *added) {
+        out << "@@ -" << fromStart << ',' << fromCount << " +" << toStart << ',' << toCount << " @@\n";
+        for (std::size_t i = 0; i < fromCount; ++i) {
+            out << '-' << removed[i] << (removed[i].empty() || removed[i].back() != '\n' ? "\n" : "");
+        }
+        for (std::size_t i = 0; i < toCount; ++i) {
+            out << '+' << added[i] << (added[i].empty() || added[i].back() != '\n' ? "\n" : "");
+        }
+    };
+    const auto n = from.size();
+    const auto m = to.size();
+    if (n == 0 && m == 0) {
+        return;
+    }
+    if ((n + 1U) * (m + 1U) > kMaxDiffCells) {
+        emit(fromLine, n, toLine, m, from.data(), to.data());
+        return;
+    }
+    // Longest common subsequence of lines, filled from the end so the walk below runs forwards.
+    std::vector<std::uint32_t> table((n + 1U) * (m + 1U), 0);
+    const auto at = [m](std::size_t i, std::size_t j) { return i * (m + 1U) + j; };
+    for (std::size_t i = n; i-- > 0;) {
+        for (std::size_t j = m; j-- > 0;) {
+            table[at(i, j)] = from[i] == to[j] ? table[at(i + 1U, j + 1U)] + 1U
+                                               : std::max(table[at(i + 1U, j)], table[at(i, j + 1U)]);
+        }
+    }
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < n || j < m) {
+        if (i < n && j < m && from[i] == to[j]) {
+            ++i;
+            ++j;
+            continue;
+        }
+        const auto hunkFrom = i;
+        const auto hunkTo = j;
+        while ((i < n || j < m) && !(i < n && j < m && from[i] == to[j])) {
+            if (j == m || (i < n && table[at(i + 1U, j)] >= table[at(i, j + 1U)])) {
+                ++i;
+            } else {
+                ++j;
+            }
+        }
+        emit(fromLine + hunkFrom, i - hunkFrom, toLine + hunkTo, j - hunkTo, from.data() + hunkFrom,
+             to.data() + hunkTo);
+    }
+}
+
+}  // namespace
+
+void write_file_atomically(const std::filesystem::path &target, const std::string &contents)
+{
+    auto temporary = target;
+    temporary += ".tmp-" + std::to_string(::getpid());
+    {
+        std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+        stream << contents;
+        stream.flush();
+        if (!stream) {
+            std::error_code ignored;
+            std::filesystem::remove(temporary, ignored);
+            throw std::runtime_error("Unable to write " + target.string());
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temporary, target, ec);
+    if (ec) {
+        std::error_code ignored;
+        std::filesystem::remove(temporary, ignored);
+        throw std::runtime_error("Unable to write " + target.string() + ": " + ec.message());
+    }
+}
+
+ConfigHistory::ConfigHistory(std::filesystem::path directory) : directory_(std::move(directory)) {}
+
+std::filesystem::path ConfigHistory::object_path(const std::string &hash) const
+{
+    return directory_ / "objects" / hash.substr(0, 2) / hash.substr(2);
+}
+
+std::filesystem::path ConfigHistory::versions_directory(const std::string &name) const
+{
+    return directory_ / "versions" / name;
+}
+
+std::string ConfigHistory::read_object(const std::string &hash) const
+{
+    return read_file(object_path(hash));
+}
+
+void ConfigHistory::write_object(const std::string &hash, const std::string &contents) const
+{
+    const auto path = object_path(hash);
+    std::error_code ec;
+    if (std::filesystem::exists(path, ec)) {
+        return;
+    }
+    std::filesystem::create_directories(path.parent_path(), ec);
+    write_file_atomically(path, contents);
+}
+
+ConfigVersion ConfigHistory::record(const std::string &name, const std::filesystem::path &path,
+                                    const std::string &label)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        throw std::runtime_error("Unable to read " + path.string());
+    }
+
+    // The document is read in blocks, so neither a large upload nor one very long line is held in memory whole.
+    ConfigVersion version;
+    version.label = label;
+    // The manifest holds one field per line.
+    std::replace_if(version.label.begin(), version.label.end(), [](char c) { return c == '\n' || c == '\r'; }, ' ');
+    Sha256 document;
+    std::string chunk;
+    // Lines are counted in the chunk holding their end, so a line split by kMaxChunkSize counts once.
+    std::size_t chunkLines = 0;
+    const auto flush = [&]() {
+        if (chunk.empty()) {
+            return;
+        }
+        const auto hash = sha256(chunk);
+        write_object(hash, chunk);
+        version.chunks.push_back({hash, chunk.size(), chunkLines});
+        chunk.clear();
+        chunkLines = 0;
+    };
+    std::vector<char> buffer(64 * 1024);
+    std::uint64_t lineHash = kLineHashSeed;
+    while (stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || stream.gcount() > 0) {
+        const auto count = static_cast<std::size_t>(stream.gcount());
+        document.update(buffer.data(), count);
+        version.size += count;
+        for (std::size_t index = 0; index < count; ++index) {
+            const char ch = buffer[index];
+            chunk.push_back(ch);
+            lineHash = update_line_hash(lineHash, ch);
+            if (ch == '\n') {
+                ++chunkLines;
+                const bool boundary = is_boundary(lineHash);
+                lineHash = kLineHashSeed;
+                if (chunk.size() >= kMinChunkSize && boundary) {
+                    flush();
+                    continue;
+                }
+            }
+            if (chunk.size() >= kMaxChunkSize) {
+                flush();
+            }
+        }
+    }
+    if (!chunk.empty() && chunk.back() != '\n') {
+        ++chunkLines;
+    }
+    flush();
+    version.digest = document.finish();
+
+    const auto existing = versions(name);
+    if (!existing.empty() && existing.back().digest == version.digest && label.empty()) {
+        return existing.back();
+    }
+    version.number = existing.empty() ? 1U : existing.back().number + 1U;
+    version.created = std::chrono::duration_cast<std::chrono::seconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+    const auto directory = versions_directory(name);
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    write_file_atomically(directory / std::to_string(version.number), format_manifest(version));
+    return version;
+}
+
+std::vector<ConfigVersion> ConfigHistory::versions(const std::string &name) const
+{
+    std::vector<ConfigVersion> result;
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator(versions_directory(name), ec)) {
+        const auto filename = entry.path().filename().string();
+        if (filename.empty() || !std::all_of(filename.begin(), filename.end(), [](unsigned char c) {
+                return std::isdigit(c);
+            })) {
+            continue;
+        }
+        result.push_back(parse_manifest(read_file(entry.path()), static_cast<std::uint32_t>(std::stoul(filename))));
+    }
+    std::sort(result.begin(), result.end(), [](const ConfigVersion &lhs, const ConfigVersion &rhs) {
+        return lhs.number < rhs.number;
+    });
+    return result;
+}
+
+ConfigVersion ConfigHistory::version(const std::string &name, std::uint32_t number) const
+{
+    const auto path = versions_directory(name) / std::to_string(number);
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec)) {
+        throw std::runtime_error("Configuration " + name + " has no version " + std::to_string(number));
+    }
+    return parse_manifest(read_file(path), number);
+}
+
+std::string ConfigHistory::load(const ConfigVersion &version) const
+{
+    std::string document;
+    document.reserve(static_cast<std::size_t>(version.size));
+    for (const auto &chunk : version.chunks) {
+        document += read_object(chunk.hash);
+    }
+    if (sha256(document) != version.digest) {
+        throw std::runtime_error("Version " + std::to_string(version.number) + " is damaged: content hash mismatch");
+    }
+    return document;
+}
+
+void ConfigHistory::restore(const ConfigVersion &version, const std::filesystem::path &target) const
+{
+    write_file_atomically(target, load(version));
+}
+
+std::string ConfigHistory::diff(const ConfigVersion &from, const ConfigVersion &to) const
+{
+    const auto &a = from.chunks;
+    const auto &b = to.chunks;
+    const auto n = a.size();
+    const auto m = b.size();
+
+    // Chunks are aligned by hash first; only the runs between shared chunks are read and compared by line.
+    std::vector<std::pair<std::size_t, std::size_t>> matches;
+    if ((n + 1U) * (m + 1U) <= kMaxDiffCells) {
+        std::vector<std::uint32_t> table((n + 1U) * (m + 1U), 0);
+        const auto at = [m](std::size_t i, std::size_t j) { return i * (m + 1U) + j; };
+        for (std::size_t i = n; i-- > 0;) {
+            for (std::size_t j = m; j-- > 0;) {
+                table[at(i, j)] = a[i].hash == b[j].hash ? table[at(i + 1U, j + 1U)] + 1U
+                                                         : std::max(table[at(i + 1U, j)], table[at(i, j + 1U)]);
+            }
+        }
+        for (std::size_t i = 0, j = 0; i < n && j < m;) {
+            if (a[i].hash == b[j].hash) {
+                matches.emplace_back(i++, j++);
+            } else if (table[at(i + 1U, j)] >= table[at(i, j + 1U)]) {
+                ++i;
+            } else {
+                ++j;
+            }
+        }
+    } else {
+        // Too many chunks to align: keep the shared prefix and suffix only.
+        std::size_t prefix = 0;
+        while (prefix < n && prefix < m && a[prefix].hash == b[prefix].hash) {
+            matches.emplace_back(prefix, prefix);
+            ++prefix;
+        }
+        std::size_t suffix = 0;
+        while (suffix < n - prefix && suffix < m - prefix && a[n - 1U - suffix].hash == b[m - 1U - suffix].hash) {
+            ++suffix;
+        }
+        for (std::size_t k = suffix; k-- > 0;) {
+            matches.emplace_back(n - 1U - k, m - 1U - k);
+        }
+    }
+    matches.emplace_back(n, m);
+
+    std::ostringstream out;
+    std::size_t i = 0;
+    std::size_t j = 0;
+    std::size_t fromLine = 1;
+    std::size_t toLine = 1;
+    for (const auto &match : matches) {
+        if (match.first > i || match.second > j) {
+            std::string removedText;
+            std::string addedText;
+            std::size_t removedLines = 0;
+            std::size_t addedLines = 0;
+            for (; i < match.first; ++i) {
+                removedText += read_object(a[i].hash);
+                removedLines += a[i].lines;
+            }
+            for (; j < match.second; ++j) {
+                addedText += read_object(b[j].hash);
+                addedLines += b[j].lines;
+            }
+            append_line_diff(out, split_lines(removedText), split_lines(addedText), fromLine, toLine);
+            fromLine += removedLines;
+            toLine += addedLines;
+        }
+        if (match.first < n) {
+            fromLine += a[match.first].lines;
+            toLine += b[match.second].lines;
+        }
+        i = match.first + 1U;
+        j = match.second + 1U;
+    }
+    return out.str();
+}
+
+}  // namespace trdp_sim
@@ -2,7 +2,9 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstdlib>
 #include <stdexcept>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "tinyxml2.h"
@@ -71,15 +73,30 @@ PdPublisherConfig load_pd_publisher(const tinyxml2::XMLElement &element)
 {
     PdPublisherConfig config;
     config.name = require_attribute(element, "name");
+    config.session = optional_uint_attribute(element, "session");
     config.comId = optional_uint_attribute(element, "comId");
     config.datasetId = optional_uint_attribute(element, "datasetId");
-    config.etbTopoCount = static_cast<std::uint16_t>(optional_uint_attribute(element, "etbTopoCount"));
-    config.opTrnTopoCount = static_cast<std::uint16_t>(optional_uint_attribute(element, "opTrnTopoCount"));
+    config.etbTopoCount = optional_uint_attribute(element, "etbTopoCount");
+    config.opTrnTopoCount = optional_uint_attribute(element, "opTrnTopoCount");
     config.sourceIp = optional_attribute(element, "sourceIp");
     config.destIp = optional_attribute(element, "destIp");
     config.cycleTimeMs = optional_uint_attribute(element, "cycleTimeMs", 1000);
     config.redundancyGroup = optional_uint_attribute(element, "redundancyGroup");
     config.useSequenceCounter = optional_bool_attribute(element, "useSequenceCounter");
+    if (const char *role = element.Attribute("role")) {
+        config.role = pd_publisher_role_from_string(role);
+    }
+    if (const char *mode = element.Attribute("mode")) {
+        config.sendMode = pd_send_mode_from_string(mode);
+    }
+    config.minIntervalMs = optional_uint_attribute(element, "minIntervalMs");
+    config.keepAliveMs = optional_uint_attribute(element, "keepAliveMs");
+    if (const char *clock = element.Attribute("launchClock")) {
+        config.launchClock = pd_launch_clock_from_string(clock);
+    }
+    config.launchOffsetUs = optional_uint_attribute(element, "launchOffsetUs");
+    config.launchLeadUs = optional_uint_attribute(element, "launchLeadUs", 500);
+    config.socketPriority = optional_uint_attribute(element, "priority");
     const auto *payloadElement = element.FirstChildElement("payload");
     if (payloadElement) {
         config.payload = load_payload_element(*payloadElement);
@@ -91,13 +108,29 @@ PdSubscriberConfig load_pd_subscriber(const tinyxml2::XMLElement &element)
 {
     PdSubscriberConfig config;
     config.name = require_attribute(element, "name");
+    config.session = optional_uint_attribute(element, "session");
     config.comId = optional_uint_attribute(element, "comId");
-    config.etbTopoCount = static_cast<std::uint16_t>(optional_uint_attribute(element, "etbTopoCount"));
-    config.opTrnTopoCount = static_cast<std::uint16_t>(optional_uint_attribute(element, "opTrnTopoCount"));
+    config.etbTopoCount = optional_uint_attribute(element, "etbTopoCount");
+    config.opTrnTopoCount = optional_uint_attribute(element, "opTrnTopoCount");
     config.sourceIp = optional_attribute(element, "sourceIp");
     config.destIp = optional_attribute(element, "destIp");
     config.timeoutMs = optional_uint_attribute(element, "timeoutMs");
     config.enableComIdFiltering = optional_bool_attribute(element, "comIdFilter", true);
+    if (const char *role = element.Attribute("role")) {
+        config.role = pd_subscriber_role_from_string(role);
+    }
+    config.requestComId = optional_uint_attribute(element, "requestComId", config.comId);
+    config.pullIntervalMs = optional_uint_attribute(element, "pullIntervalMs");
+    return config;
+}
+
+PdRedundancyGroupConfig load_pd_redundancy_group(const tinyxml2::XMLElement &element)
+{
+    PdRedundancyGroupConfig config;
+    config.id = optional_uint_attribute(element, "id");
+    config.leader = optional_bool_attribute(element, "leader", true);
+    config.partnerId = optional_uint_attribute(element, "partner");
+    config.failoverIntervalMs = optional_uint_attribute(element, "failoverIntervalMs");
     return config;
 }
 
@@ -105,6 +138,7 @@ MdSenderConfig load_md_sender(const tinyxml2::XMLElement &element)
 {
     MdSenderConfig config;
     config.name = require_attribute(element, "name");
+    config.session = optional_uint_attribute(element, "session");
     config.comId = optional_uint_attribute(element, "comId");
     config.replyComId = optional_uint_attribute(element, "replyComId");
     config.sourceIp = optional_attribute(element, "sourceIp");
@@ -112,6 +146,12 @@ MdSenderConfig load_md_sender(const tinyxml2::XMLElement &element)
     config.cycleTimeMs = optional_uint_attribute(element, "cycleTimeMs");
     config.replyTimeoutMs = optional_uint_attribute(element, "replyTimeoutMs", 1000);
     config.expectReply = optional_bool_attribute(element, "expectReply");
+    if (const char *transport = element.Attribute("transport")) {
+        config.transport = md_transport_from_string(transport);
+    }
+    if (const char *type = element.Attribute("type")) {
+        config.type = md_sender_type_from_string(type);
+    }
     const auto *payloadElement = element.FirstChildElement("payload");
     if (payloadElement) {
         config.payload = load_payload_element(*payloadElement);
@@ -123,10 +163,18 @@ MdListenerConfig load_md_listener(const tinyxml2::XMLElement &element)
 {
     MdListenerConfig config;
     config.name = require_attribute(element, "name");
+    config.session = optional_uint_attribute(element, "session");
     config.comId = optional_uint_attribute(element, "comId");
     config.sourceIp = optional_attribute(element, "sourceIp");
     config.destIp = optional_attribute(element, "destIp");
+    if (const char *transport = element.Attribute("transport")) {
+        config.transport = md_transport_from_string(transport);
+    }
     config.autoReply = optional_bool_attribute(element, "autoReply");
+    if (const char *replyType = element.Attribute("replyType")) {
+        config.replyType = md_reply_type_from_string(replyType);
+    }
+    config.confirmTimeoutMs = optional_uint_attribute(element, "confirmTimeoutMs", 1000);
     const auto *payloadElement = element.FirstChildElement("replyPayload");
     if (payloadElement) {
         config.replyPayload = load_payload_element(*payloadElement);
@@ -134,6 +182,24 @@ MdListenerConfig load_md_listener(const tinyxml2::XMLElement &element)
     return config;
 }
 
+bool is_multicast(const std::string &address)
+{
+    const auto firstOctet = std::strtoul(address.c_str(), nullptr, 10);
+    return firstOctet >= 224U && firstOctet <= 239U;
+}
+
+SessionConfig load_session(const tinyxml2::XMLElement &element)
+{
+    SessionConfig config;
+    config.hostIp = optional_attribute(element, "hostIp");
+    config.pdPort = static_cast<std::uint16_t>(optional_uint_attribute(element, "pdPort"));
+    config.mdPort = static_cast<std::uint16_t>(optional_uint_attribute(element, "mdPort"));
+    if (element.Attribute("cpu")) {
+        config.cpu = static_cast<int>(optional_uint_attribute(element, "cpu"));
+    }
+    return config;
+}
+
 LogLevel parse_log_level(const std::string &value)
 {
     std::string lowered(value);
@@ -162,16 +228,72 @@ SimulatorConfig load_configuration_from_document(tinyxml2::XMLDocument &doc)
         config.network.gatewayIp = optional_attribute(*networkElement, "gateway");
         config.network.vlanId = static_cast<std::uint16_t>(optional_uint_attribute(*networkElement, "vlanId"));
         config.network.ttl = static_cast<std::uint8_t>(optional_uint_attribute(*networkElement, "ttl", 64));
+        config.network.pdPort = static_cast<std::uint16_t>(optional_uint_attribute(*networkElement, "pdPort"));
+        config.network.mdPort = static_cast<std::uint16_t>(optional_uint_attribute(*networkElement, "mdPort"));
+        config.network.mdTcpIdleTimeoutMs =
+            optional_uint_attribute(*networkElement, "mdTcpIdleTimeoutMs", config.network.mdTcpIdleTimeoutMs);
+        config.network.mdMaxSessions =
+            optional_uint_attribute(*networkElement, "mdMaxSessions", config.network.mdMaxSessions);
+        if (config.network.mdMaxSessions == 0) {
+            throw std::runtime_error("Attribute 'mdMaxSessions' in element 'network' must be greater than 0");
+        }
+        for (auto *session = networkElement->FirstChildElement("session"); session; session = session->NextSiblingElement("session")) {
+            config.network.sessions.emplace_back(load_session(*session));
+        }
+        if (config.network.sessions.empty()) {
+            const auto count = optional_uint_attribute(*networkElement, "sessions", 1);
+            if (count == 0 || count > 64U) {
+                throw std::runtime_error("Attribute 'sessions' in element 'network' must be between 1 and 64");
+            }
+            config.network.sessions.resize(count);
+        }
+    }
+
+    if (const auto *coordinatorElement = root->FirstChildElement("coordinator")) {
+        auto &coordinator = config.coordinator;
+        coordinator.enabled = optional_bool_attribute(*coordinatorElement, "enabled", true);
+        coordinator.listen = optional_attribute(*coordinatorElement, "listen", coordinator.listen);
+        coordinator.launchWorkers = optional_bool_attribute(*coordinatorElement, "launchWorkers", true);
+        coordinator.workerBinary = optional_attribute(*coordinatorElement, "workerBinary");
+        coordinator.startDelayMs = optional_uint_attribute(*coordinatorElement, "startDelayMs", coordinator.startDelayMs);
+        coordinator.connectTimeoutMs =
+            optional_uint_attribute(*coordinatorElement, "connectTimeoutMs", coordinator.connectTimeoutMs);
+        coordinator.reportIntervalMs =
+            optional_uint_attribute(*coordinatorElement, "reportIntervalMs", coordinator.reportIntervalMs);
     }
 
     if (const auto *loggingElement = root->FirstChildElement("logging")) {
         config.logging.enableConsole = optional_bool_attribute(*loggingElement, "console", true);
         config.logging.filePath = optional_attribute(*loggingElement, "file");
+        config.logging.rotateSizeMb = optional_uint_attribute(*loggingElement, "rotateSizeMb");
+        config.logging.rotateIntervalMinutes = optional_uint_attribute(*loggingElement, "rotateIntervalMinutes");
+        config.logging.keepFiles = optional_uint_attribute(*loggingElement, "keepFiles", config.logging.keepFiles);
+        config.logging.compressRotated = optional_bool_attribute(*loggingElement, "compress", true);
+        config.logging.rateLimit.messagesPerSecond = optional_uint_attribute(*loggingElement, "rateLimitPerSecond");
+        config.logging.rateLimit.burst = optional_uint_attribute(*loggingElement, "rateLimitBurst");
+        for (auto *overrideElement = loggingElement->FirstChildElement("override"); overrideElement;
+             overrideElement = overrideElement->NextSiblingElement("override")) {
+            LogOverride entry;
+            entry.name = optional_attribute(*overrideElement, "name");
+            entry.comId = optional_uint_attribute(*overrideElement, "comId");
+            entry.category = optional_attribute(*overrideElement, "category");
+            entry.level = parse_log_level(require_attribute(*overrideElement, "level"));
+            config.logging.overrides.push_back(std::move(entry));
+        }
+        config.logging.binaryFilePath = optional_attribute(*loggingElement, "binaryFile");
+        config.logging.binaryCapacityMb =
+            optional_uint_attribute(*loggingElement, "binaryCapacityMb", config.logging.binaryCapacityMb);
         if (const char *level = loggingElement->Attribute("level")) {
             config.logging.level = parse_log_level(level);
         }
     }
 
+    if (const auto *watchdogElement = root->FirstChildElement("watchdog")) {
+        config.watchdog.enabled = optional_bool_attribute(*watchdogElement, "enabled", true);
+        config.watchdog.stallThresholdMs =
+            optional_uint_attribute(*watchdogElement, "stallThresholdMs", config.watchdog.stallThresholdMs);
+    }
+
     if (const auto *pdElement = root->FirstChildElement("pd")) {
         for (auto *publisher = pdElement->FirstChildElement("publisher"); publisher; publisher = publisher->NextSiblingElement("publisher")) {
             config.pdPublishers.emplace_back(load_pd_publisher(*publisher));
@@ -179,6 +301,9 @@ SimulatorConfig load_configuration_from_document(tinyxml2::XMLDocument &doc)
         for (auto *subscriber = pdElement->FirstChildElement("subscriber"); subscriber; subscriber = subscriber->NextSiblingElement("subscriber")) {
             config.pdSubscribers.emplace_back(load_pd_subscriber(*subscriber));
         }
+        for (auto *group = pdElement->FirstChildElement("redundancyGroup"); group; group = group->NextSiblingElement("redundancyGroup")) {
+            config.pdRedundancyGroups.emplace_back(load_pd_redundancy_group(*group));
+        }
     }
 
     if (const auto *mdElement = root->FirstChildElement("md")) {
@@ -215,22 +340,157 @@ void validate_configuration(const SimulatorConfig &config)
     ensure_unique(config.mdSenders, "MD sender");
     ensure_unique(config.mdListeners, "MD listener");
 
+    const std::size_t sessionCount = std::max<std::size_t>(config.network.sessions.size(), 1U);
+    auto ensure_session = [sessionCount](const auto &items, const char *kind) {
+        for (const auto &item : items) {
+            if (item.session > sessionCount) {
+                throw std::runtime_error(std::string(kind) + " '" + item.name + "' references session " +
+                                         std::to_string(item.session) + " but only " +
+                                         std::to_string(sessionCount) + " are configured");
+            }
+        }
+    };
+
+    ensure_session(config.pdPublishers, "PD publisher");
+    ensure_session(config.pdSubscribers, "PD subscriber");
+    ensure_session(config.mdSenders, "MD sender");
+    ensure_session(config.mdListeners, "MD listener");
+
+    if (config.coordinator.enabled) {
+        const auto &listen = config.coordinator.listen;
+        if (listen.rfind("unix:", 0) != 0 && listen.rfind("tcp:", 0) != 0) {
+            throw std::runtime_error("Coordinator listen address '" + listen + "' must start with unix: or tcp:");
+        }
+        if (config.coordinator.reportIntervalMs == 0) {
+            throw std::runtime_error("Coordinator reportIntervalMs must be > 0");
+        }
+    }
+
+    for (const auto &entry : config.logging.overrides) {
+        const int selectors = (entry.name.empty() ? 0 : 1) + (entry.comId == 0 ? 0 : 1) +
+                              (entry.category.empty() ? 0 : 1);
+        if (selectors != 1) {
+            throw std::runtime_error("Log override must select exactly one of name, comId or category");
+        }
+        if (!entry.category.empty() && entry.category != "pd" && entry.category != "md") {
+            throw std::runtime_error("Unknown log override category '" + entry.category + "' (expected pd or md)");
+        }
+    }
+
+    if (!config.logging.binaryFilePath.empty() && config.logging.binaryCapacityMb == 0) {
+        throw std::runtime_error("Logging binaryCapacityMb must be > 0");
+    }
+
+    if (config.watchdog.enabled && config.watchdog.stallThresholdMs == 0) {
+        throw std::runtime_error("Watchdog stallThresholdMs must be > 0");
+    }
+
     for (const auto &publisher : config.pdPublishers) {
+        if (publisher.role == PdPublisherConfig::Role::PullResponder) {
+            if (publisher.sendMode != PdPublisherConfig::SendMode::Cyclic) {
+                throw std::runtime_error("PD pull responder '" + publisher.name + "' must use the cyclic send mode");
+            }
+            continue;
+        }
         if (publisher.cycleTimeMs == 0) {
             throw std::runtime_error("PD publisher '" + publisher.name + "' must specify cycleTimeMs > 0");
         }
+        if (publisher.keepAliveMs != 0 && publisher.keepAliveMs < publisher.minIntervalMs) {
+            throw std::runtime_error("PD publisher '" + publisher.name + "' keepAliveMs must not be below minIntervalMs");
+        }
+        if (publisher.sendMode == PdPublisherConfig::SendMode::Tsn) {
+            const auto cycleUs = static_cast<std::uint64_t>(publisher.cycleTimeMs) * 1000U;
+            if (publisher.launchOffsetUs >= cycleUs || publisher.launchLeadUs >= cycleUs) {
+                throw std::runtime_error("PD publisher '" + publisher.name +
+                                         "' launchOffsetUs and launchLeadUs must be below the cycle time");
+            }
+            if (publisher.destIp.empty()) {
+                throw std::runtime_error("TSN PD publisher '" + publisher.name + "' must specify destIp");
+            }
+        }
+    }
+
+    for (const auto &subscriber : config.pdSubscribers) {
+        if (subscriber.role != PdSubscriberConfig::Role::PullRequester) {
+            continue;
+        }
+        if (subscriber.pullIntervalMs == 0) {
+            throw std::runtime_error("PD pull requester '" + subscriber.name + "' must specify pullIntervalMs > 0");
+        }
+        if (subscriber.sourceIp.empty()) {
+            throw std::runtime_error("PD pull requester '" + subscriber.name +
+                                     "' must specify the responder address in sourceIp");
+        }
+    }
+
+    std::unordered_set<std::uint32_t> groupIds;
+    for (const auto &publisher : config.pdPublishers) {
+        if (publisher.redundancyGroup != 0) {
+            groupIds.insert(publisher.redundancyGroup);
+        }
+    }
+    std::unordered_set<std::uint32_t> declaredGroups;
+    for (const auto &group : config.pdRedundancyGroups) {
+        const auto label = "PD redundancy group " + std::to_string(group.id);
+        if (group.id == 0) {
+            throw std::runtime_error("PD redundancy group id must be > 0");
+        }
+        if (!declaredGroups.insert(group.id).second) {
+            throw std::runtime_error("Duplicate " + label);
+        }
+        if (groupIds.count(group.id) == 0) {
+            throw std::runtime_error(label + " has no publishers");
+        }
+        if (group.partnerId != 0 && (group.partnerId == group.id || groupIds.count(group.partnerId) == 0)) {
+            throw std::runtime_error(label + " references an invalid partner group " + std::to_string(group.partnerId));
+        }
+    }
+    // Receptions are attributed to a redundancy group by ComID, so only partner groups may share one.
+    std::unordered_map<std::uint32_t, std::uint32_t> partners;
+    for (const auto &group : config.pdRedundancyGroups) {
+        if (group.partnerId != 0) {
+            partners[group.id] = group.partnerId;
+            partners.emplace(group.partnerId, group.id);
+        }
+    }
+    std::unordered_map<std::uint32_t, std::uint32_t> comIdGroups;
+    for (const auto &publisher : config.pdPublishers) {
+        if (publisher.redundancyGroup == 0) {
+            continue;
+        }
+        const auto inserted = comIdGroups.emplace(publisher.comId, publisher.redundancyGroup);
+        const auto first = inserted.first->second;
+        if (inserted.second || first == publisher.redundancyGroup) {
+            continue;
+        }
+        const auto partner = partners.find(first);
+        if (partner == partners.end() || partner->second != publisher.redundancyGroup) {
+            throw std::runtime_error("PD publisher '" + publisher.name + "' shares COMID " +
+                                     std::to_string(publisher.comId) + " with redundancy group " +
+                                     std::to_string(first) + ", which is not the partner of its group " +
+                                     std::to_string(publisher.redundancyGroup));
+        }
     }
 
     for (const auto &sender : config.mdSenders) {
         if (sender.expectReply && sender.replyTimeoutMs == 0) {
             throw std::runtime_error("MD sender '" + sender.name + "' expects a reply but replyTimeoutMs is 0");
         }
+        if (sender.transport == MdTransport::Tcp && (sender.destIp.empty() || is_multicast(sender.destIp))) {
+            throw std::runtime_error("MD sender '" + sender.name + "' needs a unicast destIp for TCP transport");
+        }
+        if (sender.type == MdSenderConfig::Type::Notify && sender.expectReply) {
+            throw std::runtime_error("MD sender '" + sender.name + "' sends notifications, which cannot expect a reply");
+        }
     }
 
     for (const auto &listener : config.mdListeners) {
         if (listener.autoReply && listener.replyPayload.value.empty()) {
             throw std::runtime_error("MD listener '" + listener.name + "' autoReply requires a replyPayload");
         }
+        if (listener.replyType == MdListenerConfig::ReplyType::Query && listener.confirmTimeoutMs == 0) {
+            throw std::runtime_error("MD listener '" + listener.name + "' sends reply queries but confirmTimeoutMs is 0");
+        }
     }
 }
 
@@ -243,6 +503,7 @@ SimulatorConfig load_configuration(const std::string &path)
     }
 
     SimulatorConfig config = load_configuration_from_document(doc);
+    config.sourcePath = path;
     validate_configuration(config);
     return config;
 }
@@ -1,9 +1,12 @@
 #include "trdp_simulator/config_store.hpp"
 
+#include <unistd.h>
+
 #include <algorithm>
 #include <cctype>
 #include <fstream>
 #include <stdexcept>
+#include <system_error>
 
 namespace trdp_sim {
 
@@ -29,27 +32,25 @@ ConfigStore::ConfigStore(std::filesystem::path base_directory)
             throw std::runtime_error("Unable to create configuration directory: " + base_directory_.string());
         }
     }
+    spool_directory_ = base_directory_ / ".spool";
+    std::filesystem::create_directories(spool_directory_, ec);
+    if (ec) {
+        throw std::runtime_error("Unable to create spool directory: " + spool_directory_.string());
+    }
+    catalog_ = std::make_unique<ConfigCatalog>(base_directory_);
+    history_ = std::make_unique<ConfigHistory>(base_directory_ / ".history");
 }
 
-std::vector<std::string> ConfigStore::list() const
+void ConfigStore::require_valid_name(const std::string &name) const
 {
-    std::vector<std::string> names;
-    std::error_code ec;
-    for (const auto &entry : std::filesystem::directory_iterator(base_directory_, ec)) {
-        if (ec) {
-            break;
-        }
-        if (!entry.is_regular_file()) {
-            continue;
-        }
-        const auto filename = entry.path().filename();
-        if (filename.extension() != ".xml") {
-            continue;
-        }
-        names.push_back(filename.stem().string());
+    if (!is_valid_name(name)) {
+        throw std::runtime_error("Invalid configuration name: " + name);
     }
-    std::sort(names.begin(), names.end());
-    return names;
+}
+
+std::vector<std::string> ConfigStore::list() const
+{
+    return catalog_->names();
 }
 
 bool ConfigStore::exists(const std::string &name) const
@@ -73,21 +74,76 @@ std::string ConfigStore::load_xml(const std::string &name) const
     return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
 }
 
-void ConfigStore::save(const std::string &name, const std::string &xml) const
+ConfigVersion ConfigStore::save(const std::string &name, const std::string &xml, const std::string &label) const
 {
-    if (!is_valid_name(name)) {
-        throw std::runtime_error("Invalid configuration name: " + name);
-    }
-    auto target = path_for(name);
-    std::ofstream stream(target);
-    if (!stream) {
-        throw std::runtime_error("Unable to write configuration: " + target.string());
+    require_valid_name(name);
+    const auto target = path_for(name);
+    // Readers and the simulator see either the old document or the new one, never a partly written file.
+    write_file_atomically(target, xml);
+    catalog_->refresh(target.stem().string());
+    return history_->record(target.stem().string(), target, label);
+}
+
+ConfigVersion ConfigStore::save_file(const std::string &name, const std::filesystem::path &source,
+                                     const std::string &label) const
+{
+    require_valid_name(name);
+    const auto target = path_for(name);
+    std::error_code ec;
+    std::filesystem::rename(source, target, ec);
+    if (ec) {
+        // A source on another filesystem is copied next to the target first, so the stored document is still
+        // replaced in one rename and never rewritten in place.
+        auto temporary = target;
+        temporary += ".tmp-" + std::to_string(::getpid());
+        ec.clear();
+        std::filesystem::copy_file(source, temporary, std::filesystem::copy_options::overwrite_existing, ec);
+        if (!ec) {
+            std::filesystem::rename(temporary, target, ec);
+        }
+        if (ec) {
+            std::error_code ignored;
+            std::filesystem::remove(temporary, ignored);
+        }
     }
-    stream << xml;
-    stream.flush();
-    if (!stream) {
-        throw std::runtime_error("Failed to write configuration: " + target.string());
+    if (ec) {
+        throw std::runtime_error("Unable to write configuration: " + target.string() + ": " + ec.message());
     }
+    // Spool files are private to the web process; stored configurations are readable like those written by save().
+    using std::filesystem::perms;
+    std::filesystem::permissions(target, perms::owner_read | perms::owner_write | perms::group_read | perms::others_read,
+                                 ec);
+    catalog_->refresh(target.stem().string());
+    return history_->record(target.stem().string(), target, label);
+}
+
+std::vector<ConfigVersion> ConfigStore::versions(const std::string &name) const
+{
+    require_valid_name(name);
+    return history_->versions(path_for(name).stem().string());
+}
+
+std::string ConfigStore::load_version(const std::string &name, std::uint32_t number) const
+{
+    require_valid_name(name);
+    return history_->load(history_->version(path_for(name).stem().string(), number));
+}
+
+std::string ConfigStore::diff(const std::string &name, std::uint32_t from, std::uint32_t to) const
+{
+    require_valid_name(name);
+    const auto key = path_for(name).stem().string();
+    return history_->diff(history_->version(key, from), history_->version(key, to));
+}
+
+ConfigVersion ConfigStore::restore(const std::string &name, std::uint32_t number) const
+{
+    require_valid_name(name);
+    const auto target = path_for(name);
+    const auto key = target.stem().string();
+    history_->restore(history_->version(key, number), target);
+    catalog_->refresh(key);
+    return history_->record(key, target, "restored from version " + std::to_string(number));
 }
 
 std::filesystem::path ConfigStore::path_for(const std::string &name) const
@@ -97,7 +153,8 @@ std::filesystem::path ConfigStore::path_for(const std::string &name) const
 
 bool ConfigStore::is_valid_name(const std::string &name)
 {
-    if (name.empty()) {
+    // A leading dot would allow "." and ".." and clash with the history directory.
+    if (name.empty() || name.front() == '.') {
         return false;
     }
     return std::all_of(name.begin(), name.end(), [](unsigned char c) {
@@ -0,0 +1,204 @@
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef TRDPSIM_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef TRDPSIM_WITH_BROTLI
+#include <brotli/encode.h>
+#endif
+
+// Build-time generator for the web interface: writes a C++ source that holds each file under web/ as constant
+// data, along with gzip and brotli variants and a strong ETag for every variant. The web server serves these
+// from read-only memory, so nothing is read from disk or compressed per request.
+
+namespace {
+
+struct Representation {
+    std::string encoding;
+    std::string data;
+};
+
+std::string read_file(const std::filesystem::path &path)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        throw std::runtime_error("Unable to read " + path.string());
+    }
+    return std::string((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+}
+
+std::string content_type_for(const std::filesystem::path &path)
+{
+    const auto extension = path.extension().string();
+    if (extension == ".html") {
+        return "text/html; charset=utf-8";
+    }
+    if (extension == ".js") {
+        return "text/javascript; charset=utf-8";
+    }
+    if (extension == ".css") {
+        return "text/css; charset=utf-8";
+    }
+    if (extension == ".svg") {
+        return "image/svg+xml";
+    }
+    if (extension == ".png") {
+        return "image/png";
+    }
+    return "application/octet-stream";
+}
+
+// FNV-1a over the bytes of one representation; the ETag changes whenever the file or its compression does.
+std::string etag_for(const std::string &data)
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (const char ch : data) {
+        hash ^= static_cast<unsigned char>(ch);
+        hash *= 1099511628211ULL;
+    }
+    char buffer[24];
+    std::snprintf(buffer, sizeof(buffer), "\"%016llx\"", static_cast<unsigned long long>(hash));
+    return buffer;
+}
+
+std::optional<std::string> gzip(const std::string &data)
+{
+#ifdef TRDPSIM_WITH_ZLIB
+    z_stream stream{};
+    // 16 added to the window bits selects the gzip wrapper.
+    if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return std::nullopt;
+    }
+    std::string output(deflateBound(&stream, static_cast<uLong>(data.size())), '\0');
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef *>(output.data());
+    stream.avail_out = static_cast<uInt>(output.size());
+    const int result = deflate(&stream, Z_FINISH);
+    output.resize(stream.total_out);
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END) {
+        return std::nullopt;
+    }
+    return output;
+#else
+    (void) data;
+    return std::nullopt;
+#endif
+}
+
+std::optional<std::string> brotli(const std::string &data)
+{
+#ifdef TRDPSIM_WITH_BROTLI
+    std::size_t size = BrotliEncoderMaxCompressedSize(data.size());
+    std::string output(size, '\0');
+    if (BrotliEncoderCompress(BROTLI_MAX_QUALITY, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT, data.size(),
+                              reinterpret_cast<const std::uint8_t *>(data.data()), &size,
+                              reinterpret_cast<std::uint8_t *>(output.data())) != BROTLI_TRUE) {
+        return std::nullopt;
+    }
+    output.resize(size);
+    return output;
+#else
+    (void) data;
+    return std::nullopt;
+#endif
+}
+
+// Every byte is written as \xNN, so an escape is always followed by another escape or the closing quote and
+// never absorbs a following hex digit.
+void write_literal(std::ostream &out, const std::string &data)
+{
+    static const char *hex = "0123456789abcdef";
+    out << "\n    \"";
+    for (std::size_t index = 0; index < data.size(); ++index) {
+        if (index != 0 && index % 32U == 0) {
+            out << "\"\n    \"";
+        }
+        const auto byte = static_cast<unsigned char>(data[index]);
+        out << "\\x" << hex[byte >> 4U] << hex[byte & 0x0FU];
+    }
+    out << '"';
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <output.cpp> <asset>..." << std::endl;
+        return 2;
+    }
+
+    try {
+        std::ostringstream out;
+        out << "// Generated by trdp-simulator-embed-assets from the files under web/; do not edit.\n\n"
+            << "#include \"trdp_simulator/web_assets.hpp\"\n\n"
+            << "namespace trdp_sim {\nnamespace {\n";
+
+        std::ostringstream table;
+        for (int argument = 2; argument < argc; ++argument) {
+            const std::filesystem::path path(argv[argument]);
+            const auto index = std::to_string(argument - 2);
+            const auto identity = read_file(path);
+            std::vector<Representation> representations{{"", identity}};
+            for (auto [encoding, compressed] : {std::make_pair("gzip", gzip(identity)),
+                                                std::make_pair("br", brotli(identity))}) {
+                if (compressed && compressed->size() < identity.size()) {
+                    representations.push_back({encoding, std::move(*compressed)});
+                }
+            }
+
+            for (std::size_t variant = 0; variant < representations.size(); ++variant) {
+                out << "\nconstexpr char asset" << index << "_" << variant << "[] =";
+                write_literal(out, representations[variant].data);
+                out << ";\n";
+            }
+            out << "\nconstexpr WebAssetRepresentation asset" << index << "[] = {\n";
+            for (std::size_t variant = 0; variant < representations.size(); ++variant) {
+                const auto name = "asset" + index + "_" + std::to_string(variant);
+                out << "    {\"" << representations[variant].encoding << "\", R\"("
+                    << etag_for(representations[variant].data) << ")\", {" << name << ", sizeof(" << name
+                    << ") - 1}},\n";
+            }
+            out << "};\n";
+
+            const auto filename = path.filename().string();
+            const auto urlPath = filename == "index.html" ? std::string("/") : "/" + filename;
+            table << "    {\"" << urlPath << "\", \"" << content_type_for(path) << "\", asset" << index << ", "
+                  << representations.size() << "},\n";
+        }
+
+        out << "\nconstexpr WebAsset kAssets[] = {\n"
+            << table.str() << "};\n\n}  // namespace\n\n"
+            << "const WebAsset *find_web_asset(std::string_view path)\n{\n"
+            << "    for (const auto &asset : kAssets) {\n"
+            << "        if (asset.path == path) {\n"
+            << "            return &asset;\n"
+            << "        }\n"
+            << "    }\n"
+            << "    return nullptr;\n}\n\n}  // namespace trdp_sim\n";
+
+        const std::filesystem::path output(argv[1]);
+        std::ofstream stream(output, std::ios::binary | std::ios::trunc);
+        stream << out.str();
+        if (!stream) {
+            throw std::runtime_error("Unable to write " + output.string());
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << argv[0] << ": " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
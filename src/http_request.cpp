@@ -0,0 +1,235 @@
+#include "trdp_simulator/http_request.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+
+namespace trdp_sim {
+namespace {
+
+bool equals_ignore_case(std::string_view lhs, std::string_view rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](char a, char b) {
+               return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+           });
+}
+
+std::string_view trim(std::string_view value)
+{
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+}  // namespace
+
+HttpRequest::~HttpRequest()
+{
+    if (!bodyFile.empty()) {
+        std::error_code ec;
+        std::filesystem::remove(bodyFile, ec);
+    }
+}
+
+std::string_view HttpRequest::header(std::string_view name) const
+{
+    for (const auto &entry : headers) {
+        if (equals_ignore_case(entry.first, name)) {
+            return entry.second;
+        }
+    }
+    return {};
+}
+
+std::string HttpRequest::media_type() const
+{
+    auto value = header("Content-Type");
+    value = trim(value.substr(0, value.find(';')));
+    std::string result(value);
+    std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return result;
+}
+
+void HttpRequest::load_body()
+{
+    if (bodyFile.empty()) {
+        return;
+    }
+    std::ifstream stream(bodyFile, std::ios::binary);
+    if (!stream) {
+        throw std::runtime_error("Unable to read request body: " + bodyFile.string());
+    }
+    body.reserve(static_cast<std::size_t>(contentLength));
+    body.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    std::error_code ec;
+    std::filesystem::remove(bodyFile, ec);
+    bodyFile.clear();
+}
+
+HttpRequestParser::HttpRequestParser(std::size_t memoryBodyLimit, std::uint64_t maxBodySize,
+                                     std::filesystem::path spoolDirectory)
+    : memoryBodyLimit_(memoryBodyLimit), maxBodySize_(maxBodySize), spoolDirectory_(std::move(spoolDirectory))
+{
+}
+
+HttpRequestParser::~HttpRequestParser()
+{
+    if (bodyFd_ >= 0) {
+        ::close(bodyFd_);
+    }
+}
+
+HttpRequestParser::State HttpRequestParser::fail(int status, std::string message)
+{
+    state_ = State::Error;
+    errorStatus_ = status;
+    errorMessage_ = std::move(message);
+    if (bodyFd_ >= 0) {
+        ::close(bodyFd_);
+        bodyFd_ = -1;
+    }
+    return state_;
+}
+
+HttpRequestParser::State HttpRequestParser::feed(const char *data, std::size_t size)
+{
+    if (state_ == State::Headers) {
+        // The terminator may straddle two reads, so the search restarts a few bytes before the new data.
+        const auto searchFrom = headSize_ >= 3U ? headSize_ - 3U : 0U;
+        const auto copied = std::min(size, head_.size() - headSize_);
+        std::memcpy(head_.data() + headSize_, data, copied);
+        headSize_ += copied;
+        const std::string_view buffered(head_.data(), headSize_);
+        const auto end = buffered.find("\r\n\r\n", searchFrom);
+        if (end == std::string_view::npos) {
+            if (headSize_ == head_.size()) {
+                return fail(431, "Request header fields too large");
+            }
+            return state_;
+        }
+        if (parse_head(buffered.substr(0, end)) == State::Error) {
+            return state_;
+        }
+        start_body();
+        if (state_ != State::Body) {
+            return state_;
+        }
+        // Whatever followed the headers in this read is the start of the body.
+        const auto consumed = end + 4U - (headSize_ - copied);
+        append_body(data + consumed, size - consumed);
+        return state_;
+    }
+    if (state_ == State::Body) {
+        append_body(data, size);
+    }
+    return state_;
+}
+
+HttpRequestParser::State HttpRequestParser::parse_head(std::string_view head)
+{
+    auto lineEnd = head.find("\r\n");
+    const auto requestLine = head.substr(0, lineEnd);
+    const auto methodEnd = requestLine.find(' ');
+    const auto targetEnd = methodEnd == std::string_view::npos ? methodEnd : requestLine.find(' ', methodEnd + 1U);
+    if (targetEnd == std::string_view::npos || methodEnd == 0 || targetEnd == methodEnd + 1U) {
+        return fail(400, "Malformed request line");
+    }
+    request_.method = requestLine.substr(0, methodEnd);
+    request_.target = requestLine.substr(methodEnd + 1U, targetEnd - methodEnd - 1U);
+    request_.version = requestLine.substr(targetEnd + 1U);
+    if (request_.version.compare(0, 5, "HTTP/") != 0) {
+        return fail(400, "Malformed request line");
+    }
+
+    while (lineEnd != std::string_view::npos) {
+        const auto start = lineEnd + 2U;
+        lineEnd = head.find("\r\n", start);
+        const auto line = head.substr(start, lineEnd == std::string_view::npos ? std::string_view::npos : lineEnd - start);
+        const auto colon = line.find(':');
+        if (colon == std::string_view::npos || colon == 0) {
+            return fail(400, "Malformed header line");
+        }
+        request_.headers.emplace_back(std::string(line.substr(0, colon)), std::string(trim(line.substr(colon + 1U))));
+    }
+
+    if (!request_.header("Transfer-Encoding").empty()) {
+        return fail(501, "Transfer encodings are not supported; send a Content-Length");
+    }
+    const auto length = request_.header("Content-Length");
+    if (!length.empty()) {
+        if (!std::all_of(length.begin(), length.end(), [](unsigned char c) { return std::isdigit(c); }) ||
+            length.size() > 18U) {
+            return fail(400, "Invalid Content-Length");
+        }
+        request_.contentLength = std::stoull(std::string(length));
+    }
+    if (request_.contentLength > maxBodySize_) {
+        return fail(413, "Request body exceeds " + std::to_string(maxBodySize_) + " bytes");
+    }
+    return state_;
+}
+
+void HttpRequestParser::start_body()
+{
+    if (request_.contentLength == 0) {
+        state_ = State::Complete;
+        return;
+    }
+    state_ = State::Body;
+    if (request_.contentLength <= memoryBodyLimit_) {
+        request_.body.reserve(static_cast<std::size_t>(request_.contentLength));
+        return;
+    }
+    auto pattern = (spoolDirectory_ / "trdp-simulator-body-XXXXXX").string();
+    bodyFd_ = ::mkstemp(pattern.data());
+    if (bodyFd_ < 0) {
+        fail(500, "Unable to spool request body: " + std::string(std::strerror(errno)));
+        return;
+    }
+    request_.bodyFile = pattern;
+}
+
+void HttpRequestParser::append_body(const char *data, std::size_t size)
+{
+    const auto remaining = request_.contentLength - bodyReceived_;
+    size = static_cast<std::size_t>(std::min<std::uint64_t>(size, remaining));
+    if (bodyFd_ < 0) {
+        request_.body.append(data, size);
+    } else {
+        for (std::size_t written = 0; written < size;) {
+            const auto result = ::write(bodyFd_, data + written, size - written);
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                fail(500, "Unable to spool request body: " + std::string(std::strerror(errno)));
+                return;
+            }
+            written += static_cast<std::size_t>(result);
+        }
+    }
+    bodyReceived_ += size;
+    if (bodyReceived_ == request_.contentLength) {
+        if (bodyFd_ >= 0) {
+            ::close(bodyFd_);
+            bodyFd_ = -1;
+        }
+        state_ = State::Complete;
+    }
+}
+
+}  // namespace trdp_sim
@@ -0,0 +1,63 @@
+#include "trdp_simulator/launch_clock.hpp"
+
+#include <cerrno>
+#include <ctime>
+
+namespace trdp_sim {
+namespace {
+
+std::int64_t to_ns(const timespec &ts)
+{
+    return static_cast<std::int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+std::int64_t clock_now_ns(clockid_t id)
+{
+    timespec ts{};
+    clock_gettime(id, &ts);
+    return to_ns(ts);
+}
+
+}  // namespace
+
+int launch_clock_id(PdPublisherConfig::LaunchClock clock)
+{
+    return clock == PdPublisherConfig::LaunchClock::Monotonic ? CLOCK_MONOTONIC : CLOCK_TAI;
+}
+
+std::int64_t launch_clock_now_ns(PdPublisherConfig::LaunchClock clock)
+{
+    return clock_now_ns(launch_clock_id(clock));
+}
+
+void launch_clock_sleep_until(PdPublisherConfig::LaunchClock clock, std::int64_t deadlineNs)
+{
+    timespec deadline{};
+    deadline.tv_sec = static_cast<time_t>(deadlineNs / 1000000000LL);
+    deadline.tv_nsec = static_cast<long>(deadlineNs % 1000000000LL);
+    while (clock_nanosleep(launch_clock_id(clock), TIMER_ABSTIME, &deadline, nullptr) == EINTR) {
+    }
+}
+
+std::int64_t first_launch_ns(std::int64_t nowNs, std::int64_t cycleNs, std::int64_t offsetNs)
+{
+    return (nowNs / cycleNs + 1) * cycleNs + offsetNs;
+}
+
+std::int64_t next_launch_ns(std::int64_t launchNs, std::int64_t nowNs, std::int64_t cycleNs, std::int64_t leadNs)
+{
+    launchNs += cycleNs;
+    if (nowNs > launchNs - leadNs) {
+        launchNs += ((nowNs - (launchNs - leadNs)) / cycleNs + 1) * cycleNs;
+    }
+    return launchNs;
+}
+
+std::int64_t launch_clock_to_realtime_ns(PdPublisherConfig::LaunchClock clock, std::int64_t launchNs)
+{
+    const auto launchNow = launch_clock_now_ns(clock);
+    const auto realtimeNow = clock_now_ns(CLOCK_REALTIME);
+    return launchNs + (realtimeNow - launchNow);
+}
+
+}  // namespace trdp_sim
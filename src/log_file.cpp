@@ -0,0 +1,298 @@
+#include "trdp_simulator/log_file.hpp"
+
+#include "trdp_simulator/thread_monitor.hpp"
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef TRDPSIM_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+namespace trdp_sim {
+namespace {
+
+std::string rotation_timestamp()
+{
+    const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm tmBuffer{};
+    localtime_r(&now, &tmBuffer);
+    std::ostringstream oss;
+    oss << std::put_time(&tmBuffer, "%Y%m%d-%H%M%S");
+    return oss.str();
+}
+
+// Compression must not compete with the simulator threads for CPU or disk.
+void lower_thread_priority()
+{
+#ifdef __linux__
+    const auto tid = static_cast<id_t>(::syscall(SYS_gettid));
+    (void) ::setpriority(PRIO_PROCESS, tid, 19);
+#ifdef SYS_ioprio_set
+    constexpr int IoprioWhoProcess = 1;
+    constexpr int IoprioClassIdle = 3;
+    (void) ::syscall(SYS_ioprio_set, IoprioWhoProcess, static_cast<int>(tid), IoprioClassIdle << 13);
+#endif
+#endif
+}
+
+}  // namespace
+
+RotatingLogFile::RotatingLogFile(const LoggingConfig &config, ErrorHandler onError)
+    : path_(config.filePath),
+      rotateBytes_(static_cast<std::uint64_t>(config.rotateSizeMb) << 20U),
+      rotateInterval_(config.rotateIntervalMinutes),
+      keepFiles_(config.keepFiles),
+#ifdef TRDPSIM_WITH_ZLIB
+      compress_(config.compressRotated),
+#else
+      compress_(false),
+#endif
+      onError_(std::move(onError))
+{
+    open();
+    if (!stream_.is_open()) {
+        throw std::runtime_error("Unable to open log file: " + path_.string());
+    }
+    worker_ = std::thread(&RotatingLogFile::run, this);
+}
+
+RotatingLogFile::~RotatingLogFile()
+{
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex_);
+        stopping_ = true;
+        jobsCv_.notify_all();
+    }
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    // A rotation the writer did not pick up any more still leaves a finished segment behind.
+    if (handoffReady_.load() && nextStream_.is_open()) {
+        Job job{Job::Kind::Retire, nextSegment_, std::move(stream_)};
+        retire(job);
+    }
+}
+
+void RotatingLogFile::open()
+{
+    stream_.open(path_, std::ios::app);
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path_, ec);
+    bytesWritten_ = ec ? 0U : size;
+    openedAt_ = std::chrono::steady_clock::now();
+}
+
+void RotatingLogFile::write(const std::string &line)
+{
+    if (handoffReady_.load(std::memory_order_acquire)) {
+        switch_stream();
+    }
+    if (!rotationPending_) {
+        const bool full = rotateBytes_ != 0 && bytesWritten_ >= rotateBytes_;
+        const bool old = rotateInterval_.count() != 0 && bytesWritten_ != 0 &&
+                         std::chrono::steady_clock::now() - openedAt_ >= rotateInterval_;
+        if (full || old) {
+            rotationPending_ = true;
+            submit({Job::Kind::Rotate, {}, {}});
+        }
+    }
+    stream_ << line << std::endl;
+    bytesWritten_ += line.size() + 1U;
+}
+
+void RotatingLogFile::switch_stream()
+{
+    std::ofstream next;
+    std::filesystem::path segment;
+    std::uint64_t nextBytes = 0;
+    {
+        std::lock_guard<std::mutex> lock(handoffMutex_);
+        next = std::move(nextStream_);
+        segment = std::move(nextSegment_);
+        nextBytes = nextBytes_;
+        handoffReady_.store(false, std::memory_order_relaxed);
+    }
+    rotationPending_ = false;
+    openedAt_ = std::chrono::steady_clock::now();
+    if (!next.is_open()) {
+        // Keep appending to the current file and try again after another full interval.
+        bytesWritten_ = 0;
+        return;
+    }
+    bytesWritten_ = nextBytes;
+    std::swap(stream_, next);
+    submit({Job::Kind::Retire, std::move(segment), std::move(next)});
+}
+
+// Runs on the background thread; the writer appends to the renamed segment until it takes the new stream.
+void RotatingLogFile::rotate()
+{
+    const auto stem = path_.stem().string();
+    const auto extension = path_.extension().string();
+    const auto timestamp = rotation_timestamp();
+    auto segment = path_;
+    segment.replace_filename(stem + "." + timestamp + extension);
+    std::error_code ec;
+    // Several rotations within one second get a counter, which sorts after the plain timestamp.
+    for (int counter = 1; std::filesystem::exists(segment, ec) ||
+                          std::filesystem::exists(segment.string() + ".gz", ec);
+         ++counter) {
+        segment.replace_filename(stem + "." + timestamp + "-" + std::to_string(counter) + extension);
+    }
+    std::ofstream next;
+    std::uint64_t nextBytes = 0;
+    std::filesystem::rename(path_, segment, ec);
+    if (ec) {
+        onError_("Unable to rotate log file '" + path_.string() + "': " + ec.message());
+    } else {
+        next.open(path_, std::ios::app);
+        if (next.is_open()) {
+            nextBytes = std::filesystem::file_size(path_, ec);
+            nextBytes = ec ? 0U : nextBytes;
+        } else {
+            // Move the segment back so the log keeps its configured name.
+            std::filesystem::rename(segment, path_, ec);
+            onError_("Unable to reopen log file '" + path_.string() + "' after rotation; still writing to '" +
+                     (ec ? segment : path_).string() + "'");
+        }
+    }
+    std::lock_guard<std::mutex> lock(handoffMutex_);
+    nextStream_ = std::move(next);
+    nextSegment_ = std::move(segment);
+    nextBytes_ = nextBytes;
+    handoffReady_.store(true, std::memory_order_release);
+}
+
+void RotatingLogFile::retire(Job &job)
+{
+    job.stream.close();
+    if (compress_) {
+        compress(job.segment);
+    }
+    prune();
+}
+
+void RotatingLogFile::submit(Job job)
+{
+    std::lock_guard<std::mutex> lock(jobsMutex_);
+    jobs_.push_back(std::move(job));
+    jobsCv_.notify_one();
+}
+
+void RotatingLogFile::run()
+{
+    set_thread_name("log-compress");
+    lower_thread_priority();
+    prune();
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobsMutex_);
+            jobsCv_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+            // Queued segments are still compressed on shutdown so none is left half-processed.
+            if (jobs_.empty()) {
+                return;
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        if (job.kind == Job::Kind::Rotate) {
+            rotate();
+        } else {
+            retire(job);
+        }
+    }
+}
+
+void RotatingLogFile::compress(const std::filesystem::path &segment)
+{
+#ifdef TRDPSIM_WITH_ZLIB
+    const std::string target = segment.string() + ".gz";
+    const std::string partial = target + ".part";
+    std::ifstream input(segment, std::ios::binary);
+    gzFile output = gzopen(partial.c_str(), "wb6");
+    bool ok = input.is_open() && output != nullptr;
+    std::vector<char> buffer(1U << 16U);
+    while (ok && input) {
+        input.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        const auto count = static_cast<unsigned>(input.gcount());
+        if (count != 0 && gzwrite(output, buffer.data(), count) != static_cast<int>(count)) {
+            ok = false;
+        }
+    }
+    if (output != nullptr && gzclose(output) != Z_OK) {
+        ok = false;
+    }
+    std::error_code ec;
+    if (ok) {
+        std::filesystem::rename(partial, target, ec);
+    }
+    if (!ok || ec) {
+        std::filesystem::remove(partial, ec);
+        onError_("Unable to compress log segment '" + segment.string() + "'");
+        return;
+    }
+    std::filesystem::remove(segment, ec);
+#else
+    (void) segment;
+#endif
+}
+
+std::vector<std::filesystem::path> RotatingLogFile::rotated_segments() const
+{
+    const auto prefix = path_.stem().string() + ".";
+    const auto extension = path_.extension().string();
+    const auto directory = path_.has_parent_path() ? path_.parent_path() : std::filesystem::path(".");
+    // Segment names are <stem>.<yyyymmdd-hhmmss>[-n]<ext>[.gz]; the key is the part between stem and extension.
+    std::vector<std::pair<std::string, std::filesystem::path>> segments;
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator(directory, ec)) {
+        auto name = entry.path().filename().string();
+        if (name.size() > 3U && name.compare(name.size() - 3U, 3U, ".gz") == 0) {
+            name.resize(name.size() - 3U);
+        }
+        if (name.size() < prefix.size() + 15U + extension.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+            name.compare(name.size() - extension.size(), extension.size(), extension) != 0) {
+            continue;
+        }
+        auto key = name.substr(prefix.size(), name.size() - prefix.size() - extension.size());
+        if (key.size() < 15U || key[8] != '-' ||
+            !std::all_of(key.begin(), key.begin() + 8, [](unsigned char c) { return std::isdigit(c); })) {
+            continue;
+        }
+        segments.emplace_back(std::move(key), entry.path());
+    }
+    std::sort(segments.begin(), segments.end());
+    std::vector<std::filesystem::path> result;
+    result.reserve(segments.size());
+    for (auto &segment : segments) {
+        result.push_back(std::move(segment.second));
+    }
+    return result;
+}
+
+void RotatingLogFile::prune()
+{
+    if (keepFiles_ == 0) {
+        return;
+    }
+    const auto segments = rotated_segments();
+    for (std::size_t index = 0; index + keepFiles_ < segments.size(); ++index) {
+        std::error_code ec;
+        std::filesystem::remove(segments[index], ec);
+    }
+}
+
+}  // namespace trdp_sim
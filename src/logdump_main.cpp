@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <cctype>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+
+#include "trdp_simulator/binary_log.hpp"
+
+namespace {
+
+void print_usage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [options] <binary log>" << std::endl;
+    std::cerr << "  --level <level>     show records of this level and more severe (error, warn, info, debug)"
+              << std::endl;
+    std::cerr << "  --message <name>    show one message type only (e.g. pd-received, text)" << std::endl;
+    std::cerr << "  --name <telegram>   show records naming this publisher, subscriber, sender or listener"
+              << std::endl;
+    std::cerr << "  --comid <n>         show records carrying this COMID" << std::endl;
+    std::cerr << "  --thread <tid>      show records written by this thread" << std::endl;
+    std::cerr << "  --summary           count the matching records per message instead of printing them"
+              << std::endl;
+}
+
+std::optional<trdp_sim::LogLevel> level_from_name(std::string name)
+{
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) {
+        return static_cast<char>(std::toupper(c));
+    });
+    for (const auto level : {trdp_sim::LogLevel::Error, trdp_sim::LogLevel::Warn, trdp_sim::LogLevel::Info,
+                             trdp_sim::LogLevel::Debug}) {
+        if (trdp_sim::log_level_to_string(level) == name) {
+            return level;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<trdp_sim::BinaryLogMessage> message_from_name(const std::string &name)
+{
+    for (std::uint16_t id = 1;; ++id) {
+        const auto message = static_cast<trdp_sim::BinaryLogMessage>(id);
+        const auto candidate = trdp_sim::binary_log_message_name(message);
+        if (candidate.empty()) {
+            return std::nullopt;
+        }
+        if (candidate == name) {
+            return message;
+        }
+    }
+}
+
+std::string wall_time(std::int64_t ns)
+{
+    const std::time_t seconds = static_cast<std::time_t>(ns / 1000000000LL);
+    std::tm tmBuffer{};
+    localtime_r(&seconds, &tmBuffer);
+    std::ostringstream oss;
+    oss << std::put_time(&tmBuffer, "%Y-%m-%d %H:%M:%S") << '.' << std::setw(6) << std::setfill('0')
+        << (ns % 1000000000LL) / 1000;
+    return oss.str();
+}
+
+}  // namespace
+
+// Renders a binary log written with <logging binaryFile="..."/> as text, optionally filtered.
+int main(int argc, char **argv)
+{
+    std::string path;
+    trdp_sim::LogLevel level = trdp_sim::LogLevel::Debug;
+    std::optional<trdp_sim::BinaryLogMessage> message;
+    std::optional<std::string> name;
+    std::optional<std::uint64_t> comId;
+    std::optional<std::uint32_t> thread;
+    bool summary = false;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg(argv[i]);
+            if (arg == "--level" && i + 1 < argc) {
+                const auto parsed = level_from_name(argv[++i]);
+                if (!parsed) {
+                    std::cerr << "Unknown log level: " << argv[i] << std::endl;
+                    return 1;
+                }
+                level = *parsed;
+            } else if (arg == "--message" && i + 1 < argc) {
+                message = message_from_name(argv[++i]);
+                if (!message) {
+                    std::cerr << "Unknown message: " << argv[i] << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--name" && i + 1 < argc) {
+                name = argv[++i];
+            } else if (arg == "--comid" && i + 1 < argc) {
+                comId = std::stoull(argv[++i], nullptr, 0);
+            } else if (arg == "--thread" && i + 1 < argc) {
+                thread = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+            } else if (arg == "--summary") {
+                summary = true;
+            } else if (arg == "--help" || arg == "-h") {
+                print_usage(argv[0]);
+                return 0;
+            } else if (path.empty() && !arg.empty() && arg[0] != '-') {
+                path = arg;
+            } else {
+                std::cerr << "Unknown argument: " << arg << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << "Invalid argument: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    if (path.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        trdp_sim::BinaryLogReader reader(path);
+        std::optional<std::uint64_t> nameId;
+        if (name) {
+            const auto &strings = reader.strings();
+            const auto it = std::find(strings.begin(), strings.end(), *name);
+            if (it == strings.end()) {
+                std::cerr << "No telegram named '" << *name << "' in " << path << std::endl;
+                return 1;
+            }
+            nameId = static_cast<std::uint64_t>(it - strings.begin());
+        }
+
+        std::map<std::string, std::uint64_t> counts;
+        std::uint64_t matched = 0;
+        reader.for_each([&](const trdp_sim::BinaryLogEntry &entry) {
+            if (entry.level > level || (message && entry.message != *message) ||
+                (thread && entry.threadId != *thread)) {
+                return;
+            }
+            bool named = !nameId;
+            bool carriesComId = !comId;
+            for (const auto &arg : entry.args) {
+                if (arg.type == trdp_sim::BinaryLogArgType::String && nameId && arg.value == *nameId) {
+                    named = true;
+                } else if (arg.type == trdp_sim::BinaryLogArgType::Unsigned && comId && arg.value == *comId) {
+                    carriesComId = true;
+                }
+            }
+            if (!named || !carriesComId) {
+                return;
+            }
+            ++matched;
+            if (summary) {
+                ++counts[trdp_sim::binary_log_message_name(entry.message)];
+                return;
+            }
+            std::cout << '[' << wall_time(entry.wallTimeNs) << "] [" << trdp_sim::log_level_to_string(entry.level)
+                      << "] [" << entry.threadId << "] " << reader.format(entry) << '\n';
+        });
+
+        if (summary) {
+            for (const auto &entry : counts) {
+                std::cout << std::setw(28) << std::left << entry.first << ' ' << entry.second << '\n';
+            }
+            std::cout << std::setw(28) << std::left << "total" << ' ' << matched << '\n';
+        }
+        if (reader.records_lost() != 0) {
+            std::cerr << reader.records_lost() << " of " << reader.records_written()
+                      << " record(s) were overwritten or incomplete" << std::endl;
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << "Fatal error: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -1,5 +1,11 @@
 #include "trdp_simulator/logger.hpp"
 
+#include "trdp_simulator/binary_log.hpp"
+#include "trdp_simulator/log_file.hpp"
+
+#include <algorithm>
+#include <utility>
+
 namespace trdp_sim {
 
 namespace {
@@ -23,7 +29,7 @@ std::string timestamp()
 }  // namespace
 
 Logger::Logger(LogLevel level)
-    : level_(level), consoleEnabled_(true), fileStream_(nullptr)
+    : level_(level), consoleEnabled_(true), file_(nullptr), binaryLog_(nullptr)
 {
 }
 
@@ -37,10 +43,16 @@ void Logger::enable_console(bool enable)
     consoleEnabled_ = enable;
 }
 
-void Logger::set_file(std::ostream *stream)
+void Logger::set_file(RotatingLogFile *file)
+{
+    std::scoped_lock lock(mutex_);
+    file_ = file;
+}
+
+void Logger::set_binary_log(BinaryLog *log)
 {
     std::scoped_lock lock(mutex_);
-    fileStream_ = stream;
+    binaryLog_ = log;
 }
 
 void Logger::error(const std::string &message)
@@ -65,7 +77,17 @@ void Logger::debug(const std::string &message)
 
 void Logger::log(LogLevel level, const std::string &message)
 {
-    if (level > level_) {
+    if (enabled(level)) {
+        write(level, message);
+    }
+}
+
+void Logger::write(LogLevel level, const std::string &message)
+{
+    if (binaryLog_ != nullptr) {
+        binaryLog_->write_text(level, message);
+    }
+    if (!consoleEnabled_ && file_ == nullptr) {
         return;
     }
 
@@ -78,11 +100,113 @@ void Logger::log(LogLevel level, const std::string &message)
         std::ostream &stream = (level == LogLevel::Error || level == LogLevel::Warn) ? std::cerr : std::cout;
         stream << formatted << std::endl;
     }
-    if (fileStream_) {
-        (*fileStream_) << formatted << std::endl;
+    if (file_) {
+        file_->write(formatted);
+    }
+}
+
+void Logger::set_overrides(std::vector<LogOverride> overrides, LogRateLimit rateLimit)
+{
+    std::scoped_lock lock(channelsMutex_);
+    overrides_ = std::move(overrides);
+    rateLimit_ = rateLimit;
+}
+
+LogChannel &Logger::channel(const std::string &category, const std::string &name, std::uint32_t comId)
+{
+    std::scoped_lock lock(channelsMutex_);
+    auto &channel = channels_[category + ':' + name];
+    if (channel.logger_ != nullptr) {
+        return channel;
+    }
+
+    const LogOverride *byName = nullptr;
+    const LogOverride *byComId = nullptr;
+    const LogOverride *byCategory = nullptr;
+    for (const auto &candidate : overrides_) {
+        if (!candidate.name.empty()) {
+            if (candidate.name == name) {
+                byName = &candidate;
+            }
+        } else if (candidate.comId != 0) {
+            if (candidate.comId == comId) {
+                byComId = &candidate;
+            }
+        } else if (candidate.category == category) {
+            byCategory = &candidate;
+        }
+    }
+    const auto *match = byName != nullptr ? byName : (byComId != nullptr ? byComId : byCategory);
+    const LogLevel level = match != nullptr ? match->level : level_;
+
+    channel.logger_ = this;
+    channel.name_ = name;
+    channel.levelMask_ = static_cast<std::uint8_t>((2U << static_cast<unsigned>(level)) - 1U);
+    if (rateLimit_.messagesPerSecond != 0) {
+        channel.ratePerSecond_ = rateLimit_.messagesPerSecond;
+        channel.capacity_ = rateLimit_.burst != 0 ? rateLimit_.burst : rateLimit_.messagesPerSecond;
+        channel.tokens_ = channel.capacity_;
+        channel.refilledAt_ = std::chrono::steady_clock::now();
+    }
+    return channel;
+}
+
+void Logger::report_suppressed()
+{
+    std::scoped_lock lock(channelsMutex_);
+    for (auto &entry : channels_) {
+        auto &channel = entry.second;
+        std::uint64_t count = 0;
+        LogLevel level = LogLevel::Debug;
+        {
+            std::scoped_lock bucketLock(channel.bucketMutex_);
+            count = std::exchange(channel.suppressed_, 0U);
+            level = std::exchange(channel.suppressedLevel_, LogLevel::Debug);
+        }
+        if (count != 0) {
+            channel.report_suppressed(level, count);
+        }
     }
 }
 
+bool LogChannel::admit(LogLevel level)
+{
+    if (ratePerSecond_ == 0.0) {
+        return true;
+    }
+    std::uint64_t suppressed = 0;
+    LogLevel suppressedLevel = LogLevel::Debug;
+    {
+        std::scoped_lock lock(bucketMutex_);
+        const auto now = std::chrono::steady_clock::now();
+        tokens_ = std::min(capacity_, tokens_ + std::chrono::duration<double>(now - refilledAt_).count() *
+                                                    ratePerSecond_);
+        refilledAt_ = now;
+        if (tokens_ < 1.0) {
+            ++suppressed_;
+            suppressedLevel_ = std::min(suppressedLevel_, level);
+            return false;
+        }
+        tokens_ -= 1.0;
+        suppressed = std::exchange(suppressed_, 0U);
+        suppressedLevel = std::exchange(suppressedLevel_, LogLevel::Debug);
+    }
+    if (suppressed != 0) {
+        report_suppressed(suppressedLevel, suppressed);
+    }
+    return true;
+}
+
+void LogChannel::log(LogLevel level, const std::string &message)
+{
+    logger_->write(level, message);
+}
+
+void LogChannel::report_suppressed(LogLevel level, std::uint64_t count)
+{
+    logger_->write(level, "Rate limit suppressed " + std::to_string(count) + " log message(s) for '" + name_ + "'");
+}
+
 std::string log_level_to_string(LogLevel level)
 {
     switch (level) {
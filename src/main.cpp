@@ -3,6 +3,7 @@
 #include <string>
 
 #include "trdp_simulator/config_loader.hpp"
+#include "trdp_simulator/shard_coordinator.hpp"
 #include "trdp_simulator/simulator.hpp"
 #include "trdp_simulator/trdp_stack_adapter.hpp"
 
@@ -18,17 +19,23 @@ void signal_handler(int)
 
 void print_usage(const char *program)
 {
-    std::cerr << "Usage: " << program << " --config <path>" << std::endl;
+    std::cerr << "Usage: " << program << " --config <path> [--shard <n> [--coordinator <endpoint>]]" << std::endl;
 }
 }  // namespace
 
 int main(int argc, char **argv)
 {
     std::string configPath;
+    std::size_t shard = 0;
+    std::string coordinatorEndpoint;
     for (int i = 1; i < argc; ++i) {
         std::string arg(argv[i]);
         if ((arg == "--config" || arg == "-c") && i + 1 < argc) {
             configPath = argv[++i];
+        } else if (arg == "--shard" && i + 1 < argc) {
+            shard = static_cast<std::size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--coordinator" && i + 1 < argc) {
+            coordinatorEndpoint = argv[++i];
         } else if (arg == "--help" || arg == "-h") {
             print_usage(argv[0]);
             return 0;
@@ -55,7 +62,39 @@ int main(int argc, char **argv)
         std::cout << std::endl;
 #endif
         auto config = trdp_sim::load_configuration(configPath);
-        auto adapter = trdp_sim::create_trdp_stack_adapter();
+        if (shard != 0) {
+            // Worker mode: run one shard of a coordinated scenario and report back to the coordinator.
+            if (coordinatorEndpoint.empty()) {
+                coordinatorEndpoint = config.coordinator.listen;
+            }
+            auto shardConfig = trdp_sim::shard_configuration(config, shard);
+            trdp_sim::ShardWorkerLink link(coordinatorEndpoint, shard, trdp_sim::shard_count(config),
+                                           config.coordinator.connectTimeoutMs);
+            auto adapter = trdp_sim::create_trdp_stack_adapter(shardConfig.network);
+            trdp_sim::Simulator simulator(std::move(shardConfig), std::move(adapter));
+            gSimulator = &simulator;
+            std::signal(SIGINT, signal_handler);
+            std::signal(SIGTERM, signal_handler);
+            // Stack setup and registration happen before the common start time, so every shard starts sending
+            // at the same instant.
+            simulator.set_start_gate([&link, &simulator, &config] {
+                link.wait_for_start();
+                link.start_reporting([&simulator] { return simulator.metrics_snapshot(); },
+                                     config.coordinator.reportIntervalMs, [&simulator] { simulator.stop(); });
+            });
+            try {
+                simulator.run();
+            } catch (...) {
+                gSimulator = nullptr;
+                link.stop();
+                throw;
+            }
+            gSimulator = nullptr;
+            link.stop();
+            return 0;
+        }
+
+        auto adapter = trdp_sim::create_trdp_stack_adapter(config.network);
         trdp_sim::Simulator simulator(std::move(config), std::move(adapter));
         gSimulator = &simulator;
         std::signal(SIGINT, signal_handler);
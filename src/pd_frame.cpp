@@ -0,0 +1,70 @@
+#include "trdp_simulator/pd_frame.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace trdp_sim {
+namespace {
+
+constexpr std::uint16_t PdProtocolVersion = 0x0100U;
+constexpr std::uint16_t PdMessageType = 0x5064U;  // "Pd"
+constexpr std::size_t FcsSize = 4U;
+
+std::array<std::uint32_t, 256> make_fcs_table()
+{
+    std::array<std::uint32_t, 256> table{};
+    for (std::uint32_t index = 0; index < table.size(); ++index) {
+        std::uint32_t value = index;
+        for (int bit = 0; bit < 8; ++bit) {
+            value = (value & 1U) != 0 ? (value >> 1U) ^ 0xEDB88320U : value >> 1U;
+        }
+        table[index] = value;
+    }
+    return table;
+}
+
+void put_be32(std::uint8_t *out, std::uint32_t value)
+{
+    out[0] = static_cast<std::uint8_t>(value >> 24U);
+    out[1] = static_cast<std::uint8_t>(value >> 16U);
+    out[2] = static_cast<std::uint8_t>(value >> 8U);
+    out[3] = static_cast<std::uint8_t>(value);
+}
+
+}  // namespace
+
+std::uint32_t pd_frame_fcs(const std::uint8_t *data, std::size_t size)
+{
+    static const auto table = make_fcs_table();
+    std::uint32_t crc = 0xFFFFFFFFU;
+    for (std::size_t index = 0; index < size; ++index) {
+        crc = (crc >> 8U) ^ table[(crc ^ data[index]) & 0xFFU];
+    }
+    return ~crc;
+}
+
+void build_pd_frame(std::vector<std::uint8_t> &frame,
+                    const PdPublisherConfig &config,
+                    std::uint32_t sequence,
+                    const std::vector<std::uint8_t> &data)
+{
+    const std::size_t paddedSize = (data.size() + 3U) & ~static_cast<std::size_t>(3U);
+    frame.assign(PdFrameHeaderSize + paddedSize, 0U);
+    std::uint8_t *header = frame.data();
+    put_be32(header, sequence);
+    header[4] = static_cast<std::uint8_t>(PdProtocolVersion >> 8U);
+    header[5] = static_cast<std::uint8_t>(PdProtocolVersion);
+    header[6] = static_cast<std::uint8_t>(PdMessageType >> 8U);
+    header[7] = static_cast<std::uint8_t>(PdMessageType);
+    put_be32(header + 8, config.comId);
+    put_be32(header + 12, config.etbTopoCount);
+    put_be32(header + 16, config.opTrnTopoCount);
+    put_be32(header + 20, static_cast<std::uint32_t>(data.size()));
+    const std::uint32_t fcs = pd_frame_fcs(header, PdFrameHeaderSize - FcsSize);
+    for (std::size_t index = 0; index < FcsSize; ++index) {
+        header[PdFrameHeaderSize - FcsSize + index] = static_cast<std::uint8_t>(fcs >> (8U * index));
+    }
+    std::copy(data.begin(), data.end(), frame.begin() + PdFrameHeaderSize);
+}
+
+}  // namespace trdp_sim
@@ -0,0 +1,201 @@
+#include "trdp_simulator/pd_redundancy_manager.hpp"
+
+#include "trdp_simulator/thread_monitor.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace trdp_sim {
+
+PdRedundancyManager::PdRedundancyManager(const SimulatorConfig &config, TrdpStackAdapter &adapter, Logger &logger,
+                                         RuntimeMetrics &metrics, std::pmr::memory_resource *resource,
+                                         StallDetector *stallDetector)
+    : adapter_(adapter), logger_(logger), metrics_(metrics), stallDetector_(stallDetector), groups_(resource),
+      comIdGroups_(resource), tracks_(resource)
+{
+    // Groups used by publishers but not declared keep their previous behaviour of always leading.
+    for (const auto &publisher : config.pdPublishers) {
+        if (publisher.redundancyGroup == 0) {
+            continue;
+        }
+        auto &group = groups_[publisher.redundancyGroup];
+        group.config.id = publisher.redundancyGroup;
+        group.cycleTimeMs = std::max(group.cycleTimeMs, publisher.cycleTimeMs);
+        // Only partner groups share a ComID (see validate_configuration); a failover advances the generation of
+        // both, so either group tells the subscriber about the switchover.
+        comIdGroups_.emplace(publisher.comId, publisher.redundancyGroup);
+    }
+    for (const auto &declared : config.pdRedundancyGroups) {
+        auto it = groups_.find(declared.id);
+        if (it == groups_.end()) {
+            continue;
+        }
+        it->second.config = declared;
+        it->second.leader = declared.leader;
+    }
+    // Partnerships are symmetric; an undeclared partner starts in the opposite role.
+    for (const auto &declared : config.pdRedundancyGroups) {
+        auto partner = groups_.find(declared.partnerId);
+        if (declared.partnerId == 0 || partner == groups_.end()) {
+            continue;
+        }
+        if (partner->second.config.partnerId == 0) {
+            partner->second.config.partnerId = declared.id;
+            const bool partnerDeclared = std::any_of(config.pdRedundancyGroups.begin(), config.pdRedundancyGroups.end(),
+                [&declared](const PdRedundancyGroupConfig &group) { return group.id == declared.partnerId; });
+            if (!partnerDeclared) {
+                partner->second.leader = !declared.leader;
+            }
+        }
+    }
+}
+
+PdRedundancyManager::~PdRedundancyManager()
+{
+    stop();
+}
+
+void PdRedundancyManager::apply_initial_state()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (groups_.empty()) {
+        return;
+    }
+    std::vector<PdRedundancyState> states;
+    states.reserve(groups_.size());
+    for (const auto &entry : groups_) {
+        states.push_back({entry.first, entry.second.leader});
+    }
+    adapter_.set_pd_redundancy(states);
+    for (const auto &entry : groups_) {
+        metrics_.record_pd_redundancy_state(entry.first, entry.second.leader, false);
+    }
+}
+
+void PdRedundancyManager::start()
+{
+    const bool scheduled = std::any_of(groups_.begin(), groups_.end(),
+        [](const auto &entry) { return entry.second.config.failoverIntervalMs != 0; });
+    if (!scheduled || running_.exchange(true)) {
+        return;
+    }
+    schedulerThread_ = std::thread(&PdRedundancyManager::run, this);
+}
+
+void PdRedundancyManager::stop()
+{
+    if (!running_.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(scheduleMutex_);
+        scheduleCv_.notify_all();
+    }
+    if (schedulerThread_.joinable()) {
+        schedulerThread_.join();
+    }
+}
+
+bool PdRedundancyManager::failover(std::uint32_t groupId, std::string &error_message)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = groups_.find(groupId);
+    if (it == groups_.end()) {
+        error_message = "PD redundancy group not found";
+        return false;
+    }
+
+    auto &group = it->second;
+    std::vector<PdRedundancyState> states{{groupId, !group.leader}};
+    auto partner = groups_.find(group.config.partnerId);
+    if (partner != groups_.end()) {
+        states.push_back({partner->first, group.leader});
+    }
+
+    try {
+        adapter_.set_pd_redundancy(states);
+    } catch (const std::exception &ex) {
+        error_message = ex.what();
+        return false;
+    }
+
+    for (const auto &state : states) {
+        auto &changed = groups_.at(state.groupId);
+        changed.leader = state.leader;
+        ++changed.generation;
+        metrics_.record_pd_redundancy_state(state.groupId, state.leader, true);
+    }
+    logger_.info("PD redundancy group " + std::to_string(groupId) + " is now " +
+                 (group.leader ? "leader" : "follower"));
+    return true;
+}
+
+void PdRedundancyManager::on_receive(const std::string &subscriberName, std::uint32_t comId)
+{
+    const auto groupIt = comIdGroups_.find(comId);
+    if (groupIt == comIdGroups_.end()) {
+        return;
+    }
+
+    const auto now = clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto &group = groups_.at(groupIt->second);
+    auto &track = tracks_[subscriberName];
+    if (track.valid && track.seenGeneration != group.generation) {
+        const auto gapUs = std::chrono::duration_cast<std::chrono::microseconds>(now - track.lastReceive).count();
+        // The regular inter-arrival time is one cycle; the switchover itself may add at most one more.
+        const bool withinCycle = gapUs <= 2 * static_cast<std::int64_t>(group.cycleTimeMs) * 1000;
+        metrics_.record_pd_switchover_gap(subscriberName, gapUs, withinCycle);
+        if (!withinCycle) {
+            logger_.warn("PD subscriber '" + subscriberName + "' saw a switchover gap of " + std::to_string(gapUs) +
+                         " us in redundancy group " + std::to_string(group.config.id));
+        }
+    }
+    track.lastReceive = now;
+    track.seenGeneration = group.generation;
+    track.valid = true;
+}
+
+void PdRedundancyManager::run()
+{
+    set_thread_name("pd-redundancy");
+    LoopProbe &probe = stallDetector_ != nullptr ? stallDetector_->attach("pd-redundancy") : StallDetector::detached();
+    std::map<std::uint32_t, clock::time_point> deadlines;
+    const auto origin = clock::now();
+    for (const auto &entry : groups_) {
+        if (entry.second.config.failoverIntervalMs != 0) {
+            deadlines[entry.first] = origin + std::chrono::milliseconds(entry.second.config.failoverIntervalMs);
+        }
+    }
+
+    while (running_) {
+        const auto next = std::min_element(deadlines.begin(), deadlines.end(),
+            [](const auto &lhs, const auto &rhs) { return lhs.second < rhs.second; });
+        {
+            std::unique_lock<std::mutex> lock(scheduleMutex_);
+            probe.sleeping_until(next->second);
+            if (scheduleCv_.wait_until(lock, next->second, [this] { return !running_.load(); })) {
+                break;
+            }
+        }
+        probe.woke();
+
+        std::string error;
+        if (!failover(next->first, error)) {
+            logger_.error("Scheduled failover of PD redundancy group " + std::to_string(next->first) +
+                          " failed: " + error);
+        }
+        // A group that fell behind skips the missed failovers instead of flapping to catch up.
+        const auto interval = std::chrono::milliseconds(groups_.at(next->first).config.failoverIntervalMs);
+        const auto now = clock::now();
+        next->second += interval;
+        if (next->second < now) {
+            next->second = now + interval;
+        }
+    }
+    if (stallDetector_ != nullptr) {
+        stallDetector_->detach(probe);
+    }
+}
+
+}  // namespace trdp_sim
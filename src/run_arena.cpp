@@ -0,0 +1,48 @@
+#include "trdp_simulator/run_arena.hpp"
+
+namespace trdp_sim {
+
+RunArena::PhaseStats RunArena::phase_stats(Phase phase) const
+{
+    const auto &counters = counters_[static_cast<std::size_t>(phase)];
+    return {counters.allocations.load(), counters.bytes.load()};
+}
+
+const char *RunArena::phase_name(Phase phase)
+{
+    switch (phase) {
+    case Phase::Setup:
+        return "setup";
+    case Phase::Running:
+        return "running";
+    case Phase::Shutdown:
+        return "shutdown";
+    }
+    return "unknown";
+}
+
+void *RunArena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    void *pointer = pool_.allocate(bytes, alignment);
+    auto &counters = counters_[static_cast<std::size_t>(phase_.load())];
+    counters.allocations.fetch_add(1U, std::memory_order_relaxed);
+    counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    const auto inUse = bytesInUse_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    auto peak = peakBytes_.load(std::memory_order_relaxed);
+    while (inUse > peak && !peakBytes_.compare_exchange_weak(peak, inUse, std::memory_order_relaxed)) {
+    }
+    return pointer;
+}
+
+void RunArena::do_deallocate(void *pointer, std::size_t bytes, std::size_t alignment)
+{
+    pool_.deallocate(pointer, bytes, alignment);
+    bytesInUse_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+bool RunArena::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
+
+}  // namespace trdp_sim
@@ -1,7 +1,96 @@
 #include "trdp_simulator/runtime_metrics.hpp"
 
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
 namespace trdp_sim {
 
+void LatencyHistogram::record(std::int64_t microseconds)
+{
+    if (microseconds < 0) {
+        microseconds = 0;
+    }
+    std::size_t index = 0;
+    auto remaining = static_cast<std::uint64_t>(microseconds);
+    while (remaining != 0U && index + 1U < BucketCount) {
+        remaining >>= 1U;
+        ++index;
+    }
+    ++buckets_[index];
+    if (count_ == 0 || microseconds < minUs_) {
+        minUs_ = microseconds;
+    }
+    if (microseconds > maxUs_) {
+        maxUs_ = microseconds;
+    }
+    ++count_;
+    sumUs_ += microseconds;
+}
+
+std::int64_t LatencyHistogram::bucket_upper_bound_us(std::size_t index)
+{
+    return static_cast<std::int64_t>(1) << index;
+}
+
+std::int64_t LatencyHistogram::percentile_us(double percentile) const
+{
+    if (count_ == 0) {
+        return 0;
+    }
+    const auto target = static_cast<std::uint64_t>(percentile / 100.0 * static_cast<double>(count_ - 1U)) + 1U;
+    std::uint64_t seen = 0;
+    for (std::size_t index = 0; index < BucketCount; ++index) {
+        seen += buckets_[index];
+        if (seen >= target) {
+            return std::min(bucket_upper_bound_us(index), maxUs_);
+        }
+    }
+    return maxUs_;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    if (other.count_ == 0) {
+        return;
+    }
+    for (std::size_t index = 0; index < BucketCount; ++index) {
+        buckets_[index] += other.buckets_[index];
+    }
+    if (count_ == 0 || other.minUs_ < minUs_) {
+        minUs_ = other.minUs_;
+    }
+    maxUs_ = std::max(maxUs_, other.maxUs_);
+    count_ += other.count_;
+    sumUs_ += other.sumUs_;
+}
+
+LatencyHistogram LatencyHistogram::from_parts(const std::array<std::uint64_t, BucketCount> &buckets,
+                                              std::uint64_t count,
+                                              std::int64_t sumUs,
+                                              std::int64_t minUs,
+                                              std::int64_t maxUs)
+{
+    LatencyHistogram histogram;
+    histogram.buckets_ = buckets;
+    histogram.count_ = count;
+    histogram.sumUs_ = sumUs;
+    histogram.minUs_ = minUs;
+    histogram.maxUs_ = maxUs;
+    return histogram;
+}
+
+RuntimeMetrics::RuntimeMetrics(std::pmr::memory_resource *resource)
+    : pdPublishers_(resource),
+      pdSubscribers_(resource),
+      pdRedundancyGroups_(resource),
+      mdSenders_(resource),
+      mdListeners_(resource),
+      mdTcpPeers_(resource),
+      loops_(resource)
+{
+}
+
 void RuntimeMetrics::reset()
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -10,13 +99,25 @@ void RuntimeMetrics::reset()
     adapterState_ = "Idle";
     pdPublishers_.clear();
     pdSubscribers_.clear();
+    pdRedundancyGroups_.clear();
+    topology_ = TopologyStats{};
     mdSenders_.clear();
     mdListeners_.clear();
+    mdTcpPeers_.clear();
+    mdSessions_ = MdSessionStats{};
+    loops_.clear();
+    startedAt_ = {};
+    stoppedAt_ = {};
 }
 
 void RuntimeMetrics::set_simulator_running(bool running)
 {
     std::lock_guard<std::mutex> lock(mutex_);
+    if (running && !simulatorRunning_) {
+        startedAt_ = std::chrono::steady_clock::now();
+    } else if (!running && simulatorRunning_) {
+        stoppedAt_ = std::chrono::steady_clock::now();
+    }
     simulatorRunning_ = running;
 }
 
@@ -34,6 +135,44 @@ void RuntimeMetrics::record_pd_publish(const std::string &name)
     ++entry.packetsSent;
 }
 
+void RuntimeMetrics::record_pd_on_change_publish(const std::string &name, std::int64_t latencySavedUs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = ensure_entry(pdPublishers_, name);
+    ++entry.packetsSent;
+    ++entry.onChangeSends;
+    entry.latencySavedUs += latencySavedUs;
+}
+
+void RuntimeMetrics::record_pd_keep_alive_publish(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = ensure_entry(pdPublishers_, name);
+    ++entry.packetsSent;
+    ++entry.keepAliveSends;
+}
+
+void RuntimeMetrics::record_pd_tsn_launch(const std::string &name, bool lateHandoff)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = ensure_entry(pdPublishers_, name);
+    ++entry.packetsSent;
+    if (lateHandoff) {
+        ++entry.tsnLateHandoffs;
+    }
+}
+
+void RuntimeMetrics::record_pd_tsn_launch_report(const std::string &name, std::int64_t errorNs, bool missed)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = ensure_entry(pdPublishers_, name);
+    if (missed) {
+        ++entry.tsnMissedLaunches;
+        return;
+    }
+    entry.tsnLaunchError.record((errorNs < 0 ? -errorNs : errorNs) / 1000);
+}
+
 void RuntimeMetrics::record_pd_receive(const std::string &name)
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -41,6 +180,65 @@ void RuntimeMetrics::record_pd_receive(const std::string &name)
     ++entry.packetsReceived;
 }
 
+void RuntimeMetrics::record_pd_pull_request(const std::string &name, bool previousLost)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = ensure_entry(pdSubscribers_, name);
+    ++entry.pullRequestsSent;
+    if (previousLost) {
+        ++entry.pullRequestsLost;
+    }
+}
+
+void RuntimeMetrics::record_pd_pull_reply(const std::string &name, std::int64_t latencyUs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = ensure_entry(pdSubscribers_, name);
+    ++entry.pullRepliesReceived;
+    entry.pullLatency.record(latencyUs);
+}
+
+void RuntimeMetrics::record_pd_switchover_gap(const std::string &name, std::int64_t gapUs, bool withinCycle)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = ensure_entry(pdSubscribers_, name);
+    entry.switchoverGap.record(gapUs);
+    if (!withinCycle) {
+        ++entry.switchoversOverCycle;
+    }
+}
+
+void RuntimeMetrics::record_pd_redundancy_state(std::uint32_t groupId, bool leader, bool failover)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = pdRedundancyGroups_[groupId];
+    entry.id = groupId;
+    entry.leader = leader;
+    if (failover) {
+        ++entry.failovers;
+    }
+}
+
+void RuntimeMetrics::record_topology_update(std::uint32_t etbTopoCount,
+                                            std::uint32_t opTrnTopoCount,
+                                            std::size_t telegramsUpdated)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    topology_.etbTopoCount = etbTopoCount;
+    topology_.opTrnTopoCount = opTrnTopoCount;
+    ++topology_.updates;
+    topology_.telegramsUpdated += telegramsUpdated;
+}
+
+void RuntimeMetrics::record_topology_stale_window(std::int64_t staleWindowUs, bool withinCycle)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    topology_.staleWindow.record(staleWindowUs);
+    if (!withinCycle) {
+        ++topology_.staleOverCycle;
+    }
+}
+
 void RuntimeMetrics::record_md_request_sent(const std::string &name)
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -55,6 +253,53 @@ void RuntimeMetrics::record_md_reply_received(const std::string &name)
     ++entry.repliesReceived;
 }
 
+void RuntimeMetrics::record_md_notification_sent(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = ensure_entry(mdSenders_, name);
+    ++entry.notificationsSent;
+}
+
+void RuntimeMetrics::record_md_reply_query_received(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = ensure_entry(mdSenders_, name);
+    ++entry.replyQueriesReceived;
+}
+
+void RuntimeMetrics::record_md_confirm_sent(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = ensure_entry(mdSenders_, name);
+    ++entry.confirmsSent;
+}
+
+void RuntimeMetrics::record_md_reply_timeout(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = ensure_entry(mdSenders_, name);
+    ++entry.replyTimeouts;
+}
+
+void RuntimeMetrics::record_md_tcp_exchange(const std::string &peer)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = ensure_entry(mdTcpPeers_, peer);
+    ++entry.exchanges;
+}
+
+void RuntimeMetrics::record_md_tcp_connection(const std::string &peer, bool opened)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = ensure_entry(mdTcpPeers_, peer);
+    if (opened) {
+        ++entry.connects;
+        ++entry.openConnections;
+    } else if (entry.openConnections > 0) {
+        --entry.openConnections;
+    }
+}
+
 void RuntimeMetrics::record_md_request_received(const std::string &name)
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -69,6 +314,62 @@ void RuntimeMetrics::record_md_reply_sent(const std::string &name)
     ++entry.repliesSent;
 }
 
+void RuntimeMetrics::record_md_notification_received(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = ensure_entry(mdListeners_, name);
+    ++entry.notificationsReceived;
+}
+
+void RuntimeMetrics::record_md_reply_query_sent(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = ensure_entry(mdListeners_, name);
+    ++entry.replyQueriesSent;
+}
+
+void RuntimeMetrics::record_md_confirm_received(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = ensure_entry(mdListeners_, name);
+    ++entry.confirmsReceived;
+}
+
+void RuntimeMetrics::record_md_session_opened(bool caller)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &open = caller ? mdSessions_.callerOpen : mdSessions_.replierOpen;
+    auto &peak = caller ? mdSessions_.callerPeak : mdSessions_.replierPeak;
+    ++open;
+    peak = std::max(peak, open);
+}
+
+void RuntimeMetrics::record_md_session_closed(bool caller, bool timedOut)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &open = caller ? mdSessions_.callerOpen : mdSessions_.replierOpen;
+    if (open > 0) {
+        --open;
+    }
+    if (timedOut) {
+        ++(caller ? mdSessions_.callerTimeouts : mdSessions_.replierTimeouts);
+    }
+}
+
+void RuntimeMetrics::record_loop_lag(const std::string &name, std::int64_t lagUs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ensure_entry(loops_, name).lag.record(lagUs);
+}
+
+void RuntimeMetrics::record_loop_stall(const std::string &name, const std::string &trace)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = ensure_entry(loops_, name);
+    ++entry.stalls;
+    entry.lastStallTrace = trace;
+}
+
 RuntimeMetrics::Snapshot RuntimeMetrics::snapshot() const
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -79,21 +380,437 @@ RuntimeMetrics::Snapshot RuntimeMetrics::snapshot() const
     snap.pdPublishers.reserve(pdPublishers_.size());
     for (const auto &entry : pdPublishers_) {
         snap.pdPublishers.push_back(entry.second);
+        snap.pdPublishers.back().name.assign(entry.first);
     }
     snap.pdSubscribers.reserve(pdSubscribers_.size());
     for (const auto &entry : pdSubscribers_) {
         snap.pdSubscribers.push_back(entry.second);
+        snap.pdSubscribers.back().name.assign(entry.first);
+    }
+    snap.pdRedundancyGroups.reserve(pdRedundancyGroups_.size());
+    for (const auto &entry : pdRedundancyGroups_) {
+        snap.pdRedundancyGroups.push_back(entry.second);
     }
+    snap.topology = topology_;
     snap.mdSenders.reserve(mdSenders_.size());
     for (const auto &entry : mdSenders_) {
         snap.mdSenders.push_back(entry.second);
+        snap.mdSenders.back().name.assign(entry.first);
     }
     snap.mdListeners.reserve(mdListeners_.size());
     for (const auto &entry : mdListeners_) {
         snap.mdListeners.push_back(entry.second);
+        snap.mdListeners.back().name.assign(entry.first);
+    }
+    snap.mdTcpPeers.reserve(mdTcpPeers_.size());
+    for (const auto &entry : mdTcpPeers_) {
+        snap.mdTcpPeers.push_back(entry.second);
+        snap.mdTcpPeers.back().peer.assign(entry.first);
+    }
+    snap.mdSessions = mdSessions_;
+    snap.loops.reserve(loops_.size());
+    for (const auto &entry : loops_) {
+        snap.loops.push_back(entry.second);
+        snap.loops.back().name.assign(entry.first);
+    }
+    if (startedAt_ != std::chrono::steady_clock::time_point{}) {
+        const auto end = simulatorRunning_ ? std::chrono::steady_clock::now() : stoppedAt_;
+        snap.uptimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(end - startedAt_).count();
     }
     return snap;
 }
 
-}  // namespace trdp_sim
+namespace {
+
+class SnapshotWriter {
+public:
+    SnapshotWriter &number(std::int64_t value)
+    {
+        stream_ << value << ' ';
+        return *this;
+    }
+
+    SnapshotWriter &text(const std::string &value)
+    {
+        stream_ << value.size() << ':' << value << ' ';
+        return *this;
+    }
+
+    SnapshotWriter &histogram(const LatencyHistogram &value)
+    {
+        number(static_cast<std::int64_t>(value.count())).number(value.sum_us()).number(value.min_us()).number(value.max_us());
+        for (const auto bucket : value.buckets()) {
+            number(static_cast<std::int64_t>(bucket));
+        }
+        return *this;
+    }
+
+    std::string str() const { return stream_.str(); }
+
+private:
+    std::ostringstream stream_;
+};
+
+class SnapshotReader {
+public:
+    explicit SnapshotReader(const std::string &encoded) : stream_(encoded) {}
+
+    std::int64_t number()
+    {
+        std::int64_t value = 0;
+        if (!(stream_ >> value)) {
+            throw std::runtime_error("Malformed metrics snapshot");
+        }
+        return value;
+    }
+
+    std::uint64_t count() { return static_cast<std::uint64_t>(number()); }
+
+    std::string text()
+    {
+        std::size_t length = 0;
+        char separator = 0;
+        if (!(stream_ >> length >> separator) || separator != ':') {
+            throw std::runtime_error("Malformed metrics snapshot");
+        }
+        std::string value(length, '\0');
+        if (!stream_.read(&value[0], static_cast<std::streamsize>(length))) {
+            throw std::runtime_error("Malformed metrics snapshot");
+        }
+        return value;
+    }
+
+    LatencyHistogram histogram()
+    {
+        const auto total = count();
+        const auto sum = number();
+        const auto min = number();
+        const auto max = number();
+        std::array<std::uint64_t, LatencyHistogram::BucketCount> buckets{};
+        for (auto &bucket : buckets) {
+            bucket = count();
+        }
+        return LatencyHistogram::from_parts(buckets, total, sum, min, max);
+    }
+
+private:
+    std::istringstream stream_;
+};
+
+template <typename Stats, typename Key>
+Stats &merge_entry(std::vector<Stats> &entries, const Key &key, Key Stats::*field)
+{
+    for (auto &entry : entries) {
+        if (entry.*field == key) {
+            return entry;
+        }
+    }
+    entries.emplace_back();
+    entries.back().*field = key;
+    return entries.back();
+}
+
+}  // namespace
+
+std::string RuntimeMetrics::encode_snapshot(const Snapshot &snapshot)
+{
+    SnapshotWriter writer;
+    writer.number(1).number(snapshot.simulatorRunning).number(snapshot.adapterInitialized).text(snapshot.adapterState);
+
+    writer.number(static_cast<std::int64_t>(snapshot.pdPublishers.size()));
+    for (const auto &stats : snapshot.pdPublishers) {
+        writer.text(stats.name)
+            .number(static_cast<std::int64_t>(stats.packetsSent))
+            .number(static_cast<std::int64_t>(stats.onChangeSends))
+            .number(static_cast<std::int64_t>(stats.keepAliveSends))
+            .number(stats.latencySavedUs)
+            .number(static_cast<std::int64_t>(stats.tsnLateHandoffs))
+            .number(static_cast<std::int64_t>(stats.tsnMissedLaunches))
+            .histogram(stats.tsnLaunchError);
+    }
+
+    writer.number(static_cast<std::int64_t>(snapshot.pdSubscribers.size()));
+    for (const auto &stats : snapshot.pdSubscribers) {
+        writer.text(stats.name)
+            .number(static_cast<std::int64_t>(stats.packetsReceived))
+            .number(static_cast<std::int64_t>(stats.pullRequestsSent))
+            .number(static_cast<std::int64_t>(stats.pullRepliesReceived))
+            .number(static_cast<std::int64_t>(stats.pullRequestsLost))
+            .histogram(stats.pullLatency)
+            .number(static_cast<std::int64_t>(stats.switchoversOverCycle))
+            .histogram(stats.switchoverGap);
+    }
+
+    writer.number(static_cast<std::int64_t>(snapshot.pdRedundancyGroups.size()));
+    for (const auto &stats : snapshot.pdRedundancyGroups) {
+        writer.number(stats.id).number(stats.leader).number(static_cast<std::int64_t>(stats.failovers));
+    }
+
+    const auto &topology = snapshot.topology;
+    writer.number(topology.etbTopoCount)
+        .number(topology.opTrnTopoCount)
+        .number(static_cast<std::int64_t>(topology.updates))
+        .number(static_cast<std::int64_t>(topology.telegramsUpdated))
+        .number(static_cast<std::int64_t>(topology.staleOverCycle))
+        .histogram(topology.staleWindow);
+
+    writer.number(static_cast<std::int64_t>(snapshot.mdSenders.size()));
+    for (const auto &stats : snapshot.mdSenders) {
+        writer.text(stats.name)
+            .number(static_cast<std::int64_t>(stats.requestsSent))
+            .number(static_cast<std::int64_t>(stats.repliesReceived))
+            .number(static_cast<std::int64_t>(stats.notificationsSent))
+            .number(static_cast<std::int64_t>(stats.replyQueriesReceived))
+            .number(static_cast<std::int64_t>(stats.confirmsSent))
+            .number(static_cast<std::int64_t>(stats.replyTimeouts));
+    }
+
+    writer.number(static_cast<std::int64_t>(snapshot.mdListeners.size()));
+    for (const auto &stats : snapshot.mdListeners) {
+        writer.text(stats.name)
+            .number(static_cast<std::int64_t>(stats.requestsReceived))
+            .number(static_cast<std::int64_t>(stats.repliesSent))
+            .number(static_cast<std::int64_t>(stats.notificationsReceived))
+            .number(static_cast<std::int64_t>(stats.replyQueriesSent))
+            .number(static_cast<std::int64_t>(stats.confirmsReceived));
+    }
+
+    writer.number(static_cast<std::int64_t>(snapshot.mdTcpPeers.size()));
+    for (const auto &stats : snapshot.mdTcpPeers) {
+        writer.text(stats.peer)
+            .number(static_cast<std::int64_t>(stats.exchanges))
+            .number(static_cast<std::int64_t>(stats.connects))
+            .number(static_cast<std::int64_t>(stats.openConnections));
+    }
+
+    const auto &sessions = snapshot.mdSessions;
+    writer.number(static_cast<std::int64_t>(sessions.callerOpen))
+        .number(static_cast<std::int64_t>(sessions.callerPeak))
+        .number(static_cast<std::int64_t>(sessions.callerTimeouts))
+        .number(static_cast<std::int64_t>(sessions.replierOpen))
+        .number(static_cast<std::int64_t>(sessions.replierPeak))
+        .number(static_cast<std::int64_t>(sessions.replierTimeouts))
+        .number(snapshot.uptimeMs);
+
+    writer.number(static_cast<std::int64_t>(snapshot.loops.size()));
+    for (const auto &stats : snapshot.loops) {
+        writer.text(stats.name)
+            .histogram(stats.lag)
+            .number(static_cast<std::int64_t>(stats.stalls))
+            .text(stats.lastStallTrace);
+    }
+
+    for (const auto &phase : snapshot.arenaPhases) {
+        writer.number(static_cast<std::int64_t>(phase.allocations)).number(static_cast<std::int64_t>(phase.bytes));
+    }
+    writer.number(static_cast<std::int64_t>(snapshot.arenaBytesInUse))
+        .number(static_cast<std::int64_t>(snapshot.arenaPeakBytes));
+    return writer.str();
+}
+
+RuntimeMetrics::Snapshot RuntimeMetrics::decode_snapshot(const std::string &encoded)
+{
+    SnapshotReader reader(encoded);
+    if (reader.number() != 1) {
+        throw std::runtime_error("Unsupported metrics snapshot version");
+    }
+
+    Snapshot snapshot;
+    snapshot.simulatorRunning = reader.number() != 0;
+    snapshot.adapterInitialized = reader.number() != 0;
+    snapshot.adapterState = reader.text();
+
+    snapshot.pdPublishers.resize(reader.count());
+    for (auto &stats : snapshot.pdPublishers) {
+        stats.name = reader.text();
+        stats.packetsSent = reader.count();
+        stats.onChangeSends = reader.count();
+        stats.keepAliveSends = reader.count();
+        stats.latencySavedUs = reader.number();
+        stats.tsnLateHandoffs = reader.count();
+        stats.tsnMissedLaunches = reader.count();
+        stats.tsnLaunchError = reader.histogram();
+    }
+
+    snapshot.pdSubscribers.resize(reader.count());
+    for (auto &stats : snapshot.pdSubscribers) {
+        stats.name = reader.text();
+        stats.packetsReceived = reader.count();
+        stats.pullRequestsSent = reader.count();
+        stats.pullRepliesReceived = reader.count();
+        stats.pullRequestsLost = reader.count();
+        stats.pullLatency = reader.histogram();
+        stats.switchoversOverCycle = reader.count();
+        stats.switchoverGap = reader.histogram();
+    }
+
+    snapshot.pdRedundancyGroups.resize(reader.count());
+    for (auto &stats : snapshot.pdRedundancyGroups) {
+        stats.id = static_cast<std::uint32_t>(reader.number());
+        stats.leader = reader.number() != 0;
+        stats.failovers = reader.count();
+    }
+
+    auto &topology = snapshot.topology;
+    topology.etbTopoCount = static_cast<std::uint32_t>(reader.number());
+    topology.opTrnTopoCount = static_cast<std::uint32_t>(reader.number());
+    topology.updates = reader.count();
+    topology.telegramsUpdated = reader.count();
+    topology.staleOverCycle = reader.count();
+    topology.staleWindow = reader.histogram();
+
+    snapshot.mdSenders.resize(reader.count());
+    for (auto &stats : snapshot.mdSenders) {
+        stats.name = reader.text();
+        stats.requestsSent = reader.count();
+        stats.repliesReceived = reader.count();
+        stats.notificationsSent = reader.count();
+        stats.replyQueriesReceived = reader.count();
+        stats.confirmsSent = reader.count();
+        stats.replyTimeouts = reader.count();
+    }
+
+    snapshot.mdListeners.resize(reader.count());
+    for (auto &stats : snapshot.mdListeners) {
+        stats.name = reader.text();
+        stats.requestsReceived = reader.count();
+        stats.repliesSent = reader.count();
+        stats.notificationsReceived = reader.count();
+        stats.replyQueriesSent = reader.count();
+        stats.confirmsReceived = reader.count();
+    }
+
+    snapshot.mdTcpPeers.resize(reader.count());
+    for (auto &stats : snapshot.mdTcpPeers) {
+        stats.peer = reader.text();
+        stats.exchanges = reader.count();
+        stats.connects = reader.count();
+        stats.openConnections = reader.count();
+    }
+
+    auto &sessions = snapshot.mdSessions;
+    sessions.callerOpen = reader.count();
+    sessions.callerPeak = reader.count();
+    sessions.callerTimeouts = reader.count();
+    sessions.replierOpen = reader.count();
+    sessions.replierPeak = reader.count();
+    sessions.replierTimeouts = reader.count();
+    snapshot.uptimeMs = reader.number();
+
+    snapshot.loops.resize(reader.count());
+    for (auto &stats : snapshot.loops) {
+        stats.name = reader.text();
+        stats.lag = reader.histogram();
+        stats.stalls = reader.count();
+        stats.lastStallTrace = reader.text();
+    }
+
+    for (auto &phase : snapshot.arenaPhases) {
+        phase.allocations = reader.count();
+        phase.bytes = reader.count();
+    }
+    snapshot.arenaBytesInUse = reader.count();
+    snapshot.arenaPeakBytes = reader.count();
+    return snapshot;
+}
+
+void RuntimeMetrics::merge_snapshot(Snapshot &into, const Snapshot &from)
+{
+    into.simulatorRunning = into.simulatorRunning || from.simulatorRunning;
+
+    for (const auto &stats : from.pdPublishers) {
+        auto &entry = merge_entry(into.pdPublishers, stats.name, &PdPublisherStats::name);
+        entry.packetsSent += stats.packetsSent;
+        entry.onChangeSends += stats.onChangeSends;
+        entry.keepAliveSends += stats.keepAliveSends;
+        entry.latencySavedUs += stats.latencySavedUs;
+        entry.tsnLateHandoffs += stats.tsnLateHandoffs;
+        entry.tsnMissedLaunches += stats.tsnMissedLaunches;
+        entry.tsnLaunchError.merge(stats.tsnLaunchError);
+    }
+
+    for (const auto &stats : from.pdSubscribers) {
+        auto &entry = merge_entry(into.pdSubscribers, stats.name, &PdSubscriberStats::name);
+        entry.packetsReceived += stats.packetsReceived;
+        entry.pullRequestsSent += stats.pullRequestsSent;
+        entry.pullRepliesReceived += stats.pullRepliesReceived;
+        entry.pullRequestsLost += stats.pullRequestsLost;
+        entry.pullLatency.merge(stats.pullLatency);
+        entry.switchoversOverCycle += stats.switchoversOverCycle;
+        entry.switchoverGap.merge(stats.switchoverGap);
+    }
+
+    // A redundancy group can span shards; each shard reports the same role, so failovers are not summed.
+    for (const auto &stats : from.pdRedundancyGroups) {
+        auto &entry = merge_entry(into.pdRedundancyGroups, stats.id, &PdRedundancyGroupStats::id);
+        entry.leader = entry.leader || stats.leader;
+        entry.failovers = std::max(entry.failovers, stats.failovers);
+    }
 
+    auto &topology = into.topology;
+    if (from.topology.updates > topology.updates) {
+        topology.etbTopoCount = from.topology.etbTopoCount;
+        topology.opTrnTopoCount = from.topology.opTrnTopoCount;
+    }
+    topology.updates = std::max(topology.updates, from.topology.updates);
+    topology.telegramsUpdated += from.topology.telegramsUpdated;
+    topology.staleOverCycle += from.topology.staleOverCycle;
+    topology.staleWindow.merge(from.topology.staleWindow);
+
+    for (const auto &stats : from.mdSenders) {
+        auto &entry = merge_entry(into.mdSenders, stats.name, &MdSenderStats::name);
+        entry.requestsSent += stats.requestsSent;
+        entry.repliesReceived += stats.repliesReceived;
+        entry.notificationsSent += stats.notificationsSent;
+        entry.replyQueriesReceived += stats.replyQueriesReceived;
+        entry.confirmsSent += stats.confirmsSent;
+        entry.replyTimeouts += stats.replyTimeouts;
+    }
+
+    for (const auto &stats : from.mdListeners) {
+        auto &entry = merge_entry(into.mdListeners, stats.name, &MdListenerStats::name);
+        entry.requestsReceived += stats.requestsReceived;
+        entry.repliesSent += stats.repliesSent;
+        entry.notificationsReceived += stats.notificationsReceived;
+        entry.replyQueriesSent += stats.replyQueriesSent;
+        entry.confirmsReceived += stats.confirmsReceived;
+    }
+
+    // Shards keep separate connection pools, so peers shared between shards add up.
+    for (const auto &stats : from.mdTcpPeers) {
+        auto &entry = merge_entry(into.mdTcpPeers, stats.peer, &MdTcpPeerStats::peer);
+        entry.exchanges += stats.exchanges;
+        entry.connects += stats.connects;
+        entry.openConnections += stats.openConnections;
+    }
+
+    // Each shard has its own session tables; peaks are summed as an upper bound of the combined occupancy.
+    auto &sessions = into.mdSessions;
+    sessions.callerOpen += from.mdSessions.callerOpen;
+    sessions.callerPeak += from.mdSessions.callerPeak;
+    sessions.callerTimeouts += from.mdSessions.callerTimeouts;
+    sessions.replierOpen += from.mdSessions.replierOpen;
+    sessions.replierPeak += from.mdSessions.replierPeak;
+    sessions.replierTimeouts += from.mdSessions.replierTimeouts;
+    into.uptimeMs = std::max(into.uptimeMs, from.uptimeMs);
+
+    // Poll threads carry the same names in every worker process and are combined per name.
+    for (const auto &stats : from.loops) {
+        auto &entry = merge_entry(into.loops, stats.name, &LoopStats::name);
+        entry.lag.merge(stats.lag);
+        entry.stalls += stats.stalls;
+        if (!stats.lastStallTrace.empty()) {
+            entry.lastStallTrace = stats.lastStallTrace;
+        }
+    }
+
+    // Every process has its own arena, so the footprint of the run is their sum.
+    for (std::size_t index = 0; index < into.arenaPhases.size(); ++index) {
+        into.arenaPhases[index].allocations += from.arenaPhases[index].allocations;
+        into.arenaPhases[index].bytes += from.arenaPhases[index].bytes;
+    }
+    into.arenaBytesInUse += from.arenaBytesInUse;
+    into.arenaPeakBytes += from.arenaPeakBytes;
+}
+
+}  // namespace trdp_sim
@@ -0,0 +1,756 @@
+#include "trdp_simulator/shard_coordinator.hpp"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+
+#include "trdp_simulator/sharded_stack_adapter.hpp"
+#include "trdp_simulator/thread_monitor.hpp"
+
+namespace trdp_sim {
+namespace {
+
+// Messages are single text lines; METRICS is followed by a payload of the announced length.
+//   worker -> coordinator: "HELLO <shard> <count>", "METRICS <length>"
+//   coordinator -> worker: "START <CLOCK_REALTIME ns>", "STOP"
+constexpr std::size_t MaxMessageSize = 16U * 1024U * 1024U;
+
+struct Endpoint {
+    bool local{true};
+    std::string path;
+    std::string host;
+    std::string port;
+};
+
+Endpoint parse_endpoint(const std::string &text)
+{
+    Endpoint endpoint;
+    if (text.rfind("unix:", 0) == 0) {
+        endpoint.path = text.substr(5);
+        if (endpoint.path.empty() || endpoint.path.size() >= sizeof(sockaddr_un::sun_path)) {
+            throw std::runtime_error("Invalid unix socket path in '" + text + "'");
+        }
+        return endpoint;
+    }
+    if (text.rfind("tcp:", 0) == 0) {
+        const auto separator = text.rfind(':');
+        if (separator <= 4U || separator + 1U >= text.size()) {
+            throw std::runtime_error("Coordinator endpoint '" + text + "' must be tcp:<host>:<port>");
+        }
+        endpoint.local = false;
+        endpoint.host = text.substr(4, separator - 4U);
+        endpoint.port = text.substr(separator + 1U);
+        return endpoint;
+    }
+    throw std::runtime_error("Coordinator endpoint '" + text + "' must start with unix: or tcp:");
+}
+
+std::string errno_text()
+{
+    return std::strerror(errno);
+}
+
+std::int64_t realtime_now_ns()
+{
+    timespec now{};
+    clock_gettime(CLOCK_REALTIME, &now);
+    return static_cast<std::int64_t>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+}
+
+addrinfo *resolve(const Endpoint &endpoint, bool passive)
+{
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+    const char *host = endpoint.host.empty() || endpoint.host == "*" ? nullptr : endpoint.host.c_str();
+    addrinfo *result = nullptr;
+    const int err = getaddrinfo(host, endpoint.port.c_str(), &hints, &result);
+    if (err != 0) {
+        throw std::runtime_error("Unable to resolve '" + endpoint.host + ":" + endpoint.port + "': " + gai_strerror(err));
+    }
+    return result;
+}
+
+sockaddr_un unix_address(const Endpoint &endpoint)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, endpoint.path.c_str(), endpoint.path.size());
+    return address;
+}
+
+int listen_on(const Endpoint &endpoint)
+{
+    if (endpoint.local) {
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            throw std::runtime_error("Unable to create coordinator socket: " + errno_text());
+        }
+        ::unlink(endpoint.path.c_str());
+        const auto address = unix_address(endpoint);
+        if (::bind(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 || ::listen(fd, 64) != 0) {
+            const auto reason = errno_text();
+            ::close(fd);
+            throw std::runtime_error("Unable to listen on unix:" + endpoint.path + ": " + reason);
+        }
+        return fd;
+    }
+
+    addrinfo *addresses = resolve(endpoint, true);
+    std::string reason = "no usable address";
+    for (addrinfo *entry = addresses; entry != nullptr; entry = entry->ai_next) {
+        const int fd = ::socket(entry->ai_family, entry->ai_socktype | SOCK_CLOEXEC, entry->ai_protocol);
+        if (fd < 0) {
+            reason = errno_text();
+            continue;
+        }
+        const int enable = 1;
+        (void) ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+        if (::bind(fd, entry->ai_addr, entry->ai_addrlen) == 0 && ::listen(fd, 64) == 0) {
+            freeaddrinfo(addresses);
+            return fd;
+        }
+        reason = errno_text();
+        ::close(fd);
+    }
+    freeaddrinfo(addresses);
+    throw std::runtime_error("Unable to listen on tcp:" + endpoint.host + ":" + endpoint.port + ": " + reason);
+}
+
+int try_connect(const Endpoint &endpoint)
+{
+    if (endpoint.local) {
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        const auto address = unix_address(endpoint);
+        if (fd >= 0 && ::connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0) {
+            return fd;
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return -1;
+    }
+
+    addrinfo *addresses = resolve(endpoint, false);
+    for (addrinfo *entry = addresses; entry != nullptr; entry = entry->ai_next) {
+        const int fd = ::socket(entry->ai_family, entry->ai_socktype | SOCK_CLOEXEC, entry->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (::connect(fd, entry->ai_addr, entry->ai_addrlen) == 0) {
+            const int enable = 1;
+            (void) ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+            freeaddrinfo(addresses);
+            return fd;
+        }
+        ::close(fd);
+    }
+    freeaddrinfo(addresses);
+    return -1;
+}
+
+bool send_all(int fd, const std::string &data)
+{
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t result = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        sent += static_cast<std::size_t>(result);
+    }
+    return true;
+}
+
+// Reads whatever is available into the buffer; returns false once the peer has closed the connection.
+bool fill(int fd, std::string &buffer)
+{
+    char chunk[4096];
+    const ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+    if (received < 0) {
+        return errno == EINTR || errno == EAGAIN;
+    }
+    if (received == 0) {
+        return false;
+    }
+    buffer.append(chunk, static_cast<std::size_t>(received));
+    return true;
+}
+
+// Extracts the next complete message, if any, from the buffer.
+bool next_message(std::string &buffer, std::string &header, std::string &payload)
+{
+    const auto newline = buffer.find('\n');
+    if (newline == std::string::npos) {
+        if (buffer.size() > MaxMessageSize) {
+            throw std::runtime_error("Coordinator message header too long");
+        }
+        return false;
+    }
+    std::string line = buffer.substr(0, newline);
+    std::size_t consumed = newline + 1U;
+    payload.clear();
+    if (line.rfind("METRICS ", 0) == 0) {
+        const auto length = static_cast<std::size_t>(std::stoull(line.substr(8)));
+        if (length > MaxMessageSize) {
+            throw std::runtime_error("Coordinator metrics message too large");
+        }
+        if (buffer.size() < consumed + length) {
+            return false;
+        }
+        payload = buffer.substr(consumed, length);
+        consumed += length;
+    }
+    header = std::move(line);
+    buffer.erase(0, consumed);
+    return true;
+}
+
+std::string default_worker_binary()
+{
+    std::error_code ec;
+    const auto self = std::filesystem::read_symlink("/proc/self/exe", ec);
+    if (ec) {
+        return "trdp-simulator";
+    }
+    return (self.parent_path() / "trdp-simulator").string();
+}
+
+}  // namespace
+
+std::size_t shard_count(const SimulatorConfig &config)
+{
+    return std::max<std::size_t>(config.network.sessions.size(), 1U);
+}
+
+SimulatorConfig shard_configuration(const SimulatorConfig &config, std::size_t shard)
+{
+    const std::size_t count = shard_count(config);
+    if (shard == 0 || shard > count) {
+        throw std::runtime_error("Shard " + std::to_string(shard) + " is outside 1.." + std::to_string(count));
+    }
+
+    SimulatorConfig result = config;
+    result.coordinator.enabled = false;
+    result.network.sessions.clear();
+    if (!config.network.sessions.empty()) {
+        SessionConfig session = config.network.sessions[shard - 1U];
+        if (!session.hostIp.empty()) {
+            result.network.hostIp = session.hostIp;
+        }
+        if (session.pdPort != 0) {
+            result.network.pdPort = session.pdPort;
+        }
+        if (session.mdPort != 0) {
+            result.network.mdPort = session.mdPort;
+        }
+        result.network.sessions.push_back({std::string(), 0, 0, session.cpu});
+    }
+    if (!result.logging.filePath.empty()) {
+        std::filesystem::path logPath(result.logging.filePath);
+        logPath.replace_filename(logPath.stem().string() + ".shard" + std::to_string(shard) +
+                                 logPath.extension().string());
+        result.logging.filePath = logPath.string();
+    }
+    if (!result.logging.binaryFilePath.empty()) {
+        std::filesystem::path logPath(result.logging.binaryFilePath);
+        logPath.replace_filename(logPath.stem().string() + ".shard" + std::to_string(shard) +
+                                 logPath.extension().string());
+        result.logging.binaryFilePath = logPath.string();
+    }
+
+    auto keep = [&](auto &items) {
+        using Item = typename std::decay_t<decltype(items)>::value_type;
+        std::vector<Item> kept;
+        for (auto &item : items) {
+            if (ShardedTrdpStackAdapter::shard_for(item.session, item.comId, count) == shard - 1U) {
+                item.session = 0;
+                kept.push_back(std::move(item));
+            }
+        }
+        items = std::move(kept);
+    };
+    keep(result.pdPublishers);
+    keep(result.pdSubscribers);
+    keep(result.mdSenders);
+    keep(result.mdListeners);
+
+    std::vector<PdRedundancyGroupConfig> groups;
+    for (const auto &group : result.pdRedundancyGroups) {
+        for (const auto &publisher : result.pdPublishers) {
+            if (publisher.redundancyGroup == group.id) {
+                groups.push_back(group);
+                break;
+            }
+        }
+    }
+    result.pdRedundancyGroups = std::move(groups);
+    return result;
+}
+
+ShardCoordinator::ShardCoordinator(const SimulatorConfig &config, Logger &logger)
+    : config_(config), logger_(logger), shards_(shard_count(config))
+{
+}
+
+ShardCoordinator::~ShardCoordinator()
+{
+    stop();
+}
+
+void ShardCoordinator::start()
+{
+    if (running_.exchange(true)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &shard : shards_) {
+            shard = Shard{};
+        }
+        startTimeNs_ = 0;
+        stopping_ = false;
+    }
+
+    try {
+        listenFd_ = listen_on(parse_endpoint(config_.coordinator.listen));
+        logger_.info("Coordinator listening on " + config_.coordinator.listen + " for " +
+                     std::to_string(shards_.size()) + " worker shard(s)");
+        if (config_.coordinator.launchWorkers) {
+            for (std::size_t index = 0; index < shards_.size(); ++index) {
+                launch_worker(index);
+            }
+        }
+
+        const auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(config_.coordinator.connectTimeoutMs);
+        for (;;) {
+            std::size_t connected = 0;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (const auto &shard : shards_) {
+                    connected += shard.connected ? 1U : 0U;
+                }
+            }
+            if (connected == shards_.size()) {
+                break;
+            }
+            if (std::chrono::steady_clock::now() >= deadline) {
+                throw std::runtime_error("Only " + std::to_string(connected) + " of " + std::to_string(shards_.size()) +
+                                         " worker shards connected to the coordinator");
+            }
+            poll_once(100);
+            reap_workers(false);
+        }
+    } catch (...) {
+        stop();
+        throw;
+    }
+
+    // Every worker sleeps until the same wall-clock instant, so cyclic traffic starts in phase across hosts.
+    std::lock_guard<std::mutex> lock(mutex_);
+    startTimeNs_ = realtime_now_ns() + static_cast<std::int64_t>(config_.coordinator.startDelayMs) * 1000000LL;
+    const std::string message = "START " + std::to_string(startTimeNs_) + "\n";
+    for (auto &shard : shards_) {
+        (void) send_all(shard.connection.fd, message);
+    }
+    logger_.info("All worker shards connected; releasing them in " + std::to_string(config_.coordinator.startDelayMs) +
+                 " ms");
+    ioThread_ = std::thread(&ShardCoordinator::run, this);
+}
+
+void ShardCoordinator::stop()
+{
+    if (!running_.load() && listenFd_ < 0) {
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stopping_ = true;
+        for (auto &shard : shards_) {
+            if (shard.connected) {
+                (void) send_all(shard.connection.fd, "STOP\n");
+            }
+        }
+        // Give workers a moment to send their final metrics before the connections go away.
+        if (ioThread_.joinable()) {
+            cv_.wait_for(lock, std::chrono::seconds(3), [this] {
+                for (const auto &shard : shards_) {
+                    if (shard.connected) {
+                        return false;
+                    }
+                }
+                return true;
+            });
+        }
+    }
+
+    running_.store(false);
+    if (ioThread_.joinable()) {
+        ioThread_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &connection : pending_) {
+        ::close(connection.fd);
+    }
+    pending_.clear();
+    for (auto &shard : shards_) {
+        if (shard.connection.fd >= 0) {
+            ::close(shard.connection.fd);
+            shard.connection.fd = -1;
+        }
+        shard.connected = false;
+    }
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        listenFd_ = -1;
+        const auto endpoint = parse_endpoint(config_.coordinator.listen);
+        if (endpoint.local) {
+            ::unlink(endpoint.path.c_str());
+        }
+    }
+    reap_workers(true);
+}
+
+RuntimeMetrics::Snapshot ShardCoordinator::metrics_snapshot() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    RuntimeMetrics::Snapshot merged;
+    std::size_t connected = 0;
+    for (const auto &shard : shards_) {
+        connected += shard.connected ? 1U : 0U;
+        if (shard.haveSnapshot) {
+            RuntimeMetrics::merge_snapshot(merged, shard.snapshot);
+        }
+    }
+    merged.adapterInitialized = connected == shards_.size();
+    if (startTimeNs_ == 0) {
+        merged.adapterState = "Waiting for worker shards (" + std::to_string(connected) + "/" +
+                              std::to_string(shards_.size()) + ")";
+    } else {
+        merged.adapterState = "Coordinating " + std::to_string(connected) + "/" + std::to_string(shards_.size()) +
+                              " worker shards";
+    }
+    return merged;
+}
+
+void ShardCoordinator::launch_worker(std::size_t index)
+{
+    if (config_.sourcePath.empty()) {
+        throw std::runtime_error("Launching worker shards requires a configuration loaded from a file");
+    }
+    const std::string binary =
+        config_.coordinator.workerBinary.empty() ? default_worker_binary() : config_.coordinator.workerBinary;
+    const std::string shard = std::to_string(index + 1U);
+    // Only async-signal-safe calls may run in the child, so the argument vector is built up front.
+    const std::vector<const char *> args = {binary.c_str(), "--config", config_.sourcePath.c_str(), "--shard",
+                                            shard.c_str(), "--coordinator", config_.coordinator.listen.c_str(), nullptr};
+
+    const pid_t pid = ::fork();
+    if (pid < 0) {
+        throw std::runtime_error("Unable to launch worker shard " + shard + ": " + errno_text());
+    }
+    if (pid == 0) {
+        ::execv(binary.c_str(), const_cast<char *const *>(args.data()));
+        ::_exit(127);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    shards_[index].pid = pid;
+    logger_.info("Launched worker shard " + shard + " (pid " + std::to_string(pid) + ")");
+}
+
+void ShardCoordinator::run()
+{
+    set_thread_name("coordinator");
+    while (running_.load()) {
+        poll_once(200);
+        reap_workers(false);
+    }
+}
+
+void ShardCoordinator::poll_once(int timeoutMs)
+{
+    std::vector<pollfd> fds;
+    std::size_t pendingCount = 0;
+    std::vector<std::size_t> shardIndexes;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fds.push_back({listenFd_, POLLIN, 0});
+        for (const auto &connection : pending_) {
+            fds.push_back({connection.fd, POLLIN, 0});
+        }
+        pendingCount = pending_.size();
+        for (std::size_t index = 0; index < shards_.size(); ++index) {
+            if (shards_[index].connected) {
+                fds.push_back({shards_[index].connection.fd, POLLIN, 0});
+                shardIndexes.push_back(index);
+            }
+        }
+    }
+
+    if (::poll(fds.data(), fds.size(), timeoutMs) <= 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Shards first: handling pending connections may reorder pending_ and reassign shard slots.
+    for (std::size_t slot = 0; slot < shardIndexes.size(); ++slot) {
+        if (fds[1U + pendingCount + slot].revents != 0) {
+            (void) handle_shard(shardIndexes[slot]);
+        }
+    }
+    for (std::size_t slot = pendingCount; slot > 0; --slot) {
+        if (fds[slot].revents == 0) {
+            continue;
+        }
+        if (!handle_pending(pending_[slot - 1U])) {
+            pending_.erase(pending_.begin() + static_cast<std::ptrdiff_t>(slot - 1U));
+        }
+    }
+    if ((fds[0].revents & POLLIN) != 0) {
+        const int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd >= 0) {
+            pending_.push_back({fd, std::string()});
+        }
+    }
+}
+
+bool ShardCoordinator::handle_pending(Connection &connection)
+{
+    std::string header;
+    std::string payload;
+    try {
+        if (!fill(connection.fd, connection.buffer) || !next_message(connection.buffer, header, payload)) {
+            if (connection.buffer.empty() || header.empty()) {
+                // Keep waiting for a complete HELLO unless the peer went away.
+                char probe = 0;
+                if (::recv(connection.fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT) == 0) {
+                    ::close(connection.fd);
+                    return false;
+                }
+            }
+            return true;
+        }
+    } catch (const std::exception &) {
+        ::close(connection.fd);
+        return false;
+    }
+
+    std::istringstream hello(header);
+    std::string keyword;
+    std::size_t shard = 0;
+    std::size_t count = 0;
+    hello >> keyword >> shard >> count;
+    if (keyword != "HELLO" || shard == 0 || shard > shards_.size() || count != shards_.size()) {
+        logger_.warn("Coordinator rejected worker handshake '" + header + "'");
+        ::close(connection.fd);
+        return false;
+    }
+
+    auto &slot = shards_[shard - 1U];
+    if (slot.connected) {
+        ::close(slot.connection.fd);
+    }
+    slot.connection = std::move(connection);
+    slot.connected = true;
+    logger_.info("Worker shard " + std::to_string(shard) + " connected");
+    // A worker that reconnects after the scenario started joins straight away.
+    if (startTimeNs_ != 0) {
+        (void) send_all(slot.connection.fd, "START " + std::to_string(std::max(startTimeNs_, realtime_now_ns())) + "\n");
+    }
+    return false;
+}
+
+bool ShardCoordinator::handle_shard(std::size_t index)
+{
+    auto &shard = shards_[index];
+    if (!fill(shard.connection.fd, shard.connection.buffer)) {
+        disconnect(index, "closed the connection");
+        return false;
+    }
+    std::string header;
+    std::string payload;
+    try {
+        while (next_message(shard.connection.buffer, header, payload)) {
+            if (header.rfind("METRICS ", 0) == 0) {
+                shard.snapshot = RuntimeMetrics::decode_snapshot(payload);
+                shard.haveSnapshot = true;
+            }
+        }
+    } catch (const std::exception &ex) {
+        disconnect(index, ex.what());
+        return false;
+    }
+    return true;
+}
+
+void ShardCoordinator::disconnect(std::size_t index, const std::string &reason)
+{
+    auto &shard = shards_[index];
+    ::close(shard.connection.fd);
+    shard.connection = Connection{};
+    shard.connected = false;
+    // The last snapshot stays in the aggregate so a failed shard does not erase its history.
+    shard.snapshot.simulatorRunning = false;
+    if (!stopping_ && startTimeNs_ != 0) {
+        logger_.warn("Worker shard " + std::to_string(index + 1U) + " disconnected: " + reason);
+    }
+    cv_.notify_all();
+}
+
+void ShardCoordinator::reap_workers(bool block)
+{
+    for (auto &shard : shards_) {
+        if (shard.pid <= 0) {
+            continue;
+        }
+        int status = 0;
+        pid_t result = ::waitpid(shard.pid, &status, WNOHANG);
+        if (result == 0 && block) {
+            for (int attempt = 0; attempt < 30 && result == 0; ++attempt) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                result = ::waitpid(shard.pid, &status, WNOHANG);
+            }
+            if (result == 0) {
+                ::kill(shard.pid, SIGKILL);
+                result = ::waitpid(shard.pid, &status, 0);
+            }
+        }
+        if (result == shard.pid) {
+            if (!block && (!WIFEXITED(status) || WEXITSTATUS(status) != 0)) {
+                logger_.warn("Worker process " + std::to_string(shard.pid) + " exited abnormally");
+            }
+            shard.pid = -1;
+        }
+    }
+}
+
+ShardWorkerLink::ShardWorkerLink(const std::string &endpoint,
+                                 std::size_t shard,
+                                 std::size_t shardCount,
+                                 std::uint32_t connectTimeoutMs)
+{
+    const auto target = parse_endpoint(endpoint);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(connectTimeoutMs);
+    // The coordinator may still be starting up, particularly when workers are launched by hand on other hosts.
+    while ((fd_ = try_connect(target)) < 0) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            throw std::runtime_error("Unable to reach coordinator at " + endpoint);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    if (!send_all(fd_, "HELLO " + std::to_string(shard) + " " + std::to_string(shardCount) + "\n")) {
+        ::close(fd_);
+        throw std::runtime_error("Unable to register with coordinator at " + endpoint);
+    }
+}
+
+ShardWorkerLink::~ShardWorkerLink()
+{
+    stop();
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+void ShardWorkerLink::wait_for_start()
+{
+    std::string header;
+    std::string payload;
+    while (!next_message(buffer_, header, payload)) {
+        if (!fill(fd_, buffer_)) {
+            throw std::runtime_error("Coordinator closed the connection before the start");
+        }
+    }
+    if (header.rfind("START ", 0) != 0) {
+        throw std::runtime_error("Coordinator did not start this shard: " + header);
+    }
+
+    const std::int64_t startNs = std::stoll(header.substr(6));
+    timespec deadline{};
+    deadline.tv_sec = static_cast<time_t>(startNs / 1000000000LL);
+    deadline.tv_nsec = static_cast<long>(startNs % 1000000000LL);
+    while (clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {
+    }
+}
+
+void ShardWorkerLink::start_reporting(std::function<RuntimeMetrics::Snapshot()> snapshot,
+                                      std::uint32_t intervalMs,
+                                      std::function<void()> onStop)
+{
+    if (running_.exchange(true)) {
+        return;
+    }
+    snapshot_ = std::move(snapshot);
+    onStop_ = std::move(onStop);
+    intervalMs_ = intervalMs;
+    reportThread_ = std::thread(&ShardWorkerLink::run, this);
+}
+
+void ShardWorkerLink::stop()
+{
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (reportThread_.joinable()) {
+        reportThread_.join();
+    }
+    const auto encoded = RuntimeMetrics::encode_snapshot(snapshot_());
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    (void) send_all(fd_, "METRICS " + std::to_string(encoded.size()) + "\n" + encoded);
+    ::shutdown(fd_, SHUT_WR);
+}
+
+void ShardWorkerLink::run()
+{
+    set_thread_name("shard-report");
+    bool stopRequested = false;
+    while (running_.load() && !stopRequested) {
+        pollfd fd{fd_, POLLIN, 0};
+        const int ready = ::poll(&fd, 1, static_cast<int>(intervalMs_));
+        if (ready > 0) {
+            if (!fill(fd_, buffer_)) {
+                stopRequested = true;
+            }
+            std::string header;
+            std::string payload;
+            while (next_message(buffer_, header, payload)) {
+                stopRequested = stopRequested || header == "STOP";
+            }
+            continue;
+        }
+
+        const auto encoded = RuntimeMetrics::encode_snapshot(snapshot_());
+        std::lock_guard<std::mutex> lock(sendMutex_);
+        if (!send_all(fd_, "METRICS " + std::to_string(encoded.size()) + "\n" + encoded)) {
+            stopRequested = true;
+        }
+    }
+    if (stopRequested && onStop_) {
+        onStop_();
+    }
+}
+
+}  // namespace trdp_sim
@@ -0,0 +1,264 @@
+#include "trdp_simulator/sharded_stack_adapter.hpp"
+
+#include "trdp_simulator/trdp_md_worker.hpp"
+#include "trdp_simulator/trdp_pd_worker.hpp"
+
+#include <stdexcept>
+
+namespace trdp_sim {
+
+ShardedTrdpStackAdapter::ShardedTrdpStackAdapter(std::size_t sessionCount, Factory factory)
+{
+    if (sessionCount == 0) {
+        throw std::runtime_error("A sharded TRDP adapter needs at least one session");
+    }
+    shards_.reserve(sessionCount);
+    for (std::size_t index = 0; index < sessionCount; ++index) {
+        shards_.push_back(factory());
+    }
+}
+
+ShardedTrdpStackAdapter::~ShardedTrdpStackAdapter()
+{
+    shutdown();
+}
+
+std::size_t ShardedTrdpStackAdapter::shard_for(std::uint32_t session, std::uint32_t comId, std::size_t sessionCount)
+{
+    if (session != 0) {
+        return static_cast<std::size_t>(session - 1U) % sessionCount;
+    }
+    // Fibonacci hashing keeps ComIDs that are multiples of the session count from piling onto one shard.
+    const std::uint32_t mixed = comId * 0x9E3779B1U;
+    return static_cast<std::size_t>((static_cast<std::uint64_t>(mixed) * sessionCount) >> 32U);
+}
+
+void ShardedTrdpStackAdapter::initialize(const NetworkConfig &networkConfig, const LoggingConfig &loggingConfig)
+{
+    for (std::size_t index = 0; index < shards_.size(); ++index) {
+        NetworkConfig sessionNetwork = networkConfig;
+        sessionNetwork.sessions.clear();
+        if (index < networkConfig.sessions.size()) {
+            const auto &session = networkConfig.sessions[index];
+            if (!session.hostIp.empty()) {
+                sessionNetwork.hostIp = session.hostIp;
+            }
+            if (session.pdPort != 0) {
+                sessionNetwork.pdPort = session.pdPort;
+            }
+            if (session.mdPort != 0) {
+                sessionNetwork.mdPort = session.mdPort;
+            }
+        }
+        try {
+            shards_[index]->initialize(sessionNetwork, loggingConfig);
+        } catch (const std::exception &ex) {
+            shutdown();
+            throw std::runtime_error("TRDP session " + std::to_string(index + 1U) + ": " + ex.what());
+        }
+        initialized_ = index + 1U;
+    }
+}
+
+void ShardedTrdpStackAdapter::shutdown()
+{
+    for (std::size_t index = initialized_; index > 0; --index) {
+        shards_[index - 1U]->shutdown();
+    }
+    initialized_ = 0;
+    pdPublisherShards_.clear();
+    pdSubscriberShards_.clear();
+    mdSenderShards_.clear();
+    mdListenerShards_.clear();
+    redundancyGroupShards_.clear();
+}
+
+std::size_t ShardedTrdpStackAdapter::assign(ShardMap &shards, const std::string &name, std::uint32_t session,
+                                            std::uint32_t comId)
+{
+    const std::size_t index = shard_for(session, comId, shards_.size());
+    shards[name] = index;
+    return index;
+}
+
+TrdpStackAdapter &ShardedTrdpStackAdapter::route(const ShardMap &shards, const std::string &name, const char *kind) const
+{
+    const auto it = shards.find(name);
+    if (it == shards.end()) {
+        throw std::runtime_error(std::string("Unknown ") + kind + " '" + name + "'");
+    }
+    return *shards_[it->second];
+}
+
+std::size_t ShardedTrdpStackAdapter::assign_pd_publisher(const PdPublisherConfig &config)
+{
+    const std::size_t index = assign(pdPublisherShards_, config.name, config.session, config.comId);
+    if (config.redundancyGroup != 0) {
+        redundancyGroupShards_[config.redundancyGroup].insert(index);
+    }
+    return index;
+}
+
+void ShardedTrdpStackAdapter::register_pd_publisher(const PdPublisherConfig &config)
+{
+    shards_[assign_pd_publisher(config)]->register_pd_publisher(config);
+}
+
+void ShardedTrdpStackAdapter::register_pd_subscriber(const PdSubscriberConfig &config, PdHandler handler)
+{
+    const std::size_t index = assign(pdSubscriberShards_, config.name, config.session, config.comId);
+    shards_[index]->register_pd_subscriber(config, std::move(handler));
+}
+
+void ShardedTrdpStackAdapter::publish_pd(const std::string &publisherName, const std::vector<std::uint8_t> &data)
+{
+    route(pdPublisherShards_, publisherName, "PD publisher").publish_pd(publisherName, data);
+}
+
+void ShardedTrdpStackAdapter::publish_pd_immediate(const std::string &publisherName,
+                                                   const std::vector<std::uint8_t> &data)
+{
+    route(pdPublisherShards_, publisherName, "PD publisher").publish_pd_immediate(publisherName, data);
+}
+
+void ShardedTrdpStackAdapter::publish_pd_at(const std::string &publisherName,
+                                            const std::vector<std::uint8_t> &data,
+                                            std::int64_t launchTimeNs)
+{
+    route(pdPublisherShards_, publisherName, "PD publisher").publish_pd_at(publisherName, data, launchTimeNs);
+}
+
+void ShardedTrdpStackAdapter::set_pd_launch_handler(PdLaunchHandler handler)
+{
+    for (auto &shard : shards_) {
+        shard->set_pd_launch_handler(handler);
+    }
+}
+
+void ShardedTrdpStackAdapter::request_pd(const std::string &subscriberName)
+{
+    route(pdSubscriberShards_, subscriberName, "PD subscriber").request_pd(subscriberName);
+}
+
+void ShardedTrdpStackAdapter::set_pd_redundancy(const std::vector<PdRedundancyState> &states)
+{
+    // Each session only knows the groups it holds a publisher of, so every state goes to those sessions only.
+    // A group may span sessions, so leaders are raised on every session before any follower is lowered.
+    for (const auto &state : states) {
+        if (redundancyGroupShards_.count(state.groupId) == 0) {
+            throw std::runtime_error("Unknown PD redundancy group " + std::to_string(state.groupId));
+        }
+    }
+    for (const bool leader : {true, false}) {
+        std::vector<std::vector<PdRedundancyState>> subsets(shards_.size());
+        for (const auto &state : states) {
+            if (state.leader != leader) {
+                continue;
+            }
+            for (const auto index : redundancyGroupShards_.at(state.groupId)) {
+                subsets[index].push_back(state);
+            }
+        }
+        for (std::size_t index = 0; index < shards_.size(); ++index) {
+            if (!subsets[index].empty()) {
+                shards_[index]->set_pd_redundancy(subsets[index]);
+            }
+        }
+    }
+}
+
+bool ShardedTrdpStackAdapter::pd_redundancy_leader(std::uint32_t groupId)
+{
+    const auto it = redundancyGroupShards_.find(groupId);
+    return shards_[it == redundancyGroupShards_.end() ? 0U : *it->second.begin()]->pd_redundancy_leader(groupId);
+}
+
+TopologyUpdateResult ShardedTrdpStackAdapter::set_topology(std::uint32_t etbTopoCount, std::uint32_t opTrnTopoCount)
+{
+    TopologyUpdateResult total;
+    for (auto &shard : shards_) {
+        const auto result = shard->set_topology(etbTopoCount, opTrnTopoCount);
+        total.publishersUpdated += result.publishersUpdated;
+        total.subscribersUpdated += result.subscribersUpdated;
+    }
+    return total;
+}
+
+void ShardedTrdpStackAdapter::register_md_sender(const MdSenderConfig &config, MdHandler replyHandler,
+                                                 MdTimeoutHandler timeoutHandler)
+{
+    const std::size_t index = assign(mdSenderShards_, config.name, config.session, config.comId);
+    shards_[index]->register_md_sender(config, std::move(replyHandler), std::move(timeoutHandler));
+}
+
+void ShardedTrdpStackAdapter::send_md_request(const std::string &senderName, const std::vector<std::uint8_t> &data)
+{
+    route(mdSenderShards_, senderName, "MD sender").send_md_request(senderName, data);
+}
+
+void ShardedTrdpStackAdapter::send_md_confirm(const std::string &senderName, const MdMessage &replyQuery)
+{
+    route(mdSenderShards_, senderName, "MD sender").send_md_confirm(senderName, replyQuery);
+}
+
+void ShardedTrdpStackAdapter::set_md_connection_handler(MdConnectionHandler handler)
+{
+    for (auto &shard : shards_) {
+        shard->set_md_connection_handler(handler);
+    }
+}
+
+void ShardedTrdpStackAdapter::set_md_session_handler(MdSessionHandler handler)
+{
+    for (auto &shard : shards_) {
+        shard->set_md_session_handler(handler);
+    }
+}
+
+void ShardedTrdpStackAdapter::register_md_listener(const MdListenerConfig &config, MdHandler requestHandler)
+{
+    const std::size_t index = assign(mdListenerShards_, config.name, config.session, config.comId);
+    shards_[index]->register_md_listener(config, std::move(requestHandler));
+}
+
+void ShardedTrdpStackAdapter::send_md_reply(const std::string &listenerName, const MdMessage &request,
+                                            const std::vector<std::uint8_t> &data)
+{
+    route(mdListenerShards_, listenerName, "MD listener").send_md_reply(listenerName, request, data);
+}
+
+// Workers are created by their session's adapter and publish to it directly, skipping the routing above.
+std::unique_ptr<PdPublisherWorker> ShardedTrdpStackAdapter::create_pd_publisher_worker(const PdPublisherConfig &config,
+                                                                                       Logger &logger,
+                                                                                       RuntimeMetrics &metrics)
+{
+    return shards_[assign_pd_publisher(config)]->create_pd_publisher_worker(config, logger, metrics);
+}
+
+std::unique_ptr<MdSenderWorker> ShardedTrdpStackAdapter::create_md_sender_worker(const MdSenderConfig &config,
+                                                                                 Logger &logger,
+                                                                                 RuntimeMetrics &metrics)
+{
+    const std::size_t index = assign(mdSenderShards_, config.name, config.session, config.comId);
+    return shards_[index]->create_md_sender_worker(config, logger, metrics);
+}
+
+void ShardedTrdpStackAdapter::poll(std::chrono::milliseconds timeout)
+{
+    const auto slice = timeout / static_cast<int>(shards_.size());
+    for (auto &shard : shards_) {
+        shard->poll(slice);
+    }
+}
+
+std::size_t ShardedTrdpStackAdapter::poll_partitions() const
+{
+    return shards_.size();
+}
+
+void ShardedTrdpStackAdapter::poll_partition(std::size_t partition, std::chrono::milliseconds timeout)
+{
+    shards_.at(partition)->poll(timeout);
+}
+
+}  // namespace trdp_sim
@@ -1,5 +1,12 @@
 #include "trdp_simulator/simulator.hpp"
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
 #include <csignal>
 #include <filesystem>
 #include <iomanip>
@@ -7,33 +14,46 @@
 #include <thread>
 #include <system_error>
 
+#include "trdp_simulator/allocation_tracker.hpp"
+#include "trdp_simulator/binary_log.hpp"
+#include "trdp_simulator/log_file.hpp"
+#include "trdp_simulator/pd_redundancy_manager.hpp"
+#include "trdp_simulator/stall_detector.hpp"
+#include "trdp_simulator/thread_monitor.hpp"
 #include "trdp_simulator/trdp_md_worker.hpp"
 #include "trdp_simulator/trdp_pd_worker.hpp"
 
 namespace trdp_sim {
 namespace {
-std::string to_hex(const std::vector<std::uint8_t> &data)
+bool pin_thread(std::thread &thread, int cpu)
 {
-    std::ostringstream oss;
-    for (std::size_t i = 0; i < data.size(); ++i) {
-        if (i != 0) {
-            oss << ' ';
-        }
-        oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(data[i]);
-    }
-    return oss.str();
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus) == 0;
+#else
+    (void) thread;
+    (void) cpu;
+    return false;
+#endif
 }
 }  // namespace
 
 Simulator::Simulator(SimulatorConfig config, std::unique_ptr<TrdpStackAdapter> adapter)
     : config_(std::move(config)), adapter_(std::move(adapter)), logger_(config_.logging.level),
-      metrics_(std::make_shared<RuntimeMetrics>())
+      metrics_(std::make_shared<RuntimeMetrics>(&arena_))
 {
+    if (config_.coordinator.enabled) {
+        coordinator_ = std::make_unique<ShardCoordinator>(config_, logger_);
+    }
 }
 
 Simulator::~Simulator()
 {
     stop();
+    logger_.set_file(nullptr);
+    logger_.set_binary_log(nullptr);
 }
 
 void Simulator::run()
@@ -46,9 +66,40 @@ void Simulator::run()
         metrics_->set_adapter_status(false, "Initializing");
     }
 
+    if (coordinator_) {
+        run_coordinator();
+        return;
+    }
+
     logger_.info("Initializing TRDP stack");
     try {
         adapter_->initialize(config_.network, config_.logging);
+        adapter_->set_pd_launch_handler([this](const PdLaunchReport &report) {
+            if (metrics_) {
+                metrics_->record_pd_tsn_launch_report(report.publisherName, report.errorNs, report.missed);
+            }
+        });
+        adapter_->set_md_connection_handler([this](const MdConnectionEvent &event) {
+            if (!metrics_) {
+                return;
+            }
+            if (event.kind == MdConnectionEvent::Kind::Exchange) {
+                metrics_->record_md_tcp_exchange(event.peer);
+            } else {
+                metrics_->record_md_tcp_connection(event.peer, event.kind == MdConnectionEvent::Kind::Opened);
+            }
+        });
+        adapter_->set_md_session_handler([this](const MdSessionEvent &event) {
+            if (!metrics_) {
+                return;
+            }
+            const bool caller = event.role == MdSessionEvent::Role::Caller;
+            if (event.kind == MdSessionEvent::Kind::Opened) {
+                metrics_->record_md_session_opened(caller);
+            } else {
+                metrics_->record_md_session_closed(caller, event.kind == MdSessionEvent::Kind::TimedOut);
+            }
+        });
         if (metrics_) {
             metrics_->set_adapter_status(true, "Running");
         }
@@ -64,15 +115,38 @@ void Simulator::run()
         running_.store(true);
         cleanedUp_ = false;
 
-        // Register PD subscribers
+        // Register PD subscribers; pull requesters are owned by the shared pull scheduler
+        if (config_.watchdog.enabled) {
+            stallDetector_ = std::make_unique<StallDetector>(config_.watchdog, logger_, *metrics_);
+        }
+        pdPullScheduler_ = std::make_unique<PdPullScheduler>(*adapter_, logger_, *metrics_, stallDetector_.get());
+        pdRedundancy_ = std::make_unique<PdRedundancyManager>(config_, *adapter_, logger_, *metrics_, &arena_,
+                                                              stallDetector_.get());
         for (const auto &subscriber : config_.pdSubscribers) {
-            adapter_->register_pd_subscriber(subscriber, [this, name = subscriber.name](const PdMessage &message) {
-                logger_.info("PD subscriber '" + name + "' received COMID " + std::to_string(message.comId) +
-                             " payload=" + to_hex(message.payload));
+            const std::uint32_t nameId = binaryLog_ ? binaryLog_->intern(subscriber.name) : 0U;
+            auto &log = logger_.channel("pd", subscriber.name, subscriber.comId);
+            auto handler = [this, name = subscriber.name, nameId, &log](const PdMessage &message) {
+                AllocationRegion region("pd.receive");
+                pdRedundancy_->on_receive(name, message.comId);
+                if (log.enabled(LogLevel::Info) && log.admit(LogLevel::Info)) {
+                    if (binaryLog_) {
+                        binaryLog_->write(LogLevel::Info, BinaryLogMessage::PdReceived,
+                                          {BinaryLogArg::string(nameId), BinaryLogArg::unsigned_value(message.comId)},
+                                          {BinaryLogDataFormat::Hex, message.payload.data(), message.payload.size()});
+                    } else {
+                        log.log(LogLevel::Info, "PD subscriber '" + name + "' received COMID " +
+                                                    std::to_string(message.comId) + " payload=" + to_hex(message.payload));
+                    }
+                }
                 if (metrics_) {
                     metrics_->record_pd_receive(name);
                 }
-            });
+            };
+            if (subscriber.role == PdSubscriberConfig::Role::PullRequester) {
+                pdPullScheduler_->add_requester(subscriber, std::move(handler));
+            } else {
+                adapter_->register_pd_subscriber(subscriber, std::move(handler));
+            }
         }
 
         // Register MD listeners
@@ -81,20 +155,75 @@ void Simulator::run()
             if (listener.autoReply && !listener.replyPayload.value.empty()) {
                 replyPayload = load_payload(listener.replyPayload);
             }
+            const std::uint32_t nameId = binaryLog_ ? binaryLog_->intern(listener.name) : 0U;
+            auto &log = logger_.channel("md", listener.name, listener.comId);
             adapter_->register_md_listener(listener,
-                [this, cfg = listener, replyPayload](const MdMessage &message) mutable {
+                [this, cfg = listener, replyPayload, nameId, &log](const MdMessage &message) mutable {
+                    AllocationRegion region("md.receive");
+                    const bool logged = log.enabled(LogLevel::Info);
+                    const bool binary = binaryLog_ != nullptr;
+                    if (message.type == MdMessageType::Confirm) {
+                        if (metrics_) {
+                            metrics_->record_md_confirm_received(cfg.name);
+                        }
+                        if (!logged || !log.admit(LogLevel::Info)) {
+                            return;
+                        }
+                        if (binary) {
+                            binaryLog_->write(LogLevel::Info, BinaryLogMessage::MdConfirmReceived,
+                                              {BinaryLogArg::string(nameId)},
+                                              {BinaryLogDataFormat::Text, message.endpoint.data(),
+                                               message.endpoint.size()});
+                        } else {
+                            log.log(LogLevel::Info, "MD listener '" + cfg.name + "' received confirmation from '" +
+                                                        message.endpoint + "'");
+                        }
+                        return;
+                    }
+                    const bool notification = message.type == MdMessageType::Notification;
                     if (metrics_) {
-                        metrics_->record_md_request_received(cfg.name);
+                        if (notification) {
+                            metrics_->record_md_notification_received(cfg.name);
+                        } else {
+                            metrics_->record_md_request_received(cfg.name);
+                        }
+                    }
+                    if (logged && log.admit(LogLevel::Info)) {
+                        if (binary) {
+                            binaryLog_->write(LogLevel::Info,
+                                              notification ? BinaryLogMessage::MdNotificationReceived
+                                                           : BinaryLogMessage::MdRequestReceived,
+                                              {BinaryLogArg::string(nameId), BinaryLogArg::unsigned_value(message.comId)},
+                                              {BinaryLogDataFormat::Hex, message.payload.data(), message.payload.size()});
+                        } else {
+                            log.log(LogLevel::Info, "MD listener '" + cfg.name + "' received " +
+                                                        (notification ? "notification" : "request") + " COMID " +
+                                                        std::to_string(message.comId) + " payload=" +
+                                                        to_hex(message.payload));
+                        }
                     }
-                    logger_.info("MD listener '" + cfg.name + "' received COMID " + std::to_string(message.comId) +
-                                 " payload=" + to_hex(message.payload));
-                    if (cfg.autoReply && !replyPayload.empty()) {
+                    if (!notification && cfg.autoReply && !replyPayload.empty()) {
+                        const bool query = cfg.replyType == MdListenerConfig::ReplyType::Query;
                         try {
                             adapter_->send_md_reply(cfg.name, message, replyPayload);
                             if (metrics_) {
-                                metrics_->record_md_reply_sent(cfg.name);
+                                if (query) {
+                                    metrics_->record_md_reply_query_sent(cfg.name);
+                                } else {
+                                    metrics_->record_md_reply_sent(cfg.name);
+                                }
+                            }
+                            if (logged && log.admit(LogLevel::Info)) {
+                                if (binary) {
+                                    binaryLog_->write(LogLevel::Info,
+                                                      query ? BinaryLogMessage::MdReplyQuerySent
+                                                            : BinaryLogMessage::MdReplySent,
+                                                      {BinaryLogArg::string(nameId)});
+                                } else {
+                                    log.log(LogLevel::Info, "MD listener '" + cfg.name + "' sent automatic " +
+                                                                (query ? "reply query" : "reply"));
+                                }
                             }
-                            logger_.info("MD listener '" + cfg.name + "' sent automatic reply");
                         } catch (const std::exception &ex) {
                             logger_.error("MD listener '" + cfg.name + "' failed to send reply: " + ex.what());
                         }
@@ -103,15 +232,25 @@ void Simulator::run()
         }
 
         setup_pd_workers();
+        pdRedundancy_->apply_initial_state();
         setup_md_workers();
+        if (startGate_) {
+            startGate_();
+        }
         start_event_loop();
 
         for (auto &worker : pdWorkers_) {
             worker->start();
         }
+        pdPullScheduler_->start();
+        pdRedundancy_->start();
         for (auto &worker : mdWorkers_) {
             worker->start();
         }
+        if (stallDetector_) {
+            stallDetector_->start();
+        }
+        arena_.set_phase(RunArena::Phase::Running);
 
         std::unique_lock<std::mutex> lock(stateMutex_);
         stateCv_.wait(lock, [this] { return !running_.load(); });
@@ -131,6 +270,30 @@ void Simulator::run()
     }
 }
 
+void Simulator::run_coordinator()
+{
+    try {
+        coordinator_->start();
+    } catch (const std::exception &ex) {
+        if (metrics_) {
+            metrics_->set_adapter_status(false, std::string("Initialization failed: ") + ex.what());
+            metrics_->set_simulator_running(false);
+        }
+        throw;
+    }
+
+    running_.store(true);
+    cleanedUp_ = false;
+    arena_.set_phase(RunArena::Phase::Running);
+    std::unique_lock<std::mutex> lock(stateMutex_);
+    stateCv_.wait(lock, [this] { return !running_.load(); });
+    if (!cleanedUp_) {
+        cleanedUp_ = true;
+        lock.unlock();
+        stop();
+    }
+}
+
 void Simulator::stop()
 {
     const bool wasRunning = running_.exchange(false);
@@ -145,21 +308,39 @@ void Simulator::stop()
 
     if (wasRunning || !cleanedUp_) {
         cleanedUp_ = true;
+        arena_.set_phase(RunArena::Phase::Shutdown);
+
+        if (coordinator_) {
+            coordinator_->stop();
+        }
+        // Threads winding down are not stalls, so the watchdog goes first.
+        if (stallDetector_) {
+            stallDetector_->stop();
+        }
 
         for (auto &worker : pdWorkers_) {
             if (worker) {
                 worker->stop();
             }
         }
+        if (pdPullScheduler_) {
+            pdPullScheduler_->stop();
+        }
+        if (pdRedundancy_) {
+            pdRedundancy_->stop();
+        }
         for (auto &worker : mdWorkers_) {
             if (worker) {
                 worker->stop();
             }
         }
 
-        if (eventThread_.joinable()) {
-            eventThread_.join();
+        for (auto &thread : eventThreads_) {
+            if (thread.joinable()) {
+                thread.join();
+            }
         }
+        eventThreads_.clear();
 
         if (adapter_) {
             try {
@@ -170,7 +351,12 @@ void Simulator::stop()
         }
 
         pdWorkers_.clear();
+        pdPullScheduler_.reset();
+        pdRedundancy_.reset();
         mdWorkers_.clear();
+        stallDetector_.reset();
+        logger_.report_suppressed();
+        log_arena_report();
     }
 
     if (metrics_) {
@@ -189,8 +375,9 @@ void Simulator::setup_logging()
 {
     logger_.set_level(config_.logging.level);
     logger_.enable_console(config_.logging.enableConsole);
-    if (!config_.logging.filePath.empty()) {
-        const std::filesystem::path logPath(config_.logging.filePath);
+    logger_.set_overrides(config_.logging.overrides, config_.logging.rateLimit);
+    const auto create_log_directory = [](const std::string &path) {
+        const std::filesystem::path logPath(path);
         if (logPath.has_parent_path()) {
             std::error_code ec;
             std::filesystem::create_directories(logPath.parent_path(), ec);
@@ -199,52 +386,127 @@ void Simulator::setup_logging()
                                          "': " + ec.message());
             }
         }
-        logFile_ = std::make_unique<std::ofstream>(config_.logging.filePath, std::ios::app);
-        if (!logFile_->is_open()) {
-            throw std::runtime_error("Unable to open log file: " + config_.logging.filePath);
-        }
+    };
+    if (!config_.logging.filePath.empty()) {
+        create_log_directory(config_.logging.filePath);
+        logFile_ = std::make_unique<RotatingLogFile>(config_.logging,
+                                                     [this](const std::string &error) { logger_.warn(error); });
         logger_.set_file(logFile_.get());
     }
+    if (!config_.logging.binaryFilePath.empty()) {
+        create_log_directory(config_.logging.binaryFilePath);
+        // Telegram names are the strings interned, so the table is sized for all of them.
+        std::size_t stringTableBytes = 0;
+        const auto add_names = [&stringTableBytes](const auto &entries) {
+            for (const auto &entry : entries) {
+                stringTableBytes += BinaryLog::string_entry_size(entry.name);
+            }
+        };
+        add_names(config_.pdPublishers);
+        add_names(config_.pdSubscribers);
+        add_names(config_.mdSenders);
+        add_names(config_.mdListeners);
+        binaryLog_ = std::make_unique<BinaryLog>(config_.logging.binaryFilePath,
+                                                 static_cast<std::size_t>(config_.logging.binaryCapacityMb) << 20U,
+                                                 stringTableBytes);
+        logger_.set_binary_log(binaryLog_.get());
+    }
 }
 
 void Simulator::setup_pd_workers()
 {
     for (const auto &publisher : config_.pdPublishers) {
-        pdWorkers_.push_back(std::make_unique<PdPublisherWorker>(publisher, *adapter_, logger_, *metrics_));
+        pdWorkers_.push_back(adapter_->create_pd_publisher_worker(publisher, logger_, *metrics_));
+        pdWorkers_.back()->set_stall_detector(stallDetector_.get());
     }
 }
 
 void Simulator::setup_md_workers()
 {
     for (const auto &sender : config_.mdSenders) {
-        mdWorkers_.push_back(std::make_unique<MdSenderWorker>(sender, *adapter_, logger_, *metrics_));
+        mdWorkers_.push_back(adapter_->create_md_sender_worker(sender, logger_, *metrics_));
+        mdWorkers_.back()->set_stall_detector(stallDetector_.get());
     }
 }
 
 void Simulator::start_event_loop()
 {
-    if (eventThread_.joinable()) {
+    if (!eventThreads_.empty()) {
         return;
     }
-    eventThread_ = std::thread([this] {
-        while (running_.load()) {
-            try {
-                adapter_->poll(std::chrono::milliseconds(100));
-            } catch (const std::exception &ex) {
-                logger_.warn("TRDP poll failed: " + std::string(ex.what()));
+    const std::size_t partitions = adapter_->poll_partitions();
+    const unsigned cores = std::max(1U, std::thread::hardware_concurrency());
+    if (partitions > 1U) {
+        logger_.info("Processing " + std::to_string(partitions) + " TRDP sessions on dedicated threads");
+    }
+    for (std::size_t partition = 0; partition < partitions; ++partition) {
+        eventThreads_.emplace_back([this, partition] {
+            const std::string threadName = "trdp-poll-" + std::to_string(partition + 1U);
+            set_thread_name(threadName);
+            LoopProbe &probe = stallDetector_ ? stallDetector_->attach(threadName) : StallDetector::detached();
+            const auto timeout = std::chrono::milliseconds(100);
+            while (running_.load()) {
+                // The stack may return early for due telegrams; a late return means a handler held the loop.
+                probe.sleeping_until(std::chrono::steady_clock::now() + timeout);
+                try {
+                    adapter_->poll_partition(partition, timeout);
+                } catch (const std::exception &ex) {
+                    logger_.warn("TRDP poll failed: " + std::string(ex.what()));
+                }
+                probe.woke();
+            }
+            if (stallDetector_) {
+                stallDetector_->detach(probe);
             }
+        });
+
+        // A single session keeps the scheduler's placement unless a core is requested explicitly.
+        int cpu = partition < config_.network.sessions.size() ? config_.network.sessions[partition].cpu : -1;
+        if (cpu < 0 && partitions > 1U) {
+            cpu = static_cast<int>(partition % cores);
+        }
+        if (cpu >= 0 && !pin_thread(eventThreads_.back(), cpu)) {
+            logger_.warn("Unable to pin TRDP session " + std::to_string(partition + 1U) + " to CPU " +
+                         std::to_string(cpu));
         }
-    });
+    }
 }
 
 RuntimeMetrics::Snapshot Simulator::metrics_snapshot() const
 {
+    if (coordinator_) {
+        auto snapshot = coordinator_->metrics_snapshot();
+        snapshot.simulatorRunning = running_.load();
+        return snapshot;
+    }
     if (metrics_) {
-        return metrics_->snapshot();
+        auto snapshot = metrics_->snapshot();
+        for (std::size_t index = 0; index < RunArena::PhaseCount; ++index) {
+            const auto stats = arena_.phase_stats(static_cast<RunArena::Phase>(index));
+            snapshot.arenaPhases[index] = {stats.allocations, stats.bytes};
+        }
+        snapshot.arenaBytesInUse = arena_.bytes_in_use();
+        snapshot.arenaPeakBytes = arena_.peak_bytes();
+        return snapshot;
     }
     return RuntimeMetrics::Snapshot{};
 }
 
+void Simulator::log_arena_report()
+{
+    std::ostringstream report;
+    report << "Run arena:";
+    for (std::size_t index = 0; index < RunArena::PhaseCount; ++index) {
+        const auto phase = static_cast<RunArena::Phase>(index);
+        const auto stats = arena_.phase_stats(phase);
+        report << ' ' << RunArena::phase_name(phase) << ' ' << stats.allocations << " allocations (" << stats.bytes
+               << " bytes)" << (index + 1U < RunArena::PhaseCount ? "," : ";");
+    }
+    report << " peak " << arena_.peak_bytes() << " bytes, " << arena_.bytes_in_use()
+           << " bytes released when the simulator is destroyed";
+    logger_.info(report.str());
+}
+
 SimulatorConfig Simulator::current_config() const
 {
     std::lock_guard<std::mutex> lock(stateMutex_);
@@ -260,6 +522,10 @@ bool Simulator::set_pd_payload(const std::string &publisher_name,
         error_message = "Simulator is not running";
         return false;
     }
+    if (coordinator_) {
+        error_message = "Not available while coordinating worker processes";
+        return false;
+    }
 
     std::lock_guard<std::mutex> lock(stateMutex_);
     for (auto &worker : pdWorkers_) {
@@ -291,6 +557,10 @@ bool Simulator::set_md_payload(const std::string &sender_name,
         error_message = "Simulator is not running";
         return false;
     }
+    if (coordinator_) {
+        error_message = "Not available while coordinating worker processes";
+        return false;
+    }
 
     std::lock_guard<std::mutex> lock(stateMutex_);
     for (auto &worker : mdWorkers_) {
@@ -313,4 +583,73 @@ bool Simulator::set_md_payload(const std::string &sender_name,
     return false;
 }
 
+void Simulator::set_start_gate(std::function<void()> gate)
+{
+    startGate_ = std::move(gate);
+}
+
+bool Simulator::trigger_pd_failover(std::uint32_t group_id, std::string &error_message)
+{
+    if (!running_.load()) {
+        error_message = "Simulator is not running";
+        return false;
+    }
+    if (coordinator_) {
+        error_message = "Not available while coordinating worker processes";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    if (!pdRedundancy_) {
+        error_message = "PD redundancy is not available";
+        return false;
+    }
+    return pdRedundancy_->failover(group_id, error_message);
+}
+
+bool Simulator::set_topology(std::uint32_t etb_topo_count, std::uint32_t op_trn_topo_count, std::string &error_message)
+{
+    if (!running_.load()) {
+        error_message = "Simulator is not running";
+        return false;
+    }
+    if (coordinator_) {
+        error_message = "Not available while coordinating worker processes";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    TopologyUpdateResult result;
+    const auto started = std::chrono::steady_clock::now();
+    try {
+        result = adapter_->set_topology(etb_topo_count, op_trn_topo_count);
+    } catch (const std::exception &ex) {
+        error_message = ex.what();
+        return false;
+    }
+    const auto updateUs =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count();
+
+    // Workers are created in configuration order. Only publishers whose counters changed are timed; responders
+    // are answered from the stack's buffer, which carries the new counters straight away.
+    for (std::size_t index = 0; index < config_.pdPublishers.size(); ++index) {
+        auto &publisher = config_.pdPublishers[index];
+        if (retarget_topology(publisher, etb_topo_count, op_trn_topo_count) &&
+            publisher.role != PdPublisherConfig::Role::PullResponder && index < pdWorkers_.size()) {
+            pdWorkers_[index]->mark_topology_change(started);
+        }
+    }
+    for (auto &subscriber : config_.pdSubscribers) {
+        retarget_topology(subscriber, etb_topo_count, op_trn_topo_count);
+    }
+
+    metrics_->record_topology_update(etb_topo_count, op_trn_topo_count,
+                                     result.publishersUpdated + result.subscribersUpdated);
+    logger_.info("Topology counters set to ETB " + std::to_string(etb_topo_count) + " / OpTrn " +
+                 std::to_string(op_trn_topo_count) + ": " + std::to_string(result.publishersUpdated) +
+                 " publisher(s) and " + std::to_string(result.subscribersUpdated) + " subscriber(s) updated in " +
+                 std::to_string(updateUs) + " us");
+    return true;
+}
+
 }  // namespace trdp_sim
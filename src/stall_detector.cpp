@@ -0,0 +1,234 @@
+#include "trdp_simulator/stall_detector.hpp"
+
+#ifdef __linux__
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <sstream>
+
+#include "trdp_simulator/thread_monitor.hpp"
+
+namespace trdp_sim {
+namespace {
+
+std::int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(LoopProbe::Clock::now().time_since_epoch()).count();
+}
+
+#ifdef __linux__
+// SIGURG is ignored by default, so a capture signal arriving after the handler is gone does no harm.
+constexpr int CaptureSignal = SIGURG;
+
+std::atomic<LoopProbe *> captureTarget{nullptr};
+#endif
+
+}  // namespace
+
+void LoopProbe::sleeping_until(Clock::time_point expectedWake)
+{
+    if (!attached_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    const auto expected = std::chrono::duration_cast<std::chrono::nanoseconds>(expectedWake.time_since_epoch()).count();
+    expectedNs_.store(expected, std::memory_order_relaxed);
+    deadlineNs_.store(expected + thresholdNs_, std::memory_order_release);
+}
+
+void LoopProbe::waiting()
+{
+    if (!attached_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    expectedNs_.store(Never, std::memory_order_relaxed);
+    deadlineNs_.store(Never, std::memory_order_release);
+}
+
+void LoopProbe::woke()
+{
+    if (!attached_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    const auto now = now_ns();
+    // Until the loop sleeps again its work counts against the same threshold.
+    deadlineNs_.store(now + thresholdNs_, std::memory_order_release);
+    const auto expected = expectedNs_.exchange(Never, std::memory_order_relaxed);
+    if (expected != Never) {
+        metrics_->record_loop_lag(name_, std::max<std::int64_t>(0, now - expected) / 1000);
+    }
+}
+
+StallDetector::StallDetector(const WatchdogConfig &config, Logger &logger, RuntimeMetrics &metrics)
+    : config_(config), logger_(logger), metrics_(metrics)
+{
+}
+
+StallDetector::~StallDetector()
+{
+    stop();
+}
+
+LoopProbe &StallDetector::detached()
+{
+    static LoopProbe probe;
+    return probe;
+}
+
+LoopProbe &StallDetector::attach(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(probesMutex_);
+    auto it = std::find_if(probes_.begin(), probes_.end(), [&name](const auto &probe) {
+        return probe->name_ == name && !probe->attached_.load();
+    });
+    if (it == probes_.end()) {
+        probes_.push_back(std::make_unique<LoopProbe>());
+        it = std::prev(probes_.end());
+    }
+    auto &probe = **it;
+    probe.name_ = name;
+    probe.metrics_ = &metrics_;
+    probe.thresholdNs_ = static_cast<std::int64_t>(config_.stallThresholdMs) * 1000000LL;
+#ifdef __linux__
+    probe.thread_ = pthread_self();
+#endif
+    probe.expectedNs_.store(LoopProbe::Never);
+    probe.deadlineNs_.store(LoopProbe::Never);
+    probe.attached_.store(true);
+    return probe;
+}
+
+void StallDetector::detach(LoopProbe &probe)
+{
+    std::lock_guard<std::mutex> lock(probesMutex_);
+    probe.attached_.store(false);
+    probe.deadlineNs_.store(LoopProbe::Never);
+}
+
+void StallDetector::start()
+{
+    if (running_.exchange(true)) {
+        return;
+    }
+#ifdef __linux__
+    // backtrace loads its unwinder on first use, which must not happen inside the signal handler.
+    void *frame = nullptr;
+    (void) backtrace(&frame, 1);
+
+    struct sigaction action {};
+    action.sa_handler = &StallDetector::record_stack;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    if (sigaction(CaptureSignal, &action, nullptr) != 0) {
+        logger_.warn("Stall detector cannot capture stacks: installing the signal handler failed");
+    }
+#endif
+    watchdogThread_ = std::thread(&StallDetector::run, this);
+}
+
+// Runs on the stalled thread itself.
+void StallDetector::record_stack(int)
+{
+#ifdef __linux__
+    const int savedErrno = errno;
+    auto *probe = captureTarget.load();
+    if (probe != nullptr && pthread_equal(pthread_self(), probe->thread_)) {
+        probe->frameCount_.store(backtrace(probe->frames_.data(), static_cast<int>(LoopProbe::MaxFrames)));
+    }
+    errno = savedErrno;
+#endif
+}
+
+void StallDetector::stop()
+{
+    if (!running_.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        wakeCv_.notify_all();
+    }
+    if (watchdogThread_.joinable()) {
+        watchdogThread_.join();
+    }
+}
+
+void StallDetector::run()
+{
+    set_thread_name("stall-watchdog");
+    const auto checkInterval = std::max(std::chrono::milliseconds(1),
+                                        std::chrono::milliseconds(config_.stallThresholdMs / 4U));
+    std::vector<LoopProbe *> probes;
+    while (running_.load()) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            wakeCv_.wait_for(lock, checkInterval, [this] { return !running_.load(); });
+        }
+        if (!running_.load()) {
+            break;
+        }
+
+        probes.clear();
+        {
+            std::lock_guard<std::mutex> lock(probesMutex_);
+            for (const auto &probe : probes_) {
+                probes.push_back(probe.get());
+            }
+        }
+        const auto now = now_ns();
+        for (auto *probe : probes) {
+            const auto deadline = probe->deadlineNs_.load(std::memory_order_acquire);
+            if (!probe->attached_.load() || deadline == LoopProbe::Never || now <= deadline ||
+                deadline == probe->reportedDeadlineNs_) {
+                continue;
+            }
+            probe->reportedDeadlineNs_ = deadline;
+            capture(*probe, now - deadline + probe->thresholdNs_);
+        }
+    }
+}
+
+void StallDetector::capture(LoopProbe &probe, std::int64_t overdueNs)
+{
+    std::ostringstream report;
+    report << "Loop '" << probe.name_ << "' has not checked in for " << overdueNs / 1000000
+           << " ms past its planned wake-up";
+
+    std::string trace;
+#ifdef __linux__
+    probe.frameCount_.store(-1);
+    captureTarget.store(&probe);
+    if (pthread_kill(probe.thread_, CaptureSignal) == 0) {
+        const auto giveUp = LoopProbe::Clock::now() + std::chrono::milliseconds(100);
+        while (probe.frameCount_.load() < 0 && LoopProbe::Clock::now() < giveUp) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+    captureTarget.store(nullptr);
+
+    const int frames = probe.frameCount_.load();
+    if (frames > 0) {
+        // Frame 0 and 1 are the signal handler and the kernel trampoline.
+        char **symbols = backtrace_symbols(probe.frames_.data(), frames);
+        std::ostringstream lines;
+        for (int index = 2; index < frames; ++index) {
+            lines << '#' << index - 2 << ' ' << (symbols != nullptr ? symbols[index] : "?") << '\n';
+        }
+        std::free(symbols);
+        trace = lines.str();
+    }
+#endif
+    if (trace.empty()) {
+        report << " (no stack captured)";
+    } else {
+        report << ":\n" << trace;
+    }
+    logger_.warn(report.str());
+    metrics_.record_loop_stall(probe.name_, trace);
+}
+
+}  // namespace trdp_sim
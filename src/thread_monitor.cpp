@@ -0,0 +1,247 @@
+#include "trdp_simulator/thread_monitor.hpp"
+
+#include "trdp_simulator/allocation_tracker.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace trdp_sim {
+namespace {
+
+std::mutex threadNamesMutex;
+std::map<int, std::string> threadNames;
+
+#ifdef __linux__
+int current_tid()
+{
+    return static_cast<int>(::syscall(SYS_gettid));
+}
+
+bool read_stat(const std::filesystem::path &dir, std::string &comm, std::uint64_t &cpuTicks)
+{
+    std::ifstream file(dir / "stat");
+    std::string line;
+    if (!std::getline(file, line)) {
+        return false;
+    }
+    // The command name may itself contain spaces and parentheses, so it ends at the last ')'.
+    const auto open = line.find('(');
+    const auto close = line.rfind(')');
+    if (open == std::string::npos || close == std::string::npos || close < open) {
+        return false;
+    }
+    comm = line.substr(open + 1, close - open - 1);
+    std::istringstream fields(line.substr(close + 1));
+    std::string field;
+    std::uint64_t utime = 0;
+    std::uint64_t stime = 0;
+    // Fields after the name start at 3 (state); utime and stime are fields 14 and 15.
+    for (int index = 3; index <= 15 && (fields >> field); ++index) {
+        if (index == 14) {
+            utime = std::stoull(field);
+        } else if (index == 15) {
+            stime = std::stoull(field);
+        }
+    }
+    cpuTicks = utime + stime;
+    return true;
+}
+#endif
+
+}  // namespace
+
+void set_thread_name(const std::string &name)
+{
+    set_allocation_thread_name(name);
+#ifdef __linux__
+    (void) pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+    std::lock_guard<std::mutex> lock(threadNamesMutex);
+    threadNames[current_tid()] = name;
+#endif
+}
+
+ThreadMonitor::ThreadMonitor(std::chrono::milliseconds interval)
+    : interval_(interval)
+{
+}
+
+ThreadMonitor::~ThreadMonitor()
+{
+    stop();
+}
+
+bool ThreadMonitor::supported()
+{
+#ifdef __linux__
+    std::error_code ec;
+    return std::filesystem::exists("/proc/self/task", ec);
+#else
+    return false;
+#endif
+}
+
+void ThreadMonitor::start()
+{
+    if (!supported() || running_.exchange(true)) {
+        return;
+    }
+    sample();
+    samplerThread_ = std::thread(&ThreadMonitor::run, this);
+}
+
+void ThreadMonitor::stop()
+{
+    if (!running_.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        wakeCv_.notify_all();
+    }
+    if (samplerThread_.joinable()) {
+        samplerThread_.join();
+    }
+}
+
+std::vector<ThreadUsage> ThreadMonitor::threads() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return latest_;
+}
+
+void ThreadMonitor::run()
+{
+    set_thread_name("thread-monitor");
+    while (running_.load()) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            if (wakeCv_.wait_for(lock, interval_, [this] { return !running_.load(); })) {
+                break;
+            }
+        }
+        sample();
+    }
+}
+
+std::map<int, ThreadMonitor::Counters> ThreadMonitor::read_counters()
+{
+    std::map<int, Counters> counters;
+#ifdef __linux__
+    static const long ticksPerSecond = ::sysconf(_SC_CLK_TCK);
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator("/proc/self/task", ec)) {
+        // Threads may exit while they are read; whatever could not be read is skipped.
+        const auto &dir = entry.path();
+        int tid = 0;
+        try {
+            tid = std::stoi(dir.filename().string());
+        } catch (const std::exception &) {
+            continue;
+        }
+
+        Counters current;
+        std::uint64_t cpuTicks = 0;
+        try {
+            if (!read_stat(dir, current.comm, cpuTicks)) {
+                continue;
+            }
+        } catch (const std::exception &) {
+            continue;
+        }
+
+        // schedstat has nanosecond CPU and run-queue times; kernels without it fall back to clock ticks.
+        std::ifstream schedstat(dir / "schedstat");
+        if (!(schedstat >> current.cpuNs >> current.waitNs)) {
+            current.cpuNs = ticksPerSecond > 0 ? cpuTicks * (1000000000ULL / static_cast<std::uint64_t>(ticksPerSecond))
+                                               : 0U;
+            current.waitNs = 0;
+        }
+
+        std::ifstream status(dir / "status");
+        std::string line;
+        while (std::getline(status, line)) {
+            std::istringstream fields(line);
+            std::string key;
+            fields >> key;
+            if (key == "voluntary_ctxt_switches:") {
+                fields >> current.voluntarySwitches;
+            } else if (key == "nonvoluntary_ctxt_switches:") {
+                fields >> current.involuntarySwitches;
+            }
+        }
+        counters.emplace(tid, std::move(current));
+    }
+#endif
+    return counters;
+}
+
+void ThreadMonitor::sample()
+{
+    const auto now = std::chrono::steady_clock::now();
+    auto counters = read_counters();
+
+    std::map<int, std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(threadNamesMutex);
+        // Thread ids are reused, so names of threads that have gone are dropped.
+        for (auto it = threadNames.begin(); it != threadNames.end();) {
+            if (counters.count(it->first) == 0) {
+                it = threadNames.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        names = threadNames;
+    }
+
+    const bool havePrevious = previousAt_ != std::chrono::steady_clock::time_point{};
+    const double elapsedNs = havePrevious ? static_cast<double>(
+                                                std::chrono::duration_cast<std::chrono::nanoseconds>(now - previousAt_).count())
+                                          : 0.0;
+    std::vector<ThreadUsage> usage;
+    usage.reserve(counters.size());
+    for (const auto &entry : counters) {
+        const auto &current = entry.second;
+        ThreadUsage thread;
+        thread.tid = entry.first;
+        const auto nameIt = names.find(entry.first);
+        thread.name = nameIt != names.end() ? nameIt->second : current.comm;
+        thread.cpuTimeMs = current.cpuNs / 1000000U;
+        thread.voluntarySwitches = current.voluntarySwitches;
+        thread.involuntarySwitches = current.involuntarySwitches;
+        thread.runQueueWaitMs = current.waitNs / 1000000U;
+
+        const auto previousIt = previous_.find(entry.first);
+        if (elapsedNs > 0.0 && previousIt != previous_.end()) {
+            const auto &before = previousIt->second;
+            const auto delta = [](std::uint64_t after, std::uint64_t earlier) {
+                return static_cast<double>(after >= earlier ? after - earlier : 0U);
+            };
+            thread.cpuPercent = delta(current.cpuNs, before.cpuNs) * 100.0 / elapsedNs;
+            thread.runQueueWaitPercent = delta(current.waitNs, before.waitNs) * 100.0 / elapsedNs;
+            thread.voluntarySwitchesPerSecond =
+                delta(current.voluntarySwitches, before.voluntarySwitches) * 1e9 / elapsedNs;
+            thread.involuntarySwitchesPerSecond =
+                delta(current.involuntarySwitches, before.involuntarySwitches) * 1e9 / elapsedNs;
+        }
+        usage.push_back(std::move(thread));
+    }
+    std::sort(usage.begin(), usage.end(), [](const ThreadUsage &lhs, const ThreadUsage &rhs) {
+        return lhs.cpuPercent != rhs.cpuPercent ? lhs.cpuPercent > rhs.cpuPercent : lhs.tid < rhs.tid;
+    });
+
+    previous_ = std::move(counters);
+    previousAt_ = now;
+    std::lock_guard<std::mutex> lock(mutex_);
+    latest_ = std::move(usage);
+}
+
+}  // namespace trdp_sim
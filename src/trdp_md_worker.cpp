@@ -1,21 +1,21 @@
 #include "trdp_simulator/trdp_md_worker.hpp"
 
+#include "trdp_simulator/binary_log.hpp"
+
 #include <chrono>
+#include <string>
 #include <thread>
+#include <utility>
 
 namespace trdp_sim {
 
-MdSenderWorker::MdSenderWorker(const MdSenderConfig &config,
-                               TrdpStackAdapter &adapter,
-                               Logger &logger,
-                               RuntimeMetrics &metrics)
-    : config_(config), adapter_(adapter), logger_(logger), metrics_(metrics)
+MdSenderWorker::MdSenderWorker(const MdSenderConfig &config, Logger &logger, RuntimeMetrics &metrics)
+    : config_(config), logger_(logger), metrics_(metrics), log_(logger.channel("md", config.name, config.comId))
 {
     payload_ = load_payload(config.payload);
-    adapter_.register_md_sender(config_, [this](const MdMessage &message) {
-        metrics_.record_md_reply_received(config_.name);
-        logger_.info("Received MD reply for sender '" + config_.name + "' from '" + message.endpoint + "'");
-    });
+    if (auto *binaryLog = logger_.binary_log()) {
+        binaryNameId_ = binaryLog->intern(config_.name);
+    }
 }
 
 MdSenderWorker::~MdSenderWorker()
@@ -27,8 +27,7 @@ void MdSenderWorker::start()
 {
     if (config_.cycleTimeMs == 0) {
         try {
-            adapter_.send_md_request(config_.name, payload_);
-            metrics_.record_md_request_sent(config_.name);
+            send(payload_);
         } catch (const std::exception &ex) {
             logger_.error("MD request failed for '" + config_.name + "': " + ex.what());
         }
@@ -50,25 +49,72 @@ void MdSenderWorker::stop()
     }
 }
 
-void MdSenderWorker::run()
+void MdSenderWorker::record_sent(const std::vector<std::uint8_t> &payload)
 {
-    logger_.info("Starting MD sender '" + config_.name + "'");
-    const auto interval = std::chrono::milliseconds(config_.cycleTimeMs);
-    while (running_) {
-        try {
-            std::vector<std::uint8_t> payloadCopy;
-            {
-                std::lock_guard<std::mutex> lock(payloadMutex_);
-                payloadCopy = payload_;
-            }
-            adapter_.send_md_request(config_.name, payloadCopy);
-            metrics_.record_md_request_sent(config_.name);
-        } catch (const std::exception &ex) {
-            logger_.error("MD request failed for '" + config_.name + "': " + ex.what());
-        }
-        std::this_thread::sleep_for(interval);
+    const bool notification = config_.type == MdSenderConfig::Type::Notify;
+    if (notification) {
+        metrics_.record_md_notification_sent(config_.name);
+    } else {
+        metrics_.record_md_request_sent(config_.name);
+    }
+    if (!log_.enabled(LogLevel::Debug) || !log_.admit(LogLevel::Debug)) {
+        return;
+    }
+    if (auto *binaryLog = logger_.binary_log()) {
+        binaryLog->write(LogLevel::Debug,
+                         notification ? BinaryLogMessage::MdNotificationSent : BinaryLogMessage::MdRequestSent,
+                         {BinaryLogArg::string(binaryNameId_), BinaryLogArg::unsigned_value(config_.comId)},
+                         {BinaryLogDataFormat::Hex, payload.data(), payload.size()});
+        return;
+    }
+    log_.log(LogLevel::Debug, "MD sender '" + config_.name + "' sent " + (notification ? "notification" : "request") +
+                                  " COMID " + std::to_string(config_.comId) + " payload=" + to_hex(payload));
+}
+
+void MdSenderWorker::record_confirm_sent(const MdMessage &replyQuery)
+{
+    metrics_.record_md_confirm_sent(config_.name);
+    if (!log_.enabled(LogLevel::Debug) || !log_.admit(LogLevel::Debug)) {
+        return;
+    }
+    if (auto *binaryLog = logger_.binary_log()) {
+        binaryLog->write(LogLevel::Debug, BinaryLogMessage::MdConfirmSent, {BinaryLogArg::string(binaryNameId_)},
+                         {BinaryLogDataFormat::Text, replyQuery.endpoint.data(), replyQuery.endpoint.size()});
+        return;
+    }
+    log_.log(LogLevel::Debug, "MD sender '" + config_.name + "' sent confirmation to '" + replyQuery.endpoint + "'");
+}
+
+void MdSenderWorker::handle_reply(const MdMessage &message)
+{
+    const bool query = message.type == MdMessageType::ReplyQuery;
+    if (query) {
+        metrics_.record_md_reply_query_received(config_.name);
+    } else {
+        metrics_.record_md_reply_received(config_.name);
+    }
+    if (!log_.enabled(LogLevel::Info) || !log_.admit(LogLevel::Info)) {
+        return;
+    }
+    auto *binaryLog = logger_.binary_log();
+    if (binaryLog != nullptr) {
+        binaryLog->write(LogLevel::Info,
+                         query ? BinaryLogMessage::MdReplyQueryReceived : BinaryLogMessage::MdReplyReceived,
+                         {BinaryLogArg::string(binaryNameId_)},
+                         {BinaryLogDataFormat::Text, message.endpoint.data(), message.endpoint.size()});
+        return;
+    }
+    log_.log(LogLevel::Info, std::string("Received MD ") + (query ? "reply query" : "reply") + " for sender '" + config_.name +
+                 "' from '" + message.endpoint + "'");
+}
+
+void MdSenderWorker::handle_timeout()
+{
+    metrics_.record_md_reply_timeout(config_.name);
+    if (log_.enabled(LogLevel::Warn) && log_.admit(LogLevel::Warn)) {
+        log_.log(LogLevel::Warn, "MD request from sender '" + config_.name + "' got no reply within " +
+                                     std::to_string(config_.replyTimeoutMs) + " ms");
     }
-    logger_.info("Stopping MD sender '" + config_.name + "'");
 }
 
 PayloadConfig MdSenderWorker::payload_config() const
@@ -1,18 +1,22 @@
 #include "trdp_simulator/trdp_pd_worker.hpp"
 
+#include "trdp_simulator/binary_log.hpp"
+#include "trdp_simulator/thread_monitor.hpp"
+
 #include <chrono>
+#include <functional>
+#include <queue>
 #include <thread>
 
 namespace trdp_sim {
 
-PdPublisherWorker::PdPublisherWorker(const PdPublisherConfig &config,
-                                     TrdpStackAdapter &adapter,
-                                     Logger &logger,
-                                     RuntimeMetrics &metrics)
-    : config_(config), adapter_(adapter), logger_(logger), metrics_(metrics)
+PdPublisherWorker::PdPublisherWorker(const PdPublisherConfig &config, Logger &logger, RuntimeMetrics &metrics)
+    : config_(config), logger_(logger), metrics_(metrics), log_(logger.channel("pd", config.name, config.comId))
 {
     payload_ = load_payload(config.payload);
-    adapter_.register_pd_publisher(config_);
+    if (auto *binaryLog = logger_.binary_log()) {
+        binaryNameId_ = binaryLog->intern(config_.name);
+    }
 }
 
 PdPublisherWorker::~PdPublisherWorker()
@@ -33,6 +37,10 @@ void PdPublisherWorker::stop()
     if (!running_.exchange(false)) {
         return;
     }
+    {
+        std::lock_guard<std::mutex> lock(payloadMutex_);
+        payloadCv_.notify_all();
+    }
     if (workerThread_.joinable()) {
         workerThread_.join();
     }
@@ -40,25 +48,69 @@ void PdPublisherWorker::stop()
 
 void PdPublisherWorker::run()
 {
+    const std::string threadName = "pd:" + config_.name;
+    set_thread_name(threadName);
+    if (stallDetector_ != nullptr) {
+        probe_ = &stallDetector_->attach(threadName);
+    }
     logger_.info("Starting PD publisher '" + config_.name + "'");
-    const auto interval = std::chrono::milliseconds(config_.cycleTimeMs);
-    while (running_) {
-        try {
-            std::vector<std::uint8_t> payloadCopy;
-            {
-                std::lock_guard<std::mutex> lock(payloadMutex_);
-                payloadCopy = payload_;
-            }
-            adapter_.publish_pd(config_.name, payloadCopy);
-            metrics_.record_pd_publish(config_.name);
-        } catch (const std::exception &ex) {
-            logger_.error("PD publish failed for '" + config_.name + "': " + ex.what());
-        }
-        std::this_thread::sleep_for(interval);
+    if (config_.role == PdPublisherConfig::Role::PullResponder) {
+        run_responder();
+    } else if (config_.sendMode == PdPublisherConfig::SendMode::OnChange) {
+        run_on_change();
+    } else if (config_.sendMode == PdPublisherConfig::SendMode::Tsn) {
+        run_tsn();
+    } else {
+        run_cyclic();
+    }
+    if (stallDetector_ != nullptr) {
+        stallDetector_->detach(*probe_);
+        probe_ = &StallDetector::detached();
     }
     logger_.info("Stopping PD publisher '" + config_.name + "'");
 }
 
+void PdPublisherWorker::log_sent(const std::vector<std::uint8_t> &payload)
+{
+    if (!log_.admit(LogLevel::Debug)) {
+        return;
+    }
+    if (auto *binaryLog = logger_.binary_log()) {
+        binaryLog->write(LogLevel::Debug, BinaryLogMessage::PdSent,
+                         {BinaryLogArg::string(binaryNameId_), BinaryLogArg::unsigned_value(config_.comId)},
+                         {BinaryLogDataFormat::Hex, payload.data(), payload.size()});
+        return;
+    }
+    log_.log(LogLevel::Debug, "PD publisher '" + config_.name + "' sent COMID " + std::to_string(config_.comId) +
+                                  " payload=" + to_hex(payload));
+}
+
+void PdPublisherWorker::mark_topology_change(std::chrono::steady_clock::time_point changedAt)
+{
+    topologyChangedNs_.store(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(changedAt.time_since_epoch()).count());
+}
+
+void PdPublisherWorker::record_topology_publish()
+{
+    const auto changedNs = topologyChangedNs_.exchange(0);
+    if (changedNs == 0) {
+        return;
+    }
+    const auto nowNs =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    const auto staleUs = (nowNs - changedNs) / 1000;
+    // A cyclic telegram picks up the new counters with its next cycle at the latest.
+    const bool withinCycle = staleUs <= static_cast<std::int64_t>(config_.cycleTimeMs) * 1000;
+    metrics_.record_topology_stale_window(staleUs, withinCycle);
+    if (!withinCycle) {
+        logger_.warn("PD publisher '" + config_.name + "' sent stale topology counters for " +
+                     std::to_string(staleUs) + " us, longer than its cycle of " +
+                     std::to_string(config_.cycleTimeMs) + " ms");
+    }
+}
+
 PayloadConfig PdPublisherWorker::payload_config() const
 {
     std::lock_guard<std::mutex> lock(payloadMutex_);
@@ -76,7 +128,10 @@ bool PdPublisherWorker::update_payload(PayloadConfig::Format format, const std::
             std::lock_guard<std::mutex> lock(payloadMutex_);
             payload_ = std::move(data);
             config_.payload = payloadSpec;
+            payloadChanged_ = true;
+            payloadChangedAt_ = std::chrono::steady_clock::now();
         }
+        payloadCv_.notify_one();
         return true;
     } catch (const std::exception &ex) {
         error_message = ex.what();
@@ -84,5 +139,139 @@ bool PdPublisherWorker::update_payload(PayloadConfig::Format format, const std::
     }
 }
 
+PdPullScheduler::PdPullScheduler(TrdpStackAdapter &adapter, Logger &logger, RuntimeMetrics &metrics,
+                                 StallDetector *stallDetector)
+    : adapter_(adapter), logger_(logger), metrics_(metrics), stallDetector_(stallDetector)
+{
+}
+
+PdPullScheduler::~PdPullScheduler()
+{
+    stop();
+}
+
+void PdPullScheduler::add_requester(const PdSubscriberConfig &config, TrdpStackAdapter::PdHandler handler)
+{
+    auto requester = std::make_unique<Requester>();
+    requester->config = config;
+    requester->handler = std::move(handler);
+    requester->log = &logger_.channel("pd", config.name, config.comId);
+    if (auto *binaryLog = logger_.binary_log()) {
+        requester->binaryNameId = binaryLog->intern(config.name);
+    }
+    Requester *raw = requester.get();
+    requesters_.push_back(std::move(requester));
+    adapter_.register_pd_subscriber(config, [this, raw](const PdMessage &message) { handle_reply(*raw, message); });
+}
+
+void PdPullScheduler::start()
+{
+    if (requesters_.empty() || running_.exchange(true)) {
+        return;
+    }
+    schedulerThread_ = std::thread(&PdPullScheduler::run, this);
+}
+
+void PdPullScheduler::stop()
+{
+    if (!running_.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cv_.notify_all();
+    }
+    if (schedulerThread_.joinable()) {
+        schedulerThread_.join();
+    }
+}
+
+void PdPullScheduler::run()
+{
+    using clock = std::chrono::steady_clock;
+    set_thread_name("pd-pull");
+    LoopProbe &probe =
+        stallDetector_ != nullptr ? stallDetector_->attach("pd-pull") : StallDetector::detached();
+    logger_.info("Starting PD pull scheduler for " + std::to_string(requesters_.size()) + " requester(s)");
+
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines;
+    const auto origin = clock::now();
+    for (std::size_t index = 0; index < requesters_.size(); ++index) {
+        deadlines.push({origin, index});
+    }
+
+    while (running_) {
+        const Deadline next = deadlines.top();
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            probe.sleeping_until(next.due);
+            if (cv_.wait_until(lock, next.due, [this] { return !running_.load(); })) {
+                break;
+            }
+        }
+        probe.woke();
+        deadlines.pop();
+
+        auto &requester = *requesters_[next.index];
+        const auto sentAt = clock::now();
+        // Replies carry no request reference, so only the latest request is timed; an earlier one still
+        // unanswered is counted as lost, and a late reply to it is timed against its successor.
+        const auto sentAtNs = std::chrono::duration_cast<std::chrono::nanoseconds>(sentAt.time_since_epoch()).count();
+        const bool previousLost = requester.pendingSinceNs.exchange(sentAtNs) != 0;
+        try {
+            adapter_.request_pd(requester.config.name);
+            metrics_.record_pd_pull_request(requester.config.name, previousLost);
+            if (requester.log->enabled(LogLevel::Debug)) {
+                log_request(requester);
+            }
+        } catch (const std::exception &ex) {
+            requester.pendingSinceNs.store(0);
+            logger_.error("PD pull request failed for '" + requester.config.name + "': " + ex.what());
+        }
+
+        // A requester that fell behind skips the missed slots instead of bursting to catch up.
+        const auto interval = std::chrono::milliseconds(requester.config.pullIntervalMs);
+        auto due = next.due + interval;
+        if (due < sentAt) {
+            due = sentAt + interval;
+        }
+        deadlines.push({due, next.index});
+    }
+
+    if (stallDetector_ != nullptr) {
+        stallDetector_->detach(probe);
+    }
+    logger_.info("Stopping PD pull scheduler");
+}
+
+void PdPullScheduler::log_request(Requester &requester)
+{
+    if (!requester.log->admit(LogLevel::Debug)) {
+        return;
+    }
+    if (auto *binaryLog = logger_.binary_log()) {
+        binaryLog->write(LogLevel::Debug, BinaryLogMessage::PdPullRequested,
+                         {BinaryLogArg::string(requester.binaryNameId),
+                          BinaryLogArg::unsigned_value(requester.config.comId)});
+        return;
+    }
+    requester.log->log(LogLevel::Debug, "PD requester '" + requester.config.name + "' sent pull request COMID " +
+                                            std::to_string(requester.config.comId));
+}
+
+void PdPullScheduler::handle_reply(Requester &requester, const PdMessage &message)
+{
+    const auto sentAtNs = requester.pendingSinceNs.exchange(0);
+    if (sentAtNs != 0) {
+        const auto nowNs =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        metrics_.record_pd_pull_reply(requester.config.name, (nowNs - sentAtNs) / 1000);
+    }
+    if (requester.handler) {
+        requester.handler(message);
+    }
+}
+
 }  // namespace trdp_sim
 
@@ -1,5 +1,7 @@
 #include "trdp_simulator/trdp_stack_adapter.hpp"
 
+#include "trdp_simulator/sharded_stack_adapter.hpp"
+
 #include <memory>
 
 namespace trdp_sim {
@@ -18,4 +20,17 @@ std::unique_ptr<TrdpStackAdapter> create_trdp_stack_adapter()
 #endif
 }
 
+std::unique_ptr<TrdpStackAdapter> create_trdp_stack_adapter(const NetworkConfig &networkConfig)
+{
+#ifdef TRDPSIM_WITH_TRDP
+    if (networkConfig.sessions.size() > 1U) {
+        return std::make_unique<ShardedTrdpStackAdapter>(networkConfig.sessions.size(), &create_real_trdp_stack_adapter);
+    }
+#else
+    // The stub loops telegrams back inside one instance, so splitting it would only break that loopback.
+    (void) networkConfig;
+#endif
+    return create_trdp_stack_adapter();
+}
+
 }  // namespace trdp_sim
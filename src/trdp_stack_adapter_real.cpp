@@ -2,20 +2,38 @@
 
 #include "trdp_simulator/trdp_stack_adapter.hpp"
 
+#include "trdp_simulator/trdp_md_worker.hpp"
+#include "trdp_simulator/trdp_pd_worker.hpp"
+
 #ifndef MD_SUPPORT
 #define MD_SUPPORT 1
 #endif
 
 #include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#endif
 
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <cstring>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "trdp_simulator/launch_clock.hpp"
+#include "trdp_simulator/pd_frame.hpp"
+
 extern "C" {
 #include <trdp_if_light.h>
 #include <vos_sock.h>
@@ -41,7 +59,8 @@ TRDP_IP_ADDR_T parse_ip(const std::string &ip)
     if (addr == INADDR_NONE) {
         throw std::runtime_error("Invalid IP address: " + ip);
     }
-    return static_cast<TRDP_IP_ADDR_T>(addr);
+    // The stack works with host byte order addresses.
+    return static_cast<TRDP_IP_ADDR_T>(ntohl(addr));
 }
 
 std::string ip_to_string(TRDP_IP_ADDR_T address)
@@ -51,7 +70,7 @@ std::string ip_to_string(TRDP_IP_ADDR_T address)
     }
 
     in_addr in{};
-    in.s_addr = address;
+    in.s_addr = htonl(address);
     char buffer[INET_ADDRSTRLEN] = {0};
     if (inet_ntop(AF_INET, &in, buffer, sizeof(buffer)) == nullptr) {
         return {};
@@ -59,6 +78,30 @@ std::string ip_to_string(TRDP_IP_ADDR_T address)
     return buffer;
 }
 
+// tlc_init() is process wide and tlc_terminate() closes every session, so sessions share one reference count.
+std::mutex libraryMutex;
+std::size_t libraryUsers = 0;
+
+void acquire_trdp_library(TRDP_MEM_CONFIG_T &memConfig)
+{
+    std::lock_guard<std::mutex> lock(libraryMutex);
+    if (libraryUsers == 0) {
+        const TRDP_ERR_T errInit = tlc_init(nullptr, nullptr, &memConfig);
+        if (errInit != TRDP_NO_ERR) {
+            throw std::runtime_error("tlc_init failed with error " + std::to_string(errInit));
+        }
+    }
+    ++libraryUsers;
+}
+
+void release_trdp_library()
+{
+    std::lock_guard<std::mutex> lock(libraryMutex);
+    if (libraryUsers != 0 && --libraryUsers == 0) {
+        tlc_terminate();
+    }
+}
+
 MdSessionId to_session_id(const UINT8 *sessionId)
 {
     MdSessionId id{};
@@ -68,7 +111,7 @@ MdSessionId to_session_id(const UINT8 *sessionId)
     return id;
 }
 
-class RealTrdpStackAdapter : public TrdpStackAdapter {
+class RealTrdpStackAdapter final : public TrdpStackAdapter {
 public:
     RealTrdpStackAdapter()
     {
@@ -91,10 +134,7 @@ public:
         memConfig_.p = nullptr;
         memConfig_.size = 0U;
 
-        const TRDP_ERR_T errInit = tlc_init(nullptr, nullptr, &memConfig_);
-        if (errInit != TRDP_NO_ERR) {
-            throw std::runtime_error("tlc_init failed with error " + std::to_string(errInit));
-        }
+        acquire_trdp_library(memConfig_);
 
         std::snprintf(processConfig_.hostName, sizeof(processConfig_.hostName), "%s", networkConfig.interfaceName.c_str());
         processConfig_.hostName[sizeof(processConfig_.hostName) - 1U] = '\0';
@@ -113,7 +153,7 @@ public:
         pdConfig_.flags = TRDP_FLAGS_NONE;
         pdConfig_.timeout = TRDP_PD_DEFAULT_TIMEOUT;
         pdConfig_.toBehavior = TRDP_TO_SET_TO_ZERO;
-        pdConfig_.port = 0U;
+        pdConfig_.port = networkConfig.pdPort;
 
         mdConfig_.pfCbFunction = nullptr;
         mdConfig_.pRefCon = nullptr;
@@ -123,19 +163,21 @@ public:
         mdConfig_.flags = TRDP_FLAGS_NONE;
         mdConfig_.replyTimeout = TRDP_MD_DEFAULT_REPLY_TIMEOUT;
         mdConfig_.confirmTimeout = TRDP_MD_DEFAULT_CONFIRM_TIMEOUT;
-        mdConfig_.connectTimeout = TRDP_MD_DEFAULT_CONNECTION_TIMEOUT;
+        // The stack keeps one TCP connection per peer open for reuse until it has been idle this long.
+        mdConfig_.connectTimeout = networkConfig.mdTcpIdleTimeoutMs * 1000U;
         mdConfig_.sendingTimeout = TRDP_MD_DEFAULT_SENDING_TIMEOUT;
-        mdConfig_.udpPort = 0U;
-        mdConfig_.tcpPort = 0U;
-        mdConfig_.maxNumSessions = TRDP_MD_MAX_NUM_SESSIONS;
+        mdConfig_.udpPort = networkConfig.mdPort;
+        mdConfig_.tcpPort = networkConfig.mdPort;
+        mdConfig_.maxNumSessions = networkConfig.mdMaxSessions;
 
         const TRDP_IP_ADDR_T ownIp = parse_ip(networkConfig.hostIp);
         const TRDP_ERR_T errSession = tlc_openSession(&appHandle_, ownIp, 0U, nullptr, &pdConfig_, &mdConfig_, &processConfig_);
         if (errSession != TRDP_NO_ERR) {
-            tlc_terminate();
+            release_trdp_library();
             appHandle_ = nullptr;
             throw std::runtime_error("tlc_openSession failed with error " + std::to_string(errSession));
         }
+        wakeFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
     }
 
     void shutdown() override
@@ -153,26 +195,45 @@ public:
             tlp_unsubscribe(appHandle_, subscriber.first);
         }
         pdSubscribers_.clear();
+        pdSubscriberHandles_.clear();
+
+        for (auto &publisher : tsnPublishers_) {
+            ::close(publisher.second->fd);
+        }
+        tsnPublishers_.clear();
 
         for (auto &listener : mdListeners_) {
             tlm_delListener(appHandle_, listener.second->handle);
         }
         mdListeners_.clear();
         mdSenders_.clear();
+        openCallerSessions_ = 0;
+        tcpConnections_.clear();
+        if (wakeFd_ >= 0) {
+            ::close(wakeFd_);
+            wakeFd_ = -1;
+        }
 
         tlc_closeSession(appHandle_);
-        tlc_terminate();
+        release_trdp_library();
         appHandle_ = nullptr;
     }
 
     void register_pd_publisher(const PdPublisherConfig &config) override
     {
+        if (config.sendMode == PdPublisherConfig::SendMode::Tsn) {
+            register_tsn_publisher(config);
+            return;
+        }
+
         PublisherState state;
         state.config = config;
 
         const TRDP_IP_ADDR_T srcIp = parse_ip(config.sourceIp.empty() ? networkConfig_.hostIp : config.sourceIp);
         const TRDP_IP_ADDR_T destIp = parse_ip(config.destIp);
-        const UINT32 interval = config.cycleTimeMs * 1000U;
+        const bool eventDriven = config.sendMode == PdPublisherConfig::SendMode::OnChange ||
+                                 config.role == PdPublisherConfig::Role::PullResponder;
+        const UINT32 interval = eventDriven ? 0U : config.cycleTimeMs * 1000U;
 
         const TRDP_ERR_T err = tlp_publish(appHandle_, &state.handle, nullptr, nullptr, 0U, config.comId,
                                            config.etbTopoCount, config.opTrnTopoCount, srcIp, destIp, interval,
@@ -199,12 +260,14 @@ public:
 
         const TRDP_ERR_T err = tlp_subscribe(appHandle_, &handle, state.get(), &RealTrdpStackAdapter::pd_callback, 0U,
                                              config.comId, config.etbTopoCount, config.opTrnTopoCount, srcIp, srcIp,
-                                             destIp, TRDP_FLAGS_DEFAULT, timeout, TRDP_TO_SET_TO_ZERO);
+                                             destIp, TRDP_FLAGS_CALLBACK | TRDP_FLAGS_FORCE_CB, timeout,
+                                             TRDP_TO_SET_TO_ZERO);
         if (err != TRDP_NO_ERR) {
             throw std::runtime_error("tlp_subscribe failed for subscriber '" + config.name + "' with error " +
                                      std::to_string(err));
         }
 
+        pdSubscriberHandles_[config.name] = handle;
         pdSubscribers_.emplace(handle, std::move(state));
         (void) tlc_updateSession(appHandle_);
     }
@@ -225,12 +288,163 @@ public:
         }
     }
 
-    void register_md_sender(const MdSenderConfig &config, MdHandler replyHandler) override
+    void publish_pd_immediate(const std::string &publisherName, const std::vector<std::uint8_t> &data) override
+    {
+        auto it = pdPublishers_.find(publisherName);
+        if (it == pdPublishers_.end()) {
+            throw std::runtime_error("Unknown PD publisher '" + publisherName + "'");
+        }
+
+        const UINT8 *payload = data.empty() ? nullptr : data.data();
+        const UINT32 payloadSize = static_cast<UINT32>(data.size());
+        const TRDP_ERR_T err = tlp_putImmediate(appHandle_, it->second.handle, payload, payloadSize, nullptr);
+        if (err != TRDP_NO_ERR) {
+            throw std::runtime_error("tlp_putImmediate failed for publisher '" + publisherName + "' with error " +
+                                     std::to_string(err));
+        }
+    }
+
+    void publish_pd_at(const std::string &publisherName,
+                       const std::vector<std::uint8_t> &data,
+                       std::int64_t launchTimeNs) override
+    {
+        auto it = tsnPublishers_.find(publisherName);
+        if (it == tsnPublishers_.end()) {
+            throw std::runtime_error("Unknown TSN PD publisher '" + publisherName + "'");
+        }
+
+        TsnPublisherState &state = *it->second;
+        std::vector<PdLaunchReport> reports;
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            build_pd_frame(state.frame, state.config, state.sequence++, data);
+            send_at(state, launchTimeNs);
+            state.pending.push_back({state.nextPacketId++, launchTimeNs,
+                                     launch_clock_to_realtime_ns(state.config.launchClock, launchTimeNs)});
+            while (state.pending.size() > MaxPendingLaunches) {
+                state.pending.pop_front();
+            }
+            drain_launch_reports(state, reports);
+        }
+
+        if (launchHandler_) {
+            for (const auto &report : reports) {
+                launchHandler_(report);
+            }
+        }
+    }
+
+    void set_pd_launch_handler(PdLaunchHandler handler) override
+    {
+        launchHandler_ = std::move(handler);
+    }
+
+    void request_pd(const std::string &subscriberName) override
+    {
+        auto it = pdSubscriberHandles_.find(subscriberName);
+        if (it == pdSubscriberHandles_.end()) {
+            throw std::runtime_error("Unknown PD subscriber '" + subscriberName + "'");
+        }
+
+        const PdSubscriberConfig &config = pdSubscribers_.at(it->second)->config;
+        const TRDP_IP_ADDR_T srcIp = parse_ip(networkConfig_.hostIp);
+        std::lock_guard<std::mutex> lock(processMutex_);
+        const TRDP_IP_ADDR_T responderIp = parse_ip(config.sourceIp);
+        const TRDP_ERR_T err = tlp_request(appHandle_, it->second, 0U, config.requestComId, config.etbTopoCount,
+                                           config.opTrnTopoCount, srcIp, responderIp, 0U, TRDP_FLAGS_DEFAULT, nullptr,
+                                           0U, config.comId, 0U);
+        if (err != TRDP_NO_ERR) {
+            throw std::runtime_error("tlp_request failed for subscriber '" + subscriberName + "' with error " +
+                                     std::to_string(err));
+        }
+        // Pull requests would otherwise wait for the next tlc_process() run of the poll loop.
+        (void) tlp_processSend(appHandle_);
+    }
+
+    void set_pd_redundancy(const std::vector<PdRedundancyState> &states) override
+    {
+        for (const bool leader : {true, false}) {
+            for (const auto &state : states) {
+                if (state.leader != leader) {
+                    continue;
+                }
+                const TRDP_ERR_T err = tlp_setRedundant(appHandle_, state.groupId, leader ? TRUE : FALSE);
+                if (err != TRDP_NO_ERR) {
+                    throw std::runtime_error("tlp_setRedundant failed for group " + std::to_string(state.groupId) +
+                                             " with error " + std::to_string(err));
+                }
+            }
+        }
+    }
+
+    bool pd_redundancy_leader(std::uint32_t groupId) override
+    {
+        BOOL8 leader = FALSE;
+        const TRDP_ERR_T err = tlp_getRedundant(appHandle_, groupId, &leader);
+        if (err != TRDP_NO_ERR) {
+            throw std::runtime_error("tlp_getRedundant failed for group " + std::to_string(groupId) + " with error " +
+                                     std::to_string(err));
+        }
+        return leader == TRUE;
+    }
+
+    TopologyUpdateResult set_topology(std::uint32_t etbTopoCount, std::uint32_t opTrnTopoCount) override
+    {
+        // Holding the process mutex keeps tlc_process() from sending a half-updated set of telegrams.
+        std::lock_guard<std::mutex> lock(processMutex_);
+        TopologyUpdateResult result;
+
+        TRDP_ERR_T err = tlc_setETBTopoCount(appHandle_, etbTopoCount);
+        if (err == TRDP_NO_ERR) {
+            err = tlc_setOpTrainTopoCount(appHandle_, opTrnTopoCount);
+        }
+        if (err != TRDP_NO_ERR) {
+            throw std::runtime_error("Setting topology counters failed with error " + std::to_string(err));
+        }
+
+        for (auto &entry : pdPublishers_) {
+            auto &config = entry.second.config;
+            if (!retarget_topology(config, etbTopoCount, opTrnTopoCount)) {
+                continue;
+            }
+            const TRDP_IP_ADDR_T srcIp = parse_ip(config.sourceIp.empty() ? networkConfig_.hostIp : config.sourceIp);
+            err = tlp_republish(appHandle_, entry.second.handle, config.etbTopoCount, config.opTrnTopoCount, srcIp,
+                                parse_ip(config.destIp));
+            if (err != TRDP_NO_ERR) {
+                throw std::runtime_error("tlp_republish failed for publisher '" + config.name + "' with error " +
+                                         std::to_string(err));
+            }
+            ++result.publishersUpdated;
+        }
+
+        for (auto &entry : pdSubscribers_) {
+            auto &config = entry.second->config;
+            if (!retarget_topology(config, etbTopoCount, opTrnTopoCount)) {
+                continue;
+            }
+            const TRDP_IP_ADDR_T srcIp = config.sourceIp.empty() ? VOS_INADDR_ANY : parse_ip(config.sourceIp);
+            err = tlp_resubscribe(appHandle_, entry.first, config.etbTopoCount, config.opTrnTopoCount, srcIp, srcIp,
+                                  parse_ip(config.destIp));
+            if (err != TRDP_NO_ERR) {
+                throw std::runtime_error("tlp_resubscribe failed for subscriber '" + config.name + "' with error " +
+                                         std::to_string(err));
+            }
+            ++result.subscribersUpdated;
+        }
+        return result;
+    }
+
+    void register_md_sender(const MdSenderConfig &config, MdHandler replyHandler,
+                            MdTimeoutHandler timeoutHandler) override
     {
         auto state = std::make_unique<MdSenderState>();
+        state->owner = this;
         state->config = config;
         state->replyHandler = std::move(replyHandler);
-        std::memset(state->sessionId, 0, sizeof(state->sessionId));
+        state->timeoutHandler = std::move(timeoutHandler);
+        if (config.transport == MdTransport::Tcp) {
+            trackTcp_ = true;
+        }
 
         mdSenders_[config.name] = std::move(state);
     }
@@ -243,7 +457,6 @@ public:
         }
 
         MdSenderState *state = it->second.get();
-        std::memset(state->sessionId, 0, sizeof(state->sessionId));
 
         const TRDP_IP_ADDR_T srcIp = parse_ip(state->config.sourceIp.empty() ? networkConfig_.hostIp : state->config.sourceIp);
         const TRDP_IP_ADDR_T destIp = parse_ip(state->config.destIp);
@@ -255,18 +468,76 @@ public:
         const UINT8 *payload = data.empty() ? nullptr : data.data();
         const UINT32 payloadSize = static_cast<UINT32>(data.size());
 
-        const TRDP_ERR_T err = tlm_request(appHandle_, state, &RealTrdpStackAdapter::md_reply_callback, &state->sessionId,
-                                           state->config.comId, 0U, 0U, srcIp, destIp, TRDP_FLAGS_DEFAULT, numReplies,
-                                           replyTimeout, &mdConfig_.sendParam, payload, payloadSize, srcUri, destUri);
+        const bool tcp = state->config.transport == MdTransport::Tcp;
+        if (state->config.type == MdSenderConfig::Type::Notify) {
+            // Notifications open no session, so there is nothing to call back.
+            const TRDP_ERR_T err = tlm_notify(appHandle_, state, nullptr, state->config.comId, 0U, 0U, srcIp, destIp,
+                                              tcp ? TRDP_FLAGS_TCP : TRDP_FLAGS_NONE, &mdConfig_.sendParam, payload,
+                                              payloadSize, srcUri, destUri);
+            if (err != TRDP_NO_ERR) {
+                throw std::runtime_error("tlm_notify failed for sender '" + senderName + "' with error " +
+                                         std::to_string(err));
+            }
+        } else {
+            // The stack bounds only replier sessions, so the caller table is capped here.
+            if (openCallerSessions_.load() >= networkConfig_.mdMaxSessions) {
+                throw std::runtime_error("MD sender '" + senderName + "' found the session table full (" +
+                                         std::to_string(networkConfig_.mdMaxSessions) + " sessions)");
+            }
+            const TRDP_FLAGS_T flags = tcp ? (TRDP_FLAGS_CALLBACK | TRDP_FLAGS_TCP) : TRDP_FLAGS_CALLBACK;
+            TRDP_UUID_T sessionId{};
+            const TRDP_ERR_T err = tlm_request(appHandle_, state, &RealTrdpStackAdapter::md_reply_callback, &sessionId,
+                                               state->config.comId, 0U, 0U, srcIp, destIp, flags, numReplies,
+                                               replyTimeout, &mdConfig_.sendParam, payload, payloadSize, srcUri,
+                                               destUri);
+            if (err != TRDP_NO_ERR) {
+                throw std::runtime_error("tlm_request failed for sender '" + senderName + "' with error " +
+                                         std::to_string(err));
+            }
+            report_md_session(MdSessionEvent::Role::Caller, MdSessionEvent::Kind::Opened);
+        }
+        wake();
+        if (tcp && connectionHandler_) {
+            connectionHandler_({MdConnectionEvent::Kind::Exchange, state->config.destIp});
+        }
+    }
+
+    void send_md_confirm(const std::string &senderName, const MdMessage &replyQuery) override
+    {
+        auto it = mdSenders_.find(senderName);
+        if (it == mdSenders_.end()) {
+            throw std::runtime_error("Unknown MD sender '" + senderName + "'");
+        }
+
+        TRDP_UUID_T sessionId{};
+        std::memcpy(sessionId, replyQuery.sessionId.data(), replyQuery.sessionId.size());
+        const TRDP_ERR_T err = tlm_confirm(appHandle_, &sessionId, 0U, &mdConfig_.sendParam);
         if (err != TRDP_NO_ERR) {
-            throw std::runtime_error("tlm_request failed for sender '" + senderName + "' with error " +
+            throw std::runtime_error("tlm_confirm failed for sender '" + senderName + "' with error " +
                                      std::to_string(err));
         }
+        wake();
+        // The stack drops a single-reply session silently once the confirmation is out; sessions with an open
+        // number of replies keep collecting until their reply timeout.
+        if (it->second->config.expectReply) {
+            report_md_session(MdSessionEvent::Role::Caller, MdSessionEvent::Kind::Closed);
+        }
+    }
+
+    void set_md_connection_handler(MdConnectionHandler handler) override
+    {
+        connectionHandler_ = std::move(handler);
+    }
+
+    void set_md_session_handler(MdSessionHandler handler) override
+    {
+        sessionHandler_ = std::move(handler);
     }
 
     void register_md_listener(const MdListenerConfig &config, MdHandler handler) override
     {
         auto state = std::make_unique<MdListenerState>();
+        state->owner = this;
         state->config = config;
         state->handler = std::move(handler);
         state->handle = nullptr;
@@ -275,10 +546,12 @@ public:
         const TRDP_IP_ADDR_T destIp = parse_ip(config.destIp);
         TRDP_URI_USER_T srcUri = {0};
         TRDP_URI_USER_T destUri = {0};
+        const TRDP_FLAGS_T flags = config.transport == MdTransport::Tcp ? (TRDP_FLAGS_CALLBACK | TRDP_FLAGS_TCP)
+                                                                        : TRDP_FLAGS_CALLBACK;
 
         const TRDP_ERR_T err = tlm_addListener(appHandle_, &state->handle, state.get(),
                                                &RealTrdpStackAdapter::md_request_callback, TRUE, config.comId, 0U, 0U,
-                                               srcIp, 0U, destIp, TRDP_FLAGS_DEFAULT, srcUri, destUri);
+                                               srcIp, 0U, destIp, flags, srcUri, destUri);
         if (err != TRDP_NO_ERR) {
             throw std::runtime_error("tlm_addListener failed for listener '" + config.name + "' with error " +
                                      std::to_string(err));
@@ -302,12 +575,40 @@ public:
         const UINT8 *payload = data.empty() ? nullptr : data.data();
         const UINT32 payloadSize = static_cast<UINT32>(data.size());
 
-        const TRDP_ERR_T err = tlm_reply(appHandle_, &sessionId, request.comId, 0U, &mdConfig_.sendParam, payload,
-                                         payloadSize, srcUri);
-        if (err != TRDP_NO_ERR) {
-            throw std::runtime_error("tlm_reply failed for listener '" + listenerName + "' with error " +
-                                     std::to_string(err));
+        const auto &config = it->second->config;
+        if (config.replyType == MdListenerConfig::ReplyType::Query) {
+            // The replier session stays open until the confirmation arrives or confirmTimeoutMs passes.
+            const TRDP_ERR_T err = tlm_replyQuery(appHandle_, &sessionId, request.comId, 0U,
+                                                  config.confirmTimeoutMs * 1000U, &mdConfig_.sendParam, payload,
+                                                  payloadSize, srcUri);
+            if (err != TRDP_NO_ERR) {
+                throw std::runtime_error("tlm_replyQuery failed for listener '" + listenerName + "' with error " +
+                                         std::to_string(err));
+            }
+        } else {
+            const TRDP_ERR_T err = tlm_reply(appHandle_, &sessionId, request.comId, 0U, &mdConfig_.sendParam, payload,
+                                             payloadSize, srcUri);
+            if (err != TRDP_NO_ERR) {
+                throw std::runtime_error("tlm_reply failed for listener '" + listenerName + "' with error " +
+                                         std::to_string(err));
+            }
+            report_md_session(MdSessionEvent::Role::Replier, MdSessionEvent::Kind::Closed);
         }
+        wake();
+    }
+
+    std::unique_ptr<PdPublisherWorker> create_pd_publisher_worker(const PdPublisherConfig &config,
+                                                                  Logger &logger,
+                                                                  RuntimeMetrics &metrics) override
+    {
+        return std::make_unique<BasicPdPublisherWorker<RealTrdpStackAdapter>>(config, *this, logger, metrics);
+    }
+
+    std::unique_ptr<MdSenderWorker> create_md_sender_worker(const MdSenderConfig &config,
+                                                            Logger &logger,
+                                                            RuntimeMetrics &metrics) override
+    {
+        return std::make_unique<BasicMdSenderWorker<RealTrdpStackAdapter>>(config, *this, logger, metrics);
     }
 
     void poll(std::chrono::milliseconds timeout) override
@@ -331,6 +632,16 @@ public:
             noDesc = 0;
         }
 
+        if (trackTcp_) {
+            track_tcp_connections(rfds, noDesc);
+        }
+
+        // Replies and TCP connects/sends are queued until tlm_process, so new MD traffic wakes the select below.
+        if (wakeFd_ >= 0) {
+            FD_SET(wakeFd_, &rfds);
+            noDesc = std::max(noDesc, static_cast<INT32>(wakeFd_));
+        }
+
         if (timeout.count() >= 0) {
             TRDP_TIME_T requested{0, 0};
             requested.tv_sec = static_cast<INT32>(timeout.count() / 1000);
@@ -348,6 +659,7 @@ public:
                 vos_threadDelay(static_cast<UINT32>(timeout.count()));
             }
 
+            std::lock_guard<std::mutex> lock(processMutex_);
             INT32 dummy = 0;
             (void) tlc_process(appHandle_, nullptr, &dummy);
 #if MD_SUPPORT
@@ -360,7 +672,14 @@ public:
         if (ready < 0) {
             return;
         }
+        if (wakeFd_ >= 0 && ready > 0 && FD_ISSET(wakeFd_, &rfds)) {
+            std::uint64_t count = 0;
+            (void) ::read(wakeFd_, &count, sizeof(count));
+            FD_CLR(wakeFd_, &rfds);
+            --ready;
+        }
 
+        std::lock_guard<std::mutex> lock(processMutex_);
         (void) tlc_process(appHandle_, &rfds, &ready);
 #if MD_SUPPORT
         (void) tlm_process(appHandle_, &rfds, &ready);
@@ -378,22 +697,218 @@ private:
         PdHandler handler;
     };
 
+    struct PendingLaunch {
+        std::uint32_t packetId;
+        std::int64_t launchTimeNs;
+        std::int64_t launchRealtimeNs;
+    };
+
+    // TSN telegrams bypass the stack's send queue and use a dedicated SO_TXTIME socket per publisher. The stack's own
+    // TRDP_FLAGS_TSN path needs a TSN_SUPPORT build, takes microsecond launch times on CLOCK_REALTIME only and
+    // reports no launch errors.
+    struct TsnPublisherState {
+        PdPublisherConfig config;
+        int fd{-1};
+        sockaddr_in dest{};
+        std::uint32_t sequence{0};
+        std::uint32_t nextPacketId{0};
+        std::deque<PendingLaunch> pending;
+        std::vector<std::uint8_t> frame;
+        std::mutex mutex;
+    };
+
+    static constexpr std::size_t MaxPendingLaunches = 256U;
+
+    void register_tsn_publisher(const PdPublisherConfig &config)
+    {
+#if defined(__linux__) && defined(SO_TXTIME)
+        auto state = std::make_unique<TsnPublisherState>();
+        state->config = config;
+        state->fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_UDP);
+        if (state->fd < 0) {
+            throw std::runtime_error("Unable to open TSN socket for publisher '" + config.name +
+                                     "': " + std::strerror(errno));
+        }
+
+        auto fail = [&state, &config](const std::string &what) {
+            const std::string reason = std::strerror(errno);
+            ::close(state->fd);
+            throw std::runtime_error(what + " failed for TSN publisher '" + config.name + "': " + reason);
+        };
+
+        sock_txtime txtime{};
+        txtime.clockid = launch_clock_id(config.launchClock);
+        txtime.flags = SOF_TXTIME_REPORT_ERRORS;
+        if (::setsockopt(state->fd, SOL_SOCKET, SO_TXTIME, &txtime, sizeof(txtime)) != 0) {
+            fail("SO_TXTIME");
+        }
+
+        // Software TX timestamps are taken when the packet leaves the qdisc, which is what the launch error is
+        // measured against. Kernels without them still send; they just report no launch errors.
+        const int timestamping = SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_OPT_ID |
+                                 SOF_TIMESTAMPING_OPT_TSONLY;
+        (void) ::setsockopt(state->fd, SOL_SOCKET, SO_TIMESTAMPING, &timestamping, sizeof(timestamping));
+
+        if (config.socketPriority != 0) {
+            const int priority = static_cast<int>(config.socketPriority);
+            if (::setsockopt(state->fd, SOL_SOCKET, SO_PRIORITY, &priority, sizeof(priority)) != 0) {
+                fail("SO_PRIORITY");
+            }
+        }
+
+        const int ttl = networkConfig_.ttl;
+        (void) ::setsockopt(state->fd, IPPROTO_IP, IP_TTL, &ttl, sizeof(ttl));
+        (void) ::setsockopt(state->fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+
+        const std::string &source = config.sourceIp.empty() ? networkConfig_.hostIp : config.sourceIp;
+        if (!source.empty()) {
+            sockaddr_in local{};
+            local.sin_family = AF_INET;
+            local.sin_addr.s_addr = htonl(parse_ip(source));
+            if (::bind(state->fd, reinterpret_cast<sockaddr *>(&local), sizeof(local)) != 0) {
+                fail("bind");
+            }
+            in_addr multicastIf{};
+            multicastIf.s_addr = local.sin_addr.s_addr;
+            (void) ::setsockopt(state->fd, IPPROTO_IP, IP_MULTICAST_IF, &multicastIf, sizeof(multicastIf));
+        }
+
+        state->dest.sin_family = AF_INET;
+        state->dest.sin_addr.s_addr = htonl(parse_ip(config.destIp));
+        const std::uint16_t port =
+            networkConfig_.pdPort != 0 ? networkConfig_.pdPort : static_cast<std::uint16_t>(TRDP_PD_UDP_PORT);
+        state->dest.sin_port = htons(port);
+
+        tsnPublishers_.emplace(config.name, std::move(state));
+#else
+        throw std::runtime_error("TSN publisher '" + config.name + "' requires Linux SO_TXTIME support");
+#endif
+    }
+
+    static void send_at(TsnPublisherState &state, std::int64_t launchTimeNs)
+    {
+#if defined(__linux__) && defined(SO_TXTIME)
+        iovec iov{};
+        iov.iov_base = state.frame.data();
+        iov.iov_len = state.frame.size();
+
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(std::uint64_t))] = {};
+        msghdr msg{};
+        msg.msg_name = &state.dest;
+        msg.msg_namelen = sizeof(state.dest);
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_TXTIME;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(std::uint64_t));
+        const auto txtime = static_cast<std::uint64_t>(launchTimeNs);
+        std::memcpy(CMSG_DATA(cmsg), &txtime, sizeof(txtime));
+
+        if (::sendmsg(state.fd, &msg, 0) < 0) {
+            throw std::runtime_error("TSN send failed for publisher '" + state.config.name +
+                                     "': " + std::strerror(errno));
+        }
+#else
+        (void) state;
+        (void) launchTimeNs;
+#endif
+    }
+
+    static void drain_launch_reports(TsnPublisherState &state, std::vector<PdLaunchReport> &reports)
+    {
+#ifdef __linux__
+        for (;;) {
+            alignas(cmsghdr) char control[512];
+            char payload[64];
+            iovec iov{payload, sizeof(payload)};
+            msghdr msg{};
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+            if (::recvmsg(state.fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+                return;
+            }
+
+            const timespec *softwareTimestamp = nullptr;
+            const sock_extended_err *error = nullptr;
+            for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+                if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING) {
+                    softwareTimestamp = &reinterpret_cast<const scm_timestamping *>(CMSG_DATA(cmsg))->ts[0];
+                } else if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_RECVERR) {
+                    error = reinterpret_cast<const sock_extended_err *>(CMSG_DATA(cmsg));
+                }
+            }
+            if (error == nullptr) {
+                continue;
+            }
+
+            if (error->ee_origin == SO_EE_ORIGIN_TIMESTAMPING && softwareTimestamp != nullptr) {
+                const auto match = take_pending(state, [error](const PendingLaunch &launch) {
+                    return launch.packetId == error->ee_data;
+                });
+                if (match) {
+                    const std::int64_t sentNs =
+                        static_cast<std::int64_t>(softwareTimestamp->tv_sec) * 1000000000LL + softwareTimestamp->tv_nsec;
+                    reports.push_back({state.config.name, sentNs - match->launchRealtimeNs, false});
+                }
+            }
+#ifdef SO_EE_ORIGIN_TXTIME
+            else if (error->ee_origin == SO_EE_ORIGIN_TXTIME) {
+                const auto txtime = static_cast<std::int64_t>((static_cast<std::uint64_t>(error->ee_data) << 32U) |
+                                                              error->ee_info);
+                const auto match = take_pending(state, [txtime](const PendingLaunch &launch) {
+                    return launch.launchTimeNs == txtime;
+                });
+                if (match) {
+                    reports.push_back({state.config.name, 0, true});
+                }
+            }
+#endif
+        }
+#else
+        (void) state;
+        (void) reports;
+#endif
+    }
+
+    template <typename Predicate>
+    static std::unique_ptr<PendingLaunch> take_pending(TsnPublisherState &state, Predicate predicate)
+    {
+        const auto it = std::find_if(state.pending.begin(), state.pending.end(), predicate);
+        if (it == state.pending.end()) {
+            return nullptr;
+        }
+        auto match = std::make_unique<PendingLaunch>(*it);
+        state.pending.erase(it);
+        return match;
+    }
+
     struct MdSenderState {
+        RealTrdpStackAdapter *owner{nullptr};
         MdSenderConfig config;
         MdHandler replyHandler;
-        TRDP_UUID_T sessionId;
+        MdTimeoutHandler timeoutHandler;
     };
 
     struct MdListenerState {
+        RealTrdpStackAdapter *owner{nullptr};
         MdListenerConfig config;
         MdHandler handler;
         TRDP_LIS_T handle;
     };
 
-    static void pd_callback(void *refCon, TRDP_APP_SESSION_T, const TRDP_PD_INFO_T *info, UINT8 *data, UINT32 dataSize)
+    // The stack passes the session reference first; the per-telegram reference arrives in pUserRef.
+    static void pd_callback(void *, TRDP_APP_SESSION_T, const TRDP_PD_INFO_T *info, UINT8 *data, UINT32 dataSize)
     {
-        auto *state = static_cast<SubscriberState *>(refCon);
-        if (state == nullptr || !state->handler) {
+        auto *state = static_cast<SubscriberState *>(const_cast<void *>(info->pUserRef));
+        // Pull requests addressed to this host also match the requester's own subscription.
+        if (state == nullptr || !state->handler || data == nullptr || info->resultCode != TRDP_NO_ERR ||
+            info->msgType == TRDP_MSG_PR) {
             return;
         }
 
@@ -406,45 +921,147 @@ private:
         state->handler(message);
     }
 
-    static void md_reply_callback(void *refCon, TRDP_APP_SESSION_T, const TRDP_MD_INFO_T *info, UINT8 *data, UINT32 dataSize)
+    void report_md_session(MdSessionEvent::Role role, MdSessionEvent::Kind kind)
     {
-        auto *state = static_cast<MdSenderState *>(refCon);
-        if (state == nullptr || !state->replyHandler) {
-            return;
+        if (role == MdSessionEvent::Role::Caller) {
+            if (kind == MdSessionEvent::Kind::Opened) {
+                ++openCallerSessions_;
+            } else if (openCallerSessions_.load() > 0) {
+                --openCallerSessions_;
+            }
+        }
+        if (sessionHandler_) {
+            sessionHandler_({role, kind});
+        }
+    }
+
+    // The stack flags the last callback of a session with aboutToDie; errors other than a missing listener are
+    // timeouts, except for requests with an open number of replies, which always end on their reply timeout.
+    static MdSessionEvent::Kind closing_kind(const TRDP_MD_INFO_T *info)
+    {
+        if (info->resultCode == TRDP_NO_ERR || info->resultCode == TRDP_NOLIST_ERR ||
+            (info->resultCode == TRDP_REPLYTO_ERR && info->numExpReplies == 0U)) {
+            return MdSessionEvent::Kind::Closed;
         }
+        return MdSessionEvent::Kind::TimedOut;
+    }
 
-        if (std::memcmp(state->sessionId, info->sessionId, MdSessionIdSize) != 0) {
+    // Every session of a sender reports through its user reference, so replies to overlapping requests all count.
+    static void md_reply_callback(void *, TRDP_APP_SESSION_T, const TRDP_MD_INFO_T *info, UINT8 *data, UINT32 dataSize)
+    {
+        auto *state = static_cast<MdSenderState *>(const_cast<void *>(info->pUserRef));
+        if (state == nullptr) {
             return;
         }
 
-        MdMessage message;
-        message.endpoint = ip_to_string(info->srcIpAddr);
-        if (message.endpoint.empty()) {
-            message.endpoint = "md-reply";
+        const bool query = info->msgType == TRDP_MSG_MQ;
+        if (state->replyHandler && data != nullptr && info->resultCode == TRDP_NO_ERR &&
+            (query || info->msgType == TRDP_MSG_MP)) {
+            MdMessage message;
+            message.type = query ? MdMessageType::ReplyQuery : MdMessageType::Reply;
+            message.endpoint = ip_to_string(info->srcIpAddr);
+            if (message.endpoint.empty()) {
+                message.endpoint = "md-reply";
+            }
+            message.comId = info->comId;
+            message.payload.assign(data, data + dataSize);
+            message.sessionId = to_session_id(info->sessionId);
+            state->replyHandler(message);
+        }
+        if (info->aboutToDie) {
+            const auto kind = closing_kind(info);
+            state->owner->report_md_session(MdSessionEvent::Role::Caller, kind);
+            if (kind == MdSessionEvent::Kind::TimedOut && state->timeoutHandler) {
+                state->timeoutHandler(to_session_id(info->sessionId));
+            }
+        }
+    }
+
+    struct TcpConnection {
+        std::uint16_t localPort{0};
+        std::string peer;
+    };
+
+    // The stack reuses pooled connections internally, so opens and closes are observed from its descriptor set.
+    void track_tcp_connections(const TRDP_FDS_T &fds, INT32 highDesc)
+    {
+        const std::uint16_t mdTcpPort = mdConfig_.tcpPort != 0 ? mdConfig_.tcpPort : TRDP_MD_TCP_PORT;
+        std::unordered_map<int, TcpConnection> current;
+        for (int fd = 0; fd <= highDesc; ++fd) {
+            if (fd == wakeFd_ || !FD_ISSET(fd, &fds)) {
+                continue;
+            }
+            int type = 0;
+            socklen_t typeLength = sizeof(type);
+            sockaddr_in local{};
+            sockaddr_in peer{};
+            socklen_t localLength = sizeof(local);
+            socklen_t peerLength = sizeof(peer);
+            if (::getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &typeLength) != 0 || type != SOCK_STREAM ||
+                ::getpeername(fd, reinterpret_cast<sockaddr *>(&peer), &peerLength) != 0 ||
+                ::getsockname(fd, reinterpret_cast<sockaddr *>(&local), &localLength) != 0 ||
+                peer.sin_family != AF_INET || ntohs(peer.sin_port) != mdTcpPort) {
+                continue;
+            }
+            current[fd] = {ntohs(local.sin_port), ip_to_string(ntohl(peer.sin_addr.s_addr))};
+        }
+
+        if (connectionHandler_) {
+            for (const auto &entry : tcpConnections_) {
+                const auto it = current.find(entry.first);
+                if (it == current.end() || it->second.localPort != entry.second.localPort) {
+                    connectionHandler_({MdConnectionEvent::Kind::Closed, entry.second.peer});
+                }
+            }
+            for (const auto &entry : current) {
+                const auto it = tcpConnections_.find(entry.first);
+                if (it == tcpConnections_.end() || it->second.localPort != entry.second.localPort) {
+                    connectionHandler_({MdConnectionEvent::Kind::Opened, entry.second.peer});
+                }
+            }
+        }
+        tcpConnections_ = std::move(current);
+    }
+
+    void wake()
+    {
+        if (wakeFd_ >= 0) {
+            const std::uint64_t one = 1;
+            (void) ::write(wakeFd_, &one, sizeof(one));
         }
-        message.comId = info->comId;
-        message.payload.assign(data, data + dataSize);
-        message.sessionId = to_session_id(info->sessionId);
-        state->replyHandler(message);
     }
 
-    static void md_request_callback(void *refCon, TRDP_APP_SESSION_T, const TRDP_MD_INFO_T *info, UINT8 *data, UINT32 dataSize)
+    // Notifications are discarded right after this callback; requests hold a replier session until answered.
+    static void md_request_callback(void *, TRDP_APP_SESSION_T, const TRDP_MD_INFO_T *info, UINT8 *data, UINT32 dataSize)
     {
-        auto *state = static_cast<MdListenerState *>(refCon);
-        if (state == nullptr || !state->handler) {
+        auto *state = static_cast<MdListenerState *>(const_cast<void *>(info->pUserRef));
+        if (state == nullptr) {
             return;
         }
 
-        MdMessage message;
-        message.endpoint = fallback_endpoint(state->config.name, ip_to_string(info->srcIpAddr));
-        message.comId = info->comId;
-        message.payload.assign(data, data + dataSize);
-        message.sessionId = to_session_id(info->sessionId);
-        state->handler(message);
+        if (info->resultCode == TRDP_NO_ERR && info->msgType == TRDP_MSG_MR) {
+            state->owner->report_md_session(MdSessionEvent::Role::Replier, MdSessionEvent::Kind::Opened);
+        }
+        if (state->handler && data != nullptr && info->resultCode == TRDP_NO_ERR &&
+            (info->msgType == TRDP_MSG_MN || info->msgType == TRDP_MSG_MR || info->msgType == TRDP_MSG_MC)) {
+            MdMessage message;
+            message.type = info->msgType == TRDP_MSG_MN   ? MdMessageType::Notification
+                           : info->msgType == TRDP_MSG_MC ? MdMessageType::Confirm
+                                                          : MdMessageType::Request;
+            message.endpoint = fallback_endpoint(state->config.name, ip_to_string(info->srcIpAddr));
+            message.comId = info->comId;
+            message.payload.assign(data, data + dataSize);
+            message.sessionId = to_session_id(info->sessionId);
+            state->handler(message);
+        }
+        if (info->aboutToDie && info->msgType != TRDP_MSG_MN) {
+            state->owner->report_md_session(MdSessionEvent::Role::Replier, closing_kind(info));
+        }
     }
 
     NetworkConfig networkConfig_;
     TRDP_APP_SESSION_T appHandle_{nullptr};
+    std::mutex processMutex_;
     TRDP_MEM_CONFIG_T memConfig_{};
     TRDP_PROCESS_CONFIG_T processConfig_{};
     TRDP_PD_CONFIG_T pdConfig_{};
@@ -452,6 +1069,16 @@ private:
 
     std::unordered_map<std::string, PublisherState> pdPublishers_;
     std::unordered_map<TRDP_SUB_T, std::unique_ptr<SubscriberState>> pdSubscribers_;
+    std::unordered_map<std::string, TRDP_SUB_T> pdSubscriberHandles_;
+    std::unordered_map<std::string, std::unique_ptr<TsnPublisherState>> tsnPublishers_;
+    PdLaunchHandler launchHandler_;
+    MdConnectionHandler connectionHandler_;
+    MdSessionHandler sessionHandler_;
+    std::atomic<std::uint32_t> openCallerSessions_{0};
+    bool trackTcp_{false};
+    // Outgoing TCP connections seen by the last poll, keyed by descriptor; only touched by the polling thread.
+    std::unordered_map<int, TcpConnection> tcpConnections_;
+    int wakeFd_{-1};
     std::unordered_map<std::string, std::unique_ptr<MdSenderState>> mdSenders_;
     std::unordered_map<std::string, std::unique_ptr<MdListenerState>> mdListeners_;
 };
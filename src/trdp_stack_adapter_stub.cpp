@@ -1,8 +1,14 @@
 #include "trdp_simulator/trdp_stack_adapter.hpp"
 
+#include "trdp_simulator/launch_clock.hpp"
+#include "trdp_simulator/trdp_md_worker.hpp"
+#include "trdp_simulator/trdp_pd_worker.hpp"
+
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <memory>
 #include <mutex>
 #include <stdexcept>
 #include <thread>
@@ -39,83 +45,290 @@ struct MdSessionIdHash {
     }
 };
 
-class StubTrdpStackAdapter : public TrdpStackAdapter {
+// Expires MD sessions without scanning the table: each session is filed under the slot of its deadline tick and
+// checked against its current deadline when that slot comes round, so replies and reschedules need no removal.
+class SessionTimerWheel {
 public:
-    void initialize(const NetworkConfig &, const LoggingConfig &) override {}
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::chrono::milliseconds Tick{10};
+    static constexpr std::size_t SlotCount = 256U;
+
+    void reset(Clock::time_point now)
+    {
+        for (auto &slot : slots_) {
+            slot.clear();
+        }
+        origin_ = now;
+        current_ = 0U;
+    }
+
+    void schedule(const MdSessionId &id, Clock::time_point deadline)
+    {
+        // The slot after the deadline's tick is only reached once the deadline has passed.
+        const auto tick = std::max(tick_of(deadline) + 1U, current_ + 1U);
+        slots_[tick % SlotCount].push_back({id, deadline});
+    }
+
+    // Moves every entry due by `now` to `expired`; entries due in a later rotation stay in their slot.
+    void advance(Clock::time_point now, std::vector<MdSessionId> &expired)
+    {
+        const auto target = tick_of(now);
+        if (target <= current_) {
+            return;
+        }
+        const auto steps = std::min<std::uint64_t>(target - current_, SlotCount);
+        for (std::uint64_t step = 1U; step <= steps; ++step) {
+            auto &slot = slots_[(current_ + step) % SlotCount];
+            const auto due = std::partition(slot.begin(), slot.end(),
+                                            [now](const Entry &entry) { return entry.deadline > now; });
+            for (auto it = due; it != slot.end(); ++it) {
+                expired.push_back(it->id);
+            }
+            slot.erase(due, slot.end());
+        }
+        current_ = target;
+    }
+
+private:
+    struct Entry {
+        MdSessionId id;
+        Clock::time_point deadline;
+    };
+
+    std::uint64_t tick_of(Clock::time_point time) const
+    {
+        if (time <= origin_) {
+            return 0U;
+        }
+        return static_cast<std::uint64_t>((time - origin_) / Tick);
+    }
+
+    std::array<std::vector<Entry>, SlotCount> slots_;
+    Clock::time_point origin_{Clock::now()};
+    std::uint64_t current_{0U};
+};
+
+class StubTrdpStackAdapter final : public TrdpStackAdapter {
+public:
+    void initialize(const NetworkConfig &networkConfig, const LoggingConfig &) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tcpIdleTimeout_ = std::chrono::milliseconds(networkConfig.mdTcpIdleTimeoutMs);
+        maxMdSessions_ = networkConfig.mdMaxSessions;
+        sessionWheel_.reset(Clock::now());
+    }
 
     void shutdown() override
     {
         std::lock_guard<std::mutex> lock(mutex_);
         pdPublishers_.clear();
         pdSubscribers_.clear();
+        ++subscriptionsVersion_;
         mdSenders_.clear();
         mdListeners_.clear();
         mdSessions_.clear();
+        sessionWheel_.reset(Clock::now());
+        redundancyLeaders_.clear();
+        tcpLastUse_.clear();
     }
 
     void register_pd_publisher(const PdPublisherConfig &config) override
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        pdPublishers_[config.name] = {config, 0U};
+        pdPublishers_[config.name] = {config, 0U, {}, nullptr, 0U};
     }
 
     void register_pd_subscriber(const PdSubscriberConfig &config, PdHandler handler) override
     {
         std::lock_guard<std::mutex> lock(mutex_);
         pdSubscribers_.push_back({config, std::move(handler)});
+        ++subscriptionsVersion_;
     }
 
+    // Steady-state publishing does not allocate: the matching subscribers are cached per publisher and the
+    // message handed to them is reused by the publishing thread.
     void publish_pd(const std::string &publisherName, const std::vector<std::uint8_t> &data) override
     {
-        PdPublisherConfig publisherConfig;
+        std::shared_ptr<const PdDispatch> dispatch;
         std::uint64_t sequence{};
-        std::vector<PdSubscriberState> targets;
         {
             std::lock_guard<std::mutex> lock(mutex_);
             const auto it = pdPublishers_.find(publisherName);
             if (it == pdPublishers_.end()) {
                 throw std::runtime_error("Unknown PD publisher '" + publisherName + "'");
             }
-            publisherConfig = it->second.config;
-            sequence = ++it->second.sequenceCounter;
-
-            for (const auto &subscriber : pdSubscribers_) {
-                if (!matches_pd_subscription(subscriber.config, publisherConfig)) {
-                    continue;
-                }
-                targets.push_back(subscriber);
+            auto &publisher = it->second;
+            if (publisher.config.role == PdPublisherConfig::Role::PullResponder) {
+                // Responders only refresh the buffer that pull requests are answered from.
+                publisher.lastPayload = data;
+                return;
             }
+            if (publisher.config.redundancyGroup != 0 && !is_leader_locked(publisher.config.redundancyGroup)) {
+                return;
+            }
+            sequence = ++publisher.sequenceCounter;
+            if (!publisher.dispatch || publisher.dispatchVersion != subscriptionsVersion_) {
+                publisher.dispatch = build_dispatch_locked(publisher.config);
+                publisher.dispatchVersion = subscriptionsVersion_;
+            }
+            dispatch = publisher.dispatch;
         }
 
-        if (targets.empty()) {
+        if (dispatch->handlers.empty()) {
             return;
         }
 
-        PdMessage message;
-        message.endpoint = fallback_endpoint(publisherName, publisherConfig.sourceIp);
-        message.comId = publisherConfig.comId;
-        message.payload = data;
+        // A handler that publishes in turn gets a message of its own rather than overwriting this one.
+        thread_local PdMessage scratch;
+        thread_local bool scratchInUse = false;
+        struct ScratchClaim {
+            bool claimed;
+            ~ScratchClaim()
+            {
+                if (claimed) {
+                    scratchInUse = false;
+                }
+            }
+        } claim{!scratchInUse};
+        PdMessage nested;
+        PdMessage &message = claim.claimed ? scratch : nested;
+        scratchInUse = true;
+        message.endpoint = dispatch->endpoint;
+        message.comId = dispatch->comId;
+        message.payload.assign(data.begin(), data.end());
         message.sequenceCounter = sequence;
 
-        for (const auto &subscriber : targets) {
-            if (subscriber.handler) {
-                subscriber.handler(message);
+        for (const auto &handler : dispatch->handlers) {
+            handler(message);
+        }
+    }
+
+    void publish_pd_immediate(const std::string &publisherName, const std::vector<std::uint8_t> &data) override
+    {
+        publish_pd(publisherName, data);
+    }
+
+    void publish_pd_at(const std::string &publisherName,
+                       const std::vector<std::uint8_t> &data,
+                       std::int64_t launchTimeNs) override
+    {
+        PdPublisherConfig::LaunchClock clock{};
+        PdLaunchHandler handler;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const auto it = pdPublishers_.find(publisherName);
+            if (it == pdPublishers_.end()) {
+                throw std::runtime_error("Unknown PD publisher '" + publisherName + "'");
+            }
+            clock = it->second.config.launchClock;
+            handler = launchHandler_;
+        }
+
+        // Without a kernel launch-time qdisc the stub can only emulate the launch from user space.
+        launch_clock_sleep_until(clock, launchTimeNs);
+        const auto launchedAt = launch_clock_now_ns(clock);
+        publish_pd(publisherName, data);
+        if (handler) {
+            handler({publisherName, launchedAt - launchTimeNs, false});
+        }
+    }
+
+    void set_pd_launch_handler(PdLaunchHandler handler) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        launchHandler_ = std::move(handler);
+    }
+
+    void request_pd(const std::string &subscriberName) override
+    {
+        PdSubscriberState target;
+        PdMessage reply;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const auto subscriberIt = std::find_if(pdSubscribers_.begin(), pdSubscribers_.end(),
+                [&subscriberName](const PdSubscriberState &state) { return state.config.name == subscriberName; });
+            if (subscriberIt == pdSubscribers_.end()) {
+                throw std::runtime_error("Unknown PD subscriber '" + subscriberName + "'");
+            }
+            target = *subscriberIt;
+
+            const auto responderIt = std::find_if(pdPublishers_.begin(), pdPublishers_.end(),
+                [&target](const auto &entry) {
+                    const auto &responder = entry.second.config;
+                    return responder.role == PdPublisherConfig::Role::PullResponder &&
+                           responder.comId == target.config.comId &&
+                           (responder.sourceIp.empty() || responder.sourceIp == target.config.sourceIp);
+                });
+            if (responderIt == pdPublishers_.end()) {
+                return;
+            }
+            auto &responder = responderIt->second;
+            reply.endpoint = fallback_endpoint(responder.config.name, responder.config.sourceIp);
+            reply.comId = responder.config.comId;
+            reply.payload = responder.lastPayload;
+            reply.sequenceCounter = ++responder.sequenceCounter;
+        }
+
+        if (target.handler) {
+            target.handler(reply);
+        }
+    }
+
+    void set_pd_redundancy(const std::vector<PdRedundancyState> &states) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &state : states) {
+            const bool known = std::any_of(pdPublishers_.begin(), pdPublishers_.end(), [&state](const auto &entry) {
+                return entry.second.config.redundancyGroup == state.groupId;
+            });
+            if (!known) {
+                throw std::runtime_error("Unknown PD redundancy group " + std::to_string(state.groupId));
+            }
+        }
+        for (const auto &state : states) {
+            redundancyLeaders_[state.groupId] = state.leader;
+        }
+    }
+
+    bool pd_redundancy_leader(std::uint32_t groupId) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return is_leader_locked(groupId);
+    }
+
+    TopologyUpdateResult set_topology(std::uint32_t etbTopoCount, std::uint32_t opTrnTopoCount) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        TopologyUpdateResult result;
+        for (auto &entry : pdPublishers_) {
+            if (retarget_topology(entry.second.config, etbTopoCount, opTrnTopoCount)) {
+                ++result.publishersUpdated;
+            }
+        }
+        for (auto &subscriber : pdSubscribers_) {
+            if (retarget_topology(subscriber.config, etbTopoCount, opTrnTopoCount)) {
+                ++result.subscribersUpdated;
             }
         }
+        return result;
     }
 
-    void register_md_sender(const MdSenderConfig &config, MdHandler handler) override
+    void register_md_sender(const MdSenderConfig &config, MdHandler handler, MdTimeoutHandler timeoutHandler) override
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        mdSenders_[config.name] = {config, std::move(handler)};
+        mdSenders_[config.name] = {config, std::move(handler), std::move(timeoutHandler)};
     }
 
     void send_md_request(const std::string &senderName, const std::vector<std::uint8_t> &data) override
     {
         MdSenderConfig senderConfig;
         MdHandler replyHandler;
+        MdConnectionHandler connectionHandler;
+        MdSessionHandler sessionHandler;
+        std::vector<MdConnectionEvent> connectionEvents;
         std::vector<MdListenerState> listeners;
         MdSessionId sessionId{};
+        bool sessionOpened = false;
 
         {
             std::lock_guard<std::mutex> lock(mutex_);
@@ -126,6 +339,16 @@ public:
 
             senderConfig = it->second.config;
             replyHandler = it->second.replyHandler;
+            if (replyHandler && senderConfig.type == MdSenderConfig::Type::Request &&
+                mdSessions_.size() >= maxMdSessions_) {
+                throw std::runtime_error("MD sender '" + senderName + "' found the session table full (" +
+                                         std::to_string(maxMdSessions_) + " sessions)");
+            }
+            connectionHandler = connectionHandler_;
+            sessionHandler = sessionHandler_;
+            if (senderConfig.transport == MdTransport::Tcp) {
+                connectionEvents = use_tcp_connection_locked(senderConfig.destIp);
+            }
             const auto numericSession = nextSessionId_++;
             sessionId = make_session_id(numericSession);
 
@@ -136,12 +359,29 @@ public:
                 listeners.push_back(listener);
             }
 
-            if (replyHandler) {
-                mdSessions_[sessionId] = {senderName, replyHandler};
+            // Notifications carry no session, so nothing is kept for replies.
+            if (replyHandler && senderConfig.type == MdSenderConfig::Type::Request) {
+                const auto deadline = Clock::now() + std::chrono::milliseconds(senderConfig.replyTimeoutMs);
+                auto &session = mdSessions_[sessionId];
+                session.senderName = senderName;
+                session.deadline = deadline;
+                sessionWheel_.schedule(sessionId, deadline);
+                sessionOpened = true;
+            }
+        }
+
+        if (connectionHandler) {
+            for (const auto &event : connectionEvents) {
+                connectionHandler(event);
             }
         }
+        if (sessionOpened && sessionHandler) {
+            sessionHandler({MdSessionEvent::Role::Caller, MdSessionEvent::Kind::Opened});
+        }
 
         MdMessage request;
+        request.type = senderConfig.type == MdSenderConfig::Type::Notify ? MdMessageType::Notification
+                                                                          : MdMessageType::Request;
         request.endpoint = fallback_endpoint(senderName, senderConfig.sourceIp);
         request.comId = senderConfig.comId;
         request.sessionId = sessionId;
@@ -153,19 +393,70 @@ public:
             }
         }
 
-        if (!senderConfig.expectReply && replyHandler) {
+        if (sessionOpened && !senderConfig.expectReply) {
             MdMessage reply;
+            reply.type = MdMessageType::Reply;
             reply.endpoint = senderConfig.destIp.empty() ? "stub-listener" : senderConfig.destIp;
             reply.comId = senderConfig.replyComId == 0 ? senderConfig.comId : senderConfig.replyComId;
             reply.sessionId = sessionId;
             reply.payload.clear();
             replyHandler(reply);
 
+            close_md_session(sessionId);
+        }
+    }
+
+    void send_md_confirm(const std::string &senderName, const MdMessage &replyQuery) override
+    {
+        MdHandler listenerHandler;
+        MdSessionHandler sessionHandler;
+        MdSenderConfig senderConfig;
+        {
             std::lock_guard<std::mutex> lock(mutex_);
-            mdSessions_.erase(sessionId);
+            const auto sessionIt = mdSessions_.find(replyQuery.sessionId);
+            if (sessionIt == mdSessions_.end() || !sessionIt->second.awaitingConfirm ||
+                sessionIt->second.senderName != senderName) {
+                throw std::runtime_error("MD sender '" + senderName + "' has no reply query to confirm");
+            }
+            const auto listenerIt = std::find_if(mdListeners_.begin(), mdListeners_.end(),
+                [&sessionIt](const MdListenerState &state) { return state.config.name == sessionIt->second.listenerName; });
+            if (listenerIt != mdListeners_.end()) {
+                listenerHandler = listenerIt->handler;
+            }
+            const auto senderIt = mdSenders_.find(senderName);
+            if (senderIt != mdSenders_.end()) {
+                senderConfig = senderIt->second.config;
+            }
+            sessionHandler = sessionHandler_;
+            mdSessions_.erase(sessionIt);
+        }
+
+        if (sessionHandler) {
+            sessionHandler({MdSessionEvent::Role::Caller, MdSessionEvent::Kind::Closed});
+            sessionHandler({MdSessionEvent::Role::Replier, MdSessionEvent::Kind::Closed});
+        }
+        if (listenerHandler) {
+            MdMessage confirm;
+            confirm.type = MdMessageType::Confirm;
+            confirm.endpoint = fallback_endpoint(senderName, senderConfig.sourceIp);
+            confirm.comId = replyQuery.comId;
+            confirm.sessionId = replyQuery.sessionId;
+            listenerHandler(confirm);
         }
     }
 
+    void set_md_connection_handler(MdConnectionHandler handler) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connectionHandler_ = std::move(handler);
+    }
+
+    void set_md_session_handler(MdSessionHandler handler) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sessionHandler_ = std::move(handler);
+    }
+
     void register_md_listener(const MdListenerConfig &config, MdHandler handler) override
     {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -175,28 +466,50 @@ public:
     void send_md_reply(const std::string &listenerName, const MdMessage &request, const std::vector<std::uint8_t> &data) override
     {
         MdHandler replyHandler;
+        MdSessionHandler sessionHandler;
         MdListenerConfig listenerConfig;
         {
             std::lock_guard<std::mutex> lock(mutex_);
             const auto sessionIt = mdSessions_.find(request.sessionId);
-            if (sessionIt == mdSessions_.end()) {
+            if (sessionIt == mdSessions_.end() || sessionIt->second.awaitingConfirm) {
                 return;
             }
-            replyHandler = sessionIt->second.replyHandler;
-            mdSessions_.erase(sessionIt);
+            const auto senderIt = mdSenders_.find(sessionIt->second.senderName);
+            if (senderIt != mdSenders_.end()) {
+                replyHandler = senderIt->second.replyHandler;
+            }
 
             const auto listenerIt = std::find_if(mdListeners_.begin(), mdListeners_.end(),
                 [&listenerName](const MdListenerState &state) { return state.config.name == listenerName; });
             if (listenerIt != mdListeners_.end()) {
                 listenerConfig = listenerIt->config;
             }
+            // A reply query holds the caller session and opens a replier session until the caller confirms.
+            if (listenerConfig.replyType == MdListenerConfig::ReplyType::Query) {
+                sessionIt->second.awaitingConfirm = true;
+                sessionIt->second.listenerName = listenerName;
+                sessionIt->second.deadline = Clock::now() + std::chrono::milliseconds(listenerConfig.confirmTimeoutMs);
+                sessionWheel_.schedule(request.sessionId, sessionIt->second.deadline);
+            } else {
+                mdSessions_.erase(sessionIt);
+            }
+            sessionHandler = sessionHandler_;
         }
 
+        const bool query = listenerConfig.replyType == MdListenerConfig::ReplyType::Query;
+        if (sessionHandler) {
+            if (query) {
+                sessionHandler({MdSessionEvent::Role::Replier, MdSessionEvent::Kind::Opened});
+            } else {
+                sessionHandler({MdSessionEvent::Role::Caller, MdSessionEvent::Kind::Closed});
+            }
+        }
         if (!replyHandler) {
             return;
         }
 
         MdMessage reply;
+        reply.type = query ? MdMessageType::ReplyQuery : MdMessageType::Reply;
         reply.endpoint = fallback_endpoint(listenerName, listenerConfig.sourceIp);
         reply.comId = request.comId;
         reply.sessionId = request.sessionId;
@@ -204,15 +517,48 @@ public:
         replyHandler(reply);
     }
 
+    std::unique_ptr<PdPublisherWorker> create_pd_publisher_worker(const PdPublisherConfig &config,
+                                                                  Logger &logger,
+                                                                  RuntimeMetrics &metrics) override
+    {
+        return std::make_unique<BasicPdPublisherWorker<StubTrdpStackAdapter>>(config, *this, logger, metrics);
+    }
+
+    std::unique_ptr<MdSenderWorker> create_md_sender_worker(const MdSenderConfig &config,
+                                                            Logger &logger,
+                                                            RuntimeMetrics &metrics) override
+    {
+        return std::make_unique<BasicMdSenderWorker<StubTrdpStackAdapter>>(config, *this, logger, metrics);
+    }
+
+    // Sleeps in wheel ticks so sessions expire close to their deadline.
     void poll(std::chrono::milliseconds timeout) override
     {
-        std::this_thread::sleep_for(timeout);
+        const auto end = Clock::now() + timeout;
+        for (;;) {
+            expire_md_sessions(Clock::now());
+            const auto now = Clock::now();
+            if (now >= end) {
+                return;
+            }
+            std::this_thread::sleep_for(std::min<Clock::duration>(SessionTimerWheel::Tick, end - now));
+        }
     }
 
 private:
+    // Immutable once built, so publishers keep using a snapshot while subscriptions change underneath.
+    struct PdDispatch {
+        std::string endpoint;
+        std::uint32_t comId{0};
+        std::vector<PdHandler> handlers;
+    };
+
     struct PdPublisherState {
         PdPublisherConfig config;
         std::uint64_t sequenceCounter;
+        std::vector<std::uint8_t> lastPayload;
+        std::shared_ptr<const PdDispatch> dispatch;
+        std::uint64_t dispatchVersion;
     };
 
     struct PdSubscriberState {
@@ -223,6 +569,7 @@ private:
     struct MdSenderState {
         MdSenderConfig config;
         MdHandler replyHandler;
+        MdTimeoutHandler timeoutHandler;
     };
 
     struct MdListenerState {
@@ -230,11 +577,109 @@ private:
         MdHandler handler;
     };
 
+    using Clock = SessionTimerWheel::Clock;
+
     struct MdSessionState {
         std::string senderName;
-        MdHandler replyHandler;
+        Clock::time_point deadline;
+        bool awaitingConfirm{false};
+        std::string listenerName;
     };
 
+    // A session waiting for a confirmation also holds a replier session, which times out with it.
+    void expire_md_sessions(Clock::time_point now)
+    {
+        std::vector<MdSessionId> due;
+        std::vector<std::pair<MdTimeoutHandler, MdSessionId>> timeouts;
+        std::size_t confirmTimeouts = 0U;
+        MdSessionHandler sessionHandler;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sessionWheel_.advance(now, due);
+            for (const auto &id : due) {
+                const auto it = mdSessions_.find(id);
+                if (it == mdSessions_.end() || it->second.deadline > now) {
+                    continue;
+                }
+                if (it->second.awaitingConfirm) {
+                    ++confirmTimeouts;
+                }
+                const auto senderIt = mdSenders_.find(it->second.senderName);
+                if (senderIt != mdSenders_.end()) {
+                    timeouts.emplace_back(senderIt->second.timeoutHandler, id);
+                }
+                mdSessions_.erase(it);
+            }
+            sessionHandler = sessionHandler_;
+        }
+
+        if (sessionHandler) {
+            for (std::size_t index = 0; index < timeouts.size(); ++index) {
+                sessionHandler({MdSessionEvent::Role::Caller, MdSessionEvent::Kind::TimedOut});
+            }
+            for (std::size_t index = 0; index < confirmTimeouts; ++index) {
+                sessionHandler({MdSessionEvent::Role::Replier, MdSessionEvent::Kind::TimedOut});
+            }
+        }
+        for (const auto &timeout : timeouts) {
+            if (timeout.first) {
+                timeout.first(timeout.second);
+            }
+        }
+    }
+
+    void close_md_session(const MdSessionId &sessionId)
+    {
+        MdSessionHandler sessionHandler;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (mdSessions_.erase(sessionId) == 0) {
+                return;
+            }
+            sessionHandler = sessionHandler_;
+        }
+        if (sessionHandler) {
+            sessionHandler({MdSessionEvent::Role::Caller, MdSessionEvent::Kind::Closed});
+        }
+    }
+
+    // Exchanges complete synchronously here, so each peer needs a single connection that stays open until idle.
+    std::vector<MdConnectionEvent> use_tcp_connection_locked(const std::string &peer)
+    {
+        std::vector<MdConnectionEvent> events;
+        const auto now = std::chrono::steady_clock::now();
+        const auto it = tcpLastUse_.find(peer);
+        if (it == tcpLastUse_.end() || now - it->second >= tcpIdleTimeout_) {
+            if (it != tcpLastUse_.end()) {
+                events.push_back({MdConnectionEvent::Kind::Closed, peer});
+            }
+            events.push_back({MdConnectionEvent::Kind::Opened, peer});
+        }
+        events.push_back({MdConnectionEvent::Kind::Exchange, peer});
+        tcpLastUse_[peer] = now;
+        return events;
+    }
+
+    std::shared_ptr<const PdDispatch> build_dispatch_locked(const PdPublisherConfig &publisher) const
+    {
+        auto dispatch = std::make_shared<PdDispatch>();
+        dispatch->endpoint = fallback_endpoint(publisher.name, publisher.sourceIp);
+        dispatch->comId = publisher.comId;
+        for (const auto &subscriber : pdSubscribers_) {
+            if (subscriber.handler && matches_pd_subscription(subscriber.config, publisher)) {
+                dispatch->handlers.push_back(subscriber.handler);
+            }
+        }
+        return dispatch;
+    }
+
+    // Mirrors the stack, where redundant publishers start out as followers.
+    bool is_leader_locked(std::uint32_t groupId) const
+    {
+        const auto it = redundancyLeaders_.find(groupId);
+        return it != redundancyLeaders_.end() && it->second;
+    }
+
     static bool matches_pd_subscription(const PdSubscriberConfig &subscriber, const PdPublisherConfig &publisher)
     {
         if (subscriber.enableComIdFiltering && subscriber.comId != 0 && subscriber.comId != publisher.comId) {
@@ -266,9 +711,18 @@ private:
     std::mutex mutex_;
     std::unordered_map<std::string, PdPublisherState> pdPublishers_;
     std::vector<PdSubscriberState> pdSubscribers_;
+    std::uint64_t subscriptionsVersion_{0};
+    std::unordered_map<std::uint32_t, bool> redundancyLeaders_;
+    PdLaunchHandler launchHandler_;
+    MdConnectionHandler connectionHandler_;
+    MdSessionHandler sessionHandler_;
+    std::chrono::milliseconds tcpIdleTimeout_{60000};
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> tcpLastUse_;
     std::unordered_map<std::string, MdSenderState> mdSenders_;
     std::vector<MdListenerState> mdListeners_;
     std::unordered_map<MdSessionId, MdSessionState, MdSessionIdHash> mdSessions_;
+    SessionTimerWheel sessionWheel_;
+    std::size_t maxMdSessions_{1000U};
     std::atomic<std::uint32_t> nextSessionId_{1};
 };
 }  // namespace
@@ -3,21 +3,29 @@
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <array>
 #include <cerrno>
 #include <cctype>
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <iomanip>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 #include <utility>
 
+#include "trdp_simulator/allocation_tracker.hpp"
 #include "trdp_simulator/config_loader.hpp"
 #include "trdp_simulator/logger.hpp"
+#include "trdp_simulator/run_arena.hpp"
 #include "trdp_simulator/simulator.hpp"
 #include "trdp_simulator/trdp_stack_adapter.hpp"
 
@@ -25,6 +33,9 @@ namespace trdp_sim {
 
 namespace {
 constexpr std::size_t kMaxConfigFileSize = 512 * 1024;
+// Larger request bodies are streamed to a temporary file instead of being held in memory.
+constexpr std::size_t kMaxInMemoryBodySize = 64 * 1024;
+constexpr std::uint64_t kMaxRequestBodySize = 256ULL * 1024 * 1024;
 std::string status_message_for(int code)
 {
     switch (code) {
@@ -32,18 +43,124 @@ std::string status_message_for(int code)
         return "OK";
     case 202:
         return "Accepted";
+    case 304:
+        return "Not Modified";
     case 400:
         return "Bad Request";
     case 404:
         return "Not Found";
     case 409:
         return "Conflict";
+    case 413:
+        return "Payload Too Large";
+    case 431:
+        return "Request Header Fields Too Large";
     case 500:
         return "Internal Server Error";
+    case 501:
+        return "Not Implemented";
     default:
         return "Unknown";
     }
 }
+
+bool is_xml_body(const HttpRequest &request)
+{
+    const auto type = request.media_type();
+    return type == "application/xml" || type == "text/xml";
+}
+
+// A spooled body is parsed from its file, so the document is never copied into a string.
+SimulatorConfig load_request_configuration(const HttpRequest &request)
+{
+    if (!request.bodyFile.empty()) {
+        return load_configuration(request.bodyFile.string());
+    }
+    return load_configuration_from_string(request.body);
+}
+
+// Rows of one list chosen by a ListQuery, in display order, and the counts reported for it under "pages".
+struct ListPage {
+    std::vector<std::size_t> rows;
+    std::size_t total{0};
+    std::size_t matched{0};
+};
+
+std::string lowercase(std::string value)
+{
+    std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return value;
+}
+
+void append_page(std::ostringstream &pages, const char *list, const ListPage &page, std::size_t offset)
+{
+    if (pages.tellp() > 0) {
+        pages << ',';
+    }
+    pages << '"' << list << "\":{\"total\":" << page.total << ",\"matched\":" << page.matched
+          << ",\"offset\":" << offset << ",\"count\":" << page.rows.size() << '}';
+}
+
+// Lists left out by the query's list parameter come back without rows.
+template <typename Entries, typename NameOf, typename ComIdOf>
+ListPage select_rows(const WebApplication::ListQuery &query, const char *list, const Entries &entries,
+                     NameOf name_of, ComIdOf com_id_of, std::ostringstream &pages)
+{
+    ListPage page;
+    page.total = entries.size();
+    if (!query.includes(list)) {
+        return page;
+    }
+    const auto filter = lowercase(query.filter);
+    const bool numeric = !filter.empty() && std::all_of(filter.begin(), filter.end(), [](unsigned char c) {
+        return std::isdigit(c);
+    });
+    const auto filterComId = numeric ? std::strtoull(filter.c_str(), nullptr, 10) : 0ULL;
+    for (std::size_t index = 0; index < entries.size(); ++index) {
+        if (filter.empty() || (numeric && com_id_of(entries[index]) == filterComId) ||
+            lowercase(name_of(entries[index])).find(filter) != std::string::npos) {
+            page.rows.push_back(index);
+        }
+    }
+    page.matched = page.rows.size();
+
+    using Sort = WebApplication::ListQuery::Sort;
+    if (query.sort == Sort::Name) {
+        std::stable_sort(page.rows.begin(), page.rows.end(), [&](std::size_t lhs, std::size_t rhs) {
+            return name_of(entries[lhs]) < name_of(entries[rhs]);
+        });
+    } else if (query.sort == Sort::ComId) {
+        std::stable_sort(page.rows.begin(), page.rows.end(), [&](std::size_t lhs, std::size_t rhs) {
+            return com_id_of(entries[lhs]) < com_id_of(entries[rhs]);
+        });
+    }
+    if (query.descending) {
+        std::reverse(page.rows.begin(), page.rows.end());
+    }
+
+    const auto begin = std::min(query.offset, page.rows.size());
+    const auto end = query.limit ? begin + std::min(*query.limit, page.rows.size() - begin) : page.rows.size();
+    page.rows.erase(page.rows.begin() + static_cast<std::ptrdiff_t>(end), page.rows.end());
+    page.rows.erase(page.rows.begin(), page.rows.begin() + static_cast<std::ptrdiff_t>(begin));
+    append_page(pages, list, page, begin);
+    return page;
+}
+
+std::int64_t unix_seconds(std::filesystem::file_time_type time)
+{
+    using namespace std::chrono;
+    const auto system = system_clock::now() + duration_cast<system_clock::duration>(time - decltype(time)::clock::now());
+    return duration_cast<seconds>(system.time_since_epoch()).count();
+}
+
+void write_pages(std::ostringstream &stream, const WebApplication::ListQuery &query, const std::ostringstream &pages)
+{
+    if (query.paged) {
+        stream << ",\"pages\":{" << pages.str() << '}';
+    }
+}
 }
 
 WebApplication::HttpResponse WebApplication::make_error_response(int status, const std::string &message)
@@ -258,7 +375,9 @@ void WebApplication::run()
         throw std::runtime_error("Failed to listen on socket: " + std::string(std::strerror(err)));
     }
 
+    thread_monitor_.start();
     accept_loop();
+    thread_monitor_.stop();
 }
 
 void WebApplication::accept_loop()
@@ -289,102 +408,122 @@ void WebApplication::accept_loop()
 
 void WebApplication::handle_client(int client_fd)
 {
-    std::string request;
-    char buffer[4096];
-    ssize_t bytes_read = 0;
-    size_t header_end = std::string::npos;
-    size_t expected_length = 0;
-
-    while (true) {
-        bytes_read = ::recv(client_fd, buffer, sizeof(buffer), 0);
+    HttpRequestParser parser(kMaxInMemoryBodySize, kMaxRequestBodySize, config_store_.spool_directory());
+    char buffer[16384];
+    bool received = false;
+    while (parser.state() == HttpRequestParser::State::Headers || parser.state() == HttpRequestParser::State::Body) {
+        const ssize_t bytes_read = ::recv(client_fd, buffer, sizeof(buffer), 0);
         if (bytes_read <= 0) {
             break;
         }
-        request.append(buffer, static_cast<std::size_t>(bytes_read));
-        if (header_end == std::string::npos) {
-            header_end = request.find("\r\n\r\n");
-            if (header_end != std::string::npos) {
-                std::string header_part = request.substr(0, header_end);
-                std::istringstream header_stream(header_part);
-                std::string line;
-                while (std::getline(header_stream, line)) {
-                    if (!line.empty() && line.back() == '\r') {
-                        line.pop_back();
-                    }
-                    std::string key, value;
-                    auto colon_pos = line.find(':');
-                    if (colon_pos == std::string::npos) {
-                        continue;
-                    }
-                    key = line.substr(0, colon_pos);
-                    value = line.substr(colon_pos + 1);
-                    while (!value.empty() && value.front() == ' ') {
-                        value.erase(value.begin());
-                    }
-                    if (key == "Content-Length") {
-                        try {
-                            expected_length = static_cast<std::size_t>(std::stoul(value));
-                        } catch (...) {
-                            expected_length = 0;
-                        }
-                    }
-                }
-                expected_length += header_end + 4;
-            }
-        }
-        if (header_end != std::string::npos && request.size() >= expected_length) {
-            break;
-        }
+        received = true;
+        parser.feed(buffer, static_cast<std::size_t>(bytes_read));
     }
 
-    if (request.empty()) {
+    if (!received) {
         return;
     }
 
-    std::istringstream request_stream(request);
-    std::string request_line;
-    std::getline(request_stream, request_line);
-    if (!request_line.empty() && request_line.back() == '\r') {
-        request_line.pop_back();
-    }
-
-    std::istringstream line_stream(request_line);
-    std::string method;
-    std::string target;
-    std::string http_version;
-    line_stream >> method >> target >> http_version;
-
-    std::string body;
-    if (header_end != std::string::npos) {
-        body = request.substr(header_end + 4);
+    HttpResponse response;
+    if (parser.state() == HttpRequestParser::State::Error) {
+        response = make_error_response(parser.error_status(), parser.error_message());
+    } else if (parser.state() != HttpRequestParser::State::Complete) {
+        response = make_error_response(400, "Incomplete request");
+    } else {
+        try {
+            response = handle_request(parser.request());
+        } catch (const std::exception &ex) {
+            response = make_error_response(500, ex.what());
+        }
     }
-
-    HttpResponse response = handle_request(method, target, body);
     if (response.status_message.empty()) {
         response.status_message = status_message_for(response.status_code);
     }
 
+    const std::string_view body = response.static_body.empty() ? response.body : response.static_body;
     std::ostringstream response_stream;
     response_stream << "HTTP/1.1 " << response.status_code << ' ' << response.status_message << "\r\n";
     response_stream << "Connection: close\r\n";
-    response_stream << "Content-Type: " << response.content_type << "\r\n";
-    response_stream << "Content-Length: " << response.body.size() << "\r\n\r\n";
-    response_stream << response.body;
+    if (!response.content_type.empty()) {
+        response_stream << "Content-Type: " << response.content_type << "\r\n";
+    }
+    for (const auto &header : response.headers) {
+        response_stream << header.first << ": " << header.second << "\r\n";
+    }
+    // A 304 has no body, and a Content-Length there would have to be that of the full representation.
+    if (response.status_code != 304) {
+        response_stream << "Content-Length: " << body.size() << "\r\n";
+    }
+    response_stream << "\r\n";
+    const auto head = response_stream.str();
+
+    // The head and the body go out in one gather write, so an embedded asset is sent straight from read-only
+    // memory without being copied into the response text.
+    std::array<iovec, 2> parts{{{const_cast<char *>(head.data()), head.size()},
+                                {const_cast<char *>(body.data()), body.size()}}};
+    std::size_t first = 0;
+    while (first < parts.size()) {
+        msghdr message{};
+        message.msg_iov = parts.data() + first;
+        message.msg_iovlen = parts.size() - first;
+        const ssize_t sent = ::sendmsg(client_fd, &message, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return;
+        }
+        auto remaining = static_cast<std::size_t>(sent);
+        while (first < parts.size() && remaining >= parts[first].iov_len) {
+            remaining -= parts[first].iov_len;
+            ++first;
+        }
+        if (first < parts.size()) {
+            parts[first].iov_base = static_cast<char *>(parts[first].iov_base) + remaining;
+            parts[first].iov_len -= remaining;
+        }
+    }
+}
 
-    auto response_text = response_stream.str();
-    ::send(client_fd, response_text.c_str(), response_text.size(), 0);
+WebApplication::HttpResponse WebApplication::handle_static_asset(const WebAsset &asset, const HttpRequest &request)
+{
+    const auto &representation = select_web_asset_representation(asset, request.header("Accept-Encoding"));
+    HttpResponse response{200, "OK", std::string(asset.contentType), std::string()};
+    response.headers.emplace_back("ETag", std::string(representation.etag));
+    // Browsers revalidate on every load and get a 304 while the file is unchanged.
+    response.headers.emplace_back("Cache-Control", "no-cache");
+    response.headers.emplace_back("Vary", "Accept-Encoding");
+    if (etag_matches(request.header("If-None-Match"), representation.etag)) {
+        response.status_code = 304;
+        response.status_message = "Not Modified";
+        response.content_type.clear();
+        return response;
+    }
+    if (!representation.contentEncoding.empty()) {
+        response.headers.emplace_back("Content-Encoding", std::string(representation.contentEncoding));
+    }
+    response.static_body = representation.data;
+    return response;
 }
 
-WebApplication::HttpResponse WebApplication::handle_request(const std::string &method,
-                                                            const std::string &target,
-                                                            const std::string &body)
+WebApplication::HttpResponse WebApplication::handle_request(HttpRequest &request)
 {
+    const std::string &method = request.method;
+    const std::string &target = request.target;
     auto query_pos = target.find('?');
     std::string path = target.substr(0, query_pos);
     std::string query = query_pos == std::string::npos ? std::string() : target.substr(query_pos + 1);
 
-    if (path == "/") {
-        return {200, "OK", "text/html; charset=utf-8", main_page_html()};
+    // Configurations posted as raw XML are parsed and stored straight from the spool file; every other body is
+    // a small form and is read into memory.
+    const bool raw_xml = is_xml_body(request) && (path == "/api/config/parse" || path == "/api/config/save");
+    if (!raw_xml) {
+        request.load_body();
+    }
+    const std::string &body = request.body;
+
+    if (const auto *asset = find_web_asset(path)) {
+        return handle_static_asset(*asset, request);
     }
 
     if (path == "/api/status") {
@@ -392,26 +531,52 @@ WebApplication::HttpResponse WebApplication::handle_request(const std::string &m
     }
 
     if (path == "/api/metrics") {
-        return respond_json(200, build_metrics_json());
+        try {
+            const auto list_query = parse_list_query(query);
+            return respond_json(200, build_metrics_json(list_query));
+        } catch (const std::exception &ex) {
+            return respond_json(400, "{\"error\":\"" + json_escape(ex.what()) + "\"}");
+        }
+    }
+
+    if (path == "/api/debug/allocations") {
+        return respond_json(200, build_allocations_json());
+    }
+
+    if (path == "/api/debug/threads") {
+        return respond_json(200, build_threads_json());
     }
 
     if (path == "/api/configs" || path == "/api/config/list") {
-        return handle_list_configs();
+        return handle_list_configs(query);
     }
 
     if (path == "/api/config/parse" && method == "POST") {
-        auto params = parse_form_urlencoded(body);
-        auto xml_it = params.find("xml");
-        if (xml_it == params.end() || xml_it->second.empty()) {
-            return respond_json(400, "{\"error\":\"Missing xml parameter\"}");
-        }
+        std::string name;
+        SimulatorConfig config;
         try {
-            auto config = load_configuration_from_string(xml_it->second);
+            if (raw_xml) {
+                if (request.contentLength == 0) {
+                    return respond_json(400, "{\"error\":\"Missing XML body\"}");
+                }
+                name = extract_parameter(query, "name");
+                config = load_request_configuration(request);
+            } else {
+                auto params = parse_form_urlencoded(body);
+                auto xml_it = params.find("xml");
+                if (xml_it == params.end() || xml_it->second.empty()) {
+                    return respond_json(400, "{\"error\":\"Missing xml parameter\"}");
+                }
+                config = load_configuration_from_string(xml_it->second);
+                auto name_it = params.find("name");
+                if (name_it != params.end()) {
+                    name = name_it->second;
+                }
+            }
             std::ostringstream stream;
-            stream << "{\"summary\":" << build_config_summary_json(config);
-            auto name_it = params.find("name");
-            if (name_it != params.end()) {
-                stream << ",\"suggestedName\":\"" << json_escape(name_it->second) << "\"";
+            stream << "{\"summary\":" << build_config_summary_json(config, ListQuery{});
+            if (!name.empty()) {
+                stream << ",\"suggestedName\":\"" << json_escape(name) << "\"";
             }
             stream << "}";
             return respond_json(200, stream.str());
@@ -421,7 +586,13 @@ WebApplication::HttpResponse WebApplication::handle_request(const std::string &m
     }
 
     if (path == "/api/config/save" && method == "POST") {
-        return handle_save_config(body);
+        return raw_xml ? handle_save_config_file(request, extract_parameter(query, "name"), extract_parameter(query, "label"))
+                       : handle_save_config(body);
+    }
+
+    if (path == "/api/config/history" || path == "/api/config/version" || path == "/api/config/diff" ||
+        (path == "/api/config/revert" && method == "POST")) {
+        return handle_config_history(path, query, body);
     }
 
     if (path == "/api/config/details") {
@@ -429,7 +600,12 @@ WebApplication::HttpResponse WebApplication::handle_request(const std::string &m
     }
 
     if (path == "/api/simulator/payloads") {
-        return respond_json(200, build_payloads_json());
+        try {
+            const auto list_query = parse_list_query(query);
+            return respond_json(200, build_payloads_json(list_query));
+        } catch (const std::exception &ex) {
+            return respond_json(400, "{\"error\":\"" + json_escape(ex.what()) + "\"}");
+        }
     }
 
     if (path == "/api/simulator/payload" && method == "POST") {
@@ -471,6 +647,69 @@ WebApplication::HttpResponse WebApplication::handle_request(const std::string &m
         }
     }
 
+    if (path == "/api/simulator/failover" && method == "POST") {
+        auto params = parse_form_urlencoded(body);
+        const auto group_it = params.find("group");
+        if (group_it == params.end() || group_it->second.empty()) {
+            return respond_json(400, "{\"error\":\"Missing group parameter\"}");
+        }
+
+        std::uint32_t group_id = 0;
+        try {
+            group_id = static_cast<std::uint32_t>(std::stoul(group_it->second));
+        } catch (const std::exception &) {
+            return respond_json(400, "{\"error\":\"Invalid group parameter\"}");
+        }
+
+        std::shared_ptr<Simulator> simulator;
+        {
+            std::lock_guard<std::mutex> lock(simulator_mutex_);
+            simulator = active_simulator_;
+        }
+        if (!simulator) {
+            return respond_json(409, "{\"error\":\"Simulator is not running\"}");
+        }
+
+        std::string error;
+        if (!simulator->trigger_pd_failover(group_id, error)) {
+            return respond_json(409, "{\"error\":\"" + json_escape(error) + "\"}");
+        }
+        return respond_json(200, "{\"message\":\"Failover triggered\"}");
+    }
+
+    if (path == "/api/simulator/topology" && method == "POST") {
+        auto params = parse_form_urlencoded(body);
+        const auto etb_it = params.find("etbTopoCount");
+        const auto op_trn_it = params.find("opTrnTopoCount");
+        if (etb_it == params.end() || op_trn_it == params.end()) {
+            return respond_json(400, "{\"error\":\"Missing required parameters\"}");
+        }
+
+        std::uint32_t etb_topo_count = 0;
+        std::uint32_t op_trn_topo_count = 0;
+        try {
+            etb_topo_count = static_cast<std::uint32_t>(std::stoul(etb_it->second, nullptr, 0));
+            op_trn_topo_count = static_cast<std::uint32_t>(std::stoul(op_trn_it->second, nullptr, 0));
+        } catch (const std::exception &) {
+            return respond_json(400, "{\"error\":\"Invalid topology counter\"}");
+        }
+
+        std::shared_ptr<Simulator> simulator;
+        {
+            std::lock_guard<std::mutex> lock(simulator_mutex_);
+            simulator = active_simulator_;
+        }
+        if (!simulator) {
+            return respond_json(409, "{\"error\":\"Simulator is not running\"}");
+        }
+
+        std::string error;
+        if (!simulator->set_topology(etb_topo_count, op_trn_topo_count, error)) {
+            return respond_json(409, "{\"error\":\"" + json_escape(error) + "\"}");
+        }
+        return respond_json(200, "{\"message\":\"Topology updated\"}");
+    }
+
     if (path == "/api/config" && method == "GET") {
         return handle_get_config(method, query, body);
     }
@@ -524,18 +763,28 @@ WebApplication::HttpResponse WebApplication::handle_request(const std::string &m
     return respond_json(404, "{\"error\":\"Not found\"}");
 }
 
-WebApplication::HttpResponse WebApplication::handle_list_configs()
+WebApplication::HttpResponse WebApplication::handle_list_configs(const std::string &query)
 {
     std::ostringstream stream;
     stream << "{\"configs\":[";
-    auto configs = config_store_.list();
+    const auto configs = config_store_.catalog().entries(extract_parameter(query, "filter"));
     for (std::size_t i = 0; i < configs.size(); ++i) {
+        const auto &entry = configs[i];
         if (i != 0) {
             stream << ',';
         }
-        stream << "{\"name\":\"" << json_escape(configs[i]) << "\"}";
+        stream << "{\"name\":\"" << json_escape(entry.name) << "\",\"size\":" << entry.size
+               << ",\"modified\":" << unix_seconds(entry.modified) << ",\"status\":\"" << to_string(entry.status)
+               << '"';
+        if (entry.status == ConfigCatalogEntry::Status::Valid) {
+            stream << ",\"pdPublishers\":" << entry.pdPublishers << ",\"pdSubscribers\":" << entry.pdSubscribers
+                   << ",\"mdSenders\":" << entry.mdSenders << ",\"mdListeners\":" << entry.mdListeners;
+        } else if (entry.status == ConfigCatalogEntry::Status::Invalid) {
+            stream << ",\"error\":\"" << json_escape(entry.error) << '"';
+        }
+        stream << '}';
     }
-    stream << "]}";
+    stream << "],\"watching\":" << (config_store_.catalog().watching() ? "true" : "false") << '}';
     return respond_json(200, stream.str());
 }
 
@@ -558,13 +807,24 @@ WebApplication::HttpResponse WebApplication::handle_get_config(const std::string
     if (!ConfigStore::is_valid_name(name)) {
         return respond_json(400, "{\"error\":\"Invalid configuration name\"}");
     }
+    ListQuery list_query;
+    try {
+        list_query = parse_list_query(query);
+    } catch (const std::exception &ex) {
+        return respond_json(400, "{\"error\":\"" + json_escape(ex.what()) + "\"}");
+    }
 
     try {
         auto xml = config_store_.load_xml(name);
         auto config = load_configuration_from_string(xml);
         std::ostringstream stream;
         stream << "{\"name\":\"" << json_escape(name) << "\",\"summary\":"
-               << build_config_summary_json(config) << ",\"xml\":\"" << json_escape(xml) << "\"}";
+               << build_config_summary_json(config, list_query);
+        // A paged view is for browsing the telegrams; the document itself is only sent with the full summary.
+        if (!list_query.paged) {
+            stream << ",\"xml\":\"" << json_escape(xml) << "\"";
+        }
+        stream << "}";
         return respond_json(200, stream.str());
     } catch (const std::exception &ex) {
         return respond_json(404, "{\"error\":\"" + json_escape(ex.what()) + "\"}");
@@ -587,15 +847,125 @@ WebApplication::HttpResponse WebApplication::handle_save_config(const std::strin
     if (!ConfigStore::is_valid_name(name)) {
         return respond_json(400, "{\"error\":\"Invalid configuration name\"}");
     }
+    if (xml_it->second.size() > kMaxConfigFileSize) {
+        return respond_json(400, "{\"error\":\"Configuration exceeds size limit (512 KB)\"}");
+    }
 
     try {
         auto config = load_configuration_from_string(xml_it->second);
         (void)config;
         bool replaced = config_store_.exists(name);
-        config_store_.save(name, xml_it->second);
+        const auto label_it = params.find("label");
+        const auto version =
+            config_store_.save(name, xml_it->second, label_it == params.end() ? std::string() : label_it->second);
         std::ostringstream stream;
         stream << "{\"message\":\"Configuration saved\",\"name\":\"" << json_escape(name)
-               << "\",\"replaced\":" << (replaced ? "true" : "false") << "}";
+               << "\",\"replaced\":" << (replaced ? "true" : "false") << ",\"version\":" << version.number << "}";
+        return respond_json(200, stream.str());
+    } catch (const std::exception &ex) {
+        return respond_json(400, "{\"error\":\"" + json_escape(ex.what()) + "\"}");
+    }
+}
+
+WebApplication::HttpResponse WebApplication::handle_save_config_file(HttpRequest &request, const std::string &name,
+                                                                     const std::string &label)
+{
+    if (name.empty()) {
+        return respond_json(400, "{\"error\":\"Missing name parameter\"}");
+    }
+    if (!ConfigStore::is_valid_name(name)) {
+        return respond_json(400, "{\"error\":\"Invalid configuration name\"}");
+    }
+    if (request.contentLength == 0) {
+        return respond_json(400, "{\"error\":\"Missing XML body\"}");
+    }
+    // Same limit as every other way of storing a configuration; only the transfer is streamed.
+    if (request.contentLength > kMaxConfigFileSize) {
+        return respond_json(400, "{\"error\":\"Configuration exceeds size limit (512 KB)\"}");
+    }
+
+    try {
+        load_request_configuration(request);
+        bool replaced = config_store_.exists(name);
+        const auto version = request.bodyFile.empty() ? config_store_.save(name, request.body, label)
+                                                      : config_store_.save_file(name, request.bodyFile, label);
+        std::ostringstream stream;
+        stream << "{\"message\":\"Configuration saved\",\"name\":\"" << json_escape(name)
+               << "\",\"replaced\":" << (replaced ? "true" : "false") << ",\"version\":" << version.number << "}";
+        return respond_json(200, stream.str());
+    } catch (const std::exception &ex) {
+        return respond_json(400, "{\"error\":\"" + json_escape(ex.what()) + "\"}");
+    }
+}
+
+WebApplication::HttpResponse WebApplication::handle_config_history(const std::string &path, const std::string &query,
+                                                                   const std::string &body)
+{
+    auto params = parse_form_urlencoded(body);
+    const auto parameter = [&](const char *key) {
+        auto value = extract_parameter(query, key);
+        if (value.empty()) {
+            const auto it = params.find(key);
+            if (it != params.end()) {
+                value = it->second;
+            }
+        }
+        return value;
+    };
+    const auto version_number = [&](const char *key) {
+        const auto value = parameter(key);
+        if (value.empty() || value.size() > 9U ||
+            !std::all_of(value.begin(), value.end(), [](unsigned char c) { return std::isdigit(c); })) {
+            throw std::runtime_error(std::string("Invalid ") + key + " parameter");
+        }
+        return static_cast<std::uint32_t>(std::stoul(value));
+    };
+
+    const auto name = parameter("name");
+    if (name.empty()) {
+        return respond_json(400, "{\"error\":\"Missing name parameter\"}");
+    }
+    if (!ConfigStore::is_valid_name(name)) {
+        return respond_json(400, "{\"error\":\"Invalid configuration name\"}");
+    }
+
+    try {
+        std::ostringstream stream;
+        if (path == "/api/config/history") {
+            stream << "{\"name\":\"" << json_escape(name) << "\",\"versions\":[";
+            const auto versions = config_store_.versions(name);
+            for (std::size_t i = 0; i < versions.size(); ++i) {
+                const auto &version = versions[i];
+                stream << (i == 0 ? "" : ",") << "{\"version\":" << version.number << ",\"created\":" << version.created
+                       << ",\"size\":" << version.size << ",\"sha256\":\"" << version.digest << "\",\"label\":\""
+                       << json_escape(version.label) << "\",\"chunks\":" << version.chunks.size() << '}';
+            }
+            stream << "]}";
+        } else if (path == "/api/config/version") {
+            const auto number = version_number("version");
+            stream << "{\"name\":\"" << json_escape(name) << "\",\"version\":" << number << ",\"xml\":\""
+                   << json_escape(config_store_.load_version(name, number)) << "\"}";
+        } else if (path == "/api/config/diff") {
+            // Without from/to the latest version is compared with the one before it.
+            std::uint32_t to = 0;
+            if (parameter("to").empty()) {
+                const auto versions = config_store_.versions(name);
+                if (versions.empty()) {
+                    return respond_json(404, "{\"error\":\"Configuration has no history\"}");
+                }
+                to = versions.back().number;
+            } else {
+                to = version_number("to");
+            }
+            const auto from = parameter("from").empty() ? (to > 1U ? to - 1U : to) : version_number("from");
+            stream << "{\"name\":\"" << json_escape(name) << "\",\"from\":" << from << ",\"to\":" << to
+                   << ",\"diff\":\"" << json_escape(config_store_.diff(name, from, to)) << "\"}";
+        } else {
+            const auto number = version_number("version");
+            const auto version = config_store_.restore(name, number);
+            stream << "{\"message\":\"Configuration restored\",\"name\":\"" << json_escape(name)
+                   << "\",\"restored\":" << number << ",\"version\":" << version.number << '}';
+        }
         return respond_json(200, stream.str());
     } catch (const std::exception &ex) {
         return respond_json(400, "{\"error\":\"" + json_escape(ex.what()) + "\"}");
@@ -734,15 +1104,17 @@ std::string WebApplication::build_status_json() const
     return stream.str();
 }
 
-std::string WebApplication::build_metrics_json() const
+std::string WebApplication::build_metrics_json(const ListQuery &query) const
 {
     RuntimeMetrics::Snapshot snapshot;
     bool have_snapshot = false;
 
     std::shared_ptr<Simulator> simulator;
+    std::shared_ptr<const TelegramComIds> com_ids;
     {
         std::lock_guard<std::mutex> lock(simulator_mutex_);
         simulator = active_simulator_;
+        com_ids = telegram_com_ids_;
         if (!simulator && has_metrics_snapshot_) {
             snapshot = last_metrics_snapshot_;
             have_snapshot = true;
@@ -761,62 +1133,243 @@ std::string WebApplication::build_metrics_json() const
         snapshot = RuntimeMetrics::Snapshot{};
     }
 
+    static const TelegramComIds no_com_ids;
+    const auto &known_com_ids = com_ids ? *com_ids : no_com_ids;
+    const auto name_of = [](const auto &entry) -> const std::string & { return entry.name; };
+    const auto com_id_in = [](const std::unordered_map<std::string, std::uint32_t> &ids) {
+        return [&ids](const auto &entry) {
+            const auto it = ids.find(entry.name);
+            return it == ids.end() ? 0U : it->second;
+        };
+    };
+
     std::ostringstream stream;
+    std::ostringstream pages;
     stream << "{";
     stream << "\"running\":" << (snapshot.simulatorRunning ? "true" : "false");
     stream << ",\"adapterInitialized\":" << (snapshot.adapterInitialized ? "true" : "false");
     stream << ",\"adapterState\":\"" << json_escape(snapshot.adapterState) << "\"";
 
+    auto serialize_histogram = [](const LatencyHistogram &histogram) {
+        std::ostringstream s;
+        s << "{\"count\":" << histogram.count() << ",\"minUs\":" << histogram.min_us()
+          << ",\"maxUs\":" << histogram.max_us();
+        if (histogram.count() != 0) {
+            s << ",\"avgUs\":" << histogram.sum_us() / static_cast<std::int64_t>(histogram.count())
+              << ",\"p50Us\":" << histogram.percentile_us(50.0) << ",\"p99Us\":" << histogram.percentile_us(99.0);
+        }
+        s << ",\"buckets\":[";
+        bool first = true;
+        const auto &buckets = histogram.buckets();
+        for (std::size_t index = 0; index < buckets.size(); ++index) {
+            if (buckets[index] == 0) {
+                continue;
+            }
+            if (!first) {
+                s << ',';
+            }
+            first = false;
+            s << "{\"leUs\":" << LatencyHistogram::bucket_upper_bound_us(index) << ",\"count\":" << buckets[index]
+              << "}";
+        }
+        s << "]}";
+        return s.str();
+    };
+
+    const auto pdPublishersComId = com_id_in(known_com_ids.pdPublishers);
+    const auto pdPublishersPage = select_rows(query, "pdPublishers", snapshot.pdPublishers, name_of, pdPublishersComId, pages);
     stream << ",\"pdPublishers\":[";
-    for (std::size_t i = 0; i < snapshot.pdPublishers.size(); ++i) {
+    for (std::size_t i = 0; i < pdPublishersPage.rows.size(); ++i) {
         if (i != 0) {
             stream << ',';
         }
-        const auto &stats = snapshot.pdPublishers[i];
-        stream << "{\"name\":\"" << json_escape(stats.name) << "\",\"packetsSent\":" << stats.packetsSent << "}";
+        const auto &stats = snapshot.pdPublishers[pdPublishersPage.rows[i]];
+        stream << "{\"name\":\"" << json_escape(stats.name) << "\",\"comId\":" << pdPublishersComId(stats)
+               << ",\"packetsSent\":" << stats.packetsSent
+               << ",\"onChangeSends\":" << stats.onChangeSends << ",\"keepAliveSends\":" << stats.keepAliveSends;
+        if (stats.onChangeSends != 0) {
+            stream << ",\"avgLatencySavedUs\":"
+                   << stats.latencySavedUs / static_cast<std::int64_t>(stats.onChangeSends);
+        }
+        if (stats.tsnLaunchError.count() != 0 || stats.tsnLateHandoffs != 0 || stats.tsnMissedLaunches != 0) {
+            stream << ",\"tsnLateHandoffs\":" << stats.tsnLateHandoffs
+                   << ",\"tsnMissedLaunches\":" << stats.tsnMissedLaunches
+                   << ",\"tsnLaunchError\":" << serialize_histogram(stats.tsnLaunchError);
+        }
+        stream << "}";
     }
     stream << "]";
 
+    const auto pdSubscribersComId = com_id_in(known_com_ids.pdSubscribers);
+    const auto pdSubscribersPage = select_rows(query, "pdSubscribers", snapshot.pdSubscribers, name_of, pdSubscribersComId, pages);
     stream << ",\"pdSubscribers\":[";
-    for (std::size_t i = 0; i < snapshot.pdSubscribers.size(); ++i) {
+    for (std::size_t i = 0; i < pdSubscribersPage.rows.size(); ++i) {
+        if (i != 0) {
+            stream << ',';
+        }
+        const auto &stats = snapshot.pdSubscribers[pdSubscribersPage.rows[i]];
+        stream << "{\"name\":\"" << json_escape(stats.name) << "\",\"comId\":" << pdSubscribersComId(stats)
+               << ",\"packetsReceived\":" << stats.packetsReceived;
+        if (stats.pullRequestsSent != 0) {
+            stream << ",\"pullRequestsSent\":" << stats.pullRequestsSent
+                   << ",\"pullRepliesReceived\":" << stats.pullRepliesReceived
+                   << ",\"pullRequestsLost\":" << stats.pullRequestsLost
+                   << ",\"pullLatency\":" << serialize_histogram(stats.pullLatency);
+        }
+        if (stats.switchoverGap.count() != 0) {
+            stream << ",\"switchoversOverCycle\":" << stats.switchoversOverCycle
+                   << ",\"switchoverGap\":" << serialize_histogram(stats.switchoverGap);
+        }
+        stream << "}";
+    }
+    stream << "]";
+
+    stream << ",\"pdRedundancyGroups\":[";
+    for (std::size_t i = 0; i < snapshot.pdRedundancyGroups.size(); ++i) {
         if (i != 0) {
             stream << ',';
         }
-        const auto &stats = snapshot.pdSubscribers[i];
-        stream << "{\"name\":\"" << json_escape(stats.name) << "\",\"packetsReceived\":" << stats.packetsReceived
-               << "}";
+        const auto &stats = snapshot.pdRedundancyGroups[i];
+        stream << "{\"id\":" << stats.id << ",\"leader\":" << (stats.leader ? "true" : "false")
+               << ",\"failovers\":" << stats.failovers << "}";
     }
     stream << "]";
 
+    const auto &topology = snapshot.topology;
+    stream << ",\"topology\":{\"etbTopoCount\":" << topology.etbTopoCount
+           << ",\"opTrnTopoCount\":" << topology.opTrnTopoCount << ",\"updates\":" << topology.updates
+           << ",\"telegramsUpdated\":" << topology.telegramsUpdated
+           << ",\"staleOverCycle\":" << topology.staleOverCycle
+           << ",\"staleWindow\":" << serialize_histogram(topology.staleWindow) << "}";
+
+    const auto mdSendersComId = com_id_in(known_com_ids.mdSenders);
+    const auto mdSendersPage = select_rows(query, "mdSenders", snapshot.mdSenders, name_of, mdSendersComId, pages);
     stream << ",\"mdSenders\":[";
-    for (std::size_t i = 0; i < snapshot.mdSenders.size(); ++i) {
+    for (std::size_t i = 0; i < mdSendersPage.rows.size(); ++i) {
         if (i != 0) {
             stream << ',';
         }
-        const auto &stats = snapshot.mdSenders[i];
-        stream << "{\"name\":\"" << json_escape(stats.name) << "\",\"requestsSent\":" << stats.requestsSent
-               << ",\"repliesReceived\":" << stats.repliesReceived << "}";
+        const auto &stats = snapshot.mdSenders[mdSendersPage.rows[i]];
+        stream << "{\"name\":\"" << json_escape(stats.name) << "\",\"comId\":" << mdSendersComId(stats)
+               << ",\"requestsSent\":" << stats.requestsSent
+               << ",\"repliesReceived\":" << stats.repliesReceived
+               << ",\"notificationsSent\":" << stats.notificationsSent
+               << ",\"replyQueriesReceived\":" << stats.replyQueriesReceived
+               << ",\"confirmsSent\":" << stats.confirmsSent
+               << ",\"replyTimeouts\":" << stats.replyTimeouts << "}";
     }
     stream << "]";
 
+    const auto mdListenersComId = com_id_in(known_com_ids.mdListeners);
+    const auto mdListenersPage = select_rows(query, "mdListeners", snapshot.mdListeners, name_of, mdListenersComId, pages);
     stream << ",\"mdListeners\":[";
-    for (std::size_t i = 0; i < snapshot.mdListeners.size(); ++i) {
+    for (std::size_t i = 0; i < mdListenersPage.rows.size(); ++i) {
+        if (i != 0) {
+            stream << ',';
+        }
+        const auto &stats = snapshot.mdListeners[mdListenersPage.rows[i]];
+        stream << "{\"name\":\"" << json_escape(stats.name) << "\",\"comId\":" << mdListenersComId(stats)
+               << ",\"requestsReceived\":" << stats.requestsReceived
+               << ",\"repliesSent\":" << stats.repliesSent
+               << ",\"notificationsReceived\":" << stats.notificationsReceived
+               << ",\"replyQueriesSent\":" << stats.replyQueriesSent
+               << ",\"confirmsReceived\":" << stats.confirmsReceived << "}";
+    }
+    stream << "]";
+
+    stream << ",\"mdTcpPeers\":[";
+    for (std::size_t i = 0; i < snapshot.mdTcpPeers.size(); ++i) {
+        if (i != 0) {
+            stream << ',';
+        }
+        const auto &stats = snapshot.mdTcpPeers[i];
+        const auto reused = stats.exchanges > stats.connects ? stats.exchanges - stats.connects : 0U;
+        stream << "{\"peer\":\"" << json_escape(stats.peer) << "\",\"exchanges\":" << stats.exchanges
+               << ",\"connects\":" << stats.connects << ",\"reused\":" << reused
+               << ",\"openConnections\":" << stats.openConnections << "}";
+    }
+    stream << "]";
+
+    // Each MD type is sent by one side and received by the other, so per-type totals combine both lists.
+    struct MdTypeTotals {
+        const char *type;
+        std::uint64_t sent;
+        std::uint64_t received;
+    };
+    std::array<MdTypeTotals, 5> mdTypes{{{"Mn", 0, 0}, {"Mr", 0, 0}, {"Mp", 0, 0}, {"Mq", 0, 0}, {"Mc", 0, 0}}};
+    for (const auto &stats : snapshot.mdSenders) {
+        mdTypes[0].sent += stats.notificationsSent;
+        mdTypes[1].sent += stats.requestsSent;
+        mdTypes[2].received += stats.repliesReceived;
+        mdTypes[3].received += stats.replyQueriesReceived;
+        mdTypes[4].sent += stats.confirmsSent;
+    }
+    for (const auto &stats : snapshot.mdListeners) {
+        mdTypes[0].received += stats.notificationsReceived;
+        mdTypes[1].received += stats.requestsReceived;
+        mdTypes[2].sent += stats.repliesSent;
+        mdTypes[3].sent += stats.replyQueriesSent;
+        mdTypes[4].received += stats.confirmsReceived;
+    }
+    const double uptimeSeconds = static_cast<double>(snapshot.uptimeMs) / 1000.0;
+    auto per_second = [uptimeSeconds](std::uint64_t count) {
+        return uptimeSeconds > 0.0 ? static_cast<double>(count) / uptimeSeconds : 0.0;
+    };
+    stream << ",\"uptimeMs\":" << snapshot.uptimeMs;
+    stream << ",\"mdMessageTypes\":[";
+    for (std::size_t i = 0; i < mdTypes.size(); ++i) {
         if (i != 0) {
             stream << ',';
         }
-        const auto &stats = snapshot.mdListeners[i];
-        stream << "{\"name\":\"" << json_escape(stats.name) << "\",\"requestsReceived\":" << stats.requestsReceived
-               << ",\"repliesSent\":" << stats.repliesSent << "}";
+        const auto &totals = mdTypes[i];
+        stream << "{\"type\":\"" << totals.type << "\",\"sent\":" << totals.sent << ",\"received\":" << totals.received
+               << ",\"sentPerSecond\":" << per_second(totals.sent)
+               << ",\"receivedPerSecond\":" << per_second(totals.received) << "}";
     }
     stream << "]";
 
+    const auto &sessions = snapshot.mdSessions;
+    stream << ",\"mdSessions\":{\"callerOpen\":" << sessions.callerOpen << ",\"callerPeak\":" << sessions.callerPeak
+           << ",\"callerTimeouts\":" << sessions.callerTimeouts << ",\"replierOpen\":" << sessions.replierOpen
+           << ",\"replierPeak\":" << sessions.replierPeak << ",\"replierTimeouts\":" << sessions.replierTimeouts
+           << "}";
+
+    const auto loopsPage = select_rows(
+        query, "loops", snapshot.loops, name_of, [](const auto &) { return 0U; }, pages);
+    stream << ",\"loops\":[";
+    for (std::size_t i = 0; i < loopsPage.rows.size(); ++i) {
+        if (i != 0) {
+            stream << ',';
+        }
+        const auto &stats = snapshot.loops[loopsPage.rows[i]];
+        stream << "{\"name\":\"" << json_escape(stats.name) << "\",\"lag\":" << serialize_histogram(stats.lag)
+               << ",\"stalls\":" << stats.stalls << ",\"lastStallTrace\":\"" << json_escape(stats.lastStallTrace)
+               << "\"}";
+    }
+    stream << "]";
+
+    stream << ",\"arena\":{\"phases\":[";
+    for (std::size_t i = 0; i < snapshot.arenaPhases.size(); ++i) {
+        if (i != 0) {
+            stream << ',';
+        }
+        stream << "{\"phase\":\"" << RunArena::phase_name(static_cast<RunArena::Phase>(i))
+               << "\",\"allocations\":" << snapshot.arenaPhases[i].allocations
+               << ",\"bytes\":" << snapshot.arenaPhases[i].bytes << "}";
+    }
+    stream << "],\"bytesInUse\":" << snapshot.arenaBytesInUse << ",\"peakBytes\":" << snapshot.arenaPeakBytes << "}";
+
+    write_pages(stream, query, pages);
     stream << "}";
     return stream.str();
 }
 
-std::string WebApplication::build_config_summary_json(const SimulatorConfig &config) const
+std::string WebApplication::build_config_summary_json(const SimulatorConfig &config, const ListQuery &query) const
 {
     std::ostringstream stream;
+    std::ostringstream pages;
+    const auto name_of = [](const auto &entry) -> const std::string & { return entry.name; };
+    const auto com_id_of = [](const auto &entry) { return entry.comId; };
     stream << "{";
     stream << "\"network\":{\"interface\":\"" << json_escape(config.network.interfaceName) << "\"";
     if (!config.network.hostIp.empty()) {
@@ -832,6 +1385,33 @@ std::string WebApplication::build_config_summary_json(const SimulatorConfig &con
            << ",\"level\":\"" << json_escape(log_level_to_string(config.logging.level)) << "\"";
     if (!config.logging.filePath.empty()) {
         stream << ",\"file\":\"" << json_escape(config.logging.filePath) << "\"";
+        stream << ",\"rotateSizeMb\":" << config.logging.rotateSizeMb
+               << ",\"rotateIntervalMinutes\":" << config.logging.rotateIntervalMinutes
+               << ",\"keepFiles\":" << config.logging.keepFiles;
+    }
+    if (!config.logging.binaryFilePath.empty()) {
+        stream << ",\"binaryFile\":\"" << json_escape(config.logging.binaryFilePath)
+               << "\",\"binaryCapacityMb\":" << config.logging.binaryCapacityMb;
+    }
+    if (config.logging.rateLimit.messagesPerSecond != 0) {
+        stream << ",\"rateLimitPerSecond\":" << config.logging.rateLimit.messagesPerSecond
+               << ",\"rateLimitBurst\":" << config.logging.rateLimit.burst;
+    }
+    if (!config.logging.overrides.empty()) {
+        stream << ",\"overrides\":[";
+        for (std::size_t i = 0; i < config.logging.overrides.size(); ++i) {
+            const auto &entry = config.logging.overrides[i];
+            stream << (i == 0 ? "" : ",") << "{\"level\":\"" << json_escape(log_level_to_string(entry.level)) << "\"";
+            if (!entry.name.empty()) {
+                stream << ",\"name\":\"" << json_escape(entry.name) << "\"";
+            } else if (entry.comId != 0) {
+                stream << ",\"comId\":" << entry.comId;
+            } else {
+                stream << ",\"category\":\"" << json_escape(entry.category) << "\"";
+            }
+            stream << "}";
+        }
+        stream << "]";
     }
     stream << "}";
 
@@ -842,50 +1422,78 @@ std::string WebApplication::build_config_summary_json(const SimulatorConfig &con
         return s.str();
     };
 
+    const auto pdPublishersPage = select_rows(query, "pdPublishers", config.pdPublishers, name_of, com_id_of, pages);
     stream << ",\"pdPublishers\":[";
-    for (std::size_t i = 0; i < config.pdPublishers.size(); ++i) {
+    for (std::size_t i = 0; i < pdPublishersPage.rows.size(); ++i) {
         if (i != 0) {
             stream << ',';
         }
-        const auto &publisher = config.pdPublishers[i];
+        const auto &publisher = config.pdPublishers[pdPublishersPage.rows[i]];
         stream << "{\"name\":\"" << json_escape(publisher.name) << "\",\"comId\":" << publisher.comId
                << ",\"datasetId\":" << publisher.datasetId
-               << ",\"cycleTimeMs\":" << publisher.cycleTimeMs
-               << ",\"payload\":{" << serialize_payload(publisher.payload) << "}}";
+               << ",\"cycleTimeMs\":" << publisher.cycleTimeMs;
+        if (publisher.redundancyGroup != 0) {
+            stream << ",\"redundancyGroup\":" << publisher.redundancyGroup;
+        }
+        stream << ",\"role\":\"" << json_escape(pd_publisher_role_to_string(publisher.role)) << "\""
+               << ",\"mode\":\"" << json_escape(pd_send_mode_to_string(publisher.sendMode)) << "\"";
+        if (publisher.sendMode == PdPublisherConfig::SendMode::OnChange) {
+            stream << ",\"minIntervalMs\":" << publisher.minIntervalMs << ",\"keepAliveMs\":" << publisher.keepAliveMs;
+        } else if (publisher.sendMode == PdPublisherConfig::SendMode::Tsn) {
+            stream << ",\"launchClock\":\"" << json_escape(pd_launch_clock_to_string(publisher.launchClock)) << "\""
+                   << ",\"launchOffsetUs\":" << publisher.launchOffsetUs << ",\"launchLeadUs\":" << publisher.launchLeadUs;
+        }
+        stream << ",\"payload\":{" << serialize_payload(publisher.payload) << "}}";
     }
     stream << "]";
 
+    const auto pdSubscribersPage = select_rows(query, "pdSubscribers", config.pdSubscribers, name_of, com_id_of, pages);
     stream << ",\"pdSubscribers\":[";
-    for (std::size_t i = 0; i < config.pdSubscribers.size(); ++i) {
+    for (std::size_t i = 0; i < pdSubscribersPage.rows.size(); ++i) {
         if (i != 0) {
             stream << ',';
         }
-        const auto &subscriber = config.pdSubscribers[i];
+        const auto &subscriber = config.pdSubscribers[pdSubscribersPage.rows[i]];
         stream << "{\"name\":\"" << json_escape(subscriber.name) << "\",\"comId\":" << subscriber.comId
-               << ",\"timeoutMs\":" << subscriber.timeoutMs << "}";
+               << ",\"timeoutMs\":" << subscriber.timeoutMs
+               << ",\"role\":\"" << json_escape(pd_subscriber_role_to_string(subscriber.role)) << "\"";
+        if (subscriber.role == PdSubscriberConfig::Role::PullRequester) {
+            stream << ",\"requestComId\":" << subscriber.requestComId
+                   << ",\"pullIntervalMs\":" << subscriber.pullIntervalMs;
+        }
+        stream << "}";
     }
     stream << "]";
 
+    const auto mdSendersPage = select_rows(query, "mdSenders", config.mdSenders, name_of, com_id_of, pages);
     stream << ",\"mdSenders\":[";
-    for (std::size_t i = 0; i < config.mdSenders.size(); ++i) {
+    for (std::size_t i = 0; i < mdSendersPage.rows.size(); ++i) {
         if (i != 0) {
             stream << ',';
         }
-        const auto &sender = config.mdSenders[i];
+        const auto &sender = config.mdSenders[mdSendersPage.rows[i]];
         stream << "{\"name\":\"" << json_escape(sender.name) << "\",\"comId\":" << sender.comId
-               << ",\"cycleTimeMs\":" << sender.cycleTimeMs
+               << ",\"cycleTimeMs\":" << sender.cycleTimeMs << ",\"transport\":\""
+               << md_transport_to_string(sender.transport) << "\""
+               << ",\"type\":\"" << md_sender_type_to_string(sender.type) << "\""
                << ",\"payload\":{" << serialize_payload(sender.payload) << "}}";
     }
     stream << "]";
 
+    const auto mdListenersPage = select_rows(query, "mdListeners", config.mdListeners, name_of, com_id_of, pages);
     stream << ",\"mdListeners\":[";
-    for (std::size_t i = 0; i < config.mdListeners.size(); ++i) {
+    for (std::size_t i = 0; i < mdListenersPage.rows.size(); ++i) {
         if (i != 0) {
             stream << ',';
         }
-        const auto &listener = config.mdListeners[i];
+        const auto &listener = config.mdListeners[mdListenersPage.rows[i]];
         stream << "{\"name\":\"" << json_escape(listener.name) << "\",\"comId\":" << listener.comId
-               << ",\"autoReply\":" << (listener.autoReply ? "true" : "false");
+               << ",\"transport\":\"" << md_transport_to_string(listener.transport) << "\""
+               << ",\"autoReply\":" << (listener.autoReply ? "true" : "false")
+               << ",\"replyType\":\"" << md_reply_type_to_string(listener.replyType) << "\"";
+        if (listener.replyType == MdListenerConfig::ReplyType::Query) {
+            stream << ",\"confirmTimeoutMs\":" << listener.confirmTimeoutMs;
+        }
         if (!listener.replyPayload.value.empty()) {
             stream << ",\"replyPayload\":{" << serialize_payload(listener.replyPayload) << "}";
         }
@@ -893,11 +1501,68 @@ std::string WebApplication::build_config_summary_json(const SimulatorConfig &con
     }
     stream << "]";
 
+    write_pages(stream, query, pages);
     stream << "}";
     return stream.str();
 }
 
-std::string WebApplication::build_payloads_json() const
+// Counts cover this process only; with sharded workers each worker keeps its own.
+std::string WebApplication::build_allocations_json() const
+{
+    const auto report = allocation_report();
+    std::ostringstream stream;
+    const auto write_counters = [&stream](const std::vector<AllocationCounter> &counters) {
+        stream << '[';
+        for (std::size_t i = 0; i < counters.size(); ++i) {
+            if (i != 0) {
+                stream << ',';
+            }
+            stream << "{\"name\":\"" << json_escape(counters[i].name) << "\",\"allocations\":"
+                   << counters[i].allocations << ",\"bytes\":" << counters[i].bytes << '}';
+        }
+        stream << ']';
+    };
+    stream << "{\"enabled\":" << (report.enabled ? "true" : "false") << ",\"threads\":";
+    write_counters(report.threads);
+    stream << ",\"regions\":";
+    write_counters(report.regions);
+    stream << '}';
+    return stream.str();
+}
+
+// Covers this process only; sharded workers run in processes of their own.
+std::string WebApplication::build_threads_json() const
+{
+    const auto threads = thread_monitor_.threads();
+    double totalCpu = 0.0;
+    for (const auto &thread : threads) {
+        totalCpu += thread.cpuPercent;
+    }
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(1);
+    stream << "{\"supported\":" << (ThreadMonitor::supported() ? "true" : "false")
+           << ",\"intervalMs\":" << thread_monitor_.interval().count()
+           << ",\"cores\":" << std::max(1U, std::thread::hardware_concurrency()) << ",\"cpuPercent\":" << totalCpu
+           << ",\"threads\":[";
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        const auto &thread = threads[i];
+        if (i != 0) {
+            stream << ',';
+        }
+        stream << "{\"tid\":" << thread.tid << ",\"name\":\"" << json_escape(thread.name)
+               << "\",\"cpuPercent\":" << thread.cpuPercent << ",\"cpuTimeMs\":" << thread.cpuTimeMs
+               << ",\"voluntarySwitches\":" << thread.voluntarySwitches
+               << ",\"involuntarySwitches\":" << thread.involuntarySwitches
+               << ",\"voluntarySwitchesPerSecond\":" << thread.voluntarySwitchesPerSecond
+               << ",\"involuntarySwitchesPerSecond\":" << thread.involuntarySwitchesPerSecond
+               << ",\"runQueueWaitPercent\":" << thread.runQueueWaitPercent
+               << ",\"runQueueWaitMs\":" << thread.runQueueWaitMs << '}';
+    }
+    stream << "]}";
+    return stream.str();
+}
+
+std::string WebApplication::build_payloads_json(const ListQuery &query) const
 {
     std::shared_ptr<Simulator> simulator;
     bool running = false;
@@ -920,16 +1585,21 @@ std::string WebApplication::build_payloads_json() const
         }
     }
 
+    const auto name_of = [](const auto &entry) -> const std::string & { return entry.name; };
+    const auto com_id_of = [](const auto &entry) { return entry.comId; };
     std::ostringstream stream;
+    std::ostringstream pages;
     stream << "{\"running\":" << (running ? "true" : "false") << ",\"pd\":[";
     if (have_config) {
-        for (std::size_t i = 0; i < config.pdPublishers.size(); ++i) {
+        const auto page = select_rows(query, "pd", config.pdPublishers, name_of, com_id_of, pages);
+        for (std::size_t i = 0; i < page.rows.size(); ++i) {
             if (i != 0) {
                 stream << ',';
             }
-            const auto &publisher = config.pdPublishers[i];
+            const auto &publisher = config.pdPublishers[page.rows[i]];
             const bool editable = publisher.payload.format != PayloadConfig::Format::File;
-            stream << "{\"name\":\"" << json_escape(publisher.name) << "\",\"format\":\""
+            stream << "{\"name\":\"" << json_escape(publisher.name) << "\",\"comId\":" << publisher.comId
+                   << ",\"format\":\""
                    << json_escape(payload_format_to_string(publisher.payload.format)) << "\",\"value\":\""
                    << json_escape(publisher.payload.value) << "\",\"editable\":"
                    << (editable ? "true" : "false") << "}";
@@ -937,36 +1607,40 @@ std::string WebApplication::build_payloads_json() const
     }
     stream << "],\"md\":[";
     if (have_config) {
-        for (std::size_t i = 0; i < config.mdSenders.size(); ++i) {
+        const auto page = select_rows(query, "md", config.mdSenders, name_of, com_id_of, pages);
+        for (std::size_t i = 0; i < page.rows.size(); ++i) {
             if (i != 0) {
                 stream << ',';
             }
-            const auto &sender = config.mdSenders[i];
+            const auto &sender = config.mdSenders[page.rows[i]];
             const bool editable = sender.payload.format != PayloadConfig::Format::File;
-            stream << "{\"name\":\"" << json_escape(sender.name) << "\",\"format\":\""
+            stream << "{\"name\":\"" << json_escape(sender.name) << "\",\"comId\":" << sender.comId
+                   << ",\"format\":\""
                    << json_escape(payload_format_to_string(sender.payload.format)) << "\",\"value\":\""
                    << json_escape(sender.payload.value) << "\",\"editable\":"
                    << (editable ? "true" : "false") << "}";
         }
     }
-    stream << "]}";
+    stream << "]";
+    write_pages(stream, query, pages);
+    stream << "}";
     return stream.str();
 }
 
-std::unordered_map<std::string, std::string> WebApplication::parse_form_urlencoded(const std::string &body) const
+std::unordered_map<std::string, std::string> WebApplication::parse_form_urlencoded(const std::string &body)
 {
     std::unordered_map<std::string, std::string> params;
+    const std::string_view form(body);
     std::size_t pos = 0;
-    while (pos < body.size()) {
-        auto amp = body.find('&', pos);
-        auto token = body.substr(pos, amp == std::string::npos ? std::string::npos : amp - pos);
+    while (pos < form.size()) {
+        auto amp = form.find('&', pos);
+        auto token = form.substr(pos, amp == std::string_view::npos ? std::string_view::npos : amp - pos);
         auto eq = token.find('=');
-        std::string key = url_decode(eq == std::string::npos ? token : token.substr(0, eq));
-        std::string value = eq == std::string::npos ? std::string() : url_decode(token.substr(eq + 1));
+        std::string key = url_decode(token.substr(0, eq));
         if (!key.empty()) {
-            params[key] = value;
+            params[std::move(key)] = eq == std::string_view::npos ? std::string() : url_decode(token.substr(eq + 1));
         }
-        if (amp == std::string::npos) {
+        if (amp == std::string_view::npos) {
             break;
         }
         pos = amp + 1;
@@ -974,6 +1648,48 @@ std::unordered_map<std::string, std::string> WebApplication::parse_form_urlencod
     return params;
 }
 
+WebApplication::ListQuery WebApplication::parse_list_query(const std::string &query)
+{
+    const auto parse_count = [&query](const char *key) -> std::optional<std::size_t> {
+        const auto value = extract_parameter(query, key);
+        if (value.empty()) {
+            return std::nullopt;
+        }
+        if (!std::all_of(value.begin(), value.end(), [](unsigned char c) { return std::isdigit(c); })) {
+            throw std::runtime_error(std::string("Invalid ") + key + " parameter");
+        }
+        errno = 0;
+        const auto count = std::strtoull(value.c_str(), nullptr, 10);
+        if (errno == ERANGE || count > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::runtime_error(std::string("Invalid ") + key + " parameter (out of range)");
+        }
+        return static_cast<std::size_t>(count);
+    };
+
+    ListQuery result;
+    result.list = extract_parameter(query, "list");
+    result.offset = parse_count("offset").value_or(0);
+    result.limit = parse_count("limit");
+    result.filter = extract_parameter(query, "filter");
+    const auto sort = extract_parameter(query, "sort");
+    if (sort == "name") {
+        result.sort = ListQuery::Sort::Name;
+    } else if (sort == "comId") {
+        result.sort = ListQuery::Sort::ComId;
+    } else if (!sort.empty()) {
+        throw std::runtime_error("Invalid sort parameter (expected name or comId)");
+    }
+    const auto order = extract_parameter(query, "order");
+    if (order == "desc") {
+        result.descending = true;
+    } else if (!order.empty() && order != "asc") {
+        throw std::runtime_error("Invalid order parameter (expected asc or desc)");
+    }
+    result.paged = !result.list.empty() || result.offset != 0 || result.limit || !result.filter.empty() ||
+                   !sort.empty() || !order.empty();
+    return result;
+}
+
 WebApplication::HttpResponse WebApplication::respond_json(int status, const std::string &body) const
 {
     return {status, std::string(), "application/json", body};
@@ -995,15 +1711,30 @@ void WebApplication::request_stop()
 
 void WebApplication::simulator_worker(std::string config_path)
 {
+    set_thread_name("sim-control");
     std::shared_ptr<Simulator> simulator;
     try {
         auto config = load_configuration(config_path);
-        auto adapter = create_trdp_stack_adapter();
+        auto com_ids = std::make_shared<TelegramComIds>();
+        for (const auto &publisher : config.pdPublishers) {
+            com_ids->pdPublishers.emplace(publisher.name, publisher.comId);
+        }
+        for (const auto &subscriber : config.pdSubscribers) {
+            com_ids->pdSubscribers.emplace(subscriber.name, subscriber.comId);
+        }
+        for (const auto &sender : config.mdSenders) {
+            com_ids->mdSenders.emplace(sender.name, sender.comId);
+        }
+        for (const auto &listener : config.mdListeners) {
+            com_ids->mdListeners.emplace(listener.name, listener.comId);
+        }
+        auto adapter = create_trdp_stack_adapter(config.network);
         simulator = std::make_shared<Simulator>(std::move(config), std::move(adapter));
 
         {
             std::lock_guard<std::mutex> lock(simulator_mutex_);
             active_simulator_ = simulator;
+            telegram_com_ids_ = std::move(com_ids);
             simulator_running_ = true;
             simulator_start_pending_ = false;
             current_config_ = config_path;
@@ -1060,555 +1791,6 @@ void WebApplication::simulator_worker(std::string config_path)
     }
 }
 
-std::string WebApplication::main_page_html()
-{
-    return R"HTML(<!DOCTYPE html>
-<html lang="en">
-<head>
-<meta charset="utf-8" />
-<title>TRDP Simulator Web</title>
-<style>
-body { font-family: "Segoe UI", sans-serif; margin: 2rem; background: #f6f8fa; color: #1f2328; }
-main { max-width: 960px; margin: 0 auto; padding: 2rem; background: #ffffff; border-radius: 12px; box-shadow: 0 2px 10px rgba(31,35,40,0.08); }
-header { margin-bottom: 2rem; }
-label { display: block; margin-bottom: 0.35rem; font-weight: 600; }
-input[type="text"], select, textarea { width: 100%; padding: 0.6rem; border: 1px solid #d0d7de; border-radius: 6px; font-size: 0.95rem; }
-textarea { min-height: 80px; resize: vertical; font-family: monospace; }
-button { padding: 0.55rem 1.1rem; margin: 0.25rem 0.25rem 0.25rem 0; border: none; border-radius: 6px; cursor: pointer; font-weight: 600; }
-button.start { background: #238636; color: #ffffff; }
-button.stop { background: #d1242f; color: #ffffff; }
-button.secondary { background: #0969da; color: #ffffff; }
-button[disabled] { opacity: 0.6; cursor: not-allowed; }
-section { margin-top: 2rem; }
-section:first-of-type { margin-top: 0; }
-pre { background: #f6f8fa; padding: 1rem; border-radius: 6px; overflow: auto; border: 1px solid #d0d7de; font-size: 0.9rem; }
-#status { font-weight: 600; }
-.control-row { display: flex; flex-wrap: wrap; gap: 0.5rem; margin-bottom: 0.5rem; }
-.control-row button { margin-right: 0; }
-.config-controls { display: flex; flex-wrap: wrap; gap: 0.5rem; align-items: center; margin-bottom: 0.75rem; }
-.config-controls select { flex: 1 1 260px; min-width: 220px; }
-.config-controls button { margin-right: 0; }
-.config-actions { display: flex; flex-wrap: wrap; gap: 0.5rem; align-items: center; margin-top: 0.75rem; }
-.config-actions button { margin-right: 0; }
-.config-actions input[type="file"] { flex: 1 1 260px; }
-.notice { margin-top: 0.5rem; font-size: 0.9rem; }
-.notice.success { color: #1a7f37; }
-.notice.error { color: #cf222e; }
-.notice.muted { color: #57606a; font-style: italic; }
-.metrics-grid { display: grid; grid-template-columns: repeat(auto-fit, minmax(220px, 1fr)); gap: 1rem; margin-top: 1rem; }
-.metrics-grid h3 { margin-top: 0; font-size: 1.05rem; }
-.metrics-grid ul { list-style: none; padding: 0.75rem; margin: 0; background: #f6f8fa; border-radius: 6px; border: 1px solid #d0d7de; }
-.metrics-grid li { margin-bottom: 0.5rem; font-size: 0.95rem; }
-.metrics-grid li:last-child { margin-bottom: 0; }
-.metrics-grid li.muted { color: #57606a; font-style: italic; }
-.drop-zone { border: 2px dashed #0969da; padding: 1.5rem; border-radius: 8px; text-align: center; color: #0969da; background: rgba(9,105,218,0.05); transition: background 0.2s ease, border-color 0.2s ease; }
-.drop-zone.dragover { background: rgba(9,105,218,0.12); border-color: #0550ae; }
-.inline-actions { display: flex; gap: 0.75rem; flex-wrap: wrap; align-items: center; }
-.hidden { display: none !important; }
-#messages { padding: 0.75rem 1rem; border-radius: 6px; margin-bottom: 1rem; display: none; }
-#messages.info { background: #e7f3ff; border: 1px solid #b6daff; color: #054289; }
-#messages.error { background: #ffebe9; border: 1px solid #ff8182; color: #b54746; }
-#messages.success { background: #dafbe1; border: 1px solid #4ac26b; color: #116329; }
-.payload-grid { display: grid; grid-template-columns: repeat(auto-fit, minmax(260px, 1fr)); gap: 1rem; margin-top: 1rem; }
-.payload-card { border: 1px solid #d0d7de; border-radius: 8px; padding: 1rem; background: #f8fafc; display: flex; flex-direction: column; gap: 0.75rem; }
-.payload-card h4 { margin: 0; font-size: 1rem; }
-.payload-meta { font-size: 0.85rem; color: #57606a; }
-.payload-actions { display: flex; justify-content: flex-end; gap: 0.5rem; }
-</style>
-</head>
-<body>
-<main>
-<header>
-  <h1>TRDP Simulator Web Interface</h1>
-  <p>Upload TRDP configuration XML files, review their contents, store them for later use, and control the simulator directly from your browser.</p>
-</header>
-
-<div id="messages"></div>
-
-<section id="uploadSection">
-  <h2>Upload configuration</h2>
-  <div class="drop-zone" id="dropZone">Drop a TRDP XML file here or <strong>click to browse</strong>.<br /><small>Only the XML content is uploaded to the server for validation.</small></div>
-  <input id="configFile" type="file" accept=".xml" style="display:none" />
-  <div class="inline-actions">
-    <div><strong>Parsed file:</strong> <span id="parsedConfigName">None</span></div>
-    <button class="secondary" id="saveConfigBtn" disabled>Save configuration</button>
-  </div>
-  <pre id="configSummary">Drop a configuration to preview its details.</pre>
-</section>
-
-<section id="savedConfigsSection">
-  <h2>Saved configurations</h2>
-  <div class="inline-actions">
-    <div style="flex:1; min-width: 240px;">
-      <label for="configSelect">Select a saved configuration</label>
-      <select id="configSelect"></select>
-    </div>
-    <button class="secondary" id="viewConfigBtn">View details</button>
-  </div>
-  <pre id="savedConfigDetails">No configuration selected.</pre>
-</section>
-
-<section id="controlSection">
-  <h2>Simulator control</h2>
-  <p>Choose a saved configuration or provide a manual file path. Saved configurations are referenced as <code>saved:&lt;name&gt;</code> when starting the simulator.</p>
-  <label for="configPath">Manual configuration path (optional)</label>
-  <input id="configPath" type="text" placeholder="/path/to/configuration.xml" />
-  <div>
-    <button class="start" id="startBtn">Start simulator</button>
-    <button class="stop" id="stopBtn">Stop simulator</button>
-  </div>
-  <section>
-    <h3>Status</h3>
-    <p id="status">Loading...</p>
-    <p><strong>Simulator:</strong> <span id="simulatorState">Unknown</span></p>
-    <pre id="details"></pre>
-  </section>
-</section>
-
-<section id="payloadEditor" class="hidden">
-  <h2>Live payload editor</h2>
-  <p>Update PD publisher and MD sender payloads while the simulator is running. Hex payloads should be entered without prefixes (spaces are ignored).</p>
-  <div>
-    <h3>Process Data publishers</h3>
-    <div id="pdPayloads" class="payload-grid"></div>
-  </div>
-  <div>
-    <h3>Message Data senders</h3>
-    <div id="mdPayloads" class="payload-grid"></div>
-  </div>
-</section>
-
-<section id="telemetrySection">
-  <h2>Telemetry</h2>
-  <p><strong>Adapter:</strong> <span id="adapterState">Idle</span></p>
-  <div class="metrics-grid">
-    <div>
-      <h3>PD Publishers</h3>
-      <ul id="pdPublishersList"><li class="muted">No data</li></ul>
-    </div>
-    <div>
-      <h3>PD Subscribers</h3>
-      <ul id="pdSubscribersList"><li class="muted">No data</li></ul>
-    </div>
-    <div>
-      <h3>MD Senders</h3>
-      <ul id="mdSendersList"><li class="muted">No data</li></ul>
-    </div>
-    <div>
-      <h3>MD Listeners</h3>
-      <ul id="mdListenersList"><li class="muted">No data</li></ul>
-    </div>
-  </div>
-  <pre id="metricsRaw"></pre>
-</section>
-</main>
-<script>
-const dropZone = document.getElementById('dropZone');
-const fileInput = document.getElementById('configFile');
-const configSummaryPre = document.getElementById('configSummary');
-const parsedConfigName = document.getElementById('parsedConfigName');
-const saveConfigBtn = document.getElementById('saveConfigBtn');
-const messageBox = document.getElementById('messages');
-const configSelect = document.getElementById('configSelect');
-const savedConfigDetails = document.getElementById('savedConfigDetails');
-let lastParsedXml = '';
-let lastSuggestedName = '';
-
-function showMessage(text, variant = 'info') {
-  if (!text) {
-    messageBox.style.display = 'none';
-    return;
-  }
-  messageBox.textContent = text;
-  messageBox.className = variant;
-  messageBox.style.display = 'block';
-  if (variant === 'success') {
-    setTimeout(() => { messageBox.style.display = 'none'; }, 4000);
-  }
-}
-
-function renderMetricList(elementId, items, formatter, emptyMessage) {
-  const list = document.getElementById(elementId);
-  if (!list) {
-    return;
-  }
-  const formatItem = typeof formatter === 'function' ? formatter : (value) => String(value);
-  list.innerHTML = '';
-  if (!Array.isArray(items) || items.length === 0) {
-    const li = document.createElement('li');
-    li.textContent = emptyMessage;
-    li.classList.add('muted');
-    list.appendChild(li);
-    return;
-  }
-  items.forEach((item) => {
-    const li = document.createElement('li');
-    li.textContent = formatItem(item);
-    list.appendChild(li);
-  });
-}
-
-function preventDefaults(event) {
-  event.preventDefault();
-  event.stopPropagation();
-}
-
-function highlightDropZone() { dropZone.classList.add('dragover'); }
-function unhighlightDropZone() { dropZone.classList.remove('dragover'); }
-
-dropZone.addEventListener('click', () => fileInput.click());
-['dragenter', 'dragover'].forEach((eventName) => {
-  dropZone.addEventListener(eventName, (event) => { preventDefaults(event); highlightDropZone(); });
-});
-['dragleave', 'drop'].forEach((eventName) => {
-  dropZone.addEventListener(eventName, (event) => { preventDefaults(event); unhighlightDropZone(); });
-});
-
-dropZone.addEventListener('drop', (event) => {
-  const files = event.dataTransfer.files;
-  if (files && files.length > 0) {
-    readConfigurationFile(files[0]);
-  }
-});
-
-fileInput.addEventListener('change', (event) => {
-  const files = event.target.files;
-  if (files && files.length > 0) {
-    readConfigurationFile(files[0]);
-  }
-});
-
-function readConfigurationFile(file) {
-  if (!file.name.toLowerCase().endsWith('.xml')) {
-    showMessage('Please select an XML configuration file.', 'error');
-    return;
-  }
-  const reader = new FileReader();
-  reader.onload = async () => {
-    const xmlText = reader.result;
-    await parseUploadedConfiguration(xmlText, file.name.replace(/\.[^.]+$/, ''));
-  };
-  reader.readAsText(file);
-}
-
-async function parseUploadedConfiguration(xmlText, suggestedName = '') {
-  try {
-    const params = new URLSearchParams();
-    params.set('xml', xmlText);
-    if (suggestedName) {
-      params.set('name', suggestedName);
-    }
-    const response = await fetch('/api/config/parse', {
-      method: 'POST',
-      headers: { 'Content-Type': 'application/x-www-form-urlencoded' },
-      body: params,
-    });
-    const data = await response.json();
-    if (!response.ok) {
-      showMessage(data.error || 'Failed to parse configuration.', 'error');
-      configSummaryPre.textContent = data.error || 'Unable to parse configuration.';
-      saveConfigBtn.disabled = true;
-      return;
-    }
-    lastParsedXml = xmlText;
-    lastSuggestedName = (suggestedName || data.suggestedName || '').replace(/\s+/g, '_');
-    parsedConfigName.textContent = lastSuggestedName || '(unspecified)';
-    configSummaryPre.textContent = JSON.stringify(data.summary, null, 2);
-    saveConfigBtn.disabled = false;
-    showMessage('Configuration parsed successfully.', 'success');
-  } catch (error) {
-    showMessage('Failed to parse configuration: ' + error.message, 'error');
-  }
-}
-
-saveConfigBtn.addEventListener('click', async () => {
-  if (!lastParsedXml) {
-    return;
-  }
-  let name = prompt('Enter a name for the configuration', lastSuggestedName || 'trdp-config');
-  if (!name) {
-    return;
-  }
-  name = name.trim();
-  try {
-    const params = new URLSearchParams();
-    params.set('name', name);
-    params.set('xml', lastParsedXml);
-    const response = await fetch('/api/config/save', {
-      method: 'POST',
-      headers: { 'Content-Type': 'application/x-www-form-urlencoded' },
-      body: params,
-    });
-    const data = await response.json();
-    if (!response.ok) {
-      showMessage(data.error || 'Unable to save configuration.', 'error');
-      return;
-    }
-    showMessage(`Configuration "${data.name}" saved successfully.`, 'success');
-    await refreshSavedConfigs();
-    configSelect.value = data.name;
-    await loadSelectedConfiguration();
-  } catch (error) {
-    showMessage('Saving configuration failed: ' + error.message, 'error');
-  }
-});
-
-document.getElementById('viewConfigBtn').addEventListener('click', loadSelectedConfiguration);
-
-async function refreshSavedConfigs() {
-  try {
-    const response = await fetch('/api/configs');
-    const data = await response.json();
-    configSelect.innerHTML = '';
-    if (!data.configs || data.configs.length === 0) {
-      const option = document.createElement('option');
-      option.value = '';
-      option.textContent = 'No saved configurations';
-      option.disabled = true;
-      option.selected = true;
-      configSelect.appendChild(option);
-      savedConfigDetails.textContent = 'No configuration selected.';
-      return;
-    }
-    const placeholder = document.createElement('option');
-    placeholder.value = '';
-    placeholder.textContent = 'Select a configuration';
-    placeholder.disabled = true;
-    placeholder.selected = true;
-    configSelect.appendChild(placeholder);
-    data.configs.forEach((item) => {
-      const option = document.createElement('option');
-      option.value = item.name;
-      option.textContent = item.name;
-      configSelect.appendChild(option);
-    });
-  } catch (error) {
-    showMessage('Unable to fetch saved configurations: ' + error.message, 'error');
-  }
-}
-
-async function loadSelectedConfiguration() {
-  const name = configSelect.value;
-  if (!name) {
-    savedConfigDetails.textContent = 'No configuration selected.';
-    return;
-  }
-  try {
-    const response = await fetch(`/api/config/details?name=${encodeURIComponent(name)}`);
-    const data = await response.json();
-    if (!response.ok) {
-      showMessage(data.error || 'Unable to load configuration details.', 'error');
-      return;
-    }
-    savedConfigDetails.textContent = JSON.stringify(data.summary, null, 2);
-  } catch (error) {
-    showMessage('Unable to load configuration details: ' + error.message, 'error');
-  }
-}
-
-async function startSimulator() {
-  const manualPath = document.getElementById('configPath').value.trim();
-  const savedName = configSelect.value;
-  let configSpec = '';
-  if (manualPath) {
-    configSpec = manualPath;
-  } else if (savedName) {
-    configSpec = `saved:${savedName}`;
-  }
-  if (!configSpec) {
-    showMessage('Please choose a saved configuration or provide a path before starting the simulator.', 'error');
-    return;
-  }
-  try {
-    const params = new URLSearchParams();
-    params.set('config', configSpec);
-    const response = await fetch('/api/start', {
-      method: 'POST',
-      headers: { 'Content-Type': 'application/x-www-form-urlencoded' },
-      body: params,
-    });
-    const data = await response.json();
-    if (!response.ok) {
-      showMessage(data.error || 'Failed to start simulator.', 'error');
-      return;
-    }
-    showMessage(data.message || 'Simulator started.', 'success');
-    refreshStatus();
-    refreshMetrics();
-    refreshPayloads();
-  } catch (error) {
-    showMessage('Failed to start simulator: ' + error.message, 'error');
-  }
-}
-
-async function stopSimulator() {
-  try {
-    const response = await fetch('/api/stop', { method: 'POST' });
-    const data = await response.json();
-    if (!response.ok) {
-      showMessage(data.error || 'Failed to stop simulator.', 'error');
-      return;
-    }
-    showMessage(data.message || 'Simulator stopped.', 'success');
-    refreshStatus();
-    refreshMetrics();
-    refreshPayloads();
-  } catch (error) {
-    showMessage('Failed to stop simulator: ' + error.message, 'error');
-  }
-}
-
-document.getElementById('startBtn').addEventListener('click', startSimulator);
-document.getElementById('stopBtn').addEventListener('click', stopSimulator);
-
-async function refreshStatus() {
-  try {
-    const response = await fetch('/api/status');
-    const data = await response.json();
-    const status = document.getElementById('status');
-    const details = document.getElementById('details');
-    const simulatorState = document.getElementById('simulatorState');
-    if (data.running) {
-      status.textContent = `Simulator is running${data.configLabel ? ' with ' + data.configLabel : ''}.`;
-      simulatorState.textContent = 'Running';
-    } else {
-      status.textContent = 'Simulator is stopped';
-      simulatorState.textContent = 'Stopped';
-    }
-    details.textContent = JSON.stringify(data, null, 2);
-    if (data.running) {
-      refreshPayloads();
-    } else {
-      hidePayloadEditor();
-    }
-  } catch (err) {
-    document.getElementById('status').textContent = 'Unable to query status';
-    document.getElementById('simulatorState').textContent = 'Unknown';
-    hidePayloadEditor();
-  }
-}
-
-function hidePayloadEditor() {
-  document.getElementById('payloadEditor').classList.add('hidden');
-  document.getElementById('pdPayloads').innerHTML = '';
-  document.getElementById('mdPayloads').innerHTML = '';
-}
-
-async function refreshMetrics() {
-  try {
-    const response = await fetch('/api/metrics');
-    if (!response.ok) {
-      throw new Error('Request failed');
-    }
-    const data = await response.json();
-    document.getElementById('adapterState').textContent = data.adapterState || 'Unknown';
-    renderMetricList('pdPublishersList', data.pdPublishers || [],
-      (item) => `${item.name}: ${item.packetsSent} packets sent`, 'No PD publishers');
-    renderMetricList('pdSubscribersList', data.pdSubscribers || [],
-      (item) => `${item.name}: ${item.packetsReceived} packets received`, 'No PD subscribers');
-    renderMetricList('mdSendersList', data.mdSenders || [],
-      (item) => `${item.name}: ${item.requestsSent} requests / ${item.repliesReceived} replies`, 'No MD senders');
-    renderMetricList('mdListenersList', data.mdListeners || [],
-      (item) => `${item.name}: ${item.requestsReceived} requests / ${item.repliesSent} replies`, 'No MD listeners');
-    document.getElementById('metricsRaw').textContent = JSON.stringify(data, null, 2);
-  } catch (err) {
-    document.getElementById('metricsRaw').textContent = 'Unable to query metrics';
-  }
-}
-
-async function refreshPayloads() {
-  try {
-    const response = await fetch('/api/simulator/payloads');
-    if (!response.ok) {
-      throw new Error('Unable to fetch payloads');
-    }
-    const data = await response.json();
-    const editorSection = document.getElementById('payloadEditor');
-    if (!data.running) {
-      hidePayloadEditor();
-      return;
-    }
-    editorSection.classList.remove('hidden');
-    renderPayloadCards('pdPayloads', data.pd || [], 'pd');
-    renderPayloadCards('mdPayloads', data.md || [], 'md');
-  } catch (error) {
-    showMessage('Unable to refresh payload information: ' + error.message, 'error');
-  }
-}
-
-function renderPayloadCards(containerId, items, type) {
-  const container = document.getElementById(containerId);
-  container.innerHTML = '';
-  if (!items || items.length === 0) {
-    const placeholder = document.createElement('div');
-    placeholder.textContent = 'No entries available.';
-    placeholder.classList.add('payload-meta');
-    container.appendChild(placeholder);
-    return;
-  }
-  items.forEach((item) => {
-    const card = document.createElement('div');
-    card.className = 'payload-card';
-    const title = document.createElement('h4');
-    title.textContent = item.name;
-    const meta = document.createElement('div');
-    meta.className = 'payload-meta';
-    meta.textContent = `Format: ${item.format}${item.editable ? '' : ' (read-only)'}`;
-    const input = document.createElement('textarea');
-    input.value = item.value || '';
-    input.disabled = !item.editable;
-    const actions = document.createElement('div');
-    actions.className = 'payload-actions';
-    const button = document.createElement('button');
-    button.textContent = 'Update payload';
-    button.className = 'secondary';
-    button.disabled = !item.editable;
-    button.addEventListener('click', async () => {
-      await updatePayload(type, item.name, item.format, input.value);
-    });
-    actions.appendChild(button);
-    card.appendChild(title);
-    card.appendChild(meta);
-    card.appendChild(input);
-    card.appendChild(actions);
-    container.appendChild(card);
-  });
-}
-
-async function updatePayload(type, name, format, value) {
-  try {
-    const params = new URLSearchParams();
-    params.set('type', type);
-    params.set('name', name);
-    params.set('format', format);
-    params.set('value', value);
-    const response = await fetch('/api/simulator/payload', {
-      method: 'POST',
-      headers: { 'Content-Type': 'application/x-www-form-urlencoded' },
-      body: params,
-    });
-    const data = await response.json();
-    if (!response.ok) {
-      showMessage(data.error || 'Unable to update payload.', 'error');
-      return;
-    }
-    showMessage(data.message || 'Payload updated.', 'success');
-    refreshPayloads();
-  } catch (error) {
-    showMessage('Unable to update payload: ' + error.message, 'error');
-  }
-}
-
-refreshSavedConfigs();
-refreshStatus();
-refreshMetrics();
-setInterval(refreshStatus, 4000);
-setInterval(refreshMetrics, 5000);
-</script>
-</body>
-</html>)HTML";
-}
-
 std::string WebApplication::json_escape(const std::string &value)
 {
     std::ostringstream stream;
@@ -0,0 +1,98 @@
+#include "trdp_simulator/web_assets.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <string>
+
+namespace trdp_sim {
+namespace {
+
+std::string_view trim(std::string_view value)
+{
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+bool equals_ignore_case(std::string_view lhs, std::string_view rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](char a, char b) {
+               return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+           });
+}
+
+// Calls visit(element) for each comma-separated element of a header value, trimmed.
+template <typename Visit>
+void for_each_element(std::string_view header, Visit visit)
+{
+    while (!header.empty()) {
+        const auto comma = header.find(',');
+        const auto element = trim(header.substr(0, comma));
+        if (!element.empty()) {
+            visit(element);
+        }
+        header = comma == std::string_view::npos ? std::string_view() : header.substr(comma + 1U);
+    }
+}
+
+// An Accept-Encoding entry allows the coding unless its quality is zero ("gzip;q=0").
+bool accepts_encoding(std::string_view acceptEncoding, std::string_view encoding)
+{
+    bool accepted = false;
+    bool explicitly = false;
+    for_each_element(acceptEncoding, [&](std::string_view element) {
+        const auto semicolon = element.find(';');
+        const auto coding = trim(element.substr(0, semicolon));
+        bool allowed = true;
+        if (semicolon != std::string_view::npos) {
+            auto parameter = trim(element.substr(semicolon + 1U));
+            if (parameter.size() > 2U && (parameter[0] == 'q' || parameter[0] == 'Q') && parameter[1] == '=') {
+                allowed = std::strtod(std::string(parameter.substr(2)).c_str(), nullptr) > 0.0;
+            }
+        }
+        // A named coding takes precedence over the "*" wildcard.
+        if (equals_ignore_case(coding, encoding)) {
+            accepted = allowed;
+            explicitly = true;
+        } else if (coding == "*" && !explicitly) {
+            accepted = allowed;
+        }
+    });
+    return accepted;
+}
+
+}  // namespace
+
+const WebAssetRepresentation &select_web_asset_representation(const WebAsset &asset,
+                                                              std::string_view acceptEncoding)
+{
+    const WebAssetRepresentation *selected = &asset.representations[0];
+    for (std::size_t index = 1; index < asset.representationCount; ++index) {
+        const auto &candidate = asset.representations[index];
+        if (candidate.data.size() < selected->data.size() &&
+            accepts_encoding(acceptEncoding, candidate.contentEncoding)) {
+            selected = &candidate;
+        }
+    }
+    return *selected;
+}
+
+bool etag_matches(std::string_view ifNoneMatch, std::string_view etag)
+{
+    bool matched = false;
+    for_each_element(ifNoneMatch, [&](std::string_view element) {
+        // If-None-Match uses the weak comparison, so a W/ prefix is ignored.
+        if (element.substr(0, 2) == "W/") {
+            element.remove_prefix(2);
+        }
+        matched = matched || element == "*" || element == etag;
+    });
+    return matched;
+}
+
+}  // namespace trdp_sim
@@ -0,0 +1,120 @@
+#include "trdp_simulator/allocation_tracker.hpp"
+#include "trdp_simulator/config_loader.hpp"
+#include "trdp_simulator/simulator.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace trdp_sim {
+std::unique_ptr<TrdpStackAdapter> create_stub_trdp_stack_adapter();
+}
+
+namespace {
+
+using namespace trdp_sim;
+
+std::uint64_t region_allocations(const AllocationReport &report, const std::string &name)
+{
+    for (const auto &region : report.regions) {
+        if (region.name == name) {
+            return region.allocations;
+        }
+    }
+    return 0;
+}
+
+std::uint64_t packets_received(const Simulator &simulator)
+{
+    std::uint64_t total = 0;
+    for (const auto &subscriber : simulator.metrics_snapshot().pdSubscribers) {
+        total += subscriber.packetsReceived;
+    }
+    return total;
+}
+
+// C allocations, such as those of the TRDP stack, have to be counted as well as operator new.
+int check_malloc_counted()
+{
+#ifdef __GLIBC__
+    {
+        AllocationRegion region("test.malloc");
+        void *volatile block = std::malloc(64);
+        block = std::realloc(block, 128);
+        std::free(block);
+    }
+    const auto allocations = region_allocations(allocation_report(), "test.malloc");
+    if (allocations != 2) {
+        std::cerr << "malloc and realloc were counted " << allocations << " time(s) instead of twice" << std::endl;
+        return 1;
+    }
+#endif
+    return 0;
+}
+
+}  // namespace
+
+// Runs a sample PD configuration on the stub adapter and fails if publishing or receiving allocates once warmed up.
+int main()
+{
+    const char *xml = R"XML(<?xml version="1.0"?>
+<trdpSimulator>
+  <network interface="lo" hostIp="127.0.0.1" />
+  <logging level="warn" console="false" />
+  <pd>
+    <publisher name="Speed" comId="1000" cycleTimeMs="2">
+      <payload format="hex">00112233445566778899AABBCCDDEEFF00112233445566778899AABBCCDDEEFF</payload>
+    </publisher>
+    <publisher name="DoorStatus" comId="1001" cycleTimeMs="5">
+      <payload format="text">all doors closed and locked</payload>
+    </publisher>
+    <subscriber name="SpeedMonitor" comId="1000" />
+    <subscriber name="DoorMonitor" comId="1001" />
+  </pd>
+</trdpSimulator>
+)XML";
+
+    if (check_malloc_counted() != 0) {
+        return 1;
+    }
+    try {
+        Simulator simulator(load_configuration_from_string(xml), create_stub_trdp_stack_adapter());
+        std::thread runner([&simulator] { simulator.run(); });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        const auto warm = allocation_report();
+        const auto receivedBefore = packets_received(simulator);
+        std::this_thread::sleep_for(std::chrono::milliseconds(700));
+        const auto steady = allocation_report();
+        const auto receivedAfter = packets_received(simulator);
+
+        simulator.stop();
+        runner.join();
+
+        if (!steady.enabled) {
+            std::cerr << "Allocation tracking is not compiled in" << std::endl;
+            return 1;
+        }
+        if (receivedAfter <= receivedBefore) {
+            std::cerr << "No PD telegrams were received during the measurement" << std::endl;
+            return 1;
+        }
+        int failures = 0;
+        for (const char *region : {"pd.publish", "pd.receive"}) {
+            const auto allocations = region_allocations(steady, region) - region_allocations(warm, region);
+            if (allocations != 0) {
+                std::cerr << "Region '" << region << "' allocated " << allocations << " time(s) while "
+                          << (receivedAfter - receivedBefore) << " telegrams were received" << std::endl;
+                ++failures;
+            }
+        }
+        return failures == 0 ? 0 : 1;
+    } catch (const std::exception &ex) {
+        std::cerr << "Steady-state allocation test failed: " << ex.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,87 @@
+#include "trdp_simulator/binary_log.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace trdp_sim {
+
+int run_binary_log_tests()
+{
+    const auto path = std::filesystem::temp_directory_path() / "trdp-simulator-binary-log-test.blog";
+    const std::string longText(300, 'x');
+    const std::vector<std::uint8_t> payload = {0x01, 0xAB};
+    std::uint64_t written = 0;
+    {
+        // The smallest ring holds 1024 records, so writing 1500 wraps it.
+        BinaryLog log(path.string(), 196U * 1024U);
+        const auto speed = log.intern("Speed");
+        if (log.intern("Speed") != speed) {
+            std::cerr << "Binary log interned the same string twice" << std::endl;
+            return 1;
+        }
+        for (int i = 0; i < 1500; ++i) {
+            log.write(LogLevel::Info, BinaryLogMessage::PdReceived,
+                      {BinaryLogArg::string(speed), BinaryLogArg::unsigned_value(1000U + static_cast<unsigned>(i))},
+                      {BinaryLogDataFormat::Hex, payload.data(), payload.size()});
+        }
+        log.write_text(LogLevel::Warn, longText);
+        written = log.records_written();
+    }
+
+    BinaryLogReader reader(path.string());
+    std::vector<std::string> lines;
+    std::size_t entries = 0;
+    reader.for_each([&](const BinaryLogEntry &entry) {
+        ++entries;
+        if (entry.message == BinaryLogMessage::Text || entry.args.size() < 2 || entry.args[1].value == 2499U) {
+            lines.push_back(reader.format(entry));
+        }
+    });
+    std::filesystem::remove(path);
+
+    if (reader.records_written() != written || reader.records_lost() != written - 1024U) {
+        std::cerr << "Binary log reported " << reader.records_lost() << " lost of " << reader.records_written()
+                  << " records" << std::endl;
+        return 1;
+    }
+    if (lines.size() != 2 || lines[0] != "PD subscriber 'Speed' received COMID 2499 payload=01 ab" ||
+        lines[1] != longText) {
+        std::cerr << "Binary log did not round-trip its records (" << entries << " read)" << std::endl;
+        return 1;
+    }
+
+    // More telegram names than the default table holds fit once the table is sized for them.
+    std::vector<std::string> names;
+    std::size_t tableBytes = 0;
+    for (int i = 0; i < 4000; ++i) {
+        names.push_back("Telegram name padded to forty characters " + std::to_string(i));
+        tableBytes += BinaryLog::string_entry_size(names.back());
+    }
+    try {
+        BinaryLog log(path.string(), 512U * 1024U, tableBytes);
+        std::uint32_t last = 0;
+        for (const auto &name : names) {
+            last = log.intern(name);
+        }
+        log.write(LogLevel::Info, BinaryLogMessage::PdSent,
+                  {BinaryLogArg::string(last), BinaryLogArg::unsigned_value(7U)},
+                  {BinaryLogDataFormat::Hex, payload.data(), payload.size()});
+    } catch (const std::exception &ex) {
+        std::cerr << "Sized binary log string table did not hold every name: " << ex.what() << std::endl;
+        return 1;
+    }
+    BinaryLogReader sized(path.string());
+    std::string line;
+    sized.for_each([&](const BinaryLogEntry &entry) { line = sized.format(entry); });
+    std::filesystem::remove(path);
+    if (line != "PD publisher '" + names.back() + "' sent COMID 7 payload=01 ab") {
+        std::cerr << "Binary log did not resolve a name beyond the default string table: " << line << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace trdp_sim
@@ -0,0 +1,117 @@
+#include "trdp_simulator/config_store.hpp"
+
+#include <sys/stat.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trdp_sim {
+namespace {
+
+const char *kConfiguration = R"XML(<trdpSimulator>
+  <network interface="lo" hostIp="127.0.0.1" />
+  <pd>
+    <publisher name="Door" comId="100" cycleTimeMs="100" />
+    <publisher name="Brake" comId="101" cycleTimeMs="100" />
+    <subscriber name="Speed" comId="102" />
+  </pd>
+  <md>
+    <listener name="Diag" comId="200" />
+  </md>
+</trdpSimulator>
+)XML";
+
+// The catalog indexes on its own thread; give it up to two seconds to catch up.
+bool eventually(const std::function<bool()> &condition)
+{
+    for (int attempt = 0; attempt < 200; ++attempt) {
+        if (condition()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+}  // namespace
+
+int run_config_catalog_tests()
+{
+    const auto directory = std::filesystem::temp_directory_path() / "trdp-simulator-catalog-test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    std::ofstream(directory / "broken.xml") << "<trdpSimulator><pd>";
+    std::ofstream(directory / "notes.txt") << "not a configuration";
+
+    ConfigStore store(directory);
+    const auto &catalog = store.catalog();
+    if (!eventually([&] {
+            const auto entries = catalog.entries();
+            return entries.size() == 1 && entries[0].status == ConfigCatalogEntry::Status::Invalid;
+        })) {
+        std::cerr << "Catalog did not index the existing library" << std::endl;
+        return 1;
+    }
+
+    // Saving through the store is listed at once, before any inotify event is handled.
+    store.save("train", kConfiguration);
+    auto entries = catalog.entries("TRA");
+    if (store.list().size() != 2 || entries.size() != 1 || entries[0].status != ConfigCatalogEntry::Status::Valid ||
+        entries[0].pdPublishers != 2 || entries[0].pdSubscribers != 1 || entries[0].mdListeners != 1 ||
+        entries[0].size != std::string(kConfiguration).size()) {
+        std::cerr << "Catalog did not index a saved configuration" << std::endl;
+        return 1;
+    }
+
+    if (catalog.watching()) {
+        std::ofstream(directory / "copied.xml") << kConfiguration;
+        std::filesystem::remove(directory / "broken.xml");
+        if (!eventually([&] {
+                const auto names = store.list();
+                return names == std::vector<std::string>{"copied", "train"} &&
+                       catalog.entries("copied").front().status == ConfigCatalogEntry::Status::Valid;
+            })) {
+            std::cerr << "Catalog did not follow changes made outside the store" << std::endl;
+            return 1;
+        }
+    }
+
+    // Uploads spooled next to the library are renamed into place.
+    const auto spooled = store.spool_directory() / "upload";
+    std::ofstream(spooled) << kConfiguration;
+    store.save_file("uploaded", spooled);
+    if (std::filesystem::exists(spooled) || store.load_xml("uploaded") != kConfiguration ||
+        catalog.entries("uploaded").size() != 1 || catalog.entries("spool").size() != 0) {
+        std::cerr << "Spooled upload was not moved into the library" << std::endl;
+        return 1;
+    }
+
+    // A file on another filesystem replaces the stored one in a single rename, never by rewriting it in place.
+    const std::filesystem::path elsewhere("/dev/shm/trdp-simulator-catalog-upload");
+    if (std::filesystem::is_directory(elsewhere.parent_path())) {
+        struct stat before {};
+        ::stat(store.path_for("uploaded").c_str(), &before);
+        std::ofstream(elsewhere) << "<trdpSimulator />\n";
+        store.save_file("uploaded", elsewhere);
+        struct stat after {};
+        ::stat(store.path_for("uploaded").c_str(), &after);
+        std::error_code ignored;
+        std::filesystem::remove(elsewhere, ignored);
+        if (store.load_xml("uploaded") != "<trdpSimulator />\n" || after.st_ino == before.st_ino ||
+            store.versions("uploaded").size() != 2) {
+            std::cerr << "Upload from another filesystem did not replace the configuration atomically" << std::endl;
+            return 1;
+        }
+    }
+
+    std::filesystem::remove_all(directory);
+    return 0;
+}
+
+}  // namespace trdp_sim
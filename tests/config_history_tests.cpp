@@ -0,0 +1,96 @@
+#include "trdp_simulator/config_store.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <set>
+#include <string>
+
+namespace trdp_sim {
+
+int run_config_history_tests()
+{
+    const auto directory = std::filesystem::temp_directory_path() / "trdp-simulator-history-test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    ConfigStore store(directory);
+
+    const auto digest = store.save("abc", "abc").digest;
+    if (digest != "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad") {
+        std::cerr << "Configuration history hashed 'abc' as " << digest << std::endl;
+        return 1;
+    }
+
+    std::string original = "<trdpSimulator>\n";
+    for (int i = 0; i < 4000; ++i) {
+        original += "  <publisher name=\"Pub" + std::to_string(i) + "\" comId=\"" + std::to_string(10000 + i) +
+                    "\" cycleTimeMs=\"100\" />\n";
+    }
+    original += "</trdpSimulator>\n";
+    auto edited = original;
+    const std::string before = "name=\"Pub2500\" comId=\"12500\" cycleTimeMs=\"100\"";
+    edited.replace(edited.find(before), before.size(), "name=\"Pub2500\" comId=\"12500\" cycleTimeMs=\"50\"");
+
+    const auto first = store.save("train", original);
+    const auto second = store.save("train", edited, "faster Pub2500");
+    const auto unchanged = store.save("train", edited);
+    std::set<std::string> objects;
+    for (const auto &version : {first, second}) {
+        for (const auto &chunk : version.chunks) {
+            objects.insert(chunk.hash);
+        }
+    }
+    if (first.number != 1 || second.number != 2 || unchanged.number != 2 || first.chunks.size() < 10 ||
+        objects.size() != first.chunks.size() + 1U || store.versions("train").back().label != "faster Pub2500") {
+        std::cerr << "Configuration history did not deduplicate an edited version: " << objects.size() << " objects for "
+                  << first.chunks.size() << " chunks" << std::endl;
+        return 1;
+    }
+
+    const auto diff = store.diff("train", 1, 2);
+    const std::string expected = "@@ -2502,1 +2502,1 @@\n"
+                                 "-  <publisher name=\"Pub2500\" comId=\"12500\" cycleTimeMs=\"100\" />\n"
+                                 "+  <publisher name=\"Pub2500\" comId=\"12500\" cycleTimeMs=\"50\" />\n";
+    if (diff != expected) {
+        std::cerr << "Unexpected configuration diff:\n" << diff << std::endl;
+        return 1;
+    }
+
+    const auto restored = store.restore("train", 1);
+    if (store.load_xml("train") != original || store.load_version("train", 2) != edited || restored.number != 3 ||
+        restored.digest != first.digest) {
+        std::cerr << "Configuration history did not restore version 1" << std::endl;
+        return 1;
+    }
+
+    // A document on one line, as minified XML is, is still cut into bounded chunks.
+    std::string minified = "<trdpSimulator>";
+    while (minified.size() < 700 * 1024) {
+        minified += "<publisher name=\"Pub" + std::to_string(minified.size()) + "\" comId=\"1\" />";
+    }
+    minified += "</trdpSimulator>";
+    const auto single = store.save("minified", minified);
+    std::size_t lines = 0;
+    std::size_t largest = 0;
+    for (const auto &chunk : single.chunks) {
+        lines += chunk.lines;
+        largest = std::max<std::size_t>(largest, chunk.size);
+    }
+    if (single.chunks.size() < 3 || largest > 256 * 1024 || lines != 1 || store.load_version("minified", 1) != minified) {
+        std::cerr << "Single-line document was stored as " << single.chunks.size() << " chunks of up to " << largest
+                  << " bytes" << std::endl;
+        return 1;
+    }
+    auto appended = minified;
+    appended.insert(appended.size() - 16, "<subscriber name=\"Sub\" comId=\"1\" />");
+    const auto longer = store.save("minified", appended);
+    if (longer.chunks.front().hash != single.chunks.front().hash || store.load_version("minified", 2) != appended) {
+        std::cerr << "Edit at the end of a single-line document did not keep its leading chunks" << std::endl;
+        return 1;
+    }
+
+    std::filesystem::remove_all(directory);
+    return 0;
+}
+
+}  // namespace trdp_sim
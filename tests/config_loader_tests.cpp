@@ -1,4 +1,5 @@
 #include "trdp_simulator/config_loader.hpp"
+#include "trdp_simulator/shard_coordinator.hpp"
 
 #include <iostream>
 
@@ -8,12 +9,27 @@ int run_config_loader_test()
 
     const char *xml = R"XML(<?xml version="1.0"?>
 <trdpSimulator>
-  <network interface="eth0" hostIp="10.0.0.1" />
+  <network interface="eth0" hostIp="10.0.0.1" sessions="2" mdTcpIdleTimeoutMs="5000" mdMaxSessions="64" />
+  <coordinator listen="tcp:0.0.0.0:17300" launchWorkers="false" />
+  <logging console="false" file="logs/run.log" rotateSizeMb="100" rotateIntervalMinutes="1440" keepFiles="4" compress="false" binaryFile="logs/run.blog" binaryCapacityMb="8" rateLimitPerSecond="5" rateLimitBurst="20">
+    <override category="pd" level="warn" />
+    <override name="DoorStatus" level="debug" />
+  </logging>
+  <watchdog stallThresholdMs="20" />
   <pd>
     <publisher name="Pub" comId="100" cycleTimeMs="500">
       <payload format="hex">0A0B</payload>
     </publisher>
+    <publisher name="Event" comId="101" cycleTimeMs="100" mode="onChange" minIntervalMs="5" keepAliveMs="1000" redundancyGroup="3" />
+    <publisher name="Scheduled" comId="103" cycleTimeMs="10" destIp="239.0.0.3" mode="tsn" launchClock="monotonic" launchOffsetUs="250" />
+    <subscriber name="Poll" comId="102" session="2" role="pullRequester" sourceIp="10.0.0.2" pullIntervalMs="20" />
+    <redundancyGroup id="3" leader="false" failoverIntervalMs="250" />
   </pd>
+  <md>
+    <sender name="Diag" comId="200" destIp="10.0.0.2" transport="tcp" />
+    <sender name="Status" comId="201" destIp="239.0.0.4" cycleTimeMs="10" type="notify" />
+    <listener name="DiagServer" comId="200" transport="tcp" replyType="query" confirmTimeoutMs="250" />
+  </md>
 </trdpSimulator>
 )XML";
 
@@ -23,15 +39,97 @@ int run_config_loader_test()
             std::cerr << "Unexpected interface name: " << config.network.interfaceName << std::endl;
             return 1;
         }
-        if (config.pdPublishers.size() != 1 || config.pdPublishers.front().payload.format != PayloadConfig::Format::Hex) {
+        if (config.pdPublishers.size() != 3 || config.pdPublishers.front().payload.format != PayloadConfig::Format::Hex) {
             std::cerr << "Configuration did not parse PD publisher correctly" << std::endl;
             return 1;
         }
+        const auto &onChange = config.pdPublishers[1];
+        if (onChange.sendMode != PdPublisherConfig::SendMode::OnChange || onChange.minIntervalMs != 5 ||
+            onChange.keepAliveMs != 1000) {
+            std::cerr << "Configuration did not parse on-change PD publisher correctly" << std::endl;
+            return 1;
+        }
+        const auto &tsn = config.pdPublishers.back();
+        if (tsn.sendMode != PdPublisherConfig::SendMode::Tsn ||
+            tsn.launchClock != PdPublisherConfig::LaunchClock::Monotonic || tsn.launchOffsetUs != 250 ||
+            tsn.launchLeadUs != 500) {
+            std::cerr << "Configuration did not parse TSN PD publisher correctly" << std::endl;
+            return 1;
+        }
+        if (config.network.sessions.size() != 2 || config.pdSubscribers.front().session != 2) {
+            std::cerr << "Configuration did not parse TRDP sessions correctly" << std::endl;
+            return 1;
+        }
+        const auto shard = shard_configuration(config, 2);
+        if (!config.coordinator.enabled || config.coordinator.launchWorkers || shard.coordinator.enabled ||
+            shard.network.sessions.size() != 1 || shard.pdSubscribers.size() != 1 ||
+            shard.pdSubscribers.front().session != 0) {
+            std::cerr << "Configuration did not parse coordinator or shard correctly" << std::endl;
+            return 1;
+        }
+        if (config.pdSubscribers.size() != 1 ||
+            config.pdSubscribers.front().role != PdSubscriberConfig::Role::PullRequester ||
+            config.pdSubscribers.front().requestComId != 102 || config.pdSubscribers.front().pullIntervalMs != 20) {
+            std::cerr << "Configuration did not parse PD pull requester correctly" << std::endl;
+            return 1;
+        }
+        if (config.pdRedundancyGroups.size() != 1 || config.pdRedundancyGroups.front().leader ||
+            config.pdRedundancyGroups.front().failoverIntervalMs != 250) {
+            std::cerr << "Configuration did not parse PD redundancy group correctly" << std::endl;
+            return 1;
+        }
+        if (config.network.mdTcpIdleTimeoutMs != 5000 || config.mdSenders.size() != 2 ||
+            config.mdSenders.front().transport != MdTransport::Tcp ||
+            config.mdListeners.front().transport != MdTransport::Tcp) {
+            std::cerr << "Configuration did not parse MD TCP transport correctly" << std::endl;
+            return 1;
+        }
+        if (config.mdSenders.front().type != MdSenderConfig::Type::Request ||
+            config.mdSenders.back().type != MdSenderConfig::Type::Notify ||
+            config.mdListeners.front().replyType != MdListenerConfig::ReplyType::Query ||
+            config.mdListeners.front().confirmTimeoutMs != 250 || config.network.mdMaxSessions != 64 ||
+            !config.watchdog.enabled || config.watchdog.stallThresholdMs != 20 ||
+            config.logging.binaryFilePath != "logs/run.blog" || config.logging.binaryCapacityMb != 8 ||
+            config.logging.rotateSizeMb != 100 || config.logging.rotateIntervalMinutes != 1440 ||
+            config.logging.keepFiles != 4 || config.logging.compressRotated ||
+            config.logging.rateLimit.messagesPerSecond != 5 || config.logging.rateLimit.burst != 20 ||
+            config.logging.overrides.size() != 2 || config.logging.overrides.front().category != "pd" ||
+            config.logging.overrides.back().level != LogLevel::Debug) {
+            std::cerr << "Configuration did not parse MD message types correctly" << std::endl;
+            return 1;
+        }
         validate_configuration(config);
     } catch (const std::exception &ex) {
         std::cerr << "Configuration parsing failed: " << ex.what() << std::endl;
         return 1;
     }
 
+    // Receptions are attributed to a redundancy group by ComID, so only partner groups may share one.
+    std::string shared = R"XML(<?xml version="1.0"?>
+<trdpSimulator>
+  <network interface="eth0" />
+  <pd>
+    <publisher name="LeftA" comId="300" cycleTimeMs="100" redundancyGroup="1" />
+    <publisher name="LeftB" comId="300" cycleTimeMs="100" redundancyGroup="2" />
+    <redundancyGroup id="1" partner="2" />
+  </pd>
+</trdpSimulator>
+)XML";
+    try {
+        (void) load_configuration_from_string(shared);
+    } catch (const std::exception &ex) {
+        std::cerr << "ComID shared by partner redundancy groups was rejected: " << ex.what() << std::endl;
+        return 1;
+    }
+    shared.insert(shared.find("    <redundancyGroup"),
+                  "    <publisher name=\"Other\" comId=\"300\" cycleTimeMs=\"100\" redundancyGroup=\"3\" />\n");
+    try {
+        (void) load_configuration_from_string(shared);
+        std::cerr << "ComID shared by unrelated redundancy groups was accepted" << std::endl;
+        return 1;
+    } catch (const std::exception &) {
+        // Expected path
+    }
+
     return 0;
 }
@@ -0,0 +1,72 @@
+#include "trdp_simulator/http_request.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+namespace trdp_sim {
+
+int run_http_request_tests()
+{
+    const auto spool = std::filesystem::temp_directory_path();
+
+    // Fed one byte at a time, so the header terminator and the body are split across reads.
+    {
+        const std::string raw = "POST /api/config/save?name=demo HTTP/1.1\r\nHost: localhost\r\n"
+                                "content-type: application/xml; charset=utf-8\r\nContent-Length: 6\r\n\r\n<a/>\n\nGET";
+        HttpRequestParser parser(1024, 1U << 20U, spool);
+        for (const char c : raw) {
+            parser.feed(&c, 1);
+        }
+        auto &request = parser.request();
+        if (parser.state() != HttpRequestParser::State::Complete || request.method != "POST" ||
+            request.target != "/api/config/save?name=demo" || request.media_type() != "application/xml" ||
+            request.header("HOST") != "localhost" || request.body != "<a/>\n\n" || !request.bodyFile.empty()) {
+            std::cerr << "HTTP parser did not assemble the request: body '" << request.body << "'" << std::endl;
+            return 1;
+        }
+    }
+
+    // Bodies over the memory limit are streamed to a spool file that goes away with the request.
+    {
+        const std::string body(100000, 'x');
+        const std::string raw = "POST /upload HTTP/1.1\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+        std::filesystem::path spooled;
+        {
+            HttpRequestParser parser(1024, 1U << 20U, spool);
+            for (std::size_t offset = 0; offset < raw.size(); offset += 4096) {
+                parser.feed(raw.data() + offset, std::min<std::size_t>(4096, raw.size() - offset));
+            }
+            auto &request = parser.request();
+            spooled = request.bodyFile;
+            std::ifstream stream(spooled, std::ios::binary);
+            const std::string contents((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+            if (parser.state() != HttpRequestParser::State::Complete || !request.body.empty() || contents != body) {
+                std::cerr << "HTTP parser did not spool the request body" << std::endl;
+                return 1;
+            }
+        }
+        if (spooled.empty() || std::filesystem::exists(spooled)) {
+            std::cerr << "HTTP request body spool file was not removed" << std::endl;
+            return 1;
+        }
+    }
+
+    const auto error_status = [&spool](const std::string &raw) {
+        HttpRequestParser parser(1024, 4096, spool);
+        parser.feed(raw.data(), raw.size());
+        return parser.state() == HttpRequestParser::State::Error ? parser.error_status() : 0;
+    };
+    if (error_status("GET / HTTP/1.1\r\nX-Padding: " + std::string(HttpRequestParser::HeaderLimit, 'p')) != 431 ||
+        error_status("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n") != 501 ||
+        error_status("POST / HTTP/1.1\r\nContent-Length: 5000\r\n\r\n") != 413 ||
+        error_status("POST / HTTP/1.1\r\nContent-Length: 12a\r\n\r\n") != 400 || error_status("garbage\r\n\r\n") != 400) {
+        std::cerr << "HTTP parser accepted a malformed request" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace trdp_sim
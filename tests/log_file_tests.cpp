@@ -0,0 +1,102 @@
+#include "trdp_simulator/log_file.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace trdp_sim {
+namespace {
+
+// The background thread rotates while the writer goes on; pausing now and then gives it the CPU, as the
+// gaps between log lines do in a simulator run.
+void write_lines(RotatingLogFile &file, int count)
+{
+    const std::string line(1023, 'x');
+    for (int i = 0; i < count; ++i) {
+        file.write(line);
+        if (i % 64 == 63) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+int check_rotation()
+{
+    const auto directory = std::filesystem::temp_directory_path() / "trdp-simulator-log-rotation-test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    LoggingConfig config;
+    config.filePath = (directory / "soak.log").string();
+    config.rotateSizeMb = 1;
+    config.keepFiles = 2;
+    std::string errors;
+    {
+        RotatingLogFile file(config, [&errors](const std::string &error) { errors += error + "\n"; });
+        // About 3.5 MiB: three rotations, of which the oldest segment is pruned.
+        write_lines(file, 3584);
+    }
+    // The destructor finishes the queued compression and pruning before the segments are counted.
+    RotatingLogFile reopened(config, [](const std::string &) {});
+    const auto kept = reopened.rotated_segments();
+    const auto currentSize = std::filesystem::file_size(config.filePath);
+    std::filesystem::remove_all(directory);
+
+    if (!errors.empty()) {
+        std::cerr << "Log rotation reported errors: " << errors;
+        return 1;
+    }
+    if (kept.size() != 2 || currentSize >= (1U << 20U)) {
+        std::cerr << "Log rotation kept " << kept.size() << " segment(s) and a " << currentSize
+                  << " byte current file" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// A log file removed from under the simulator cannot be rotated; the writer keeps going and the failure is
+// reported instead.
+int check_rotation_failure()
+{
+    const auto directory = std::filesystem::temp_directory_path() / "trdp-simulator-log-rotation-failure-test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    LoggingConfig config;
+    config.filePath = (directory / "removed.log").string();
+    config.rotateSizeMb = 1;
+    config.keepFiles = 2;
+    std::string errors;
+    std::mutex errorsMutex;
+    {
+        RotatingLogFile file(config, [&errors, &errorsMutex](const std::string &error) {
+            std::lock_guard<std::mutex> lock(errorsMutex);
+            errors += error + "\n";
+        });
+        write_lines(file, 1024);
+        std::filesystem::remove(config.filePath);
+        write_lines(file, 256);
+    }
+    std::filesystem::remove_all(directory);
+
+    if (errors.find("Unable to rotate log file") == std::string::npos) {
+        std::cerr << "Failed log rotation was not reported: '" << errors << "'" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace
+
+int run_log_file_tests()
+{
+    if (check_rotation() != 0) {
+        return 1;
+    }
+    return check_rotation_failure();
+}
+
+}  // namespace trdp_sim
@@ -0,0 +1,67 @@
+#include "trdp_simulator/log_file.hpp"
+#include "trdp_simulator/logger.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+namespace trdp_sim {
+
+int run_logger_tests()
+{
+    Logger logger(LogLevel::Warn);
+    logger.enable_console(false);
+    logger.set_overrides({{"door", 0, "", LogLevel::Debug}, {"", 1000, "", LogLevel::Error}, {"", 0, "pd", LogLevel::Info}},
+                         {10, 2});
+
+    // Name beats ComID beats category; telegrams without an override follow the logger level.
+    auto &door = logger.channel("pd", "door", 1000);
+    auto &brake = logger.channel("pd", "brake", 1000);
+    auto &hvac = logger.channel("pd", "hvac", 2000);
+    auto &pis = logger.channel("md", "pis", 2000);
+    if (!door.enabled(LogLevel::Debug) || brake.enabled(LogLevel::Warn) || !brake.enabled(LogLevel::Error) ||
+        !hvac.enabled(LogLevel::Info) || hvac.enabled(LogLevel::Debug) || pis.enabled(LogLevel::Info) ||
+        !pis.enabled(LogLevel::Warn)) {
+        std::cerr << "Log overrides resolved to unexpected levels" << std::endl;
+        return 1;
+    }
+    if (&logger.channel("pd", "door", 1000) != &door) {
+        std::cerr << "Log channels are not shared per telegram" << std::endl;
+        return 1;
+    }
+
+    const auto directory = std::filesystem::temp_directory_path() / "trdp-simulator-logger-test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    LoggingConfig config;
+    config.filePath = (directory / "filter.log").string();
+    std::string text;
+    {
+        RotatingLogFile file(config, [](const std::string &) {});
+        logger.set_file(&file);
+        // A burst of two, then the bucket is empty until it refills at ten messages per second.
+        const bool admitted = door.admit(LogLevel::Info) && door.admit(LogLevel::Info);
+        const bool limited = !door.admit(LogLevel::Debug) && !door.admit(LogLevel::Warn);
+        std::this_thread::sleep_for(std::chrono::milliseconds(150));
+        const bool refilled = door.admit(LogLevel::Info);
+        logger.set_file(nullptr);
+        if (!admitted || !limited || !refilled) {
+            std::cerr << "Log rate limit admitted unexpected messages" << std::endl;
+            return 1;
+        }
+    }
+    std::ifstream input(config.filePath);
+    text.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    std::filesystem::remove_all(directory);
+    if (text.find("[WARN] Rate limit suppressed 2 log message(s) for 'door'") == std::string::npos) {
+        std::cerr << "Log rate limit summary missing: " << text << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace trdp_sim
@@ -6,6 +6,21 @@
 int run_config_loader_test();
 namespace trdp_sim {
 int run_web_application_tests();
+int run_stall_detector_tests();
+int run_thread_monitor_tests();
+int run_binary_log_tests();
+int run_log_file_tests();
+int run_logger_tests();
+int run_http_request_tests();
+int run_web_assets_tests();
+int run_config_catalog_tests();
+int run_config_history_tests();
+int run_sharded_stack_adapter_tests();
+int run_shard_coordinator_tests();
+int run_tsn_launch_tests();
+int run_stub_adapter_tests();
+int run_pd_redundancy_manager_tests();
+int run_pd_pull_scheduler_tests();
 }
 
 int main()
@@ -45,5 +60,65 @@ int main()
         return 1;
     }
 
+    if (trdp_sim::run_stall_detector_tests() != 0) {
+        return 1;
+    }
+
+    if (trdp_sim::run_thread_monitor_tests() != 0) {
+        return 1;
+    }
+
+    if (trdp_sim::run_binary_log_tests() != 0) {
+        return 1;
+    }
+
+    if (trdp_sim::run_log_file_tests() != 0) {
+        return 1;
+    }
+
+    if (trdp_sim::run_logger_tests() != 0) {
+        return 1;
+    }
+
+    if (trdp_sim::run_http_request_tests() != 0) {
+        return 1;
+    }
+
+    if (trdp_sim::run_web_assets_tests() != 0) {
+        return 1;
+    }
+
+    if (trdp_sim::run_config_catalog_tests() != 0) {
+        return 1;
+    }
+
+    if (trdp_sim::run_config_history_tests() != 0) {
+        return 1;
+    }
+
+    if (trdp_sim::run_sharded_stack_adapter_tests() != 0) {
+        return 1;
+    }
+
+    if (trdp_sim::run_shard_coordinator_tests() != 0) {
+        return 1;
+    }
+
+    if (trdp_sim::run_tsn_launch_tests() != 0) {
+        return 1;
+    }
+
+    if (trdp_sim::run_stub_adapter_tests() != 0) {
+        return 1;
+    }
+
+    if (trdp_sim::run_pd_redundancy_manager_tests() != 0) {
+        return 1;
+    }
+
+    if (trdp_sim::run_pd_pull_scheduler_tests() != 0) {
+        return 1;
+    }
+
     return 0;
 }
@@ -0,0 +1,159 @@
+#include "trdp_simulator/trdp_pd_worker.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trdp_sim {
+
+std::unique_ptr<TrdpStackAdapter> create_stub_trdp_stack_adapter();
+
+namespace {
+
+std::unique_ptr<TrdpStackAdapter> make_adapter()
+{
+    auto adapter = create_stub_trdp_stack_adapter();
+    adapter->initialize(NetworkConfig{}, LoggingConfig{});
+    return adapter;
+}
+
+PdSubscriberConfig requester_config(const std::string &name, std::uint32_t comId, std::uint32_t pullIntervalMs)
+{
+    PdSubscriberConfig config;
+    config.name = name;
+    config.comId = comId;
+    config.role = PdSubscriberConfig::Role::PullRequester;
+    config.pullIntervalMs = pullIntervalMs;
+    return config;
+}
+
+void add_responder(TrdpStackAdapter &adapter, const std::string &name, std::uint32_t comId)
+{
+    PdPublisherConfig responder;
+    responder.name = name;
+    responder.comId = comId;
+    responder.role = PdPublisherConfig::Role::PullResponder;
+    adapter.register_pd_publisher(responder);
+}
+
+const RuntimeMetrics::PdSubscriberStats *subscriber_stats(const RuntimeMetrics::Snapshot &snapshot,
+                                                         const std::string &name)
+{
+    for (const auto &stats : snapshot.pdSubscribers) {
+        if (stats.name == name) {
+            return &stats;
+        }
+    }
+    return nullptr;
+}
+
+// The stub answers pull requests synchronously, so the reply order is the order the scheduler sent them in:
+// both requesters at the start, then four 10 ms requests for every 40 ms one.
+int check_deadline_order()
+{
+    auto adapter = make_adapter();
+    add_responder(*adapter, "FastResponder", 900);
+    add_responder(*adapter, "SlowResponder", 901);
+    Logger logger(LogLevel::Error);
+    RuntimeMetrics metrics;
+    std::vector<std::string> order;
+    std::mutex orderMutex;
+    PdPullScheduler scheduler(*adapter, logger, metrics);
+    for (const auto &config : {requester_config("Fast", 900, 10), requester_config("Slow", 901, 40)}) {
+        scheduler.add_requester(config, [&order, &orderMutex, name = config.name](const PdMessage &) {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(name);
+        });
+    }
+    scheduler.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(130));
+    scheduler.stop();
+    adapter->shutdown();
+
+    std::vector<std::size_t> fastBetweenSlow;
+    std::size_t fast = 0;
+    bool slowSeen = false;
+    for (const auto &name : order) {
+        if (name == "Fast") {
+            ++fast;
+            continue;
+        }
+        if (slowSeen) {
+            fastBetweenSlow.push_back(fast);
+        }
+        slowSeen = true;
+        fast = 0;
+    }
+    if (fastBetweenSlow.size() < 2) {
+        std::cerr << "PD pull scheduler sent " << fastBetweenSlow.size() + 1U << " request(s) of the 40 ms requester"
+                  << std::endl;
+        return 1;
+    }
+    for (const auto count : fastBetweenSlow) {
+        if (count < 3 || count > 5) {
+            std::cerr << "PD pull scheduler sent " << count << " 10 ms request(s) between two 40 ms ones" << std::endl;
+            return 1;
+        }
+    }
+
+    const auto snapshot = metrics.snapshot();
+    for (const auto *name : {"Fast", "Slow"}) {
+        const auto *stats = subscriber_stats(snapshot, name);
+        if (stats == nullptr || stats->pullRepliesReceived != stats->pullRequestsSent || stats->pullRequestsLost != 0 ||
+            stats->pullLatency.count() != stats->pullRequestsSent || stats->pullLatency.max_us() > 10000) {
+            std::cerr << "Pull latency of '" << name << "' was not measured for every answered request" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Without a responder nothing answers; each request supersedes an unanswered one, and a late reply is timed
+// against the latest request only.
+int check_lost_requests()
+{
+    auto adapter = make_adapter();
+    PdPublisherConfig late;
+    late.name = "Late";
+    late.comId = 910;
+    adapter->register_pd_publisher(late);
+    Logger logger(LogLevel::Error);
+    RuntimeMetrics metrics;
+    PdPullScheduler scheduler(*adapter, logger, metrics);
+    scheduler.add_requester(requester_config("Silent", 910, 20), {});
+    scheduler.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(70));
+    adapter->publish_pd("Late", {1});
+    scheduler.stop();
+    adapter->shutdown();
+
+    const auto snapshot = metrics.snapshot();
+    const auto *stats = subscriber_stats(snapshot, "Silent");
+    if (stats == nullptr || stats->pullRequestsSent < 3 || stats->pullRequestsLost != stats->pullRequestsSent - 1U) {
+        std::cerr << "Unanswered pull requests were not counted as lost: "
+                  << (stats != nullptr ? stats->pullRequestsLost : 0) << " of "
+                  << (stats != nullptr ? stats->pullRequestsSent : 0) << std::endl;
+        return 1;
+    }
+    if (stats->pullRepliesReceived != 1 || stats->pullLatency.count() != 1 || stats->pullLatency.max_us() > 30000) {
+        std::cerr << "Late pull reply was not timed against the latest request ("
+                  << stats->pullLatency.max_us() << " us)" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace
+
+int run_pd_pull_scheduler_tests()
+{
+    if (check_deadline_order() != 0) {
+        return 1;
+    }
+    return check_lost_requests();
+}
+
+}  // namespace trdp_sim
@@ -0,0 +1,162 @@
+#include "trdp_simulator/pd_redundancy_manager.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace trdp_sim {
+
+std::unique_ptr<TrdpStackAdapter> create_stub_trdp_stack_adapter();
+
+namespace {
+
+// Group 1 leads and is partnered with the undeclared group 2, which therefore starts as follower; both
+// publish ComID 100 with a 20 ms cycle.
+SimulatorConfig partnered_config(std::uint32_t failoverIntervalMs)
+{
+    SimulatorConfig config;
+    PdPublisherConfig publisher;
+    publisher.name = "Left";
+    publisher.comId = 100;
+    publisher.cycleTimeMs = 20;
+    publisher.redundancyGroup = 1;
+    config.pdPublishers.push_back(publisher);
+    publisher.name = "Right";
+    publisher.redundancyGroup = 2;
+    config.pdPublishers.push_back(publisher);
+    PdRedundancyGroupConfig group;
+    group.id = 1;
+    group.leader = true;
+    group.partnerId = 2;
+    group.failoverIntervalMs = failoverIntervalMs;
+    config.pdRedundancyGroups.push_back(group);
+    return config;
+}
+
+std::unique_ptr<TrdpStackAdapter> make_adapter(const SimulatorConfig &config)
+{
+    auto adapter = create_stub_trdp_stack_adapter();
+    adapter->initialize(NetworkConfig{}, LoggingConfig{});
+    for (const auto &publisher : config.pdPublishers) {
+        adapter->register_pd_publisher(publisher);
+    }
+    return adapter;
+}
+
+const RuntimeMetrics::PdRedundancyGroupStats *group_stats(const RuntimeMetrics::Snapshot &snapshot, std::uint32_t id)
+{
+    for (const auto &stats : snapshot.pdRedundancyGroups) {
+        if (stats.id == id) {
+            return &stats;
+        }
+    }
+    return nullptr;
+}
+
+int check_failover()
+{
+    const auto config = partnered_config(0);
+    auto adapter = make_adapter(config);
+    Logger logger(LogLevel::Error);
+    RuntimeMetrics metrics;
+    PdRedundancyManager manager(config, *adapter, logger, metrics);
+    manager.apply_initial_state();
+    if (!adapter->pd_redundancy_leader(1) || adapter->pd_redundancy_leader(2)) {
+        std::cerr << "Partner of a leading redundancy group did not start as follower" << std::endl;
+        return 1;
+    }
+
+    std::string error;
+    if (!manager.failover(1, error) || adapter->pd_redundancy_leader(1) || !adapter->pd_redundancy_leader(2)) {
+        std::cerr << "Failover did not swap the roles of the partner groups: " << error << std::endl;
+        return 1;
+    }
+    const auto snapshot = metrics.snapshot();
+    const auto *left = group_stats(snapshot, 1);
+    const auto *right = group_stats(snapshot, 2);
+    if (left == nullptr || right == nullptr || left->leader || !right->leader || left->failovers != 1 ||
+        right->failovers != 1) {
+        std::cerr << "Failover was not reported for both partner groups" << std::endl;
+        return 1;
+    }
+    if (manager.failover(9, error) || error.empty()) {
+        std::cerr << "Failover of an unknown redundancy group did not fail" << std::endl;
+        return 1;
+    }
+    adapter->shutdown();
+    return 0;
+}
+
+// A reception only measures a gap when a switchover happened since the previous one; gaps beyond two
+// cycles (40 ms) count as delayed delivery.
+int check_switchover_gap()
+{
+    const auto config = partnered_config(0);
+    auto adapter = make_adapter(config);
+    Logger logger(LogLevel::Error);
+    RuntimeMetrics metrics;
+    PdRedundancyManager manager(config, *adapter, logger, metrics);
+    manager.apply_initial_state();
+
+    std::string error;
+    manager.on_receive("Watcher", 100);
+    manager.on_receive("Watcher", 100);
+    manager.on_receive("Unrelated", 999);
+    manager.failover(1, error);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    manager.on_receive("Watcher", 100);
+    manager.failover(2, error);
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    manager.on_receive("Watcher", 100);
+
+    const auto snapshot = metrics.snapshot();
+    if (snapshot.pdSubscribers.size() != 1 || snapshot.pdSubscribers.front().name != "Watcher") {
+        std::cerr << "Switchover gaps were recorded for receptions outside a redundancy group" << std::endl;
+        return 1;
+    }
+    const auto &watcher = snapshot.pdSubscribers.front();
+    if (watcher.switchoverGap.count() != 2 || watcher.switchoversOverCycle != 1 ||
+        watcher.switchoverGap.sum_us() < 65000) {
+        std::cerr << "Switchover gaps were not measured per failover (" << watcher.switchoverGap.count() << " gaps, "
+                  << watcher.switchoversOverCycle << " over cycle)" << std::endl;
+        return 1;
+    }
+    adapter->shutdown();
+    return 0;
+}
+
+int check_scheduled_failover()
+{
+    const auto config = partnered_config(20);
+    auto adapter = make_adapter(config);
+    Logger logger(LogLevel::Error);
+    RuntimeMetrics metrics;
+    PdRedundancyManager manager(config, *adapter, logger, metrics);
+    manager.apply_initial_state();
+    manager.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(110));
+    manager.stop();
+
+    const auto snapshot = metrics.snapshot();
+    const auto *left = group_stats(snapshot, 1);
+    if (left == nullptr || left->failovers < 3 || left->failovers > 6) {
+        std::cerr << "Scheduled failover did not run every failoverIntervalMs: "
+                  << (left != nullptr ? left->failovers : 0) << " failovers in 110 ms" << std::endl;
+        return 1;
+    }
+    adapter->shutdown();
+    return 0;
+}
+
+}  // namespace
+
+int run_pd_redundancy_manager_tests()
+{
+    if (check_failover() != 0 || check_switchover_gap() != 0) {
+        return 1;
+    }
+    return check_scheduled_failover();
+}
+
+}  // namespace trdp_sim
@@ -0,0 +1,270 @@
+#include "trdp_simulator/shard_coordinator.hpp"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "trdp_simulator/sharded_stack_adapter.hpp"
+
+namespace trdp_sim {
+namespace {
+
+SimulatorConfig two_session_config()
+{
+    SimulatorConfig config;
+    config.coordinator.enabled = true;
+    config.network.hostIp = "10.0.0.1";
+    config.network.sessions = {{std::string(), 0, 0, 1}, {"10.0.0.2", 20000, 20001, 2}};
+    config.logging.filePath = "/var/log/trdp/sim.log";
+
+    PdPublisherConfig publisher;
+    publisher.name = "Pinned";
+    publisher.comId = 10;
+    publisher.session = 2;
+    config.pdPublishers.push_back(publisher);
+    for (std::uint32_t comId = 100; comId < 140; ++comId) {
+        publisher.name = "Hashed" + std::to_string(comId);
+        publisher.comId = comId;
+        publisher.session = 0;
+        config.pdPublishers.push_back(publisher);
+    }
+    publisher.name = "Redundant";
+    publisher.comId = 20;
+    publisher.session = 1;
+    publisher.redundancyGroup = 7;
+    config.pdPublishers.push_back(publisher);
+    PdRedundancyGroupConfig group;
+    group.id = 7;
+    config.pdRedundancyGroups.push_back(group);
+
+    PdSubscriberConfig subscriber;
+    subscriber.name = "Subscriber";
+    subscriber.comId = 10;
+    subscriber.session = 2;
+    config.pdSubscribers.push_back(subscriber);
+    MdSenderConfig sender;
+    sender.name = "Sender";
+    sender.comId = 30;
+    sender.session = 1;
+    config.mdSenders.push_back(sender);
+    MdListenerConfig listener;
+    listener.name = "Listener";
+    listener.comId = 31;
+    config.mdListeners.push_back(listener);
+    return config;
+}
+
+int check_shard_configuration()
+{
+    const auto config = two_session_config();
+    if (shard_count(config) != 2 || shard_count(SimulatorConfig{}) != 1) {
+        std::cerr << "Shard count does not follow the configured sessions" << std::endl;
+        return 1;
+    }
+
+    const auto first = shard_configuration(config, 1);
+    const auto second = shard_configuration(config, 2);
+    if (first.coordinator.enabled || second.network.sessions.size() != 1 || second.network.sessions.front().cpu != 2) {
+        std::cerr << "Shard configuration did not reduce the scenario to a single uncoordinated session" << std::endl;
+        return 1;
+    }
+    if (first.network.hostIp != "10.0.0.1" || second.network.hostIp != "10.0.0.2" || second.network.pdPort != 20000 ||
+        second.network.mdPort != 20001) {
+        std::cerr << "Shard configuration did not apply the session's network overrides" << std::endl;
+        return 1;
+    }
+    if (second.logging.filePath != "/var/log/trdp/sim.shard2.log") {
+        std::cerr << "Shard log file was not renamed: " << second.logging.filePath << std::endl;
+        return 1;
+    }
+
+    // Every telegram runs in exactly the shard the in-process adapter would have picked, with its session cleared.
+    if (first.pdPublishers.size() + second.pdPublishers.size() != config.pdPublishers.size()) {
+        std::cerr << "PD publishers were lost or duplicated when splitting the scenario" << std::endl;
+        return 1;
+    }
+    for (const auto &publisher : config.pdPublishers) {
+        const auto &shard = ShardedTrdpStackAdapter::shard_for(publisher.session, publisher.comId, 2) == 0 ? first
+                                                                                                            : second;
+        bool found = false;
+        for (const auto &kept : shard.pdPublishers) {
+            found = found || (kept.name == publisher.name && kept.session == 0);
+        }
+        if (!found) {
+            std::cerr << "PD publisher '" << publisher.name << "' is not in its shard" << std::endl;
+            return 1;
+        }
+    }
+    if (second.pdSubscribers.size() != 1 || first.mdSenders.size() != 1 || !second.mdSenders.empty() ||
+        first.mdListeners.size() + second.mdListeners.size() != 1) {
+        std::cerr << "Subscribers and MD telegrams were not split by session" << std::endl;
+        return 1;
+    }
+    if (first.pdRedundancyGroups.size() != 1 || !second.pdRedundancyGroups.empty()) {
+        std::cerr << "Redundancy group was not kept only in the shard of its publisher" << std::endl;
+        return 1;
+    }
+
+    try {
+        (void) shard_configuration(config, 3);
+        std::cerr << "Shard outside the session range was accepted" << std::endl;
+        return 1;
+    } catch (const std::exception &) {
+        // Expected path
+    }
+    return 0;
+}
+
+RuntimeMetrics::Snapshot sample_snapshot(const std::string &prefix, std::uint64_t sends)
+{
+    RuntimeMetrics metrics;
+    metrics.set_simulator_running(true);
+    for (std::uint64_t i = 0; i < sends; ++i) {
+        metrics.record_pd_publish(prefix + " publisher");
+        metrics.record_md_tcp_exchange("10.0.0.9:17225");
+    }
+    metrics.record_pd_receive(prefix + " subscriber");
+    metrics.record_pd_pull_reply(prefix + " subscriber", 1500);
+    metrics.record_pd_redundancy_state(7, true, true);
+    metrics.record_topology_update(3, 4, 2);
+    metrics.record_topology_stale_window(250, true);
+    metrics.record_md_request_sent(prefix + " sender");
+    metrics.record_md_reply_timeout(prefix + " sender");
+    metrics.record_md_request_received(prefix + " listener");
+    metrics.record_md_session_opened(true);
+    metrics.record_loop_stall(prefix + " loop", "frame 0\nframe 1");
+    return metrics.snapshot();
+}
+
+int check_snapshot_encoding()
+{
+    const auto original = sample_snapshot("Shard one", 3);
+    const auto decoded = RuntimeMetrics::decode_snapshot(RuntimeMetrics::encode_snapshot(original));
+    if (!decoded.simulatorRunning || decoded.pdPublishers.size() != 1 ||
+        decoded.pdPublishers.front().name != "Shard one publisher" || decoded.pdPublishers.front().packetsSent != 3) {
+        std::cerr << "Encoded snapshot lost its PD publisher counters" << std::endl;
+        return 1;
+    }
+    const auto &subscriber = decoded.pdSubscribers.front();
+    if (decoded.pdSubscribers.size() != 1 || subscriber.packetsReceived != 1 || subscriber.pullLatency.count() != 1 ||
+        subscriber.pullLatency.sum_us() != 1500) {
+        std::cerr << "Encoded snapshot lost its PD subscriber counters" << std::endl;
+        return 1;
+    }
+    if (decoded.topology.etbTopoCount != 3 || decoded.topology.opTrnTopoCount != 4 ||
+        decoded.topology.telegramsUpdated != 2 || decoded.pdRedundancyGroups.size() != 1 ||
+        decoded.pdRedundancyGroups.front().failovers != 1) {
+        std::cerr << "Encoded snapshot lost its topology or redundancy state" << std::endl;
+        return 1;
+    }
+    if (decoded.mdSenders.size() != 1 || decoded.mdSenders.front().replyTimeouts != 1 ||
+        decoded.mdListeners.size() != 1 || decoded.mdTcpPeers.size() != 1 ||
+        decoded.mdTcpPeers.front().exchanges != 3 || decoded.mdSessions.callerPeak != 1) {
+        std::cerr << "Encoded snapshot lost its MD counters" << std::endl;
+        return 1;
+    }
+    if (decoded.loops.size() != 1 || decoded.loops.front().lastStallTrace != "frame 0\nframe 1") {
+        std::cerr << "Encoded snapshot did not preserve a multi-line stall trace" << std::endl;
+        return 1;
+    }
+
+    RuntimeMetrics::Snapshot merged;
+    RuntimeMetrics::merge_snapshot(merged, decoded);
+    RuntimeMetrics::merge_snapshot(merged,
+                                   RuntimeMetrics::decode_snapshot(RuntimeMetrics::encode_snapshot(
+                                       sample_snapshot("Shard two", 2))));
+    if (merged.pdPublishers.size() != 2 || merged.pdSubscribers.size() != 2 || merged.mdSenders.size() != 2) {
+        std::cerr << "Merged snapshot does not list the telegrams of both shards" << std::endl;
+        return 1;
+    }
+    // Both shards talk to the same TCP peer and report the same redundancy group.
+    if (merged.mdTcpPeers.size() != 1 || merged.mdTcpPeers.front().exchanges != 5 ||
+        merged.pdRedundancyGroups.size() != 1 || merged.pdRedundancyGroups.front().failovers != 1 ||
+        merged.topology.telegramsUpdated != 4) {
+        std::cerr << "Merged snapshot did not combine shared peers, groups and topology" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int check_coordinator()
+{
+    SimulatorConfig config = two_session_config();
+    config.coordinator.listen = "unix:/tmp/trdpsim-coordinator-test-" + std::to_string(::getpid()) + ".sock";
+    config.coordinator.launchWorkers = false;
+    config.coordinator.startDelayMs = 20;
+    config.coordinator.connectTimeoutMs = 5000;
+    Logger logger(LogLevel::Error);
+    ShardCoordinator coordinator(config, logger);
+
+    std::string error;
+    std::thread starter([&coordinator, &error] {
+        try {
+            coordinator.start();
+        } catch (const std::exception &ex) {
+            error = ex.what();
+        }
+    });
+    // Both links retry until the coordinator listens, then announce themselves.
+    ShardWorkerLink second(config.coordinator.listen, 2, 2, 5000);
+    ShardWorkerLink first(config.coordinator.listen, 1, 2, 5000);
+    first.wait_for_start();
+    second.wait_for_start();
+    starter.join();
+    if (!error.empty()) {
+        std::cerr << "Coordinator failed to start: " << error << std::endl;
+        return 1;
+    }
+
+    std::atomic<int> stopRequests{0};
+    first.start_reporting([] { return sample_snapshot("Shard one", 3); }, 20, [&stopRequests] { ++stopRequests; });
+    second.start_reporting([] { return sample_snapshot("Shard two", 2); }, 20, [&stopRequests] { ++stopRequests; });
+
+    RuntimeMetrics::Snapshot merged;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+        merged = coordinator.metrics_snapshot();
+        if (merged.pdPublishers.size() == 2) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (!merged.adapterInitialized || merged.pdPublishers.size() != 2 || merged.mdTcpPeers.size() != 1 ||
+        merged.mdTcpPeers.front().exchanges != 5) {
+        std::cerr << "Coordinator did not aggregate the metrics of both worker shards (" << merged.adapterState << ")"
+                  << std::endl;
+        return 1;
+    }
+
+    // As in a worker process, the links disconnect once the coordinator has asked them to stop; the coordinator
+    // waits for that before it closes the connections.
+    std::thread stopper([&coordinator] { coordinator.stop(); });
+    const auto stopDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (stopRequests.load() < 2 && std::chrono::steady_clock::now() < stopDeadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    first.stop();
+    second.stop();
+    stopper.join();
+    if (stopRequests.load() != 2) {
+        std::cerr << "Worker links did not pass on the coordinator's stop request" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace
+
+int run_shard_coordinator_tests()
+{
+    if (check_shard_configuration() != 0 || check_snapshot_encoding() != 0) {
+        return 1;
+    }
+    return check_coordinator();
+}
+
+}  // namespace trdp_sim
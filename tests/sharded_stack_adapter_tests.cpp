@@ -0,0 +1,217 @@
+#include "trdp_simulator/sharded_stack_adapter.hpp"
+
+#include <array>
+#include <iostream>
+#include <set>
+#include <string>
+
+namespace trdp_sim {
+
+std::unique_ptr<TrdpStackAdapter> create_stub_trdp_stack_adapter();
+
+namespace {
+
+int check_shard_for()
+{
+    // Sessions are 1-based in the configuration and wrap around the session count.
+    if (ShardedTrdpStackAdapter::shard_for(1, 999, 4) != 0 || ShardedTrdpStackAdapter::shard_for(4, 1, 4) != 3 ||
+        ShardedTrdpStackAdapter::shard_for(6, 1, 4) != 1) {
+        std::cerr << "Explicit session assignment did not select the configured session" << std::endl;
+        return 1;
+    }
+
+    std::array<std::size_t, 4> counts{};
+    for (std::uint32_t comId = 1; comId <= 4000; ++comId) {
+        const auto shard = ShardedTrdpStackAdapter::shard_for(0, comId, counts.size());
+        if (shard >= counts.size()) {
+            std::cerr << "ComID " << comId << " was hashed outside the session range" << std::endl;
+            return 1;
+        }
+        ++counts[shard];
+        if (shard != ShardedTrdpStackAdapter::shard_for(0, comId, counts.size())) {
+            std::cerr << "ComID hashing is not stable" << std::endl;
+            return 1;
+        }
+    }
+    for (const auto count : counts) {
+        if (count < 800 || count > 1200) {
+            std::cerr << "ComID hashing spread 4000 telegrams unevenly: " << count << " on one session" << std::endl;
+            return 1;
+        }
+    }
+
+    // ComIDs that are multiples of the session count must not all land on one session.
+    std::set<std::size_t> used;
+    for (std::uint32_t comId = 4; comId <= 400; comId += 4) {
+        used.insert(ShardedTrdpStackAdapter::shard_for(0, comId, 4));
+    }
+    if (used.size() != 4) {
+        std::cerr << "Multiples of the session count were hashed onto " << used.size() << " sessions" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Each shard is a separate stub instance, which loops telegrams back only within itself, so a telegram is
+// delivered exactly when publisher and subscriber were routed to the same session.
+int check_routing()
+{
+    ShardedTrdpStackAdapter adapter(3, &create_stub_trdp_stack_adapter);
+    NetworkConfig network;
+    network.sessions.resize(3);
+    adapter.initialize(network, LoggingConfig{});
+    if (adapter.poll_partitions() != 3) {
+        std::cerr << "Sharded adapter does not expose one poll partition per session" << std::endl;
+        return 1;
+    }
+
+    std::size_t sameSession = 0;
+    std::size_t otherSession = 0;
+    std::size_t hashed = 0;
+    PdPublisherConfig pinned;
+    pinned.name = "Pinned";
+    pinned.comId = 100;
+    pinned.session = 2;
+    adapter.register_pd_publisher(pinned);
+    PdSubscriberConfig subscriber;
+    subscriber.name = "SameSession";
+    subscriber.comId = 100;
+    subscriber.session = 2;
+    adapter.register_pd_subscriber(subscriber, [&sameSession](const PdMessage &) { ++sameSession; });
+    subscriber.name = "OtherSession";
+    subscriber.session = 3;
+    adapter.register_pd_subscriber(subscriber, [&otherSession](const PdMessage &) { ++otherSession; });
+
+    PdPublisherConfig unassigned;
+    unassigned.name = "Hashed";
+    unassigned.comId = 200;
+    adapter.register_pd_publisher(unassigned);
+    subscriber.name = "HashedSubscriber";
+    subscriber.comId = 200;
+    subscriber.session = 0;
+    adapter.register_pd_subscriber(subscriber, [&hashed](const PdMessage &) { ++hashed; });
+
+    adapter.publish_pd("Pinned", {1, 2, 3});
+    adapter.publish_pd("Hashed", {4});
+    if (sameSession != 1 || otherSession != 0) {
+        std::cerr << "PD telegram was not routed to its configured session (same " << sameSession << ", other "
+                  << otherSession << ")" << std::endl;
+        return 1;
+    }
+    if (hashed != 1) {
+        std::cerr << "Unassigned publisher and subscriber of one ComID were not routed to the same session"
+                  << std::endl;
+        return 1;
+    }
+
+    std::size_t requests = 0;
+    MdListenerConfig listener;
+    listener.name = "Listener";
+    listener.comId = 300;
+    listener.session = 2;
+    adapter.register_md_listener(listener, [&requests](const MdMessage &) { ++requests; });
+    MdSenderConfig sender;
+    sender.name = "Elsewhere";
+    sender.comId = 300;
+    sender.session = 1;
+    adapter.register_md_sender(sender, [](const MdMessage &) {}, [](const MdSessionId &) {});
+    sender.name = "Alongside";
+    sender.session = 2;
+    adapter.register_md_sender(sender, [](const MdMessage &) {}, [](const MdSessionId &) {});
+    adapter.send_md_request("Elsewhere", {1});
+    adapter.send_md_request("Alongside", {1});
+    if (requests != 1) {
+        std::cerr << "MD requests were not routed by session: listener saw " << requests << std::endl;
+        return 1;
+    }
+
+    try {
+        adapter.publish_pd("Unknown", {1});
+        std::cerr << "Publishing an unregistered telegram did not fail" << std::endl;
+        return 1;
+    } catch (const std::exception &) {
+        // Expected path
+    }
+    adapter.shutdown();
+    return 0;
+}
+
+// Partner groups 1 and 2 sit on different sessions and group 3 spans both; every state has to reach exactly
+// the sessions that publish for its group.
+int check_redundancy()
+{
+    ShardedTrdpStackAdapter adapter(2, &create_stub_trdp_stack_adapter);
+    NetworkConfig network;
+    network.sessions.resize(2);
+    adapter.initialize(network, LoggingConfig{});
+
+    PdPublisherConfig publisher;
+    publisher.name = "Left";
+    publisher.comId = 100;
+    publisher.session = 1;
+    publisher.redundancyGroup = 1;
+    adapter.register_pd_publisher(publisher);
+    publisher.name = "Right";
+    publisher.session = 2;
+    publisher.redundancyGroup = 2;
+    adapter.register_pd_publisher(publisher);
+    publisher.comId = 300;
+    publisher.redundancyGroup = 3;
+    for (const std::uint32_t session : {1U, 2U}) {
+        publisher.name = "Spanning" + std::to_string(session);
+        publisher.session = session;
+        adapter.register_pd_publisher(publisher);
+    }
+    std::size_t spanning = 0;
+    PdSubscriberConfig subscriber;
+    subscriber.comId = 300;
+    for (const std::uint32_t session : {1U, 2U}) {
+        subscriber.name = "SpanningSubscriber" + std::to_string(session);
+        subscriber.session = session;
+        adapter.register_pd_subscriber(subscriber, [&spanning](const PdMessage &) { ++spanning; });
+    }
+
+    try {
+        adapter.set_pd_redundancy({{1, true}, {2, false}, {3, true}});
+    } catch (const std::exception &ex) {
+        std::cerr << "Redundancy state was sent to a session without the group: " << ex.what() << std::endl;
+        return 1;
+    }
+    if (!adapter.pd_redundancy_leader(1) || adapter.pd_redundancy_leader(2) || !adapter.pd_redundancy_leader(3)) {
+        std::cerr << "Initial redundancy roles were not applied per session" << std::endl;
+        return 1;
+    }
+    adapter.publish_pd("Spanning1", {1});
+    adapter.publish_pd("Spanning2", {1});
+    if (spanning != 2) {
+        std::cerr << "Redundancy group spanning two sessions leads on " << spanning << " of them" << std::endl;
+        return 1;
+    }
+
+    adapter.set_pd_redundancy({{1, false}, {2, true}});
+    if (adapter.pd_redundancy_leader(1) || !adapter.pd_redundancy_leader(2)) {
+        std::cerr << "Failover across sessions did not swap the partner roles" << std::endl;
+        return 1;
+    }
+    try {
+        adapter.set_pd_redundancy({{9, true}});
+        std::cerr << "Redundancy state of an unknown group was accepted" << std::endl;
+        return 1;
+    } catch (const std::exception &) {
+        // Expected path
+    }
+    adapter.shutdown();
+    return 0;
+}
+
+}  // namespace
+
+int run_sharded_stack_adapter_tests()
+{
+    if (check_shard_for() != 0 || check_routing() != 0) {
+        return 1;
+    }
+    return check_redundancy();
+}
+
+}  // namespace trdp_sim
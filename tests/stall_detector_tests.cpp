@@ -0,0 +1,58 @@
+#include "trdp_simulator/stall_detector.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace trdp_sim {
+
+int run_stall_detector_tests()
+{
+    WatchdogConfig config;
+    config.stallThresholdMs = 20;
+    Logger logger(LogLevel::Error);
+    RuntimeMetrics metrics;
+
+    {
+        StallDetector detector(config, logger, metrics);
+        detector.start();
+        std::thread loop([&detector] {
+            auto &probe = detector.attach("test-loop");
+            for (int cycle = 0; cycle < 3; ++cycle) {
+                const auto interval = std::chrono::milliseconds(5);
+                probe.sleeping_until(std::chrono::steady_clock::now() + interval);
+                // The second cycle oversleeps as a blocked handler would.
+                std::this_thread::sleep_for(cycle == 1 ? std::chrono::milliseconds(150) : interval);
+                probe.woke();
+            }
+            detector.detach(probe);
+        });
+        loop.join();
+        detector.stop();
+    }
+
+    const auto snapshot = metrics.snapshot();
+    if (snapshot.loops.size() != 1 || snapshot.loops.front().name != "test-loop") {
+        std::cerr << "Stall detector did not report the probed loop" << std::endl;
+        return 1;
+    }
+    const auto &loop = snapshot.loops.front();
+    if (loop.lag.count() != 3 || loop.lag.max_us() < 100000) {
+        std::cerr << "Stall detector recorded unexpected lag (" << loop.lag.count() << " samples, max "
+                  << loop.lag.max_us() << " us)" << std::endl;
+        return 1;
+    }
+    if (loop.stalls != 1) {
+        std::cerr << "Expected one stall, got " << loop.stalls << std::endl;
+        return 1;
+    }
+#ifdef __linux__
+    if (loop.lastStallTrace.empty()) {
+        std::cerr << "Stall detector did not capture the stalled thread's stack" << std::endl;
+        return 1;
+    }
+#endif
+    return 0;
+}
+
+}  // namespace trdp_sim
@@ -0,0 +1,516 @@
+#include "trdp_simulator/config_loader.hpp"
+#include "trdp_simulator/log_file.hpp"
+#include "trdp_simulator/simulator.hpp"
+#include "trdp_simulator/trdp_md_worker.hpp"
+#include "trdp_simulator/trdp_pd_worker.hpp"
+#include "trdp_simulator/trdp_stack_adapter.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trdp_sim {
+
+std::unique_ptr<TrdpStackAdapter> create_stub_trdp_stack_adapter();
+
+namespace {
+
+struct SessionCounts {
+    std::size_t opened{0};
+    std::size_t closed{0};
+    std::size_t timedOut{0};
+
+    std::size_t open() const { return opened - closed - timedOut; }
+};
+
+std::unique_ptr<TrdpStackAdapter> make_adapter(SessionCounts &sessions, std::uint32_t maxSessions = 1000)
+{
+    auto adapter = create_stub_trdp_stack_adapter();
+    NetworkConfig network;
+    network.mdMaxSessions = maxSessions;
+    adapter->initialize(network, LoggingConfig{});
+    adapter->set_md_session_handler([&sessions](const MdSessionEvent &event) {
+        if (event.role != MdSessionEvent::Role::Caller) {
+            return;
+        }
+        switch (event.kind) {
+        case MdSessionEvent::Kind::Opened:
+            ++sessions.opened;
+            break;
+        case MdSessionEvent::Kind::Closed:
+            ++sessions.closed;
+            break;
+        case MdSessionEvent::Kind::TimedOut:
+            ++sessions.timedOut;
+            break;
+        }
+    });
+    return adapter;
+}
+
+// A caller waiting for a reply nobody sends holds a session until its reply timeout, and no longer.
+int check_md_reply_timeout()
+{
+    SessionCounts sessions;
+    auto adapter = make_adapter(sessions, 3);
+    std::size_t replies = 0;
+    std::size_t timeouts = 0;
+    MdSenderConfig sender;
+    sender.name = "Unanswered";
+    sender.comId = 500;
+    sender.expectReply = true;
+    sender.replyTimeoutMs = 30;
+    adapter->register_md_sender(sender, [&replies](const MdMessage &) { ++replies; },
+                                [&timeouts](const MdSessionId &) { ++timeouts; });
+
+    for (int request = 0; request < 3; ++request) {
+        adapter->send_md_request("Unanswered", {1});
+    }
+    try {
+        adapter->send_md_request("Unanswered", {1});
+        std::cerr << "MD request was accepted with the session table full" << std::endl;
+        return 1;
+    } catch (const std::exception &) {
+        // Expected path
+    }
+    if (sessions.open() != 3 || timeouts != 0) {
+        std::cerr << "Unanswered MD requests did not hold their sessions until the reply timeout" << std::endl;
+        return 1;
+    }
+
+    adapter->poll(std::chrono::milliseconds(80));
+    if (timeouts != 3 || sessions.timedOut != 3 || sessions.open() != 0 || replies != 0) {
+        std::cerr << "Reply timeouts did not fire and release the sessions (" << timeouts << " timeouts, "
+                  << sessions.open() << " open)" << std::endl;
+        return 1;
+    }
+
+    // Released sessions make room again, so the table stays bounded under a steady stream of requests.
+    for (int round = 0; round < 5; ++round) {
+        for (int request = 0; request < 3; ++request) {
+            adapter->send_md_request("Unanswered", {1});
+        }
+        adapter->poll(std::chrono::milliseconds(60));
+    }
+    adapter->shutdown();
+    if (timeouts != 18 || sessions.open() != 0) {
+        std::cerr << "MD sessions were not released under repeated timeouts: " << timeouts << " timeouts" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Notifications (Mn) reach the listener without a session, so a full session table does not hold them back.
+int check_md_notification()
+{
+    SessionCounts sessions;
+    auto adapter = make_adapter(sessions, 1);
+    std::vector<MdMessage> received;
+    MdListenerConfig listener;
+    listener.name = "Display";
+    listener.comId = 800;
+    adapter->register_md_listener(listener, [&received](const MdMessage &message) { received.push_back(message); });
+    std::size_t replies = 0;
+    MdSenderConfig sender;
+    sender.name = "Announcer";
+    sender.comId = 800;
+    sender.type = MdSenderConfig::Type::Notify;
+    adapter->register_md_sender(sender, [&replies](const MdMessage &) { ++replies; }, [](const MdSessionId &) {});
+
+    for (std::uint8_t index = 0; index < 5; ++index) {
+        adapter->send_md_request("Announcer", {index});
+    }
+    adapter->shutdown();
+    if (received.size() != 5 || received.back().type != MdMessageType::Notification ||
+        received.back().payload != std::vector<std::uint8_t>{4}) {
+        std::cerr << "MD notifications were not delivered to the listener: " << received.size() << std::endl;
+        return 1;
+    }
+    if (sessions.opened != 0 || replies != 0) {
+        std::cerr << "MD notifications opened " << sessions.opened << " session(s) or received replies" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// A plain reply (Mp) closes the caller session it answers.
+int check_md_request_reply()
+{
+    SessionCounts sessions;
+    auto adapter = make_adapter(sessions);
+    auto *stack = adapter.get();
+    MdListenerConfig listener;
+    listener.name = "Server";
+    listener.comId = 810;
+    adapter->register_md_listener(listener, [stack](const MdMessage &request) {
+        stack->send_md_reply("Server", request, {static_cast<std::uint8_t>(request.payload.front() + 1U)});
+    });
+    std::vector<MdMessage> replies;
+    std::size_t timeouts = 0;
+    MdSenderConfig sender;
+    sender.name = "Client";
+    sender.comId = 810;
+    sender.expectReply = true;
+    sender.replyTimeoutMs = 30;
+    adapter->register_md_sender(sender, [&replies](const MdMessage &reply) { replies.push_back(reply); },
+                                [&timeouts](const MdSessionId &) { ++timeouts; });
+
+    adapter->send_md_request("Client", {7});
+    adapter->send_md_request("Client", {8});
+    adapter->poll(std::chrono::milliseconds(60));
+    adapter->shutdown();
+    if (replies.size() != 2 || replies.front().type != MdMessageType::Reply ||
+        replies.back().payload != std::vector<std::uint8_t>{9}) {
+        std::cerr << "MD requests were not answered with replies: " << replies.size() << std::endl;
+        return 1;
+    }
+    if (sessions.opened != 2 || sessions.closed != 2 || sessions.open() != 0 || timeouts != 0) {
+        std::cerr << "Replies did not close their caller sessions (" << sessions.open() << " open, " << timeouts
+                  << " timeouts)" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// A reply query (Mq) keeps the caller session open until the caller confirms (Mc) or the confirm timeout.
+int check_md_reply_query_confirm()
+{
+    SessionCounts sessions;
+    auto adapter = make_adapter(sessions);
+    auto *stack = adapter.get();
+    std::size_t confirms = 0;
+    MdListenerConfig listener;
+    listener.name = "Server";
+    listener.comId = 820;
+    listener.replyType = MdListenerConfig::ReplyType::Query;
+    listener.confirmTimeoutMs = 30;
+    adapter->register_md_listener(listener, [stack, &confirms](const MdMessage &message) {
+        if (message.type == MdMessageType::Confirm) {
+            ++confirms;
+        } else {
+            stack->send_md_reply("Server", message, {1});
+        }
+    });
+    std::vector<MdMessage> queries;
+    std::size_t timeouts = 0;
+    MdSenderConfig sender;
+    sender.name = "Client";
+    sender.comId = 820;
+    sender.expectReply = true;
+    adapter->register_md_sender(sender, [&queries](const MdMessage &reply) { queries.push_back(reply); },
+                                [&timeouts](const MdSessionId &) { ++timeouts; });
+
+    adapter->send_md_request("Client", {1});
+    if (queries.size() != 1 || queries.front().type != MdMessageType::ReplyQuery || sessions.open() != 1) {
+        std::cerr << "Reply query did not keep the caller session open for the confirmation" << std::endl;
+        return 1;
+    }
+    adapter->send_md_confirm("Client", queries.front());
+    if (confirms != 1 || sessions.closed != 1 || sessions.open() != 0) {
+        std::cerr << "Confirmation did not reach the listener and close the session" << std::endl;
+        return 1;
+    }
+    try {
+        adapter->send_md_confirm("Client", queries.front());
+        std::cerr << "Reply query was confirmed twice" << std::endl;
+        return 1;
+    } catch (const std::exception &) {
+        // Expected path
+    }
+
+    // An unconfirmed reply query is released after confirmTimeoutMs.
+    adapter->send_md_request("Client", {2});
+    adapter->poll(std::chrono::milliseconds(60));
+    adapter->shutdown();
+    if (queries.size() != 2 || sessions.timedOut != 1 || sessions.open() != 0 || timeouts != 1 || confirms != 1) {
+        std::cerr << "Unconfirmed reply query did not time out (" << sessions.timedOut << " timed out)" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+const RuntimeMetrics::MdTcpPeerStats *tcp_peer_stats(const RuntimeMetrics::Snapshot &snapshot,
+                                                     const std::string &peer)
+{
+    for (const auto &stats : snapshot.mdTcpPeers) {
+        if (stats.peer == peer) {
+            return &stats;
+        }
+    }
+    return nullptr;
+}
+
+// TCP exchanges with one peer share a pooled connection until it has been idle for mdTcpIdleTimeoutMs; UDP
+// opens none.
+int check_md_tcp_pool()
+{
+    auto adapter = create_stub_trdp_stack_adapter();
+    NetworkConfig network;
+    network.mdTcpIdleTimeoutMs = 40;
+    adapter->initialize(network, LoggingConfig{});
+    RuntimeMetrics metrics;
+    adapter->set_md_connection_handler([&metrics](const MdConnectionEvent &event) {
+        if (event.kind == MdConnectionEvent::Kind::Exchange) {
+            metrics.record_md_tcp_exchange(event.peer);
+        } else {
+            metrics.record_md_tcp_connection(event.peer, event.kind == MdConnectionEvent::Kind::Opened);
+        }
+    });
+    MdSenderConfig sender;
+    sender.comId = 830;
+    sender.type = MdSenderConfig::Type::Notify;
+    sender.transport = MdTransport::Tcp;
+    for (const auto *peer : {"10.0.0.9", "10.0.0.10"}) {
+        sender.name = peer;
+        sender.destIp = peer;
+        adapter->register_md_sender(sender, {}, {});
+    }
+    sender.name = "Datagram";
+    sender.transport = MdTransport::Udp;
+    adapter->register_md_sender(sender, {}, {});
+
+    for (int request = 0; request < 5; ++request) {
+        adapter->send_md_request("10.0.0.9", {1});
+        adapter->send_md_request("Datagram", {1});
+    }
+    adapter->send_md_request("10.0.0.10", {1});
+    auto snapshot = metrics.snapshot();
+    const auto *pooled = tcp_peer_stats(snapshot, "10.0.0.9");
+    if (snapshot.mdTcpPeers.size() != 2 || pooled == nullptr || pooled->exchanges != 5 || pooled->connects != 1 ||
+        pooled->openConnections != 1) {
+        std::cerr << "TCP exchanges with one peer did not reuse a pooled connection" << std::endl;
+        return 1;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    adapter->send_md_request("10.0.0.9", {1});
+    adapter->shutdown();
+    snapshot = metrics.snapshot();
+    pooled = tcp_peer_stats(snapshot, "10.0.0.9");
+    if (pooled == nullptr || pooled->exchanges != 6 || pooled->connects != 2 || pooled->openConnections != 1) {
+        std::cerr << "Idle TCP connection was not replaced: " << (pooled != nullptr ? pooled->connects : 0)
+                  << " connects" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+const RuntimeMetrics::PdPublisherStats *publisher_stats(const RuntimeMetrics::Snapshot &snapshot,
+                                                       const std::string &name)
+{
+    for (const auto &stats : snapshot.pdPublishers) {
+        if (stats.name == name) {
+            return &stats;
+        }
+    }
+    return nullptr;
+}
+
+// Timeline: initial send at 0, three changes at 10 ms coalesced into one send at minIntervalMs, keep-alive
+// keepAliveMs after that. A cyclic publisher would only have sent the change at the 200 ms cycle boundary.
+int check_pd_on_change()
+{
+    SessionCounts sessions;
+    auto adapter = make_adapter(sessions);
+    Logger logger(LogLevel::Error);
+    RuntimeMetrics metrics;
+    std::vector<std::vector<std::uint8_t>> received;
+    std::mutex receivedMutex;
+    PdSubscriberConfig subscriber;
+    subscriber.name = "Watcher";
+    subscriber.comId = 600;
+    adapter->register_pd_subscriber(subscriber, [&received, &receivedMutex](const PdMessage &message) {
+        std::lock_guard<std::mutex> lock(receivedMutex);
+        received.push_back(message.payload);
+    });
+
+    PdPublisherConfig publisher;
+    publisher.name = "Door";
+    publisher.comId = 600;
+    publisher.sendMode = PdPublisherConfig::SendMode::OnChange;
+    publisher.cycleTimeMs = 200;
+    publisher.minIntervalMs = 50;
+    publisher.keepAliveMs = 300;
+    publisher.payload.format = PayloadConfig::Format::Hex;
+    publisher.payload.value = "01";
+    auto worker = adapter->create_pd_publisher_worker(publisher, logger, metrics);
+    const auto started = std::chrono::steady_clock::now();
+    worker->start();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    std::string error;
+    for (const auto *value : {"02", "03", "04"}) {
+        worker->update_payload(PayloadConfig::Format::Hex, value, error);
+    }
+    std::this_thread::sleep_until(started + std::chrono::milliseconds(150));
+    auto snapshot = metrics.snapshot();
+    const auto *stats = publisher_stats(snapshot, "Door");
+    {
+        std::lock_guard<std::mutex> lock(receivedMutex);
+        if (stats == nullptr || stats->packetsSent != 2 || stats->onChangeSends != 1 || stats->keepAliveSends != 0 ||
+            received.size() != 2 || received.back() != std::vector<std::uint8_t>{0x04}) {
+            std::cerr << "On-change publisher did not send the initial payload and one coalesced change" << std::endl;
+            return 1;
+        }
+    }
+    // Only the change counts towards the latency saved: about 200 - 50 ms.
+    if (stats->latencySavedUs < 100000 || stats->latencySavedUs > 200000) {
+        std::cerr << "On-change publisher reported " << stats->latencySavedUs << " us saved for one change"
+                  << std::endl;
+        return 1;
+    }
+
+    std::this_thread::sleep_until(started + std::chrono::milliseconds(450));
+    worker->stop();
+    snapshot = metrics.snapshot();
+    stats = publisher_stats(snapshot, "Door");
+    if (stats == nullptr || stats->keepAliveSends != 1 || stats->onChangeSends != 1 || stats->packetsSent != 3) {
+        std::cerr << "On-change publisher did not send a keep-alive after an idle keepAliveMs" << std::endl;
+        return 1;
+    }
+    adapter->shutdown();
+    return 0;
+}
+
+// Sends are logged only for telegrams whose channel has debug enabled.
+int check_debug_send_logging()
+{
+    const auto directory = std::filesystem::temp_directory_path() / "trdp-simulator-send-log-test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    LoggingConfig config;
+    config.filePath = (directory / "sends.log").string();
+    std::string text;
+    {
+        SessionCounts sessions;
+        auto adapter = make_adapter(sessions);
+        Logger logger(LogLevel::Info);
+        logger.enable_console(false);
+        logger.set_overrides({{"Quiet", 0, "", LogLevel::Info}, {"", 0, "pd", LogLevel::Debug},
+                              {"", 0, "md", LogLevel::Debug}},
+                             {});
+        RotatingLogFile file(config, [](const std::string &) {});
+        logger.set_file(&file);
+        RuntimeMetrics metrics;
+
+        PdPublisherConfig publisher;
+        publisher.name = "Door";
+        publisher.comId = 700;
+        publisher.cycleTimeMs = 10;
+        publisher.payload.format = PayloadConfig::Format::Hex;
+        publisher.payload.value = "0A0B";
+        auto loud = adapter->create_pd_publisher_worker(publisher, logger, metrics);
+        publisher.name = "Quiet";
+        publisher.comId = 701;
+        auto quiet = adapter->create_pd_publisher_worker(publisher, logger, metrics);
+        MdSenderConfig sender;
+        sender.name = "Notifier";
+        sender.comId = 702;
+        sender.type = MdSenderConfig::Type::Notify;
+        sender.payload.format = PayloadConfig::Format::Hex;
+        sender.payload.value = "FF";
+        auto notifier = adapter->create_md_sender_worker(sender, logger, metrics);
+
+        loud->start();
+        quiet->start();
+        notifier->start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(35));
+        loud->stop();
+        quiet->stop();
+        notifier->stop();
+        logger.set_file(nullptr);
+        adapter->shutdown();
+    }
+    std::ifstream input(config.filePath);
+    text.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    std::filesystem::remove_all(directory);
+    if (text.find("[DEBUG] PD publisher 'Door' sent COMID 700 payload=0a 0b") == std::string::npos ||
+        text.find("[DEBUG] MD sender 'Notifier' sent notification COMID 702 payload=ff") == std::string::npos) {
+        std::cerr << "Sends of telegrams with a debug override were not logged: " << text << std::endl;
+        return 1;
+    }
+    if (text.find("'Quiet' sent") != std::string::npos) {
+        std::cerr << "Sends of a telegram at info level were logged" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Only telegrams that validate the counters are re-addressed, and each sending one reports how long it carried
+// the old counters.
+int check_topology_retarget()
+{
+    const char *xml = R"XML(<?xml version="1.0"?>
+<trdpSimulator>
+  <network interface="lo" hostIp="127.0.0.1" />
+  <logging level="error" console="false" />
+  <pd>
+    <publisher name="Validating" comId="800" cycleTimeMs="20" etbTopoCount="1" />
+    <publisher name="Unchecked" comId="801" cycleTimeMs="20" />
+    <publisher name="Responder" comId="802" role="pullResponder" opTrnTopoCount="1" />
+    <subscriber name="ValidatingMonitor" comId="800" etbTopoCount="1" opTrnTopoCount="1" />
+  </pd>
+</trdpSimulator>
+)XML";
+    Simulator simulator(load_configuration_from_string(xml), create_stub_trdp_stack_adapter());
+    std::thread runner([&simulator] { simulator.run(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    std::string error;
+    bool updated = simulator.set_topology(7, 9, error);
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    // Repeating the counters re-addresses nothing, so it must not open another stale-counter window.
+    updated = updated && simulator.set_topology(7, 9, error);
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    const auto snapshot = simulator.metrics_snapshot();
+    const auto config = simulator.current_config();
+    simulator.stop();
+    runner.join();
+
+    if (!updated) {
+        std::cerr << "Topology update failed: " << error << std::endl;
+        return 1;
+    }
+    const auto &publishers = config.pdPublishers;
+    const auto &monitor = config.pdSubscribers.front();
+    if (publishers[0].etbTopoCount != 7 || publishers[0].opTrnTopoCount != 0 || publishers[1].etbTopoCount != 0 ||
+        publishers[2].opTrnTopoCount != 9 || monitor.etbTopoCount != 7 || monitor.opTrnTopoCount != 9) {
+        std::cerr << "Topology update did not re-address exactly the telegrams that validate the counters"
+                  << std::endl;
+        return 1;
+    }
+    const auto &topology = snapshot.topology;
+    if (topology.updates != 2 || topology.telegramsUpdated != 3 || topology.etbTopoCount != 7) {
+        std::cerr << "Topology update was not counted: " << topology.telegramsUpdated << " telegrams" << std::endl;
+        return 1;
+    }
+    // The responder has no send loop, so only the cyclic publisher reports a window: up to one 20 ms cycle plus
+    // the time its loop takes.
+    if (topology.staleWindow.count() != 1 || topology.staleWindow.max_us() > 40000) {
+        std::cerr << "Stale-counter window was not measured up to the first publish with the new counters ("
+                  << topology.staleWindow.count() << " windows, max " << topology.staleWindow.max_us() << " us)"
+                  << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace
+
+int run_stub_adapter_tests()
+{
+    if (check_md_reply_timeout() != 0 || check_md_notification() != 0 || check_md_request_reply() != 0 ||
+        check_md_reply_query_confirm() != 0 || check_md_tcp_pool() != 0 || check_pd_on_change() != 0 ||
+        check_debug_send_logging() != 0) {
+        return 1;
+    }
+    return check_topology_retarget();
+}
+
+}  // namespace trdp_sim
@@ -0,0 +1,44 @@
+#include "trdp_simulator/thread_monitor.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace trdp_sim {
+
+int run_thread_monitor_tests()
+{
+    if (!ThreadMonitor::supported()) {
+        return 0;
+    }
+
+    ThreadMonitor monitor(std::chrono::milliseconds(100));
+    monitor.start();
+    std::atomic<bool> spinning{true};
+    std::thread busy([&spinning] {
+        set_thread_name("pd:TestTelegramWithALongName");
+        while (spinning.load()) {
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(350));
+    const auto threads = monitor.threads();
+    spinning.store(false);
+    busy.join();
+    monitor.stop();
+
+    for (const auto &thread : threads) {
+        if (thread.name != "pd:TestTelegramWithALongName") {
+            continue;
+        }
+        if (thread.cpuPercent < 20.0 || thread.cpuTimeMs == 0) {
+            std::cerr << "Thread monitor reported " << thread.cpuPercent << "% CPU for a spinning thread" << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    std::cerr << "Thread monitor did not report the named thread" << std::endl;
+    return 1;
+}
+
+}  // namespace trdp_sim
@@ -1,6 +1,11 @@
 #include "trdp_simulator/web_application.hpp"
 
+#include <unistd.h>
+
+#include <filesystem>
 #include <iostream>
+#include <limits>
+#include <string>
 
 namespace trdp_sim {
 
@@ -35,7 +40,118 @@ int run_web_application_tests()
         return 1;
     }
 
-    return 0;
+    auto query = WebApplication::parse_list_query("list=pdPublishers&offset=1&limit=2&sort=comId&order=desc&filter=Door");
+    if (query.list != "pdPublishers" || query.offset != 1 || query.limit != std::optional<std::size_t>(2) ||
+        query.sort != WebApplication::ListQuery::Sort::ComId || !query.descending || query.filter != "Door" ||
+        !query.paged) {
+        std::cerr << "List query parameters were not parsed" << std::endl;
+        return 1;
+    }
+    query = WebApplication::parse_list_query("name=demo");
+    if (query.paged || query.limit || query.sort != WebApplication::ListQuery::Sort::Configured) {
+        std::cerr << "A query without list parameters was treated as paged" << std::endl;
+        return 1;
+    }
+    for (const char *invalid : {"sort=size", "order=up", "offset=-1", "offset=abc", "limit=2x", "offset=4294967296",
+                                "limit=99999999999999999999"}) {
+        try {
+            (void) WebApplication::parse_list_query(invalid);
+            std::cerr << "Invalid list query '" << invalid << "' was accepted" << std::endl;
+            return 1;
+        } catch (const std::exception &) {
+            // Expected path
+        }
+    }
+
+    // The application keeps its configuration library below the working directory.
+    const auto directory = std::filesystem::temp_directory_path() /
+                           ("trdp-simulator-web-test-" + std::to_string(::getpid()));
+    std::filesystem::create_directories(directory);
+    const auto workingDirectory = std::filesystem::current_path();
+    std::filesystem::current_path(directory);
+    int result = 0;
+    {
+        WebApplication application("127.0.0.1", 0);
+        SimulatorConfig config;
+        for (const auto &[name, comId] : {std::pair<const char *, std::uint32_t>{"Door3", 30}, {"Brake", 10},
+                                          {"door1", 50}, {"Hvac", 20}, {"Door2", 40}}) {
+            PdPublisherConfig publisher;
+            publisher.name = name;
+            publisher.comId = comId;
+            config.pdPublishers.push_back(publisher);
+        }
+        PdSubscriberConfig subscriber;
+        subscriber.name = "Monitor";
+        config.pdSubscribers.push_back(subscriber);
+
+        // Names in the order they appear in the publisher list of the summary.
+        const auto names = [](const std::string &json) {
+            std::string order;
+            const auto end = json.find("\"pdSubscribers\"");
+            for (auto pos = json.find("{\"name\":\""); pos < end; pos = json.find("{\"name\":\"", pos + 1)) {
+                const auto start = pos + 9;
+                order += (order.empty() ? "" : ",") + json.substr(start, json.find('"', start) - start);
+            }
+            return order;
+        };
+        const struct {
+            const char *query;
+            const char *names;
+            const char *pages;
+        } cases[] = {
+            {"", "Door3,Brake,door1,Hvac,Door2", nullptr},
+            {"list=pdPublishers&sort=comId&order=desc&offset=1&limit=2", "Door2,Door3",
+             "\"pages\":{\"pdPublishers\":{\"total\":5,\"matched\":5,\"offset\":1,\"count\":2}}"},
+            {"sort=name&filter=door", "Door2,Door3,door1",
+             "\"pdPublishers\":{\"total\":5,\"matched\":3,\"offset\":0,\"count\":3}"},
+            {"filter=20", "Hvac", "\"pdPublishers\":{\"total\":5,\"matched\":1,\"offset\":0,\"count\":1}"},
+            {"limit=0", "", "\"pdPublishers\":{\"total\":5,\"matched\":5,\"offset\":0,\"count\":0}"},
+            {"offset=9", "", "\"pdPublishers\":{\"total\":5,\"matched\":5,\"offset\":5,\"count\":0}"},
+            {"offset=3&limit=4294967295", "Hvac,Door2",
+             "\"pdPublishers\":{\"total\":5,\"matched\":5,\"offset\":3,\"count\":2}"},
+        };
+        for (const auto &entry : cases) {
+            const auto json = application.build_config_summary_json(config, WebApplication::parse_list_query(entry.query));
+            const bool pagesMatch = entry.pages == nullptr ? json.find("\"pages\"") == std::string::npos
+                                                           : json.find(entry.pages) != std::string::npos;
+            if (names(json) != entry.names || !pagesMatch) {
+                std::cerr << "List query '" << entry.query << "' selected '" << names(json) << "': " << json
+                          << std::endl;
+                result = 1;
+                break;
+            }
+        }
+        // Both save routes hold stored configurations to the same size limit.
+        HttpRequest oversized;
+        oversized.contentLength = 512U * 1024U + 1U;
+        const auto rawSave = application.handle_save_config_file(oversized, "oversized", "");
+        const auto formSave =
+            application.handle_save_config("name=oversized&xml=" + std::string(512U * 1024U + 1U, 'x'));
+        if (result == 0 && (rawSave.status_code != 400 || formSave.status_code != 400 ||
+                            rawSave.body.find("size limit") == std::string::npos ||
+                            formSave.body.find("size limit") == std::string::npos)) {
+            std::cerr << "Oversized configuration was not rejected by both save routes: " << rawSave.body << ' '
+                      << formSave.body << std::endl;
+            result = 1;
+        }
+
+        // A limit reaching past the end of the address space must not wrap around the offset.
+        auto unbounded = WebApplication::parse_list_query("offset=4");
+        unbounded.limit = std::numeric_limits<std::size_t>::max();
+        if (result == 0 && names(application.build_config_summary_json(config, unbounded)) != "Door2") {
+            std::cerr << "List query with the largest limit did not select the rows after the offset" << std::endl;
+            result = 1;
+        }
+        const auto restricted =
+            application.build_config_summary_json(config, WebApplication::parse_list_query("list=pdPublishers"));
+        if (result == 0 && restricted.find("\"pdSubscribers\":[]") == std::string::npos) {
+            std::cerr << "List query did not leave out the lists it does not select" << std::endl;
+            result = 1;
+        }
+    }
+    std::filesystem::current_path(workingDirectory);
+    std::filesystem::remove_all(directory);
+    return result;
 }
 
 }  // namespace trdp_sim
@@ -0,0 +1,77 @@
+#include "trdp_simulator/web_assets.hpp"
+
+#ifdef TRDPSIM_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#include <iostream>
+#include <set>
+#include <string>
+
+namespace trdp_sim {
+
+int run_web_assets_tests()
+{
+    const auto *page = find_web_asset("/");
+    const auto *script = find_web_asset("/app.js");
+    if (page == nullptr || script == nullptr || find_web_asset("/app.css") == nullptr ||
+        find_web_asset("/index.html") != nullptr || page->contentType != "text/html; charset=utf-8" ||
+        page->representations[0].data.find("/app.js") == std::string_view::npos) {
+        std::cerr << "Embedded web assets are missing" << std::endl;
+        return 1;
+    }
+
+    std::set<std::string_view> etags;
+    for (std::size_t index = 0; index < script->representationCount; ++index) {
+        const auto &representation = script->representations[index];
+        etags.insert(representation.etag);
+        if (representation.etag.size() != 18U || representation.etag.front() != '"' ||
+            (index != 0 && representation.data.size() >= script->representations[0].data.size())) {
+            std::cerr << "Embedded asset representation " << index << " is malformed" << std::endl;
+            return 1;
+        }
+#ifdef TRDPSIM_WITH_ZLIB
+        if (representation.contentEncoding == "gzip") {
+            std::string inflated(script->representations[0].data.size(), '\0');
+            z_stream stream{};
+            inflateInit2(&stream, 15 + 16);
+            stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(representation.data.data()));
+            stream.avail_in = static_cast<uInt>(representation.data.size());
+            stream.next_out = reinterpret_cast<Bytef *>(inflated.data());
+            stream.avail_out = static_cast<uInt>(inflated.size());
+            const int result = inflate(&stream, Z_FINISH);
+            inflateEnd(&stream);
+            if (result != Z_STREAM_END || inflated != script->representations[0].data) {
+                std::cerr << "Embedded gzip asset does not inflate to the original" << std::endl;
+                return 1;
+            }
+        }
+#endif
+    }
+    if (etags.size() != script->representationCount) {
+        std::cerr << "Embedded asset representations share an ETag" << std::endl;
+        return 1;
+    }
+
+    const WebAssetRepresentation representations[] = {
+        {"", "\"a\"", "identity body"}, {"gzip", "\"b\"", "gzip body"}, {"br", "\"c\"", "br"}};
+    const WebAsset asset{"/test", "text/plain", representations, 3};
+    const auto selected = [&asset](std::string_view acceptEncoding) {
+        return select_web_asset_representation(asset, acceptEncoding).contentEncoding;
+    };
+    if (selected("") != "" || selected("gzip, deflate") != "gzip" || selected("gzip, br") != "br" ||
+        selected("BR;q=0.5") != "br" || selected("br;q=0, gzip") != "gzip" || selected("*") != "br" ||
+        selected("*, br;q=0") != "gzip" || selected("identity") != "") {
+        std::cerr << "Accept-Encoding negotiation picked the wrong representation" << std::endl;
+        return 1;
+    }
+
+    if (!etag_matches("\"a\"", "\"a\"") || !etag_matches("\"x\", W/\"a\"", "\"a\"") || !etag_matches("*", "\"a\"") ||
+        etag_matches("\"b\"", "\"a\"") || etag_matches("", "\"a\"")) {
+        std::cerr << "If-None-Match comparison is wrong" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace trdp_sim
@@ -0,0 +1,611 @@
+const dropZone = document.getElementById('dropZone');
+const fileInput = document.getElementById('configFile');
+const configSummaryPre = document.getElementById('configSummary');
+const parsedConfigName = document.getElementById('parsedConfigName');
+const saveConfigBtn = document.getElementById('saveConfigBtn');
+const messageBox = document.getElementById('messages');
+const configSelect = document.getElementById('configSelect');
+const savedConfigDetails = document.getElementById('savedConfigDetails');
+let lastParsedFile = null;
+let lastSuggestedName = '';
+
+function showMessage(text, variant = 'info') {
+  if (!text) {
+    messageBox.style.display = 'none';
+    return;
+  }
+  messageBox.textContent = text;
+  messageBox.className = variant;
+  messageBox.style.display = 'block';
+  if (variant === 'success') {
+    setTimeout(() => { messageBox.style.display = 'none'; }, 4000);
+  }
+}
+
+function renderMetricList(elementId, items, formatter, emptyMessage) {
+  const list = document.getElementById(elementId);
+  if (!list) {
+    return;
+  }
+  const formatItem = typeof formatter === 'function' ? formatter : (value) => String(value);
+  list.innerHTML = '';
+  if (!Array.isArray(items) || items.length === 0) {
+    const li = document.createElement('li');
+    li.textContent = emptyMessage;
+    li.classList.add('muted');
+    list.appendChild(li);
+    return;
+  }
+  items.forEach((item) => {
+    const li = document.createElement('li');
+    li.textContent = formatItem(item);
+    list.appendChild(li);
+  });
+}
+
+// Telegram lists are paged on the server: a list only holds the rows in view, its scroll height comes from the
+// row count the server reports, and scrolling, filtering or sorting fetches just the visible window.
+class VirtualList {
+  constructor(container, options) {
+    this.options = options;
+    this.query = { list: options.lists ? options.lists[0].value : '', filter: '', sort: '' };
+    this.requestId = 0;
+    this.frame = null;
+
+    const controls = document.createElement('div');
+    controls.className = 'list-controls';
+    if (options.lists) {
+      const listSelect = document.createElement('select');
+      options.lists.forEach(({ value, label }) => listSelect.appendChild(new Option(label, value)));
+      listSelect.addEventListener('change', () => this.setQuery({ list: listSelect.value }));
+      controls.appendChild(listSelect);
+    }
+    const filter = document.createElement('input');
+    filter.type = 'text';
+    filter.placeholder = 'Filter by name or ComID';
+    let filterTimer = null;
+    filter.addEventListener('input', () => {
+      clearTimeout(filterTimer);
+      filterTimer = setTimeout(() => this.setQuery({ filter: filter.value.trim() }), 250);
+    });
+    const sort = document.createElement('select');
+    [['', 'Configured order'], ['name:asc', 'Name'], ['name:desc', 'Name (descending)'], ['comId:asc', 'ComID'],
+      ['comId:desc', 'ComID (descending)']].forEach(([value, label]) => sort.appendChild(new Option(label, value)));
+    sort.addEventListener('change', () => this.setQuery({ sort: sort.value }));
+    this.count = document.createElement('span');
+    this.count.className = 'list-count';
+    controls.append(filter, sort, this.count);
+
+    this.viewport = document.createElement('div');
+    this.viewport.className = 'virtual-list';
+    this.viewport.style.height = `${options.height || 240}px`;
+    this.spacer = document.createElement('div');
+    this.spacer.className = 'virtual-spacer';
+    this.rows = document.createElement('div');
+    this.rows.className = 'virtual-rows';
+    this.spacer.appendChild(this.rows);
+    this.viewport.appendChild(this.spacer);
+    container.append(controls, this.viewport);
+
+    this.viewport.addEventListener('scroll', () => {
+      if (!this.frame) {
+        this.frame = requestAnimationFrame(() => {
+          this.frame = null;
+          this.refresh();
+        });
+      }
+    });
+  }
+
+  setQuery(changes) {
+    Object.assign(this.query, changes);
+    this.viewport.scrollTop = 0;
+    this.refresh();
+  }
+
+  // Periodic refreshes pass background so that a row being edited is not replaced.
+  async refresh(background = false) {
+    if (background && this.viewport.contains(document.activeElement)) {
+      return;
+    }
+    const rowHeight = this.options.rowHeight;
+    const overscan = 5;
+    const first = Math.max(0, Math.floor(this.viewport.scrollTop / rowHeight) - overscan);
+    const limit = Math.ceil(this.viewport.clientHeight / rowHeight) + 2 * overscan;
+    const requestId = ++this.requestId;
+    try {
+      const page = await this.options.fetchRows(first, limit, this.query);
+      if (requestId === this.requestId) {
+        this.render(first, page);
+      }
+    } catch (error) {
+      if (requestId === this.requestId) {
+        this.render(0, { items: [], matched: 0, total: 0, error: error.message });
+      }
+    }
+  }
+
+  render(first, page) {
+    const rowHeight = this.options.rowHeight;
+    this.spacer.style.height = `${page.matched * rowHeight}px`;
+    this.rows.style.transform = `translateY(${first * rowHeight}px)`;
+    this.count.textContent = page.matched === page.total ? `${page.total}` : `${page.matched} of ${page.total}`;
+    this.rows.innerHTML = '';
+    if (page.items.length === 0) {
+      const row = document.createElement('div');
+      row.className = 'virtual-row muted';
+      row.textContent = page.error || this.options.emptyMessage;
+      this.rows.appendChild(row);
+      return;
+    }
+    page.items.forEach((item) => {
+      const row = this.options.renderRow(item);
+      row.classList.add('virtual-row');
+      row.style.height = `${rowHeight}px`;
+      this.rows.appendChild(row);
+    });
+  }
+}
+
+function listParams(list, offset, limit, query) {
+  const params = new URLSearchParams({ list, offset: String(offset), limit: String(limit) });
+  if (query.filter) {
+    params.set('filter', query.filter);
+  }
+  if (query.sort) {
+    const [sort, order] = query.sort.split(':');
+    params.set('sort', sort);
+    params.set('order', order);
+  }
+  return params.toString();
+}
+
+// Fetches one page of a list; the lists and their "pages" counts sit in the object chosen by select.
+async function fetchPage(url, list, select = (data) => data) {
+  const response = await fetch(url);
+  const data = await response.json();
+  if (!response.ok) {
+    throw new Error(data.error || 'Request failed');
+  }
+  const root = select(data) || {};
+  const page = (root.pages || {})[list] || { matched: 0, total: 0 };
+  return { data, items: root[list] || [], matched: page.matched, total: page.total };
+}
+
+function textRow(text) {
+  const row = document.createElement('div');
+  row.textContent = text;
+  row.title = text;
+  return row;
+}
+
+function preventDefaults(event) {
+  event.preventDefault();
+  event.stopPropagation();
+}
+
+function highlightDropZone() { dropZone.classList.add('dragover'); }
+function unhighlightDropZone() { dropZone.classList.remove('dragover'); }
+
+dropZone.addEventListener('click', () => fileInput.click());
+['dragenter', 'dragover'].forEach((eventName) => {
+  dropZone.addEventListener(eventName, (event) => { preventDefaults(event); highlightDropZone(); });
+});
+['dragleave', 'drop'].forEach((eventName) => {
+  dropZone.addEventListener(eventName, (event) => { preventDefaults(event); unhighlightDropZone(); });
+});
+
+dropZone.addEventListener('drop', (event) => {
+  const files = event.dataTransfer.files;
+  if (files && files.length > 0) {
+    readConfigurationFile(files[0]);
+  }
+});
+
+fileInput.addEventListener('change', (event) => {
+  const files = event.target.files;
+  if (files && files.length > 0) {
+    readConfigurationFile(files[0]);
+  }
+});
+
+function readConfigurationFile(file) {
+  if (!file.name.toLowerCase().endsWith('.xml')) {
+    showMessage('Please select an XML configuration file.', 'error');
+    return;
+  }
+  parseUploadedConfiguration(file, file.name.replace(/\.[^.]+$/, ''));
+}
+
+// The file is posted as raw XML; the server streams large bodies to disk instead of decoding a form.
+async function parseUploadedConfiguration(file, suggestedName = '') {
+  try {
+    const params = new URLSearchParams();
+    if (suggestedName) {
+      params.set('name', suggestedName);
+    }
+    const response = await fetch(`/api/config/parse?${params}`, {
+      method: 'POST',
+      headers: { 'Content-Type': 'application/xml' },
+      body: file,
+    });
+    const data = await response.json();
+    if (!response.ok) {
+      showMessage(data.error || 'Failed to parse configuration.', 'error');
+      configSummaryPre.textContent = data.error || 'Unable to parse configuration.';
+      saveConfigBtn.disabled = true;
+      return;
+    }
+    lastParsedFile = file;
+    lastSuggestedName = (suggestedName || data.suggestedName || '').replace(/\s+/g, '_');
+    parsedConfigName.textContent = lastSuggestedName || '(unspecified)';
+    configSummaryPre.textContent = JSON.stringify(data.summary, null, 2);
+    saveConfigBtn.disabled = false;
+    showMessage('Configuration parsed successfully.', 'success');
+  } catch (error) {
+    showMessage('Failed to parse configuration: ' + error.message, 'error');
+  }
+}
+
+saveConfigBtn.addEventListener('click', async () => {
+  if (!lastParsedFile) {
+    return;
+  }
+  let name = prompt('Enter a name for the configuration', lastSuggestedName || 'trdp-config');
+  if (!name) {
+    return;
+  }
+  name = name.trim();
+  try {
+    const response = await fetch(`/api/config/save?name=${encodeURIComponent(name)}`, {
+      method: 'POST',
+      headers: { 'Content-Type': 'application/xml' },
+      body: lastParsedFile,
+    });
+    const data = await response.json();
+    if (!response.ok) {
+      showMessage(data.error || 'Unable to save configuration.', 'error');
+      return;
+    }
+    showMessage(`Configuration "${data.name}" saved successfully.`, 'success');
+    await refreshSavedConfigs();
+    configSelect.value = data.name;
+    await loadSelectedConfiguration();
+  } catch (error) {
+    showMessage('Saving configuration failed: ' + error.message, 'error');
+  }
+});
+
+document.getElementById('viewConfigBtn').addEventListener('click', loadSelectedConfiguration);
+
+async function refreshSavedConfigs() {
+  try {
+    const response = await fetch('/api/configs');
+    const data = await response.json();
+    configSelect.innerHTML = '';
+    if (!data.configs || data.configs.length === 0) {
+      const option = document.createElement('option');
+      option.value = '';
+      option.textContent = 'No saved configurations';
+      option.disabled = true;
+      option.selected = true;
+      configSelect.appendChild(option);
+      savedConfigDetails.textContent = 'No configuration selected.';
+      return;
+    }
+    const placeholder = document.createElement('option');
+    placeholder.value = '';
+    placeholder.textContent = 'Select a configuration';
+    placeholder.disabled = true;
+    placeholder.selected = true;
+    configSelect.appendChild(placeholder);
+    data.configs.forEach((item) => {
+      const option = document.createElement('option');
+      option.value = item.name;
+      if (item.status === 'valid') {
+        const pd = item.pdPublishers + item.pdSubscribers;
+        const md = item.mdSenders + item.mdListeners;
+        option.textContent = `${item.name} (${pd} PD, ${md} MD)`;
+      } else if (item.status === 'invalid') {
+        option.textContent = `${item.name} (invalid)`;
+        option.title = item.error;
+      } else {
+        option.textContent = item.name;
+      }
+      configSelect.appendChild(option);
+    });
+  } catch (error) {
+    showMessage('Unable to fetch saved configurations: ' + error.message, 'error');
+  }
+}
+
+let selectedConfigName = '';
+const configTelegramsView = new VirtualList(document.getElementById('configTelegramsView'), {
+  rowHeight: 28,
+  height: 280,
+  emptyMessage: 'No telegrams',
+  lists: [
+    { value: 'pdPublishers', label: 'PD publishers' },
+    { value: 'pdSubscribers', label: 'PD subscribers' },
+    { value: 'mdSenders', label: 'MD senders' },
+    { value: 'mdListeners', label: 'MD listeners' },
+  ],
+  fetchRows: (offset, limit, query) => fetchPage(
+    `/api/config/details?name=${encodeURIComponent(selectedConfigName)}&${listParams(query.list, offset, limit, query)}`,
+    query.list, (data) => data.summary),
+  renderRow: (item) => textRow(`${item.name} (ComID ${item.comId}): ${JSON.stringify(item)}`),
+});
+
+async function loadSelectedConfiguration() {
+  const name = configSelect.value;
+  const telegramsPanel = document.getElementById('configTelegramsPanel');
+  if (!name) {
+    savedConfigDetails.textContent = 'No configuration selected.';
+    telegramsPanel.classList.add('hidden');
+    return;
+  }
+  try {
+    // The telegram lists are browsed page by page below; the overview only carries their counts.
+    const response = await fetch(`/api/config/details?name=${encodeURIComponent(name)}&limit=0`);
+    const data = await response.json();
+    if (!response.ok) {
+      showMessage(data.error || 'Unable to load configuration details.', 'error');
+      return;
+    }
+    const { pdPublishers, pdSubscribers, mdSenders, mdListeners, ...overview } = data.summary;
+    savedConfigDetails.textContent = JSON.stringify(overview, null, 2);
+    selectedConfigName = name;
+    telegramsPanel.classList.remove('hidden');
+    configTelegramsView.refresh();
+  } catch (error) {
+    showMessage('Unable to load configuration details: ' + error.message, 'error');
+  }
+}
+
+async function startSimulator() {
+  const manualPath = document.getElementById('configPath').value.trim();
+  const savedName = configSelect.value;
+  let configSpec = '';
+  if (manualPath) {
+    configSpec = manualPath;
+  } else if (savedName) {
+    configSpec = `saved:${savedName}`;
+  }
+  if (!configSpec) {
+    showMessage('Please choose a saved configuration or provide a path before starting the simulator.', 'error');
+    return;
+  }
+  try {
+    const params = new URLSearchParams();
+    params.set('config', configSpec);
+    const response = await fetch('/api/start', {
+      method: 'POST',
+      headers: { 'Content-Type': 'application/x-www-form-urlencoded' },
+      body: params,
+    });
+    const data = await response.json();
+    if (!response.ok) {
+      showMessage(data.error || 'Failed to start simulator.', 'error');
+      return;
+    }
+    showMessage(data.message || 'Simulator started.', 'success');
+    refreshStatus();
+    refreshMetrics();
+    refreshPayloads();
+  } catch (error) {
+    showMessage('Failed to start simulator: ' + error.message, 'error');
+  }
+}
+
+async function stopSimulator() {
+  try {
+    const response = await fetch('/api/stop', { method: 'POST' });
+    const data = await response.json();
+    if (!response.ok) {
+      showMessage(data.error || 'Failed to stop simulator.', 'error');
+      return;
+    }
+    showMessage(data.message || 'Simulator stopped.', 'success');
+    refreshStatus();
+    refreshMetrics();
+    refreshPayloads();
+  } catch (error) {
+    showMessage('Failed to stop simulator: ' + error.message, 'error');
+  }
+}
+
+document.getElementById('startBtn').addEventListener('click', startSimulator);
+document.getElementById('stopBtn').addEventListener('click', stopSimulator);
+
+async function refreshStatus() {
+  try {
+    const response = await fetch('/api/status');
+    const data = await response.json();
+    const status = document.getElementById('status');
+    const details = document.getElementById('details');
+    const simulatorState = document.getElementById('simulatorState');
+    if (data.running) {
+      status.textContent = `Simulator is running${data.configLabel ? ' with ' + data.configLabel : ''}.`;
+      simulatorState.textContent = 'Running';
+    } else {
+      status.textContent = 'Simulator is stopped';
+      simulatorState.textContent = 'Stopped';
+    }
+    details.textContent = JSON.stringify(data, null, 2);
+    if (data.running) {
+      refreshPayloads();
+    } else {
+      hidePayloadEditor();
+    }
+  } catch (err) {
+    document.getElementById('status').textContent = 'Unable to query status';
+    document.getElementById('simulatorState').textContent = 'Unknown';
+    hidePayloadEditor();
+  }
+}
+
+function hidePayloadEditor() {
+  document.getElementById('payloadEditor').classList.add('hidden');
+}
+
+const metricFormatters = {
+  pdPublishers: (item) => {
+    let text = `${item.name}: ${item.packetsSent} packets sent`;
+    if (item.onChangeSends) {
+      text += ` (${item.onChangeSends} on change, ${item.keepAliveSends} keep-alive, ` +
+        `${(item.avgLatencySavedUs / 1000).toFixed(1)} ms saved on average)`;
+    }
+    if (item.tsnLaunchError) {
+      text += ` (launch error p50 ${item.tsnLaunchError.p50Us || 0} us, p99 ${item.tsnLaunchError.p99Us || 0} us, ` +
+        `${item.tsnLateHandoffs} late handoffs, ${item.tsnMissedLaunches} missed)`;
+    }
+    return text;
+  },
+  pdSubscribers: (item) => {
+    let text = `${item.name}: ${item.packetsReceived} packets received`;
+    if (item.pullLatency) {
+      text += ` (${item.pullRepliesReceived}/${item.pullRequestsSent} pull replies, ${item.pullRequestsLost} lost`;
+      if (item.pullLatency.count) {
+        text += `, p50 ${item.pullLatency.p50Us} us, p99 ${item.pullLatency.p99Us} us`;
+      }
+      text += ')';
+    }
+    if (item.switchoverGap) {
+      text += ` (switchover gap max ${item.switchoverGap.maxUs} us, ${item.switchoversOverCycle} over one cycle)`;
+    }
+    return text;
+  },
+  mdSenders: (item) => `${item.name}: ${item.requestsSent} requests / ${item.repliesReceived} replies`,
+  mdListeners: (item) => `${item.name}: ${item.requestsReceived} requests / ${item.repliesSent} replies`,
+  loops: (item) => `${item.name}: p99 ${item.lag.p99Us || 0} us, max ${item.lag.maxUs} us (${item.stalls} stalls)`,
+};
+
+const metricViews = {};
+[['pdPublishers', 'No PD publishers'], ['pdSubscribers', 'No PD subscribers'], ['mdSenders', 'No MD senders'],
+  ['mdListeners', 'No MD listeners'], ['loops', 'No loops watched']].forEach(([list, emptyMessage]) => {
+  metricViews[list] = new VirtualList(document.getElementById(`${list}View`), {
+    rowHeight: 28,
+    emptyMessage,
+    fetchRows: (offset, limit, query) => fetchPage(`/api/metrics?${listParams(list, offset, limit, query)}`, list),
+    renderRow: (item) => textRow(metricFormatters[list](item)),
+  });
+});
+
+async function refreshMetrics() {
+  try {
+    // limit=0 returns the totals without any telegram rows; each list then fetches the rows it shows.
+    const response = await fetch('/api/metrics?limit=0');
+    if (!response.ok) {
+      throw new Error('Request failed');
+    }
+    const data = await response.json();
+    document.getElementById('adapterState').textContent = data.adapterState || 'Unknown';
+    Object.values(metricViews).forEach((view) => view.refresh(true));
+    renderMetricList('pdRedundancyList', data.pdRedundancyGroups || [],
+      (item) => `Group ${item.id}: ${item.leader ? 'leader' : 'follower'} (${item.failovers} failovers)`,
+      'No PD redundancy groups');
+    renderMetricList('mdTcpPeersList', data.mdTcpPeers || [],
+      (item) => `${item.peer}: ${item.exchanges} exchanges / ${item.connects} connects (${item.openConnections} open)`,
+      'No TCP message data');
+    const mdTypeItems = (data.mdMessageTypes || []).filter((item) => item.sent || item.received)
+      .map((item) => `${item.type}: ${item.sentPerSecond.toFixed(1)}/s sent, ${item.receivedPerSecond.toFixed(1)}/s received`);
+    const sessions = data.mdSessions || {};
+    if (sessions.callerPeak || sessions.replierPeak) {
+      mdTypeItems.push(`Sessions: ${sessions.callerOpen} caller (peak ${sessions.callerPeak}), ` +
+        `${sessions.replierOpen} replier (peak ${sessions.replierPeak})`);
+    }
+    renderMetricList('mdMessageTypesList', mdTypeItems, (text) => text, 'No message data');
+    document.getElementById('metricsRaw').textContent = JSON.stringify(data, null, 2);
+  } catch (err) {
+    document.getElementById('metricsRaw').textContent = 'Unable to query metrics';
+  }
+}
+
+function payloadRow(item, type) {
+  const card = document.createElement('div');
+  card.className = 'payload-card';
+  const title = document.createElement('h4');
+  title.textContent = `${item.name} (ComID ${item.comId})`;
+  const meta = document.createElement('div');
+  meta.className = 'payload-meta';
+  meta.textContent = `Format: ${item.format}${item.editable ? '' : ' (read-only)'}`;
+  const input = document.createElement('textarea');
+  input.value = item.value || '';
+  input.disabled = !item.editable;
+  const actions = document.createElement('div');
+  actions.className = 'payload-actions';
+  const button = document.createElement('button');
+  button.textContent = 'Update payload';
+  button.className = 'secondary';
+  button.disabled = !item.editable;
+  button.addEventListener('click', async () => {
+    await updatePayload(type, item.name, item.format, input.value);
+  });
+  actions.appendChild(button);
+  card.appendChild(title);
+  card.appendChild(meta);
+  card.appendChild(input);
+  card.appendChild(actions);
+  return card;
+}
+
+const payloadViews = {};
+['pd', 'md'].forEach((type) => {
+  payloadViews[type] = new VirtualList(document.getElementById(`${type}PayloadsView`), {
+    rowHeight: 200,
+    height: 480,
+    emptyMessage: 'No entries available.',
+    fetchRows: (offset, limit, query) =>
+      fetchPage(`/api/simulator/payloads?${listParams(type, offset, limit, query)}`, type),
+    renderRow: (item) => payloadRow(item, type),
+  });
+});
+
+async function refreshPayloads() {
+  try {
+    const response = await fetch('/api/simulator/payloads?limit=0');
+    if (!response.ok) {
+      throw new Error('Unable to fetch payloads');
+    }
+    const data = await response.json();
+    const editorSection = document.getElementById('payloadEditor');
+    if (!data.running) {
+      hidePayloadEditor();
+      return;
+    }
+    editorSection.classList.remove('hidden');
+    Object.values(payloadViews).forEach((view) => view.refresh(true));
+  } catch (error) {
+    showMessage('Unable to refresh payload information: ' + error.message, 'error');
+  }
+}
+
+async function updatePayload(type, name, format, value) {
+  try {
+    const params = new URLSearchParams();
+    params.set('type', type);
+    params.set('name', name);
+    params.set('format', format);
+    params.set('value', value);
+    const response = await fetch('/api/simulator/payload', {
+      method: 'POST',
+      headers: { 'Content-Type': 'application/x-www-form-urlencoded' },
+      body: params,
+    });
+    const data = await response.json();
+    if (!response.ok) {
+      showMessage(data.error || 'Unable to update payload.', 'error');
+      return;
+    }
+    showMessage(data.message || 'Payload updated.', 'success');
+    refreshPayloads();
+  } catch (error) {
+    showMessage('Unable to update payload: ' + error.message, 'error');
+  }
+}
+
+refreshSavedConfigs();
+refreshStatus();
+refreshMetrics();
+setInterval(refreshStatus, 4000);
+setInterval(refreshMetrics, 5000);